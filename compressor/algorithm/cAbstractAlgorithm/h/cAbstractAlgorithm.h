@@ -8,8 +8,9 @@
  * \brief Предназначен для реализации алгоритмов сжатия.
  *
  * \details Является основным функциональным модулем проекта.
- * Состоит из абстрактного интерфейса алгоритмов - \ref AlgorithmAbstract
- * и его реализаций: \ref AlgorithmRLE, \ref AlgorithmHaffman
+ * Состоит из абстрактного интерфейса алгоритмов - \ref AlgorithmAbstract,
+ * его реализаций: \ref AlgorithmRLE, \ref AlgorithmHaffman, - и их списка
+ * \ref AlgorithmRegistry
  *
  * ****************************************************************************/
 
@@ -20,7 +21,24 @@
  *
  * \brief Модуль, содержащий интерфейс для реализаций алгоритмов сжатия.
  *
- * \details Реализован с поиощью класса \ref cAbstractAlgorithm
+ * \details Алгоритм по типу создает \ref cAbstractAlgorithm::create, общий
+ * объект алгоритма выдает реестр \ref cAlgorithmRegistry.
+ *
+ * Объект алгоритма не хранит состояния, поэтому один объект можно вызывать
+ * из нескольких потоков одновременно. Вся рабочая память вызова (таблицы,
+ * гистограммы, буферы участков) находится в контексте
+ * \ref cAbstractAlgorithm::cContext, который в каждый момент использует один
+ * поток. Контекст переиспользуется от вызова к вызову, поэтому сжатие
+ * множества небольших данных подряд после первого вызова не выделяет
+ * рабочую память, а при передаче того же буфера результата - и память под
+ * результат.
+ *
+ * Методы без контекста берут его из запаса текущего потока: контекст
+ * выдается на время вызова и возвращается в запас, поэтому вложенный вызов
+ * в том же потоке (пул \ref ThreadPool выполняет чужие задачи, пока ждет
+ * свои) получает другой контекст.
+ *
+ * Реализован с поиощью класса \ref cAbstractAlgorithm
  * ****************************************************************************/
 
 
@@ -30,26 +48,93 @@
 #include <fstream> /// Для работы с файлами
 #include <vector> /// Вектор
 #include <common.h> /// Общие константы
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <memory> /// Умные указатели
 #include <string>
+#include <string_view> /// Представления строк
 
 /// \brief Абстрактный класс алгоритмов сжатия данных
 /// \class cAbstractAlgorithm
 class cAbstractAlgorithm
 {
 public:
-    /// \brief Интерфейс для сжатия данных
+    /// \brief Класс контекста - рабочей памяти алгоритма для одного потока
+    /// \class cContext
+    class cContext
+    {
+    public:
+        /// \brief Деструктор класса
+        virtual ~cContext( void ) = default;
+    };
+
+    /// \brief Деструктор класса
+    virtual ~cAbstractAlgorithm( void ) = default;
+
+    /// \brief Создать контекст этого алгоритма
+    /// \return Пустой контекст. Память выделяется при первом вызове
+    virtual std::unique_ptr< cContext > createContext( void ) const = 0;
+
+    /// \brief Интерфейс для сжатия данных с рабочей памятью контекста
+    ///
+    /// \details Данные передаются без копирования: представление может
+    /// указывать в отображенный в память файл
+    ///
+    /// \param [in] oldData Исходные данные для сжатия
+    /// \param [in] context Контекст, созданный \ref createContext этого
+    /// алгоритма
+    /// \param [out] result Сжатые данные. Память строки переиспользуется.
+    /// Пустая строка - ошибка
+    virtual void compress( std::string_view oldData, cContext &context, std::string &result ) const = 0;
+
+    /// \brief Интерфейс для распаковки данных с рабочей памятью контекста
+    /// \param [in] oldData Исходные данные для распаковки
+    /// \param [in] context Контекст, созданный \ref createContext этого
+    /// алгоритма
+    /// \param [out] result Распакованные данные. Память строки
+    /// переиспользуется. Пустая строка - ошибка
+    virtual void decompress( std::string_view oldData, cContext &context, std::string &result ) const = 0;
+
+    /// \brief Сжать данные с контекстом из запаса потока
     /// \param [in] oldData Исходные данные для сжатия
     /// \return Сжатые в соответсвии с алгоритмом данные
-    virtual std::string compress( const std::string & oldData ) = 0;
+    std::string compress( std::string_view oldData ) const;
 
-    /// \brief Интерфейс для распаковки данных
+    /// \brief Распаковать данные с контекстом из запаса потока
     /// \param [in] oldData Исходные данные для распаковки
     /// \return Распакованные в соответсвии с алгоритмом данные
-    virtual std::string decompress( const std::string & oldData ) = 0;
+    std::string decompress( std::string_view oldData ) const;
 
     /// \brief Получить постфикс
     /// \return Строка-расширение для упакованных данных
     inline virtual std::string getPostfix( void ) const = 0;
+
+    /// \brief Получить тип алгоритма
+    /// \return Тип алгоритма для записи в заголовок сжатых данных
+    inline virtual eTypeOfComprAlgorithm getType( void ) const = 0;
+
+    /// \brief Получить оценку памяти, выделяемой алгоритмом для блока
+    ///
+    /// \details Сверху, вместе с результатом: по ней бюджет \ref MemoryBudget
+    /// резервирует память до обработки блока
+    ///
+    /// \param [in] rawSize Размер исходного блока
+    /// \param [in] action Сжатие или распаковка
+    /// \return Количество байт
+    virtual uint64_t getMemoryBound( uint64_t rawSize, eTypeOfActions action ) const = 0;
+
+    /// \brief Создать алгоритм
+    /// \param [in] type Тип алгоритма
+    /// \return Алгоритм или nullptr для неизвестного типа
+    static std::unique_ptr< cAbstractAlgorithm > create( eTypeOfComprAlgorithm type );
+
+private:
+    /// \brief Взять контекст из запаса потока или создать новый
+    /// \return Контекст этого алгоритма
+    std::unique_ptr< cContext > acquireContext( void ) const;
+
+    /// \brief Вернуть контекст в запас потока
+    /// \param [in] context Контекст, полученный \ref acquireContext
+    void releaseContext( std::unique_ptr< cContext > context ) const;
 };
 
 /// @}
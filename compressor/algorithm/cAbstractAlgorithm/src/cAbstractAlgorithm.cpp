@@ -0,0 +1,71 @@
+/** ****************************************************************************
+ * \brief Исходные коды интерфейса алгоритмов
+ *
+ * \file cAbstractAlgorithm.cpp
+ * ****************************************************************************/
+
+#include "algorithm/cAbstractAlgorithm/h/cAbstractAlgorithm.h" /// Заголовок класса
+#include "algorithm/cAlgorithmRegistry/h/cAlgorithmRegistry.h" /// Реестр алгоритмов
+#include <array> /// Массивы фиксированного размера
+#include <type_traits> /// std::decay_t
+
+/// \brief Свободные контексты потока по типу алгоритма. Контексты одного
+/// типа взаимозаменяемы: объекты алгоритма не хранят состояния
+static thread_local std::array< std::vector< std::unique_ptr< cAbstractAlgorithm::cContext > >,
+                                cAlgorithmRegistry::COUNT > tFreeContexts;
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+std::unique_ptr< cAbstractAlgorithm > cAbstractAlgorithm::create( eTypeOfComprAlgorithm type )
+{
+    std::unique_ptr< cAbstractAlgorithm > algorithm;
+    cAlgorithmRegistry::visit( type, [ &algorithm ]( const auto &known )
+    {
+        algorithm = std::make_unique< std::decay_t< decltype( known ) > >();
+    } );
+
+    return algorithm;
+}
+
+std::string cAbstractAlgorithm::compress( std::string_view oldData ) const
+{
+    std::unique_ptr< cContext > context( acquireContext() );
+    std::string result;
+    compress( oldData, *context, result );
+    releaseContext( std::move( context ) );
+
+    return result;
+}
+
+std::string cAbstractAlgorithm::decompress( std::string_view oldData ) const
+{
+    std::unique_ptr< cContext > context( acquireContext() );
+    std::string result;
+    decompress( oldData, *context, result );
+    releaseContext( std::move( context ) );
+
+    return result;
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+std::unique_ptr< cAbstractAlgorithm::cContext > cAbstractAlgorithm::acquireContext( void ) const
+{
+    std::vector< std::unique_ptr< cContext > > &freeContexts = tFreeContexts[ getType() ];
+    if( freeContexts.empty() )
+        return createContext();
+
+    std::unique_ptr< cContext > context( std::move( freeContexts.back() ) );
+    freeContexts.pop_back();
+
+    return context;
+}
+
+void cAbstractAlgorithm::releaseContext( std::unique_ptr< cContext > context ) const
+{
+    tFreeContexts[ getType() ].push_back( std::move( context ) );
+}
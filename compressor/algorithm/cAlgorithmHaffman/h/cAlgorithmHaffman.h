@@ -13,7 +13,8 @@
  * элементы.
  *
  * Для создания дерева используется очередь с приоритетом. Узел с минимальной
- * частотой имеет наивысший приоритет.
+ * частотой имеет наивысший приоритет. Узлы хранятся в массиве контекста и
+ * ссылаются на потомков по номерам, очередь - куча из номеров узлов.
  * Шаги построения дерева:
  * - Создать узел для каждого символа и добавить его в очередь с приоритетом
  * - Пока в очереди > 1 листа
@@ -23,10 +24,10 @@
  * -- Добавить созданный узел в очередь
  * - Последний оставшийся элемент - корень дерева
  *
- * После создания дерева создаем отображение элемента на его код. Все элементы
- * будут находиться именно в листьях дерева. Для получения кода элемента
- * проходим по дереву от корня до элемента. Каждый спуск по левой ветви -
- * +0 к коду, каждый спуск по правой ветви +1 к коду.
+ * После создания дерева заполняем таблицу кодов по значению символа. Все
+ * элементы будут находиться именно в листьях дерева. Для получения кода
+ * элемента проходим по дереву от корня до элемента. Каждый спуск по левой
+ * ветви - +0 к коду, каждый спуск по правой ветви +1 к коду.
  *
  * Для успешного декодирования сжатых данных алгоритму требуется получить
  * дерево из закодированных данных. Без потерь по памяти сделать это невозможно.
@@ -47,11 +48,46 @@
  * количество значащих бит в служебном месте сжатого файла. Для этого выделено
  * 8 байт.
  *
- * Так как для декодирования данных необходимо считывать информацию побитно
- * и после каждого считанного бита сравнивать результат буфера со всеми кодами
- * в поисках символа - декомпрессия методом Хаффмана не самое быстрое
- * предприятие. Поэтому на файлах, имеющих большой размер алгоритм выполняется
- * довольно долго.
+ * Для декодирования по таблице кодов восстанавливается дерево в виде плоского
+ * массива узлов, и каждый бит - переход к потомку текущего узла.
+ *
+ * Поток бит нельзя разрезать по границам символов, не декодировав его, однако
+ * коды Хаффмана самосинхронизируются: декодирование, начатое с произвольного
+ * бита, через несколько символов попадает на настоящие границы символов.
+ * Поэтому распаковка тоже параллельна:
+ * - поток бит делится на участки произвольно, каждый участок декодируется
+ * со своего первого бита "наугад", запоминаются границы первых символов;
+ * - затем участки сшиваются последовательно: настоящее начало участка - конец
+ * последнего символа предыдущего. Если оно совпало с одной из запомненных
+ * границ - результат участка верен начиная с нее, иначе участок заново
+ * декодируется с настоящего начала до первого совпадения.
+ * Так распаковываются и файлы, сжатые предыдущими версиями программы.
+ *
+ * Испорченные данные распаковываются с ошибкой (пустой результат), а не в
+ * мусор: таблица кодов должна помещаться в данные, размер данных - точно
+ * соответствовать количеству значимых бит, в потоке не должно быть
+ * несуществующих кодов, а последний символ - заканчиваться ровно на последнем
+ * значимом бите.
+ *
+ * Сжатие выполняется параллельно, но результатом остается один поток бит:
+ * - данные делятся на участки по числу потоков \ref ThreadPool;
+ * - для каждого участка параллельно считается своя гистограмма частот, затем
+ * гистограммы складываются и по сумме строится одна общая таблица кодов;
+ * - точная длина участка в битах вычисляется по его гистограмме и длинам
+ * кодов, без повторного прохода по данным. Префиксная сумма длин дает
+ * каждому участку бит, с которого начинаются его коды;
+ * - участки параллельно записывают коды сразу в общий выходной буфер. Байт,
+ * на который приходится граница двух участков, каждый из них возвращает
+ * отдельно, и после завершения всех потоков такие байты объединяются.
+ * Результат побитно совпадает с последовательным кодированием.
+ *
+ * Вся рабочая память - участки, гистограммы, узлы дерева, таблица кодов,
+ * дерево декодирования и буферы декодированных участков - хранится в
+ * контексте \ref cAlgorithmHaffman::sContext и переиспользуется. Служебные
+ * данные и таблица пишутся сразу на свои места в результате, размер
+ * которого вычисляется заранее. Буферы участков, выросшие больше
+ * MAX_RETAINED_CHUNK_SIZE, после вызова освобождаются, чтобы контексты
+ * потоков не удерживали память крупных блоков.
  *
  * С учетом того, что алгоритм добавляет 8 + 4 + X байт информации в результат
  * сжатия (8 - Количество бит, 4 - размер таблицы, X - таблица) большого смысла
@@ -65,28 +101,70 @@
 
 #include "algorithm/cAbstractAlgorithm/h/cAbstractAlgorithm.h" /// Абстрактный
                                                                /// класс для алгоритмов
-#include <map> /// Отображение
+#include <array> /// Массивы фиксированного размера
+#include <tuple> /// Кортежи
+#include <vector> /// Вектор
 
 /// \brief Класс реализующий алгоритм Хаффмана
 /// \class cAlgorithmHaffman
 class cAlgorithmHaffman final : public cAbstractAlgorithm
 {
 public:
+    /// \brief Тип алгоритма
+    constexpr static eTypeOfComprAlgorithm TYPE = ALG_TYPE_HFMN;
+    /// \brief Имя алгоритма в командной строке, замерах и статистике
+    constexpr static std::string_view NAME = "Haffman";
+    /// \brief Постфикс сжатого файла
+    constexpr static std::string_view POSTFIX = ".cmprHaffman";
+
+    using cAbstractAlgorithm::compress;
+    using cAbstractAlgorithm::decompress;
+
+    /// \brief Создать контекст алгоритма
+    /// \return Контекст \ref sContext
+    virtual std::unique_ptr< cContext > createContext( void ) const override;
+
     /// \brief Сжатие данных
     /// \param [in] oldData Исходные данные для сжатия
-    /// \return Сжатые в соответсвии с кодированием Хаффмана
-    virtual std::string compress( const std::string & oldData ) override;
+    /// \param [in] context Контекст алгоритма
+    /// \param [out] result Сжатые в соответсвии с кодированием Хаффмана
+    /// данные
+    virtual void compress( std::string_view oldData, cContext &context, std::string &result ) const override;
 
     /// \brief Распаковка данных
     /// \param [in] oldData Исходные данные для распаковки
-    /// \return Распакованные данные в кодированием Хаффмана
-    virtual std::string decompress( const std::string & oldData ) override;
+    /// \param [in] context Контекст алгоритма
+    /// \param [out] result Распакованные данные в кодированием Хаффмана.
+    /// Пустая строка - данные испорчены
+    virtual void decompress( std::string_view oldData, cContext &context, std::string &result ) const override;
 
     /// \brief Получить постфикс
     /// \return Строка-расширение для упакованных данных
-    inline virtual std::string getPostfix( void ) const override { return ".cmprHaffman"; }
+    inline virtual std::string getPostfix( void ) const override { return std::string( POSTFIX ); }
+
+    /// \brief Получить тип алгоритма
+    /// \return TYPE
+    inline virtual eTypeOfComprAlgorithm getType( void ) const override { return TYPE; }
+
+    /// \brief Получить оценку памяти для блока
+    /// \details Код Хаффмана не длиннее 8 бит на символ в среднем, поэтому
+    /// сжатые данные не больше исходных и кодовой таблицы. При распаковке
+    /// участки декодируются в свои буферы и сшиваются в результат
+    /// \param [in] rawSize Размер исходного блока
+    /// \param [in] action Сжатие или распаковка
+    /// \return Количество байт
+    inline virtual uint64_t getMemoryBound( uint64_t rawSize, eTypeOfActions action ) const override
+    {
+        return ( ACT_TYPE_COMPR == action ? rawSize : 3 * rawSize ) + TABLES_MEMORY_BOUND;
+    }
 
 private:
+    /// \brief Микрозамеры отдельных частей алгоритма (\ref MicroBench)
+    friend class cKernelBench;
+
+    /// \brief Номер отсутствующего узла
+    constexpr static int32_t NO_NODE = -1;
+
     /// \brief Структура, описывающая узел дерева Хаффмана
     /// \struct sNode
     struct sNode
@@ -95,34 +173,142 @@ private:
         /// \brief Конструктор
         /// \param [in] sym Символ
         /// \param [in] freq Частота символа в исходном тексте
-        /// \param [in] left Левый лист
-        /// \param [in] right Правый лист
+        /// \param [in] left Номер левого потомка
+        /// \param [in] right Номер правого потомка
         sNode( char sym,
                size_t freq,
-               sNode *left = nullptr,
-               sNode *right = nullptr ) :
+               int32_t left = NO_NODE,
+               int32_t right = NO_NODE ) :
             mSym( sym ),
             mFreq( freq ),
-            mpLeft( left ),
-            mpRight( right ) {}
+            mLeft( left ),
+            mRight( right ) {}
 
         /// \brief Символ
         char mSym = '0';
         /// \brief Частота символа в исходном тексте
         size_t mFreq = 0;
-        /// \brief Левый лист
-        sNode *mpLeft = nullptr;
-        /// \brief Правый лист
-        sNode *mpRight = nullptr;
+        /// \brief Номер левого потомка в массиве узлов
+        int32_t mLeft = NO_NODE;
+        /// \brief Номер правого потомка в массиве узлов
+        int32_t mRight = NO_NODE;
+    };
+
+    /// \brief Псевдоним для гистограммы частот символов
+    /// \typedef freqTable_t
+    using freqTable_t = std::array< uint64_t, 256 >;
+
+    /// \brief Структура, описывающая код символа для быстрой записи
+    /// \struct sCode
+    struct sCode
+    {
+        /// \brief Биты кода, выровненные по младшему биту
+        uint64_t mBits = 0;
+        /// \brief Длина кода в битах
+        size_t mLength = 0;
+        /// \brief Код в виде строки из 0 и 1, если он длиннее MAX_FAST_CODE_LENGTH
+        std::string mLongCode;
+    };
+
+    /// \brief Псевдоним для таблицы кодов по значению символа
+    /// \typedef codeTable_t
+    using codeTable_t = std::array< sCode, 256 >;
+
+    /// \brief Структура, описывающая граничные байты участка
+    ///
+    /// \details Байт, в котором участок начинается не с нулевого бита, и байт,
+    /// в котором он заканчивается не на последнем бите, делятся с соседними
+    /// участками. Участок не пишет их в общий буфер сам, а возвращает
+    /// \struct sChunkBoundary
+    struct sChunkBoundary
+    {
+        /// \brief Первый байт участка, если он общий с предыдущим
+        uint8_t mFirstByte = 0;
+        /// \brief Признак наличия mFirstByte
+        bool mHasFirstByte = false;
+        /// \brief Последний байт участка, если он общий со следующим
+        uint8_t mLastByte = 0;
+        /// \brief Признак наличия mLastByte
+        bool mHasLastByte = false;
+    };
+
+    /// \brief Структура, описывающая узел дерева для декодирования
+    /// \struct sDecodeNode
+    struct sDecodeNode
+    {
+        /// \brief Номера потомков по значению бита, -1 - нет потомка
+        int32_t mChild[ 2 ] = { -1, -1 };
+        /// \brief Символ листа
+        char mSym = '\0';
+        /// \brief Признак листа
+        bool mIsLeaf = false;
+    };
+
+    /// \brief Псевдоним для дерева декодирования, корень - нулевой элемент
+    /// \typedef decodeTree_t
+    using decodeTree_t = std::vector< sDecodeNode >;
+
+    /// \brief Структура, описывающая результат декодирования участка
+    /// \struct sDecodedChunk
+    struct sDecodedChunk
+    {
+        /// \brief Декодированные символы
+        std::string mOutput;
+        /// \brief Номер бита после каждого из первых декодированных символов
+        std::vector< uint64_t > mSyncBits;
+        /// \brief Номер бита после последнего декодированного символа
+        uint64_t mEndBit = 0;
+        /// \brief false - встречен код, отсутствующий в таблице
+        bool mIsValid = true;
     };
 
-    /// \brief Псевдоним для отображения символа на код
-    /// \typedef mapSym2VtorBit_t
-    using mapSym2VtorBit_t = std::map< char, std::string >;
+    /// \brief Структура, описывающая контекст алгоритма - рабочую память
+    /// сжатия и распаковки, переиспользуемую между вызовами
+    /// \struct sContext
+    struct sContext final : public cContext
+    {
+        /// \brief Участки исходных данных
+        std::vector< std::string_view > mChunks;
+        /// \brief Гистограммы участков
+        std::vector< freqTable_t > mChunkFreqs;
+        /// \brief Бит начала каждого участка и бит конца последнего
+        std::vector< uint64_t > mChunkStartBit;
+        /// \brief Граничные байты участков
+        std::vector< sChunkBoundary > mBoundaries;
+        /// \brief Узлы дерева Хаффмана
+        std::vector< sNode > mNodes;
+        /// \brief Очередь с приоритетом - куча из номеров узлов
+        std::vector< int32_t > mHeap;
+        /// \brief Код узла при обходе дерева
+        std::string mCodePath;
+        /// \brief Таблица кодов
+        codeTable_t mCodes;
+        /// \brief Дерево декодирования
+        decodeTree_t mDecodeTree;
+        /// \brief Результаты декодирования участков
+        std::vector< sDecodedChunk > mDecodedChunks;
+    };
 
     /// \brief Количество бит в символе
     constexpr static size_t BIT_2_SYM = 8;
 
+    /// \brief Количество запоминаемых границ символов в начале участка при
+    /// параллельном декодировании
+    constexpr static size_t SYNC_WINDOW_SYMBOLS = 4096;
+
+    /// \brief Максимальная длина кода, записываемого за одну операцию
+    constexpr static size_t MAX_FAST_CODE_LENGTH = 56;
+
+    /// \brief Минимальный размер участка для параллельного кодирования
+    constexpr static size_t MIN_PARALLEL_CHUNK_SIZE = 256 * 1024;
+
+    /// \brief Оценка памяти под таблицы частот, дерево и кодовую таблицу
+    constexpr static uint64_t TABLES_MEMORY_BOUND = 256 * 1024;
+
+    /// \brief Наибольший буфер декодированного участка, сохраняемый в
+    /// контексте после вызова
+    constexpr static size_t MAX_RETAINED_CHUNK_SIZE = 1024 * 1024;
+
     /// \brief Количество байт в коде, занимаемых размером кодовой таблицы
     constexpr static size_t SHIFT_TABLE_SIZE = 4;
     /// \brief Количество байт в коде, занимаемых количеством значимых бит
@@ -135,70 +321,145 @@ private:
     /// \brief Сдвиг в строке кодовой таблицы для получения кода Хаффмана символа
     constexpr static size_t SHIFT_IN_TABLE_CODE = 2;
 
-    /// \brief Создать дерево
-    /// \warning Данные выделяются в куче! Для освобождения - deleteTree
+    /// \brief Подсчет частот появления символов
     /// \param [in] data Исходные данные
-    /// \return Корень дерева
-    sNode* buildTree(const std::string_view oldData );
+    /// \return Гистограмма частот
+    freqTable_t countFrequencies( const std::string_view data ) const;
+
+    /// \brief Создать дерево в массиве узлов контекста
+    /// \param [in] freq Гистограмма частот символов
+    /// \param [in,out] context Контекст: узлы и очередь
+    /// \return Номер корня дерева
+    int32_t buildTree( const freqTable_t &freq, sContext &context ) const;
+
+    /// \brief Заполнение таблицы кодов контекста по дереву Хаффмана
+    /// \param [in] root Номер корня дерева Хаффмана
+    /// \param [in,out] context Контекст: узлы дерева и таблица кодов
+    void encodeTree( int32_t root, sContext &context ) const;
 
-    /// \brief Получение отображения символов на их код Хаффмана
+    /// \brief Рекурсивное заполнение таблицы кодов
     ///
     /// \details Для каждого листа дерева, корнем которого является
-    /// root создаст запись символ-код. Каждая левая ветвь = code + 0,
+    /// node, записывает код символа. Каждая левая ветвь = code + 0,
     /// каждая правая = code + 1
     ///
-    /// \param [in] root Корень дерева Хаффмана
-    /// \param [in] code Код символа, если тот является листом
+    /// \param [in] nodes Узлы дерева
+    /// \param [in] node Номер узла дерева Хаффмана
+    /// \param [in,out] code Код узла. Восстанавливается после обхода
+    /// \param [out] codes Заполняемая таблица кодов
+    void encodeNode( const std::vector< sNode > &nodes,
+                     int32_t node,
+                     std::string &code,
+                     codeTable_t &codes ) const;
+
+    /// \brief Записать код символа в таблицу кодов
+    /// \param [in] code Код символа из 0 и 1
+    /// \param [out] symCode Код символа для быстрой записи
+    void setCode( std::string_view code, sCode &symCode ) const;
+
+    /// \brief Получить бит кода символа
+    /// \param [in] code Код символа
+    /// \param [in] index Номер бита от начала кода
+    /// \return Значение бита
+    static inline bool getCodeBit( const sCode &code, size_t index ) noexcept
+    {
+        return code.mLength > MAX_FAST_CODE_LENGTH ? '1' == code.mLongCode[ index ]
+                                                   : ( code.mBits >> ( code.mLength - 1 - index ) ) & 1;
+    }
+
+    /// \brief Разделить данные на участки для параллельной обработки
+    /// \param [in] data Исходные данные
+    /// \param [out] chunks Участки данных
+    void splitToChunks( const std::string_view data, std::vector< std::string_view > &chunks ) const;
+
+    /// \brief Записать коды участка в общий выходной буфер
     ///
-    /// \return Отображение символов дерева на их код
-    mapSym2VtorBit_t encodeTree(sNode* root, const std::string &code = std::string() );
+    /// \param [in] chunk Участок исходных данных
+    /// \param [in] codes Таблица кодов
+    /// \param [in] startBit Номер бита, с которого начинается участок
+    /// \param [out] pOut Начало общего буфера для данных
+    ///
+    /// \return Граничные байты участка, не записанные в буфер
+    sChunkBoundary emitChunk( const std::string_view chunk,
+                              const codeTable_t &codes,
+                              uint64_t startBit,
+                              uint8_t *pOut ) const;
 
-    /// \brief Создать таблицу кодов для добавления к сжатому файлу
-    /// \param [in] sym2map Отображение символов на код
-    /// \return Таблица для записи к сжатым данным
-    std::string encodeMap( const mapSym2VtorBit_t &sym2map );
+    /// \brief Получить размер кодовой таблицы для добавления к сжатому файлу
+    /// \param [in] codes Таблица кодов
+    /// \return Размер в байтах
+    size_t getCodeTableSize( const codeTable_t &codes ) const;
+
+    /// \brief Записать кодовую таблицу для добавления к сжатому файлу
+    ///
+    /// \details Строки идут в порядке значений char: так таблицу писали
+    /// предыдущие версии, и сжатые данные побайтно совпадают с ними
+    ///
+    /// \param [in] codes Таблица кодов
+    /// \param [out] pOut Место для записи. Заполнено нулями, размер -
+    /// \ref getCodeTableSize
+    void writeCodeTable( const codeTable_t &codes, char *pOut ) const;
 
     /// \brief Чтение кодовой таблицы из сжатых данных
     /// \param [in] code Сжатые данные
-    /// \return Кортеж из отображения символа на код и размера таблицы
-    std::tuple< mapSym2VtorBit_t, size_t > readCodeTableFromCmprData(const std::string_view code );
+    /// \param [out] codes Таблица кодов. Повторная строка символа заменяет
+    /// предыдущую
+    /// \return Кортеж из размера таблицы и признака корректности: false -
+    /// таблица выходит за данные или ее строки - за таблицу
+    std::tuple< size_t, bool > readCodeTable( const std::string_view code, codeTable_t &codes ) const;
 
     /// \brief Заполнить выходной контейнер для декомпрессии
     ///
     /// \param [in] oldData Сжатые данные
     /// \param [in] servDataShift Сдвиг до данных (минуя сервисные байты)
-    /// \param [in] sym2code Отображение символа на код Хаффмана
+    /// \param [in,out] context Контекст: таблица кодов, дерево и участки
     /// \param [in] significantBitCount Количество значимых бит в данных
+    /// \param [out] result Контейнер для разжатых данных. Пустой, если данные
+    /// испорчены
+    void fillDecomrData( const std::string_view oldData,
+                         size_t servDataShift,
+                         sContext &context,
+                         uint64_t significantBitCount,
+                         std::string &result ) const;
+
+    /// \brief Построить дерево декодирования по таблице кодов
+    /// \param [in] codes Таблица кодов
+    /// \param [out] tree Дерево декодирования
+    void buildDecodeTree( const codeTable_t &codes, decodeTree_t &tree ) const;
+
+    /// \brief Декодировать символы потока бит
     ///
-    /// \return Контейнер для разжатых данных
-    std::string fillDecomrData( const std::string_view oldData,
-                                size_t servDataShift,
-                                const mapSym2VtorBit_t &sym2code,
-                                uint64_t significantBitCount );
-
-    /// \brief Очистить динамически выделенную память под дерево
-    /// \param [in] root Корень дерева
-    void deleteTree( sNode *root ) const;
-
-    /// \brief Уплотнение коллекции символов
-    /// \param [in] collection Коллекция для уплотнения
-    /// \return Уплотненные данные \todo rename
-    std::string sealCollection(const std::string_view collection) const;
-
-    /// \brief Запись в place2Write коллекции clctn размера size побайтно
+    /// \details Декодирование начинается с бита startBit и идет до конца
+    /// символа, пересекающего stopBit, или до конца потока. Если syncLimit не 0,
+    /// запоминаются границы первых syncLimit символов
     ///
-    /// \param [in] clctn Коллекция
-    /// \param [in] place2Write Место для записи
+    /// \param [in] pData Начало потока бит
+    /// \param [in] tree Дерево декодирования
+    /// \param [in] startBit Бит начала декодирования
+    /// \param [in] stopBit Бит, после которого декодирование завершается на
+    /// ближайшей границе символа
+    /// \param [in] totalBitCount Количество значимых бит в потоке
+    /// \param [in] syncLimit Количество запоминаемых границ символов
+    /// \param [out] chunk Результат декодирования. Буферы переиспользуются
+    void decodeRange( const uint8_t *pData,
+                      const decodeTree_t &tree,
+                      uint64_t startBit,
+                      uint64_t stopBit,
+                      uint64_t totalBitCount,
+                      size_t syncLimit,
+                      sDecodedChunk &chunk ) const;
+
+    /// \brief Запись размера size побайтно, начиная со старшего байта
+    ///
+    /// \param [out] pOut Место для записи
     /// \param [in] size Размер для записи
     template< typename T >
-    inline void writeSize2StartOfClctn( std::string &clctn,
-                                        size_t index,
-                                        T size ) const
+    inline void writeSize( char *pOut, T size ) const
     {
         constexpr size_t BYTE_IN_SIZE_WD( sizeof( T ) );
         for( size_t bt = 0; bt < BYTE_IN_SIZE_WD; ++bt )
-            clctn.insert( index, 1,
-                        ( size & ( 0xFF << ( BIT_2_SYM * bt ) ) ) >> ( BIT_2_SYM * bt ) );
+            pOut[ BYTE_IN_SIZE_WD - 1 - bt ] =
+                    static_cast< char >( ( uint64_t( size ) >> ( BIT_2_SYM * bt ) ) & 0xFF );
     }
 
     /// \brief Чтение первых sizeof(T) байт коллекции clctn со сдвигом shiftFromStart
@@ -217,7 +478,7 @@ private:
              bt < BYTE_IN_SIZE_WD;
              ++bt, --shift )
         {
-            result |= ( uint8_t( clctn[ bt + shiftFromStart ] ) << ( shift * BIT_2_SYM ) );
+            result |= ( T( uint8_t( clctn[ bt + shiftFromStart ] ) ) << ( shift * BIT_2_SYM ) );
         }
 
         return result;
@@ -5,174 +5,418 @@
  * ****************************************************************************/
 
 #include "algorithm/cAlgorithmHaffman/h/cAlgorithmHaffman.h" /// Заголовок модуля
-#include <queue> /// Очереди
-#include <map> /// Отображение
+#include "threadPool/h/cThreadPool.h" /// Пул потоков
+#include "stats/cJobStats/h/cJobStats.h" /// Статистика задания
+#include <algorithm> /// std::min, std::max, std::push_heap, std::pop_heap
+#include <limits> /// Пределы значений типов
 
 /** ****************************************************************************
  * Определения публичной части класса
  * ****************************************************************************/
 
-std::string cAlgorithmHaffman::compress( const std::string & oldData)
+std::unique_ptr< cAbstractAlgorithm::cContext > cAlgorithmHaffman::createContext( void ) const
 {
-    /// Создание дерева Хаффмана
-    sNode *root = buildTree( std::move( oldData ) );
-    /// Создание отображения символ - код
-    mapSym2VtorBit_t sym2code = encodeTree( root );
-    /// Очистка кучи
-    deleteTree( root );
+    return std::make_unique< sContext >();
+}
+
+
+void cAlgorithmHaffman::compress( std::string_view oldData, cContext &context, std::string &result ) const
+{
+    result.clear();
+    if( oldData.empty() )
+        return;
 
-    /// Результат сжатия
-    std::string result;
+    sContext &ctx = static_cast< sContext & >( context );
+    cThreadPool &pool = cThreadPool::instance();
+    cJobStats::cTimer timer( cJobStats::STAGE_HISTOGRAM, oldData.size() );
 
-    /// Кодовая таблица
-    const std::string codeTable( encodeMap( sym2code ) );
-        result += codeTable;
+    /// Участки для параллельной обработки
+    const std::vector< std::string_view > &chunks = ctx.mChunks;
+    splitToChunks( oldData, ctx.mChunks );
 
-    /// Код Хаффмана исходных данных каждый элемент bufferHfmn 0 или 1
-    std::string bufferHfmn;
-    for( const auto &sym : oldData )
-        bufferHfmn += sym2code[ sym ];
+    /// Локальные гистограммы участков
+    std::vector< freqTable_t > &chunkFreqs = ctx.mChunkFreqs;
+    chunkFreqs.resize( chunks.size() );
+    pool.parallelFor( chunks.size(), [ & ]( size_t i )
+    {
+        chunkFreqs[ i ] = countFrequencies( chunks[ i ] );
+    } );
+
+    /// Общая гистограмма
+    freqTable_t freq{};
+    for( size_t i = 0; i < chunks.size(); ++i )
+        for( size_t sym = 0; sym < freq.size(); ++sym )
+            freq[ sym ] += chunkFreqs[ i ][ sym ];
+
+    /// Создание дерева Хаффмана и таблицы кодов
+    timer.next( cJobStats::STAGE_TREE );
+    encodeTree( buildTree( freq, ctx ), ctx );
+    const codeTable_t &codes = ctx.mCodes;
+
+    /// Точная длина каждого участка в битах и префиксная сумма - бит, с
+    /// которого начинается каждый участок
+    std::vector< uint64_t > &chunkStartBit = ctx.mChunkStartBit;
+    chunkStartBit.assign( chunks.size() + 1, 0 );
+    for( size_t i = 0; i < chunks.size(); ++i )
+    {
+        uint64_t chunkBitCount = 0;
+        for( size_t sym = 0; sym < codes.size(); ++sym )
+            chunkBitCount += chunkFreqs[ i ][ sym ] * codes[ sym ].mLength;
+
+        chunkStartBit[ i + 1 ] = chunkStartBit[ i ] + chunkBitCount;
+    }
 
     /// Результирующее количество бит для записи кода
-    const uint64_t totalDataBitCount = bufferHfmn.size();
+    const uint64_t totalDataBitCount = chunkStartBit.back();
+    const size_t tableSize = getCodeTableSize( codes );
 
-    /// Уплотнение и запись данных
-    result += ( sealCollection( bufferHfmn ) );
+    /// Результат выделяется сразу целиком: количество бит данных, размер
+    /// таблицы, таблица и данные
+    timer.next( cJobStats::STAGE_ENCODE, oldData.size() );
+    const size_t dataShift = SHIFT_BITS_COUNT + SHIFT_TABLE_SIZE + tableSize;
+    result.resize( dataShift + ( totalDataBitCount + BIT_2_SYM - 1 ) / BIT_2_SYM, '\0' );
 
-    /// Запись количества бит даннх в сжатый файл.
-    writeSize2StartOfClctn( result, 0, totalDataBitCount );
+    writeSize( result.data(), totalDataBitCount );
+    writeSize( result.data() + SHIFT_BITS_COUNT, uint32_t( tableSize ) );
+    writeCodeTable( codes, result.data() + SHIFT_BITS_COUNT + SHIFT_TABLE_SIZE );
 
-    return result;
+    uint8_t *pData = reinterpret_cast< uint8_t * >( result.data() + dataShift );
+
+    /// Параллельная запись кодов участков
+    std::vector< sChunkBoundary > &boundaries = ctx.mBoundaries;
+    boundaries.resize( chunks.size() );
+    pool.parallelFor( chunks.size(), [ & ]( size_t i )
+    {
+        boundaries[ i ] = emitChunk( chunks[ i ], codes, chunkStartBit[ i ], pData );
+    } );
+
+    /// Сшивка байт на границах участков
+    for( size_t i = 0; i < chunks.size(); ++i )
+    {
+        if( boundaries[ i ].mHasFirstByte )
+            pData[ chunkStartBit[ i ] / BIT_2_SYM ] |= boundaries[ i ].mFirstByte;
+
+        if( boundaries[ i ].mHasLastByte )
+            pData[ chunkStartBit[ i + 1 ] / BIT_2_SYM ] |= boundaries[ i ].mLastByte;
+    }
 }
 
 
-std::string cAlgorithmHaffman::decompress( const std::string & oldData )
+void cAlgorithmHaffman::decompress( std::string_view oldData, cContext &context, std::string &result ) const
 {
-    /// Чтение таблицы символов и получение сдвига к данным
-   const std::tuple< mapSym2VtorBit_t, size_t > codeAndTblSize =
-            readCodeTableFromCmprData( oldData );
+    result.clear();
 
-    const size_t serviceShift =
-            std::get< 1 >( codeAndTblSize ) + SHIFT_TABLE_SIZE + SHIFT_BITS_COUNT;
+    /// Служебные данные должны помещаться целиком
+    if( oldData.size() < SHIFT_BITS_COUNT + SHIFT_TABLE_SIZE )
+        return;
 
-    const mapSym2VtorBit_t &sym2code = std::get< 0 >( codeAndTblSize );
+    sContext &ctx = static_cast< sContext & >( context );
+    const cJobStats::cTimer timer( cJobStats::STAGE_DECODE, oldData.size() );
+
+    /// Чтение таблицы символов и получение сдвига к данным
+    const auto [ tableSize, isTableValid ] = readCodeTable( oldData, ctx.mCodes );
+    if( !isTableValid )
+        return;
+
+    const size_t serviceShift = tableSize + SHIFT_TABLE_SIZE + SHIFT_BITS_COUNT;
 
     /// Получение количества значимых бит
     const uint64_t significantBitCount = readSizeFromStartOfClctn< uint64_t >( oldData );
 
     /// Заполнение данных
-    return fillDecomrData( oldData, serviceShift, sym2code, significantBitCount );
+    fillDecomrData( oldData, serviceShift, ctx, significantBitCount, result );
 }
 
 
-
 /** ****************************************************************************
  * Определения приватной части класса
  * ****************************************************************************/
 
-cAlgorithmHaffman::sNode *cAlgorithmHaffman::buildTree( const std::string_view data )
+cAlgorithmHaffman::freqTable_t cAlgorithmHaffman::countFrequencies( const std::string_view data ) const
 {
-    /// Подсчет частот появления символов в тексте
-    std::map< symbol_t, size_t > freq;
-    for( auto &&sym : data )
-        freq[ sym ]++;
+    /// Четыре независимые гистограммы, чтобы подряд идущие одинаковые символы
+    /// не ждали друг друга на инкременте одного и того же счетчика
+    std::array< freqTable_t, 4 > partial{};
+
+    size_t i = 0;
+    for( ; i + 4 <= data.size(); i += 4 )
+    {
+        partial[ 0 ][ symbol_t( data[ i ] ) ]++;
+        partial[ 1 ][ symbol_t( data[ i + 1 ] ) ]++;
+        partial[ 2 ][ symbol_t( data[ i + 2 ] ) ]++;
+        partial[ 3 ][ symbol_t( data[ i + 3 ] ) ]++;
+    }
+    for( ; i < data.size(); ++i )
+        partial[ 0 ][ symbol_t( data[ i ] ) ]++;
+
+    freqTable_t freq{};
+    for( size_t sym = 0; sym < freq.size(); ++sym )
+        freq[ sym ] = partial[ 0 ][ sym ] + partial[ 1 ][ sym ] +
+                      partial[ 2 ][ sym ] + partial[ 3 ][ sym ];
+
+    return freq;
+}
+
+
+int32_t cAlgorithmHaffman::buildTree( const freqTable_t &freq, sContext &context ) const
+{
+    std::vector< sNode > &nodes = context.mNodes;
+    nodes.clear();
 
     /// Функция для сравнения частот узлов для очереди с приоритетом
-    auto comparer = []( sNode* l, sNode* r ){ return l->mFreq > r->mFreq; };
+    auto comparer = [ &nodes ]( int32_t l, int32_t r ){ return nodes[ l ].mFreq > nodes[ r ].mFreq; };
+
+    /// Очередь с приоритетом для заполнения дерева. Операции кучи те же, что
+    /// у std::priority_queue, поэтому и дерево получается тем же
+    std::vector< int32_t > &pq = context.mHeap;
+    pq.clear();
+
+    auto push = [ & ]( char sym, size_t nodeFreq, int32_t left, int32_t right )
+    {
+        nodes.emplace_back( sym, nodeFreq, left, right );
+        pq.push_back( static_cast< int32_t >( nodes.size() - 1 ) );
+        std::push_heap( pq.begin(), pq.end(), comparer );
+    };
 
-    /// Создаем очередь с приоритетом для заполнения дерева
-    std::priority_queue< sNode *,
-                         std::deque< sNode* >,
-                         decltype( comparer ) > pq( comparer );
+    auto pop = [ & ]( void )
+    {
+        std::pop_heap( pq.begin(), pq.end(), comparer );
+        const int32_t node = pq.back();
+        pq.pop_back();
+
+        return node;
+    };
 
     /// Созддание узлов
-    for( const auto &pair : freq )
-        pq.push( new sNode( pair.first, pair.second ) );
+    for( size_t sym = 0; sym < freq.size(); ++sym )
+        if( freq[ sym ] )
+            push( static_cast< char >( sym ), freq[ sym ], NO_NODE, NO_NODE );
 
     /// Пока в очереди более 1 элемента
     while( pq.size() > 1 )
     {
         /// Получение 2х узлов с наивысшим приоритетом
-        auto left = pq.top(); pq.pop();
-        auto right = pq.top(); pq.pop();
+        const int32_t left = pop();
+        const int32_t right = pop();
 
         /// Создание нового узла, частота которого равна сумме частот двух
         /// листьев
-        const size_t sumFreq = left->mFreq + right->mFreq;
-        pq.push( new sNode( '\0', sumFreq, left, right ) );
+        push( '\0', nodes[ left ].mFreq + nodes[ right ].mFreq, left, right );
+    }
+
+    /// Единственный символ в данных: корень - лист с пустым кодом, что не
+    /// дает ни одного бита данных. Добавляется корень, чтобы код был "0"
+    const int32_t top = pq.front();
+    if( NO_NODE == nodes[ top ].mLeft && NO_NODE == nodes[ top ].mRight )
+    {
+        pop();
+        push( '\0', nodes[ top ].mFreq, top, NO_NODE );
     }
 
     /// Корень дерева
-    return pq.top();
+    return pq.front();
 }
 
 
-cAlgorithmHaffman::mapSym2VtorBit_t cAlgorithmHaffman::encodeTree( sNode *root, const std::string &code )
+void cAlgorithmHaffman::encodeTree( int32_t root, sContext &context ) const
 {
-    if( !root )
-        return mapSym2VtorBit_t();
+    /// Символы, которых нет в дереве, не имеют кода
+    for( sCode &code : context.mCodes )
+    {
+        code.mBits = 0;
+        code.mLength = 0;
+        code.mLongCode.clear();
+    }
+
+    context.mCodePath.clear();
+    encodeNode( context.mNodes, root, context.mCodePath, context.mCodes );
+}
 
-    /// Отображение
-    static mapSym2VtorBit_t sym2HfmnCode;
 
-    /// Очистка отображения, если метод был вызван не рекурсивно, значит это
-    /// первый вызов и нужно новое отображение
-    if( code.empty() )
-        sym2HfmnCode.clear();
+void cAlgorithmHaffman::encodeNode( const std::vector< sNode > &nodes,
+                                    int32_t node,
+                                    std::string &code,
+                                    codeTable_t &codes ) const
+{
+    if( NO_NODE == node )
+        return;
 
     /// Поиск листьев
-    if ( !root->mpLeft && !root->mpRight )
+    const sNode &current = nodes[ node ];
+    if( NO_NODE == current.mLeft && NO_NODE == current.mRight )
     {
-        sym2HfmnCode[ root->mSym ] = code;
+        setCode( code, codes[ symbol_t( current.mSym ) ] );
+        return;
     }
 
     /// Дозапись кода
-    std::string leftCode = code.data();
-    leftCode += '0';
+    code += '0';
+    encodeNode( nodes, current.mLeft, code, codes );
 
-    std::string rigthCode = code.data();
-    rigthCode += '1';
+    code.back() = '1';
+    encodeNode( nodes, current.mRight, code, codes );
 
-    encodeTree( root->mpLeft, leftCode );
-    encodeTree( root->mpRight, rigthCode );
+    code.pop_back();
+}
 
-    return sym2HfmnCode;
+
+void cAlgorithmHaffman::setCode( std::string_view code, sCode &symCode ) const
+{
+    symCode.mBits = 0;
+    symCode.mLength = code.size();
+
+    if( symCode.mLength > MAX_FAST_CODE_LENGTH )
+    {
+        symCode.mLongCode.assign( code.data(), code.size() );
+        return;
+    }
+
+    symCode.mLongCode.clear();
+    for( const char bit : code )
+        symCode.mBits = ( symCode.mBits << 1 ) | ( '1' == bit );
 }
 
 
-std::string cAlgorithmHaffman::encodeMap( const mapSym2VtorBit_t &sym2map )
+void cAlgorithmHaffman::splitToChunks( const std::string_view data, std::vector< std::string_view > &chunks ) const
 {
-    /// Для результирующей таблицы
-    std::string result;
+    const size_t chunkCount =
+            std::max< size_t >( 1, std::min( cThreadPool::instance().getThreadCount(),
+                                              data.size() / MIN_PARALLEL_CHUNK_SIZE ) );
+    const size_t chunkSize = ( data.size() + chunkCount - 1 ) / chunkCount;
+
+    chunks.clear();
+    for( size_t shift = 0; shift < data.size(); shift += chunkSize )
+        chunks.push_back( data.substr( shift, chunkSize ) );
+}
+
+
+cAlgorithmHaffman::sChunkBoundary cAlgorithmHaffman::emitChunk( const std::string_view chunk,
+                                                                const codeTable_t &codes,
+                                                                uint64_t startBit,
+                                                                uint8_t *pOut ) const
+{
+    sChunkBoundary boundary;
+
+    /// Текущий байт для записи
+    uint8_t *pByte = pOut + startBit / BIT_2_SYM;
+
+    /// Накопитель бит. Начальные нули соответствуют битам предыдущего
+    /// участка в общем байте
+    uint64_t acc = 0;
+    size_t accBitCount = startBit % BIT_2_SYM;
+    bool isFirstByteShared = 0 != accBitCount;
 
-    for( const auto &symAndCode : sym2map )
+    /// Выгрузка заполненных байт из накопителя
+    auto flush = [ & ]( void )
     {
-        /// Размер кода в битах
-        result += static_cast< char >( symAndCode.second.size() );
-        /// Символ
-        result += symAndCode.first;
+        while( accBitCount >= BIT_2_SYM )
+        {
+            accBitCount -= BIT_2_SYM;
+            const uint8_t byte = static_cast< uint8_t >( acc >> accBitCount );
+
+            if( isFirstByteShared )
+            {
+                boundary.mFirstByte = byte;
+                boundary.mHasFirstByte = true;
+                isFirstByteShared = false;
+                ++pByte;
+            }
+            else
+            {
+                *pByte++ = byte;
+            }
+        }
+    };
+
+    for( const char sym : chunk )
+    {
+        const sCode &code = codes[ symbol_t( sym ) ];
+        if( code.mLength <= MAX_FAST_CODE_LENGTH )
+        {
+            acc = ( acc << code.mLength ) | code.mBits;
+            accBitCount += code.mLength;
+            flush();
+        }
+        else
+        {
+            for( const char bit : code.mLongCode )
+            {
+                acc = ( acc << 1 ) | ( '1' == bit );
+                ++accBitCount;
+                flush();
+            }
+        }
+    }
 
-        /// Код Хаффмана символа
-        result += sealCollection( symAndCode.second );
+    /// Незаполненный последний байт
+    if( accBitCount )
+    {
+        boundary.mLastByte = static_cast< uint8_t >( acc << ( BIT_2_SYM - accBitCount ) );
+        boundary.mHasLastByte = true;
     }
 
-    /// Запись размера таблицы в байтах
-    const uint32_t mapSize( result.size() );
-    writeSize2StartOfClctn( result, 0, mapSize );
+    return boundary;
+}
+
+
+size_t cAlgorithmHaffman::getCodeTableSize( const codeTable_t &codes ) const
+{
+    size_t tableSize = 0;
+    for( const sCode &code : codes )
+        if( code.mLength )
+            tableSize += SHIFT_IN_TABLE_CODE + ( code.mLength + BIT_2_SYM - 1 ) / BIT_2_SYM;
 
-    return result;
+    return tableSize;
 }
 
-std::tuple< cAlgorithmHaffman::mapSym2VtorBit_t,
-            size_t > cAlgorithmHaffman::readCodeTableFromCmprData( const std::string_view code )
+
+void cAlgorithmHaffman::writeCodeTable( const codeTable_t &codes, char *pOut ) const
 {
-    mapSym2VtorBit_t sym2code;
+    for( int sym = std::numeric_limits< char >::min(); sym <= std::numeric_limits< char >::max(); ++sym )
+    {
+        const sCode &code = codes[ symbol_t( sym ) ];
+        if( !code.mLength )
+            continue;
+
+        /// Размер кода в битах
+        pOut[ SHIFT_IN_TABLE_BIT_COUNT ] = static_cast< char >( code.mLength );
+        /// Символ
+        pOut[ SHIFT_IN_TABLE_SYM ] = static_cast< char >( sym );
+
+        /// Код Хаффмана символа, уплотненный в байты со старшего бита
+        uint8_t *pCode = reinterpret_cast< uint8_t * >( pOut + SHIFT_IN_TABLE_CODE );
+        for( size_t bit = 0; bit < code.mLength; ++bit )
+            if( getCodeBit( code, bit ) )
+                pCode[ bit / BIT_2_SYM ] |= uint8_t( 1 << ( BIT_2_SYM - 1 - bit % BIT_2_SYM ) );
+
+        pOut += SHIFT_IN_TABLE_CODE + ( code.mLength + BIT_2_SYM - 1 ) / BIT_2_SYM;
+    }
+}
+
+
+std::tuple< size_t, bool > cAlgorithmHaffman::readCodeTable( const std::string_view code, codeTable_t &codes ) const
+{
+    for( sCode &symCode : codes )
+    {
+        symCode.mBits = 0;
+        symCode.mLength = 0;
+        symCode.mLongCode.clear();
+    }
 
     /// Получение размера таблицы.
     uint32_t tableSize = readSizeFromStartOfClctn< uint32_t >( code, SHIFT_BITS_COUNT );
 
+    /// Конец таблицы в данных
+    const uint64_t tableEnd = uint64_t( SHIFT_TABLE_SIZE ) + SHIFT_BITS_COUNT + tableSize;
+    if( tableEnd > code.size() )
+        return std::make_tuple( tableSize, false );
+
     for( size_t row = 0; row < tableSize; )
     {
+        /// Размер и символ строки должны быть в таблице
+        if( SHIFT_IN_TABLE_CODE + SHIFT_TABLE_SIZE + SHIFT_BITS_COUNT + row > tableEnd )
+            return std::make_tuple( tableSize, false );
+
         /// Сдвиг для получения количество бит для текущего символа
         size_t shiftBitCount = SHIFT_IN_TABLE_BIT_COUNT + SHIFT_TABLE_SIZE + SHIFT_BITS_COUNT + row;
         /// Сдвиг для получения текущего символа
@@ -180,157 +424,263 @@ std::tuple< cAlgorithmHaffman::mapSym2VtorBit_t,
         /// Сдвиг для получения кода символа
         size_t shiftCode = SHIFT_IN_TABLE_CODE + SHIFT_TABLE_SIZE + SHIFT_BITS_COUNT + row;
 
-        std::string codeSym;
+        /// Длина кода в битах - беззнаковый байт
+        const uint8_t codeBitCount = static_cast< uint8_t >( code[ shiftBitCount ] );
+        /// Количество байт в коде символа, включая неполный
+        const size_t byteInCode = ( codeBitCount + BIT_2_SYM - 1 ) / BIT_2_SYM;
 
-        /// Количество целых байт в коде символа
-        size_t fullByteInCode = code[ shiftBitCount ] / BIT_2_SYM;
-        /// Количество используемых старших бит в крайнем незаполненном(если есть) байте
-        const size_t remaindBitInLastByteCode = code[ shiftBitCount ] % BIT_2_SYM;
+        /// Код строки тоже
+        if( shiftCode + byteInCode > tableEnd )
+            return std::make_tuple( tableSize, false );
 
-        for( size_t bt = 0, shift = BIT_2_SYM - 1;
-             bt < fullByteInCode * BIT_2_SYM;
-             ++bt, --shift )
-        {
-            codeSym += ( ( code[ shiftCode ] & ( 1 << shift ) ) ? '1' : '0' );
+        /// Повторная строка символа заменяет предыдущую
+        sCode &symCode = codes[ symbol_t( code[ shiftSym ] ) ];
+        symCode.mBits = 0;
+        symCode.mLength = codeBitCount;
+        symCode.mLongCode.clear();
 
-            if( 0 == shift )
-                shift = BIT_2_SYM;
-        }
-
-        for( size_t shift = BIT_2_SYM - 1;
-             shift > ( BIT_2_SYM - 1 - remaindBitInLastByteCode );
-             shift-- )
+        for( size_t bit = 0; bit < codeBitCount; ++bit )
         {
-            codeSym += ( code[ shiftCode + fullByteInCode ] & ( 1 << shift ) ? '1' : '0' );
+            const bool isSet = ( uint8_t( code[ shiftCode + bit / BIT_2_SYM ] ) >> ( BIT_2_SYM - 1 - bit % BIT_2_SYM ) ) & 1;
+            if( codeBitCount > MAX_FAST_CODE_LENGTH )
+                symCode.mLongCode += isSet ? '1' : '0';
+            else
+                symCode.mBits = ( symCode.mBits << 1 ) | isSet;
         }
 
-        sym2code[ code[ shiftSym ] ] = codeSym;
-
-        /// Размер + символ
-        row += 2;
-        /// Количество целых байт
-        row += fullByteInCode;
-        /// Неполноценный байт, если такой есть
-        if( remaindBitInLastByteCode )
-            row += 1;
+        /// Размер + символ + код
+        row += SHIFT_IN_TABLE_CODE + byteInCode;
     }
 
-    return std::make_tuple( sym2code, tableSize );
+    return std::make_tuple( tableSize, true );
 }
 
 
-std::string cAlgorithmHaffman::fillDecomrData(const std::string_view oldData,
-                                               size_t servDataShift,
-                                               const cAlgorithmHaffman::mapSym2VtorBit_t &sym2code,
-                                               uint64_t significantBitCount )
+void cAlgorithmHaffman::fillDecomrData( const std::string_view oldData,
+                                        size_t servDataShift,
+                                        sContext &context,
+                                        uint64_t significantBitCount,
+                                        std::string &result ) const
 {
-    /// Для хранения результата
-    std::string result;
-    //result.reserve( significantBitCount / BIT_2_SYM );
-
-    /// Отображение кода на символ. Было принято решение создать его, т.к.
-    /// создать и инициализировать такое в общем случае быстрее, чем каждый раз
-    /// проходить по всем значениям sym2code в поисках нужного
-    using mapVtorBit_t2sym = std::map< std::string, char >;
-    mapVtorBit_t2sym code2sym;
-    for( const auto &treeEl : sym2code  )
-        code2sym[ treeEl.second ] = treeEl.first;
-
-    /// Текущий счетчик бита
-    uint64_t bitCounter = 0;
-
-    std::string buff;
-    auto addBit = [ &buff, &significantBitCount, &bitCounter ]( char val )
+    result.clear();
+    if( servDataShift >= oldData.size() )
+        return;
+
+    /// Данные обрезаны или дописаны - количество байт должно точно
+    /// соответствовать количеству значимых бит
+    if( ( significantBitCount + BIT_2_SYM - 1 ) / BIT_2_SYM != oldData.size() - servDataShift )
+        return;
+
+    const decodeTree_t &tree = context.mDecodeTree;
+    buildDecodeTree( context.mCodes, context.mDecodeTree );
+    const uint8_t *pData = reinterpret_cast< const uint8_t * >( oldData.data() + servDataShift );
+    const uint64_t totalBitCount = significantBitCount;
+
+    /// Границы участков выбираются без учета границ символов
+    cThreadPool &pool = cThreadPool::instance();
+    const size_t chunkCount =
+            std::max< size_t >( 1, std::min< uint64_t >( pool.getThreadCount(),
+                                                         totalBitCount / ( MIN_PARALLEL_CHUNK_SIZE * BIT_2_SYM ) ) );
+
+    std::vector< uint64_t > &chunkStartBit = context.mChunkStartBit;
+    chunkStartBit.resize( chunkCount + 1 );
+    for( size_t i = 0; i <= chunkCount; ++i )
+        chunkStartBit[ i ] = totalBitCount * i / chunkCount;
+
+    /// Параллельное декодирование каждого участка с его первого бита.
+    /// Первый участок декодируется сразу в буфер результата
+    std::vector< sDecodedChunk > &chunks = context.mDecodedChunks;
+    chunks.resize( chunkCount );
+    chunks[ 0 ].mOutput.swap( result );
+    pool.parallelFor( chunkCount, [ & ]( size_t i )
     {
-        if( bitCounter < significantBitCount )
-        {
-            buff.push_back(val);
-            bitCounter++;
-        }
+        decodeRange( pData, tree, chunkStartBit[ i ], chunkStartBit[ i + 1 ],
+                     totalBitCount, 0 == i ? 0 : SYNC_WINDOW_SYMBOLS, chunks[ i ] );
+    } );
+    result.swap( chunks[ 0 ].mOutput );
 
+    /// Буферы участков крупных блоков не удерживаются контекстом
+    auto releaseLargeChunks = [ & ]( void )
+    {
+        for( size_t i = 1; i < chunkCount; ++i )
+            if( chunks[ i ].mOutput.capacity() > MAX_RETAINED_CHUNK_SIZE )
+                std::string().swap( chunks[ i ].mOutput );
     };
 
-    auto checkAndAdd = [ sym2code, &buff, &result, &code2sym ]()
+    /// Ошибка распаковки - пустой результат
+    auto fail = [ & ]( void )
     {
-        if( code2sym.end() != code2sym.find( buff ) )
-        {
-            result += code2sym[ buff ];
-            buff.clear();
-        }
+        result.clear();
+        releaseLargeChunks();
     };
 
+    /// Последовательная сшивка участков. Первый участок начат с настоящей
+    /// границы символа, поэтому несуществующий код в нем - порча данных
+    if( !chunks[ 0 ].mIsValid )
+    {
+        fail();
+        return;
+    }
+
+    uint64_t trueStartBit = chunks[ 0 ].mEndBit;
 
-    for( size_t it = servDataShift;
-         it < oldData.size();
-         it++ )
+    for( size_t i = 1; i < chunkCount; ++i )
     {
-        for( int shift = BIT_2_SYM - 1; shift >= 0; shift-- )
+        sDecodedChunk &chunk = chunks[ i ];
+
+        /// Предыдущий участок уже декодировал этот целиком
+        if( trueStartBit >= chunkStartBit[ i + 1 ] )
+            continue;
+
+        /// Настоящее начало совпало с началом участка
+        if( trueStartBit == chunkStartBit[ i ] && chunk.mIsValid )
         {
-            /// Добавление очередной 1 или 0
-            addBit( oldData[ it ] & ( 1 << shift ) ? '1' : '0' );
-            checkAndAdd();
+            result += chunk.mOutput;
+            trueStartBit = chunk.mEndBit;
+            continue;
         }
-        checkAndAdd();
-    }
 
-    return result;
-}
+        /// Поиск настоящего начала среди запомненных границ
+        size_t syncIndex = 0;
+        auto syncIt = std::lower_bound( chunk.mSyncBits.begin(), chunk.mSyncBits.end(), trueStartBit );
+        if( chunk.mIsValid && chunk.mSyncBits.end() != syncIt && trueStartBit == *syncIt )
+        {
+            syncIndex = syncIt - chunk.mSyncBits.begin() + 1;
+            result.append( chunk.mOutput, syncIndex, std::string::npos );
+            trueStartBit = chunk.mEndBit;
+            continue;
+        }
 
+        /// Повторное декодирование с настоящего начала до совпадения с одной
+        /// из запомненных границ
+        uint64_t bit = trueStartBit;
+        size_t node = 0;
+        bool isSynced = false;
+        while( bit < totalBitCount )
+        {
+            const int32_t child = tree[ node ].mChild[ ( pData[ bit / BIT_2_SYM ] >> ( BIT_2_SYM - 1 - bit % BIT_2_SYM ) ) & 1 ];
+            ++bit;
+
+            /// Декодирование идет с настоящей границы - данные испорчены
+            if( child < 0 )
+            {
+                fail();
+                return;
+            }
+
+            node = child;
+            if( !tree[ node ].mIsLeaf )
+                continue;
+
+            result += tree[ node ].mSym;
+            trueStartBit = bit;
+            node = 0;
+
+            if( chunk.mIsValid )
+            {
+                while( chunk.mSyncBits.end() != syncIt && *syncIt < bit )
+                    ++syncIt;
+
+                if( chunk.mSyncBits.end() != syncIt && *syncIt == bit )
+                {
+                    syncIndex = syncIt - chunk.mSyncBits.begin() + 1;
+                    isSynced = true;
+                    break;
+                }
+            }
+
+            if( bit >= chunkStartBit[ i + 1 ] )
+                break;
+        }
 
-void cAlgorithmHaffman::deleteTree( sNode *root ) const
-{
-    if( !root )
-        return;
+        if( isSynced )
+        {
+            result.append( chunk.mOutput, syncIndex, std::string::npos );
+            trueStartBit = chunk.mEndBit;
+        }
+    }
 
-    if ( !root->mpLeft && !root->mpRight )
+    /// Последний символ должен заканчиваться на последнем значимом бите
+    if( trueStartBit != totalBitCount )
     {
-        delete root;
+        fail();
         return;
     }
 
-    deleteTree( root->mpLeft );
-    deleteTree( root->mpRight );
+    releaseLargeChunks();
 }
 
-std::string cAlgorithmHaffman::sealCollection( const std::string_view collection ) const
+
+void cAlgorithmHaffman::buildDecodeTree( const codeTable_t &codes, decodeTree_t &tree ) const
 {
-    /// Полное количество символов и остаток значимых бит в незаполненном,
-    /// если такой есть символе
-    const size_t fullSym = collection.size() / BIT_2_SYM;
-    const size_t remaindBit = collection.size() % BIT_2_SYM;
-
-    /// Текущий символ для записи. В данном случае символ - это код из 0 и 1
-    /// размером 8 BIT_2_SYM
-    uint8_t currSym = 0;
-
-    /// Для результата
-    std::string result;
-
-    /// Кодирование полных байт
-    for( size_t bitCount = 0, shift = BIT_2_SYM - 1;
-         bitCount < fullSym * BIT_2_SYM;
-         ++bitCount, --shift )
+    tree.assign( 1, sDecodeNode() );
+
+    /// Символы в порядке значений char - в том же, в каком их обходили
+    /// предыдущие версии
+    for( int sym = std::numeric_limits< char >::min(); sym <= std::numeric_limits< char >::max(); ++sym )
     {
-        /// Уплотнение нулей и единиц в размер символа
-        currSym |= ( collection[ bitCount ] == '1' ) ? ( 1 << shift ) : ( 0 << shift );
-        /// Если буфер уже заполнен
-        if( 0 == shift )
+        /// Пустой код (единственный символ у предыдущих версий) не дает бит
+        const sCode &code = codes[ symbol_t( sym ) ];
+        if( !code.mLength )
+            continue;
+
+        size_t node = 0;
+        for( size_t bit = 0; bit < code.mLength; ++bit )
         {
-            shift = BIT_2_SYM;
-            result += ( currSym );
-            currSym = 0;
+            const size_t childIndex = getCodeBit( code, bit ) ? 1 : 0;
+            if( tree[ node ].mChild[ childIndex ] < 0 )
+            {
+                tree[ node ].mChild[ childIndex ] = static_cast< int32_t >( tree.size() );
+                tree.emplace_back();
+            }
+            node = tree[ node ].mChild[ childIndex ];
         }
+
+        tree[ node ].mSym = static_cast< char >( sym );
+        tree[ node ].mIsLeaf = true;
     }
+}
 
-    //// Кодирование неполноценного байта
-    for( size_t shift = BIT_2_SYM - 1, bitCount = 0;
-         shift > ( BIT_2_SYM - 1 - remaindBit );
-         shift--, bitCount++ )
+
+void cAlgorithmHaffman::decodeRange( const uint8_t *pData,
+                                     const decodeTree_t &tree,
+                                     uint64_t startBit,
+                                     uint64_t stopBit,
+                                     uint64_t totalBitCount,
+                                     size_t syncLimit,
+                                     sDecodedChunk &chunk ) const
+{
+    chunk.mOutput.clear();
+    chunk.mSyncBits.clear();
+    chunk.mEndBit = startBit;
+    chunk.mIsValid = true;
+    chunk.mSyncBits.reserve( syncLimit );
+
+    size_t node = 0;
+    for( uint64_t bit = startBit; bit < totalBitCount; )
     {
-        currSym |= ( collection[ fullSym * BIT_2_SYM + bitCount ] == '1' ) ? ( 1 << shift ) : ( 0 << shift );
-    }
-    if( remaindBit )
-        result += currSym;
+        const int32_t child = tree[ node ].mChild[ ( pData[ bit / BIT_2_SYM ] >> ( BIT_2_SYM - 1 - bit % BIT_2_SYM ) ) & 1 ];
+        ++bit;
+
+        /// Такого кода нет - начало участка не было границей символа
+        if( child < 0 )
+        {
+            chunk.mIsValid = false;
+            break;
+        }
 
-    return result;
+        node = child;
+        if( !tree[ node ].mIsLeaf )
+            continue;
+
+        chunk.mOutput += tree[ node ].mSym;
+        chunk.mEndBit = bit;
+        node = 0;
+
+        if( chunk.mSyncBits.size() < syncLimit )
+            chunk.mSyncBits.push_back( bit );
+
+        if( bit >= stopBit )
+            break;
+    }
 }
@@ -54,6 +54,9 @@
  * Пример 1: [ 1 0 0 0  0 0 0 1 ]
  * Пример 2: [ 0 0 0 0  0 0 1 1 ]
  *
+ * Рабочей памяти, кроме результата, алгоритм не использует, поэтому его
+ * контекст пуст.
+ *
  * Реализован с поиощью класса \ref cAlgorithmRLE
  * ****************************************************************************/
 
@@ -68,19 +71,52 @@
 class cAlgorithmRLE final : public cAbstractAlgorithm
 {
 public:
+    /// \brief Тип алгоритма
+    constexpr static eTypeOfComprAlgorithm TYPE = ALG_TYPE_RLE;
+    /// \brief Имя алгоритма в командной строке, замерах и статистике
+    constexpr static std::string_view NAME = "RLE";
+    /// \brief Постфикс сжатого файла
+    constexpr static std::string_view POSTFIX = ".cmprRLE";
+
+    using cAbstractAlgorithm::compress;
+    using cAbstractAlgorithm::decompress;
+
+    /// \brief Создать контекст алгоритма
+    /// \return Пустой контекст
+    virtual std::unique_ptr< cContext > createContext( void ) const override;
+
     /// \brief Сжатие данных
     /// \param [in] oldData Исходные данные для сжатия
-    /// \return Сжатые в соответсвии с алгоритмом RLE
-    virtual std::string compress( const std::string & oldData ) override;
+    /// \param [in] context Контекст алгоритма
+    /// \param [out] result Сжатые в соответсвии с алгоритмом RLE данные
+    virtual void compress( std::string_view oldData, cContext &context, std::string &result ) const override;
 
     /// \brief Распаковка данных
     /// \param [in] oldData Исходные данные для распаковки
-    /// \return Распакованные данные в соответсвии с алгоритмом RLE
-    virtual std::string decompress( const std::string & oldData ) override;
+    /// \param [in] context Контекст алгоритма
+    /// \param [out] result Распакованные данные в соответсвии с алгоритмом
+    /// RLE. Пустая строка - данные повреждены
+    virtual void decompress( std::string_view oldData, cContext &context, std::string &result ) const override;
 
     /// \brief Получить постфикс для файла
     /// \return Строка-расширение для упакованных данных
-    inline virtual std::string getPostfix( void ) const override { return ".cmprRLE"; }
+    inline virtual std::string getPostfix( void ) const override { return std::string( POSTFIX ); }
+
+    /// \brief Получить тип алгоритма
+    /// \return TYPE
+    inline virtual eTypeOfComprAlgorithm getType( void ) const override { return TYPE; }
+
+    /// \brief Получить оценку памяти для блока
+    /// \details Сжатие резервирует результат сразу (служебный байт на каждые
+    /// MAX_SIZE_SINGLE одиночных элементов), распакованный результат растет
+    /// удвоением
+    /// \param [in] rawSize Размер исходного блока
+    /// \param [in] action Сжатие или распаковка
+    /// \return Количество байт
+    inline virtual uint64_t getMemoryBound( uint64_t rawSize, eTypeOfActions action ) const override
+    {
+        return ACT_TYPE_COMPR == action ? rawSize + rawSize / MAX_SIZE_SINGLE + 1 : 2 * rawSize;
+    }
 
 private:
     /// \brief Типы последовательностей в исходном наборе данных
@@ -135,6 +171,26 @@ private:
     ///
     /// \return Структура, описывающая служебный байт
     static sServiceByteInfo readServiceByte(const char data[], size_t index ) noexcept;
+
+    /// \brief Найти длину цепочки одинаковых элементов
+    ///
+    /// \param [in] data Исходные данные
+    /// \param [in] index Индекс первого элемента цепочки
+    ///
+    /// \return Длина цепочки, не больше MAX_SIZE_SET. 1 - цепочки нет
+    static size_t countRun( std::string_view data, size_t index ) noexcept;
+
+    /// \brief Найти количество одиночных элементов до начала следующей
+    /// цепочки
+    ///
+    /// \param [in] data Исходные данные
+    /// \param [in] index Индекс первого одиночного элемента
+    ///
+    /// \return Количество элементов, не больше MAX_SIZE_SINGLE
+    static size_t countLiterals( std::string_view data, size_t index ) noexcept;
+
+    /// \brief Микрозамеры отдельных частей алгоритма (\ref MicroBench)
+    friend class cKernelBench;
 };
 
 /// @}
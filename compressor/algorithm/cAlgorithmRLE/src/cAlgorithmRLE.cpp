@@ -5,111 +5,84 @@
  * ****************************************************************************/
 
 #include "algorithm/cAlgorithmRLE/h/cAlgorithmRLE.h" /// Заголовок класса
+#include "stats/cJobStats/h/cJobStats.h" /// Статистика задания
+#include <algorithm> /// std::min
 
 /** ****************************************************************************
  * Определения публичной части класса
  * ****************************************************************************/
 
-std::string cAlgorithmRLE::compress( const std::string & oldData )
+std::unique_ptr< cAbstractAlgorithm::cContext > cAlgorithmRLE::createContext( void ) const
 {
-    /// Для результата
-    std::string result;
+    return std::make_unique< cContext >();
+}
+
+void cAlgorithmRLE::compress( std::string_view oldData, cContext &, std::string &result ) const
+{
+    /// Для результата. Худший случай - служебный байт на каждые
+    /// MAX_SIZE_SINGLE одиночных элементов
+    const cJobStats::cTimer timer( cJobStats::STAGE_ENCODE, oldData.size() );
 
-    /// Переменная для хранения "предыдущего" значения последовательсности
-    char prevVal = oldData[ 0 ];
+    result.clear();
+    result.reserve( oldData.size() + oldData.size() / MAX_SIZE_SINGLE + 1 );
 
-    /// С единицы, т.к. будем сравнивать с предыдущим
-    for( size_t curIndex = 1; curIndex <= oldData.size(); ++curIndex )
+    size_t curIndex = 0;
+    while( curIndex < oldData.size() )
     {
-        /// Текущий тип последовательности (одиночный или цепочка)
-        eTypeOfSequence curType = oldData[ curIndex ] == prevVal ? SEQ_TYPE_SET
-                                                                 : SEQ_TYPE_SINGLE;
-
-        /// Счетчик. Количество одинаковых при SEQ_TYPE_SET
-        /// или количество подряд идущих разных при SEQ_TYPE_SINGLE
-        size_t counter = 0;
-        if( SEQ_TYPE_SET == curType )
+        /// Длина цепочки одинаковых элементов, начиная с текущего
+        const size_t counter = countRun( oldData, curIndex );
+        if( counter >= COUNT_INCREMENT_SET )
         {
-            /// Раз совпало - уже 2 (предыдущий + текущий)
-            counter = 2;
-
-            /// Считаем
-            while( oldData[ ++curIndex ] == prevVal &&
-                   counter < MAX_SIZE_SET &&
-                   curIndex < oldData.size() )
-            {
-                counter++;
-            }
-
-            /// Добавляем в результат
-            result += getServiceByte( curType, counter );
-            result += prevVal;
-
-            /// Обновление "предыдущего" значения
-            prevVal = oldData[ curIndex ];
+            /// Цепочка: служебный байт и значение
+            result += getServiceByte( SEQ_TYPE_SET, counter );
+            result += oldData[ curIndex ];
+            curIndex += counter;
+            continue;
         }
-        else
-        {
-            std::string buffer;
 
-            /// Считаем
-            size_t startIndex = curIndex;
-            while( oldData[ curIndex ] != oldData[ curIndex - 1] &&
-                   curIndex <= oldData.size() )
-            {
-                prevVal = oldData[ curIndex - 1 ];
-                buffer += prevVal;
-                curIndex++;
-            }
-            counter = curIndex - startIndex;
-
-            /// Добавляем в результат
-            while( buffer.size() > MAX_SIZE_SINGLE )
-            {
-                result += ( getServiceByte( curType, MAX_SIZE_SINGLE ) );
-                std::move( buffer.begin(),
-                           buffer.begin() + MAX_SIZE_SINGLE,
-                           std::back_inserter( result ) );
-                buffer.erase( buffer.begin(), buffer.begin() + MAX_SIZE_SINGLE );
-            }
-
-            result += getServiceByte( curType, buffer.size() );
-            result += buffer;
-
-            /// Обновление предыдущего значения и индекса
-            prevVal = oldData[ curIndex ];
-            curIndex--;
-        }
+        /// Одиночные элементы - до начала следующей цепочки
+        const size_t literalCount = countLiterals( oldData, curIndex );
+        result += getServiceByte( SEQ_TYPE_SINGLE, literalCount );
+        result.append( oldData.data() + curIndex, literalCount );
+        curIndex += literalCount;
     }
-
-    return result;
 }
 
-std::string cAlgorithmRLE::decompress( const std::string & oldData )
+void cAlgorithmRLE::decompress( std::string_view oldData, cContext &, std::string &decomprData ) const
 {
-    std::string decomprData;
+    const cJobStats::cTimer timer( cJobStats::STAGE_DECODE, oldData.size() );
+
+    decomprData.clear();
     size_t index = 0;
     while( index < oldData.size() )
     {
-        sServiceByteInfo infoServByte = readServiceByte( oldData.data(), index );
+        const sServiceByteInfo infoServByte = readServiceByte( oldData.data(), index );
 
         if( SEQ_TYPE_SET == infoServByte.mType )
         {
-            while( infoServByte.mCount-- )
-                decomprData += ( oldData[ index + 1 ] );
+            /// Нет значения цепочки - данные обрезаны
+            if( index + 1 >= oldData.size() )
+            {
+                decomprData.clear();
+                return;
+            }
 
+            decomprData.append( infoServByte.mCount, oldData[ index + 1 ] );
             index += 2;
         }
         else
         {
-            while( infoServByte.mCount -- )
-                decomprData += ( oldData[ ++index ] );
+            /// Одиночных элементов меньше, чем указано в служебном байте
+            if( infoServByte.mCount > oldData.size() - index - 1 )
+            {
+                decomprData.clear();
+                return;
+            }
 
-            index += 1;
+            decomprData.append( oldData.data() + index + 1, infoServByte.mCount );
+            index += infoServByte.mCount + 1;
         }
     }
-
-    return decomprData;
 }
 
 
@@ -117,6 +90,31 @@ std::string cAlgorithmRLE::decompress( const std::string & oldData )
  * Определения приватной части класса
  * ****************************************************************************/
 
+size_t cAlgorithmRLE::countRun( std::string_view data, size_t index ) noexcept
+{
+    const char value = data[ index ];
+    const size_t limit = std::min< size_t >( data.size() - index, MAX_SIZE_SET );
+
+    size_t counter = 1;
+    while( counter < limit && data[ index + counter ] == value )
+        counter++;
+
+    return counter;
+}
+
+size_t cAlgorithmRLE::countLiterals( std::string_view data, size_t index ) noexcept
+{
+    const size_t startIndex = index;
+    while( index < data.size() &&
+           index - startIndex < MAX_SIZE_SINGLE &&
+           !( index + 1 < data.size() && data[ index ] == data[ index + 1 ] ) )
+    {
+        index++;
+    }
+
+    return index - startIndex;
+}
+
 cAlgorithmRLE::sServiceByteInfo cAlgorithmRLE::readServiceByte( const char data[], size_t index ) noexcept
 {
     sServiceByteInfo info;
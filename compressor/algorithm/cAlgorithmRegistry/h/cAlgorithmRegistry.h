@@ -0,0 +1,201 @@
+/** ****************************************************************************
+ * \file cAlgorithmRegistry.h
+ *
+ * \defgroup AlgorithmRegistry Реестр алгоритмов
+ * @{
+ *
+ * \ingroup Algorithm
+ *
+ * \brief Модуль, перечисляющий алгоритмы программы на этапе компиляции
+ *
+ * \details Каждый алгоритм объявляет свои свойства константами класса:
+ * - TYPE - тип, он же номер в форматах и протоколе службы;
+ * - NAME - имя в командной строке, замерах и статистике;
+ * - POSTFIX - постфикс сжатого файла.
+ *
+ * Реестр \ref cAlgorithmRegistry - список классов алгоритмов
+ * \ref cAlgorithmList. Таблицы имен и постфиксов по типу строятся из констант
+ * классов при компиляции, там же проверяется, что типы идут подряд с нуля в
+ * порядке списка, а имена и постфиксы не повторяются. Новый алгоритм
+ * добавляется в список одной строкой.
+ *
+ * \ref cAlgorithmList::visit вызывает переданную функцию с объектом
+ * конкретного класса алгоритма: обобщенная функция компилируется отдельно для
+ * каждого алгоритма, и вызовы в ней не виртуальные (классы алгоритмов
+ * final). Виртуальный интерфейс \ref cAbstractAlgorithm остается на внешней
+ * границе, где алгоритм выбирается во время работы: задание, файл, запрос
+ * службы. Там один вызов приходится на блок, а циклы по данным находятся
+ * внутри алгоритма и виртуальных вызовов не содержат.
+ *
+ * Объекты алгоритмов не хранят состояния, поэтому реестр держит по одному
+ * общему объекту каждого алгоритма - \ref cAlgorithmList::get, - вместо
+ * создания нового на каждый вызов.
+ *
+ * Реализован с поиощью шаблона класса \ref cAlgorithmList
+ * ****************************************************************************/
+
+#ifndef CALGORITHMREGISTRY_H
+#define CALGORITHMREGISTRY_H
+
+#include "algorithm/cAlgorithmHaffman/h/cAlgorithmHaffman.h" /// Алгоритм Хаффмана
+#include "algorithm/cAlgorithmRLE/h/cAlgorithmRLE.h" /// Алгоритм RLE
+#include <array> /// Массивы фиксированного размера
+#include <string_view> /// Представления строк
+#include <tuple> /// Кортежи
+
+/// \brief Класс списка алгоритмов
+/// \class cAlgorithmList
+/// \tparam Algorithms Классы алгоритмов в порядке их типов
+template< typename... Algorithms >
+class cAlgorithmList final
+{
+public:
+    /// \brief Количество алгоритмов
+    constexpr static size_t COUNT = sizeof...( Algorithms );
+
+    /// \brief Типы алгоритмов в порядке списка
+    constexpr static std::array< eTypeOfComprAlgorithm, COUNT > TYPES = { Algorithms::TYPE... };
+
+    /// \brief Имена алгоритмов по типу
+    constexpr static std::array< std::string_view, COUNT > NAMES = { Algorithms::NAME... };
+
+    /// \brief Постфиксы сжатых файлов по типу
+    constexpr static std::array< std::string_view, COUNT > POSTFIXES = { Algorithms::POSTFIX... };
+
+    /// \brief Проверить, есть ли алгоритм такого типа
+    /// \param [in] type Тип, прочитанный из данных
+    /// \return true - тип известен
+    constexpr static bool isKnown( int type ) noexcept
+    {
+        return type >= 0 && size_t( type ) < COUNT;
+    }
+
+    /// \brief Получить имя алгоритма
+    /// \param [in] type Тип алгоритма
+    /// \return Имя или пустая строка для неизвестного типа
+    constexpr static std::string_view getName( eTypeOfComprAlgorithm type ) noexcept
+    {
+        return isKnown( type ) ? NAMES[ type ] : std::string_view();
+    }
+
+    /// \brief Получить постфикс сжатого файла
+    /// \param [in] type Тип алгоритма
+    /// \return Постфикс или пустая строка для неизвестного типа
+    constexpr static std::string_view getPostfix( eTypeOfComprAlgorithm type ) noexcept
+    {
+        return isKnown( type ) ? POSTFIXES[ type ] : std::string_view();
+    }
+
+    /// \brief Найти алгоритм по имени
+    /// \param [in] name Имя
+    /// \return Тип алгоритма и признак того, что имя известно
+    constexpr static std::tuple< eTypeOfComprAlgorithm, bool > findByName( std::string_view name ) noexcept
+    {
+        for( size_t type = 0; type < COUNT; ++type )
+            if( NAMES[ type ] == name )
+                return std::make_tuple( TYPES[ type ], true );
+
+        return std::make_tuple( TYPES[ 0 ], false );
+    }
+
+    /// \brief Найти алгоритм по постфиксу пути
+    /// \param [in] path Путь к сжатому файлу
+    /// \return Тип алгоритма и признак того, что путь длиннее постфикса и
+    /// заканчивается им
+    constexpr static std::tuple< eTypeOfComprAlgorithm, bool > findByPostfix( std::string_view path ) noexcept
+    {
+        for( size_t type = 0; type < COUNT; ++type )
+        {
+            const std::string_view postfix( POSTFIXES[ type ] );
+            if( path.size() > postfix.size() && path.substr( path.size() - postfix.size() ) == postfix )
+                return std::make_tuple( TYPES[ type ], true );
+        }
+
+        return std::make_tuple( TYPES[ 0 ], false );
+    }
+
+    /// \brief Вызвать функцию с общим объектом алгоритма типа type
+    ///
+    /// \details Функция получает ссылку на конкретный класс алгоритма
+    ///
+    /// \param [in] type Тип алгоритма
+    /// \param [in] func Обобщенная функция от ссылки на алгоритм
+    ///
+    /// \return false - тип неизвестен, функция не вызвана
+    template< typename Func >
+    static bool visit( eTypeOfComprAlgorithm type, Func &&func )
+    {
+        return ( ( Algorithms::TYPE == type && ( ( void )func( instance< Algorithms >() ), true ) ) || ... );
+    }
+
+    /// \brief Вызвать функцию с общим объектом каждого алгоритма по порядку
+    /// \param [in] func Обобщенная функция от ссылки на алгоритм
+    template< typename Func >
+    static void forEach( Func &&func )
+    {
+        ( ( void )func( instance< Algorithms >() ), ... );
+    }
+
+    /// \brief Получить общий объект алгоритма
+    /// \param [in] type Тип алгоритма
+    /// \return Алгоритм или nullptr для неизвестного типа
+    static cAbstractAlgorithm *get( eTypeOfComprAlgorithm type )
+    {
+        cAbstractAlgorithm *pAlgorithm = nullptr;
+        visit( type, [ &pAlgorithm ]( cAbstractAlgorithm &algorithm ) { pAlgorithm = &algorithm; } );
+
+        return pAlgorithm;
+    }
+
+    /// \brief Проверить, что типы идут подряд с нуля в порядке списка
+    /// \return true - тип совпадает с номером в списке
+    constexpr static bool isDense( void ) noexcept
+    {
+        for( size_t type = 0; type < COUNT; ++type )
+            if( size_t( TYPES[ type ] ) != type )
+                return false;
+
+        return true;
+    }
+
+    /// \brief Проверить, что строки не повторяются
+    /// \param [in] values Строки по типу
+    /// \return true - все строки различны и не пусты
+    constexpr static bool isUnique( const std::array< std::string_view, COUNT > &values ) noexcept
+    {
+        for( size_t i = 0; i < COUNT; ++i )
+        {
+            if( values[ i ].empty() )
+                return false;
+
+            for( size_t j = i + 1; j < COUNT; ++j )
+                if( values[ i ] == values[ j ] )
+                    return false;
+        }
+
+        return true;
+    }
+
+private:
+    /// \brief Общий объект алгоритма
+    /// \return Ссылка на объект, созданный при первом обращении
+    template< typename Algorithm >
+    static Algorithm &instance( void )
+    {
+        static Algorithm algorithm;
+        return algorithm;
+    }
+};
+
+/// \brief Псевдоним для реестра алгоритмов программы
+/// \typedef cAlgorithmRegistry
+using cAlgorithmRegistry = cAlgorithmList< cAlgorithmRLE, cAlgorithmHaffman >;
+
+static_assert( cAlgorithmRegistry::isDense(), "Типы алгоритмов должны идти подряд с нуля в порядке реестра" );
+static_assert( cAlgorithmRegistry::isUnique( cAlgorithmRegistry::NAMES ), "Имена алгоритмов не должны повторяться" );
+static_assert( cAlgorithmRegistry::isUnique( cAlgorithmRegistry::POSTFIXES ),
+               "Постфиксы алгоритмов не должны повторяться" );
+
+/// @}
+
+#endif // CALGORITHMREGISTRY_H
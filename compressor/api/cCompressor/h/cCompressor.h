@@ -0,0 +1,137 @@
+/** ****************************************************************************
+ * \file cCompressor.h
+ * ****************************************************************************/
+
+/** ****************************************************************************
+ * \defgroup Api Библиотека ядра
+ *
+ * \brief Интерфейс для встраивания сжатия в другие программы
+ *
+ * \details Ядро программы собирается отдельной библиотекой без Qt
+ * (core/core.pro): статической, а при qmake CONFIG+=core_shared -
+ * разделяемой. Для программ на C++ - \ref ApiCpp, для C и других языков
+ * через FFI - \ref ApiC. Устанавливаемые заголовки (make install) зависят
+ * только от стандартной библиотеки и common.h
+ *
+ * ****************************************************************************/
+
+/** ****************************************************************************
+ * \defgroup ApiCpp Интерфейс C++
+ * @{
+ * \ingroup Api
+ *
+ * \brief Модуль, предоставляющий сжатие буферов и файлов одним вызовом
+ *
+ * \details Буферы сжимаются в блочном формате \ref BlockFormat с
+ * контрольными суммами, блоки - параллельно в общем пуле потоков
+ * \ref ThreadPool, как и в программе. Распаковка принимает и данные из
+ * нескольких частей, записанных подряд (результат сжатия потока программой
+ * командной строки \ref Cli). Алгоритм распаковки определяется по заголовку.
+ * Данные предыдущих версий программы без заголовка не распаковываются.
+ *
+ * Файлы обрабатываются \ref cFileWorker: результат пишется рядом с
+ * исходным под теми же именами, что и в программе.
+ *
+ * Все методы можно вызывать из нескольких потоков одновременно.
+ *
+ * Реализован с поиощью класса \ref cCompressor
+ * ****************************************************************************/
+
+#ifndef CCOMPRESSOR_H
+#define CCOMPRESSOR_H
+
+#include "common.h" /// Общие константы программы
+#include <cstddef> /// size_t
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+#include <tuple> /// Кортежи
+
+/// \brief Класс, реализующий интерфейс библиотеки ядра
+/// \class cCompressor
+class cCompressor final
+{
+public:
+    /// \brief Сжать буфер
+    ///
+    /// \param [in] type Алгоритм
+    /// \param [in] data Исходные данные
+    /// \param [in] blockSize Размер блока. 0 - данные сжимаются одним блоком
+    ///
+    /// \return Сжатые данные и статус:
+    /// ERR_STATUS_SUCCESS - успех,
+    /// ERR_STATUS_EMPTY_SRC_FILE - данные пусты,
+    /// ERR_STATUS_BAD_ALG - неизвестный алгоритм или ошибка алгоритма,
+    /// ERR_STATUS_MEMORY_LIMIT - данные не помещаются в предел памяти
+    static std::tuple< std::string, eErrStatus > compress( eTypeOfComprAlgorithm type, std::string_view data,
+                                                           uint64_t blockSize = DEFAULT_BLOCK_SIZE );
+
+    /// \brief Распаковать буфер
+    ///
+    /// \param [in] data Сжатые данные из одной или нескольких частей
+    ///
+    /// \return Распакованные данные и статус:
+    /// ERR_STATUS_SUCCESS - успех,
+    /// ERR_STATUS_EMPTY_SRC_FILE - данные пусты,
+    /// ERR_STATUS_BAD_FORMAT - данные испорчены, обрезаны или без заголовка,
+    /// ERR_STATUS_BAD_ALG - ошибка алгоритма,
+    /// ERR_STATUS_MEMORY_LIMIT - результат не помещается в предел памяти
+    static std::tuple< std::string, eErrStatus > decompress( std::string_view data );
+
+    /// \brief Получить размер исходных данных по заголовкам, не распаковывая
+    ///
+    /// \param [in] data Сжатые данные из одной или нескольких частей
+    ///
+    /// \return Размер и статус: ERR_STATUS_SUCCESS,
+    /// ERR_STATUS_EMPTY_SRC_FILE или ERR_STATUS_BAD_FORMAT
+    static std::tuple< uint64_t, eErrStatus > getRawSize( std::string_view data );
+
+    /// \brief Сжать файл. Результат - рядом с исходным, с постфиксом
+    /// алгоритма
+    ///
+    /// \param [in] type Алгоритм
+    /// \param [in] path Путь до файла
+    /// \param [in] blockSize Размер блока. 0 - файл сжимается одним блоком
+    ///
+    /// \return Путь до результата и статус \ref cFileWorker::applyAlgorithm
+    static std::tuple< std::string, eErrStatus > compressFile( eTypeOfComprAlgorithm type, const std::string &path,
+                                                               uint64_t blockSize = DEFAULT_BLOCK_SIZE );
+
+    /// \brief Распаковать файл. Алгоритм определяется по постфиксу имени
+    ///
+    /// \param [in] path Путь до файла
+    ///
+    /// \return Путь до результата и статус \ref cFileWorker::applyAlgorithm.
+    /// Файл без постфикса алгоритма - ERR_STATUS_BAD_POSTFIX
+    static std::tuple< std::string, eErrStatus > decompressFile( const std::string &path );
+
+    /// \brief Задать количество рабочих потоков. Действует только до первого
+    /// сжатия или распаковки
+    /// \param [in] threadCount Количество потоков. 0 - по числу доступных
+    /// процессоров
+    static void setThreadCount( size_t threadCount ) noexcept;
+
+    /// \brief Задать общий предел памяти под блоки для всех сжатий и
+    /// распаковок (\ref cMemoryBudget::global). Файлы сжимаются меньшими
+    /// блоками, чтобы уложиться в предел
+    /// \param [in] limit Предел в байтах. 0 - без ограничения
+    static void setMemoryLimit( uint64_t limit );
+
+    /// \brief Размер блока по умолчанию (совпадает с
+    /// \ref cFileWorker::DEFAULT_BLOCK_SIZE)
+    constexpr static uint64_t DEFAULT_BLOCK_SIZE = 4 * 1024 * 1024;
+
+private:
+    /// \brief Разделить сжатые данные на части
+    /// \param [in] data Сжатые данные
+    /// \param [in] handler Обработчик части. Перебор прекращается на первом
+    /// неуспешном статусе
+    /// \return ERR_STATUS_SUCCESS, статус обработчика,
+    /// ERR_STATUS_EMPTY_SRC_FILE или ERR_STATUS_BAD_FORMAT
+    template< typename F >
+    static eErrStatus forEachPart( std::string_view data, F &&handler );
+};
+
+/// @}
+
+#endif // CCOMPRESSOR_H
@@ -0,0 +1,150 @@
+/** ****************************************************************************
+ * \brief Исходные коды интерфейса C++ библиотеки ядра
+ *
+ * \file cCompressor.cpp
+ * ****************************************************************************/
+
+#include "api/cCompressor/h/cCompressor.h" /// Заголовок класса
+#include "algorithm/cAlgorithmRegistry/h/cAlgorithmRegistry.h" /// Реестр алгоритмов
+#include "blockFormat/h/cBlockFormat.h" /// Блочный формат
+#include "cFileWorker/h/cFileWorker.h" /// Работа с файлами
+#include "memoryBudget/h/cMemoryBudget.h" /// Бюджет памяти
+#include "threadPool/h/cThreadPool.h" /// Пул потоков
+
+static_assert( cCompressor::DEFAULT_BLOCK_SIZE == cFileWorker::DEFAULT_BLOCK_SIZE,
+               "Размер блока по умолчанию библиотеки и программы должен совпадать" );
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+std::tuple< std::string, eErrStatus > cCompressor::compress( eTypeOfComprAlgorithm type, std::string_view data,
+                                                             uint64_t blockSize )
+{
+    cAbstractAlgorithm *pAlgorithm = cAlgorithmRegistry::get( type );
+    if( !pAlgorithm )
+        return std::make_tuple( std::string(), ERR_STATUS_BAD_ALG );
+
+    return cFileWorker::compressData( *pAlgorithm, data, blockSize );
+}
+
+std::tuple< std::string, eErrStatus > cCompressor::decompress( std::string_view data )
+{
+    const auto [ rawSize, sizeStatus ] = getRawSize( data );
+    if( ERR_STATUS_SUCCESS != sizeStatus )
+        return std::make_tuple( std::string(), sizeStatus );
+
+    std::string result;
+    const eErrStatus status = forEachPart( data, [ &result, rawSize = rawSize ]( std::string_view part,
+                                                                                 const cBlockFormat::sHeader &header )
+    {
+        auto [ raw, rawStatus ] = cFileWorker::decompressData( *cAlgorithmRegistry::get( header.mAlgType ), part );
+        if( ERR_STATUS_SUCCESS != rawStatus )
+            return rawStatus;
+
+        /// Данные из одной части возвращаются без копирования
+        if( result.empty() && raw.size() == rawSize )
+        {
+            result = std::move( raw );
+        }
+        else
+        {
+            result.reserve( rawSize );
+            result.append( raw );
+        }
+
+        return ERR_STATUS_SUCCESS;
+    } );
+
+    if( ERR_STATUS_SUCCESS != status )
+        result.clear();
+
+    return std::make_tuple( std::move( result ), status );
+}
+
+std::tuple< uint64_t, eErrStatus > cCompressor::getRawSize( std::string_view data )
+{
+    uint64_t rawSize = 0;
+    const eErrStatus status = forEachPart( data, [ &rawSize ]( std::string_view part,
+                                                               const cBlockFormat::sHeader &header )
+    {
+        ( void )part;
+        rawSize += header.mRawSize;
+        return ERR_STATUS_SUCCESS;
+    } );
+
+    return std::make_tuple( ERR_STATUS_SUCCESS == status ? rawSize : 0, status );
+}
+
+std::tuple< std::string, eErrStatus > cCompressor::compressFile( eTypeOfComprAlgorithm type, const std::string &path,
+                                                                 uint64_t blockSize )
+{
+    cAbstractAlgorithm *pAlgorithm = cAlgorithmRegistry::get( type );
+    if( !pAlgorithm )
+        return std::make_tuple( std::string(), ERR_STATUS_BAD_ALG );
+
+    cFileWorker worker;
+    worker.setBlockSize( blockSize );
+    const eErrStatus status = worker.updateReadFile( path );
+    if( ERR_STATUS_SUCCESS != status )
+        return std::make_tuple( std::string(), status );
+
+    return worker.applyAlgorithm( *pAlgorithm, ACT_TYPE_COMPR );
+}
+
+std::tuple< std::string, eErrStatus > cCompressor::decompressFile( const std::string &path )
+{
+    /// Алгоритм - по постфиксу, как при выборе файла в программе
+    const auto [ type, isKnown ] = cAlgorithmRegistry::findByPostfix( path );
+    if( !isKnown )
+        return std::make_tuple( std::string(), ERR_STATUS_BAD_POSTFIX );
+
+    cFileWorker worker;
+    const eErrStatus status = worker.updateReadFile( path );
+    if( ERR_STATUS_SUCCESS != status )
+        return std::make_tuple( std::string(), status );
+
+    return worker.applyAlgorithm( *cAlgorithmRegistry::get( type ), ACT_TYPE_DECOMPR );
+}
+
+void cCompressor::setThreadCount( size_t threadCount ) noexcept
+{
+    cThreadPool::setInstanceThreadCount( threadCount );
+}
+
+void cCompressor::setMemoryLimit( uint64_t limit )
+{
+    cMemoryBudget::global().setLimit( limit );
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+template< typename F >
+eErrStatus cCompressor::forEachPart( std::string_view data, F &&handler )
+{
+    if( data.empty() )
+        return ERR_STATUS_EMPTY_SRC_FILE;
+
+    while( !data.empty() )
+    {
+        const auto [ partSize, sizeStatus ] = cBlockFormat::readContainerSize( data );
+        if( ERR_STATUS_SUCCESS != sizeStatus || partSize > data.size() )
+            return ERR_STATUS_BAD_FORMAT;
+
+        const std::string_view part( data.substr( 0, partSize ) );
+        const auto [ header, headerSize, headerStatus ] = cBlockFormat::readHeader( part );
+        ( void )headerSize;
+        if( ERR_STATUS_SUCCESS != headerStatus )
+            return headerStatus;
+
+        const eErrStatus status = handler( part, header );
+        if( ERR_STATUS_SUCCESS != status )
+            return status;
+
+        data.remove_prefix( partSize );
+    }
+
+    return ERR_STATUS_SUCCESS;
+}
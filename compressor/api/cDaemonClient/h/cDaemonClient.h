@@ -0,0 +1,100 @@
+/** ****************************************************************************
+ * \file cDaemonClient.h
+ *
+ * \defgroup ApiDaemon Клиент службы сжатия
+ * @{
+ * \ingroup Api
+ *
+ * \brief Модуль, предоставляющий сжатие и распаковку через службу сжатия
+ * \ref Daemon
+ *
+ * \details Для потока небольших данных: служба держит запущенный пул потоков
+ * и готовые алгоритмы, поэтому на запрос не тратится ни запуск процесса, ни
+ * подготовка. Соединение устанавливается один раз и используется для многих
+ * запросов. Данные больше \ref cDaemonProtocol::INLINE_LIMIT передаются через
+ * memfd (\ref DaemonProtocol).
+ *
+ * Результат совпадает с \ref cCompressor::compress и
+ * \ref cCompressor::decompress. Объект не потокобезопасен: каждому потоку -
+ * свое соединение.
+ *
+ * Реализован с поиощью класса \ref cDaemonClient
+ * ****************************************************************************/
+
+#ifndef CDAEMONCLIENT_H
+#define CDAEMONCLIENT_H
+
+#include "common.h" /// Общие константы программы
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+#include <tuple> /// Кортежи
+
+/// \brief Класс, реализующий клиент службы сжатия
+/// \class cDaemonClient
+class cDaemonClient final
+{
+public:
+    /// \brief Конструктор класса
+    cDaemonClient( void ) = default;
+
+    /// \brief Деструктор класса. Закрывает соединение
+    ~cDaemonClient( void );
+
+    cDaemonClient( const cDaemonClient & ) = delete;
+    cDaemonClient &operator=( const cDaemonClient & ) = delete;
+
+    /// \brief Подключиться к службе
+    /// \param [in] socketPath Путь до сокета службы. Пустой - путь по
+    /// умолчанию \ref cDaemonProtocol::getDefaultSocketPath
+    /// \return ERR_STATUS_SUCCESS или ERR_STATUS_BAD_FILE_OPEN
+    eErrStatus connect( const std::string &socketPath = std::string() );
+
+    /// \brief Сжать данные
+    ///
+    /// \param [in] type Алгоритм
+    /// \param [in] data Исходные данные
+    /// \param [in] blockSize Размер блока. 0 - данные сжимаются одним блоком
+    ///
+    /// \return Сжатые данные и статус \ref cCompressor::compress. Ошибки
+    /// соединения - ERR_STATUS_BAD_FILE_OPEN или ERR_STATUS_BAD_FILE_WRITE,
+    /// соединение при этом закрывается
+    std::tuple< std::string, eErrStatus > compress( eTypeOfComprAlgorithm type, std::string_view data,
+                                                    uint64_t blockSize = DEFAULT_BLOCK_SIZE );
+
+    /// \brief Распаковать данные
+    /// \param [in] data Сжатые данные из одной или нескольких частей
+    /// \return Распакованные данные и статус \ref cCompressor::decompress или
+    /// ошибка соединения, как у \ref compress
+    std::tuple< std::string, eErrStatus > decompress( std::string_view data );
+
+    /// \brief Размер блока по умолчанию (совпадает с
+    /// \ref cCompressor::DEFAULT_BLOCK_SIZE)
+    constexpr static uint64_t DEFAULT_BLOCK_SIZE = 4 * 1024 * 1024;
+
+    /// \brief Проверить, установлено ли соединение
+    /// \return true - соединение установлено
+    inline bool isConnected( void ) const noexcept { return -1 != mSocket; }
+
+    /// \brief Закрыть соединение
+    void close( void );
+
+private:
+    /// \brief Выполнить запрос
+    /// \param [in] operation Операция \ref cDaemonProtocol::eOperation
+    /// \param [in] type Алгоритм
+    /// \param [in] data Данные
+    /// \param [in] blockSize Размер блока
+    /// \return Результат и статус
+    std::tuple< std::string, eErrStatus > request( uint8_t operation, eTypeOfComprAlgorithm type,
+                                                   std::string_view data, uint64_t blockSize );
+
+    /// \brief Сокет соединения
+    int mSocket = -1;
+    /// \brief Номер следующего запроса
+    uint64_t mNextId = 1;
+};
+
+/// @}
+
+#endif // CDAEMONCLIENT_H
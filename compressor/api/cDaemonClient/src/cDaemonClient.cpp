@@ -0,0 +1,117 @@
+/** ****************************************************************************
+ * \brief Исходные коды клиента службы сжатия
+ *
+ * \file cDaemonClient.cpp
+ * ****************************************************************************/
+
+#include "api/cDaemonClient/h/cDaemonClient.h" /// Заголовок класса
+#include "api/cCompressor/h/cCompressor.h" /// Размер блока по умолчанию
+#include "daemonProtocol/h/cDaemonProtocol.h" /// Протокол службы
+#include <cstring> /// std::memcpy
+#include <sys/socket.h> /// socket, connect
+#include <sys/un.h> /// sockaddr_un
+#include <unistd.h> /// close
+
+static_assert( cDaemonClient::DEFAULT_BLOCK_SIZE == cCompressor::DEFAULT_BLOCK_SIZE,
+               "Размер блока по умолчанию клиента и библиотеки должен совпадать" );
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+cDaemonClient::~cDaemonClient( void )
+{
+    close();
+}
+
+eErrStatus cDaemonClient::connect( const std::string &socketPath )
+{
+    close();
+
+    const std::string path( socketPath.empty() ? cDaemonProtocol::getDefaultSocketPath() : socketPath );
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if( path.size() >= sizeof( address.sun_path ) )
+        return ERR_STATUS_BAD_FILE_OPEN;
+
+    std::memcpy( address.sun_path, path.c_str(), path.size() + 1 );
+
+    mSocket = socket( AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0 );
+    if( -1 == mSocket )
+        return ERR_STATUS_BAD_FILE_OPEN;
+
+    if( 0 != ::connect( mSocket, reinterpret_cast< const sockaddr * >( &address ), sizeof( address ) ) )
+    {
+        close();
+        return ERR_STATUS_BAD_FILE_OPEN;
+    }
+
+    return ERR_STATUS_SUCCESS;
+}
+
+std::tuple< std::string, eErrStatus > cDaemonClient::compress( eTypeOfComprAlgorithm type, std::string_view data,
+                                                               uint64_t blockSize )
+{
+    return request( cDaemonProtocol::OPERATION_COMPRESS, type, data, blockSize );
+}
+
+std::tuple< std::string, eErrStatus > cDaemonClient::decompress( std::string_view data )
+{
+    return request( cDaemonProtocol::OPERATION_DECOMPRESS, ALG_TYPE_HFMN, data, 0 );
+}
+
+void cDaemonClient::close( void )
+{
+    if( -1 != mSocket )
+        ::close( mSocket );
+
+    mSocket = -1;
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+std::tuple< std::string, eErrStatus > cDaemonClient::request( uint8_t operation, eTypeOfComprAlgorithm type,
+                                                              std::string_view data, uint64_t blockSize )
+{
+    if( !isConnected() )
+        return std::make_tuple( std::string(), ERR_STATUS_BAD_FILE_OPEN );
+
+    cDaemonProtocol::sRequest request;
+    request.mOperation = cDaemonProtocol::eOperation( operation );
+    request.mAlgType = type;
+    request.mId = mNextId++;
+    request.mBlockSize = blockSize;
+
+    eErrStatus status = cDaemonProtocol::sendRequest( mSocket, request, data );
+    if( ERR_STATUS_SUCCESS != status )
+    {
+        close();
+        return std::make_tuple( std::string(), status );
+    }
+
+    cDaemonProtocol::sResponse response;
+    cDaemonProtocol::sPayload payload;
+    status = cDaemonProtocol::receiveResponse( mSocket, response, payload );
+
+    /// Ответ на чужой запрос - рассинхронизация, соединение не годится
+    if( ERR_STATUS_SUCCESS == status && response.mId != request.mId )
+        status = ERR_STATUS_BAD_FORMAT;
+
+    if( ERR_STATUS_SUCCESS != status )
+    {
+        close();
+        return std::make_tuple( std::string(), ERR_STATUS_CANCELED == status ? ERR_STATUS_BAD_FILE_OPEN : status );
+    }
+
+    if( ERR_STATUS_SUCCESS != response.mStatus )
+        return std::make_tuple( std::string(), response.mStatus );
+
+    /// Данные из сообщения забираются без копирования
+    if( nullptr == payload.mpMapped )
+        return std::make_tuple( std::move( payload.mInline ), ERR_STATUS_SUCCESS );
+
+    return std::make_tuple( std::string( payload.getData() ), ERR_STATUS_SUCCESS );
+}
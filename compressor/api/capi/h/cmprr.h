@@ -0,0 +1,166 @@
+/** ****************************************************************************
+ * \file cmprr.h
+ *
+ * \defgroup ApiC Интерфейс C
+ * @{
+ *
+ * \ingroup Api
+ *
+ * \brief Модуль, предоставляющий библиотеку ядра программам на C и другим
+ * языкам через FFI
+ *
+ * \details Обертка над \ref cCompressor. Заголовок не зависит от остальных
+ * заголовков программы. Буферы результата выделяет вызывающий: наибольший
+ * размер сжатых данных - \ref cmprr_compress_bound, размер распакованных -
+ * \ref cmprr_get_raw_size. Если буфера не хватает, возвращается
+ * CMPRR_ERROR_BUFFER_TOO_SMALL, а в *dst_size - нужный размер.
+ *
+ * Коды ошибок до CMPRR_ERROR_MEMORY_LIMIT совпадают с \ref eErrStatus.
+ * Исключения не выходят за пределы библиотеки - вместо нехватки памяти
+ * возвращается CMPRR_ERROR_NO_MEMORY, вместо остальных -
+ * CMPRR_ERROR_INTERNAL.
+ *
+ * Реализован функциями cmprr_*
+ * ****************************************************************************/
+
+#ifndef CMPRR_H
+#define CMPRR_H
+
+#include <stddef.h> /* size_t */
+#include <stdint.h> /* uint64_t */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined( __GNUC__ )
+#define CMPRR_API __attribute__( ( visibility( "default" ) ) )
+#else
+#define CMPRR_API
+#endif
+
+/** \brief Статус выполнения */
+typedef enum cmprr_status
+{
+    CMPRR_OK = 0, /**< Без ошибок */
+    CMPRR_ERROR_ALGORITHM, /**< Ошибка алгоритма или неизвестный алгоритм */
+    CMPRR_ERROR_FILE_OPEN, /**< Ошибка открытия файла */
+    CMPRR_ERROR_POSTFIX, /**< Постфикс файла не соответствует алгоритму */
+    CMPRR_ERROR_EMPTY, /**< Пустые входные данные */
+    CMPRR_ERROR_FORMAT, /**< Ошибка формата сжатых данных */
+    CMPRR_ERROR_FILE_WRITE, /**< Ошибка записи файла */
+    CMPRR_ERROR_CANCELED, /**< Операция отменена */
+    CMPRR_ERROR_MEMORY_LIMIT, /**< Не хватает памяти в пределах ограничения */
+    CMPRR_ERROR_BUFFER_TOO_SMALL = 100, /**< Не хватает буфера результата */
+    CMPRR_ERROR_ARGUMENT, /**< Неверный аргумент (нулевой указатель) */
+    CMPRR_ERROR_NO_MEMORY, /**< Не хватило памяти */
+    CMPRR_ERROR_INTERNAL /**< Внутренняя ошибка библиотеки */
+} cmprr_status;
+
+/** \brief Алгоритм сжатия. Значения совпадают с \ref eTypeOfComprAlgorithm */
+typedef enum cmprr_algorithm
+{
+    CMPRR_ALGORITHM_RLE = 0, /**< Алгоритм RLE */
+    CMPRR_ALGORITHM_HAFFMAN = 1 /**< Алгоритм Хаффмана */
+} cmprr_algorithm;
+
+/** \brief Размер блока по умолчанию */
+#define CMPRR_DEFAULT_BLOCK_SIZE ( (size_t)4 * 1024 * 1024 )
+
+/**
+ * \brief Наибольший размер сжатых данных
+ * \param [in] raw_size Размер исходных данных
+ * \param [in] block_size Размер блока. 0 - данные сжимаются одним блоком
+ * \return Размер в байтах
+ */
+CMPRR_API size_t cmprr_compress_bound( size_t raw_size, size_t block_size );
+
+/**
+ * \brief Сжать буфер
+ * \param [in] algorithm Алгоритм
+ * \param [in] src Исходные данные
+ * \param [in] src_size Размер исходных данных
+ * \param [in] block_size Размер блока. 0 - данные сжимаются одним блоком
+ * \param [out] dst Буфер результата
+ * \param [in] dst_capacity Размер буфера результата
+ * \param [out] dst_size Размер сжатых данных (нужный, если буфера не хватило)
+ * \return Статус
+ */
+CMPRR_API cmprr_status cmprr_compress( cmprr_algorithm algorithm, const void *src, size_t src_size,
+                                       size_t block_size, void *dst, size_t dst_capacity, size_t *dst_size );
+
+/**
+ * \brief Получить размер исходных данных по заголовкам сжатых
+ * \param [in] src Сжатые данные
+ * \param [in] src_size Размер сжатых данных
+ * \param [out] raw_size Размер исходных данных
+ * \return Статус
+ */
+CMPRR_API cmprr_status cmprr_get_raw_size( const void *src, size_t src_size, uint64_t *raw_size );
+
+/**
+ * \brief Распаковать буфер. Алгоритм определяется по заголовку
+ * \param [in] src Сжатые данные
+ * \param [in] src_size Размер сжатых данных
+ * \param [out] dst Буфер результата
+ * \param [in] dst_capacity Размер буфера результата
+ * \param [out] dst_size Размер распакованных данных (нужный, если буфера не
+ * хватило)
+ * \return Статус
+ */
+CMPRR_API cmprr_status cmprr_decompress( const void *src, size_t src_size, void *dst, size_t dst_capacity,
+                                         size_t *dst_size );
+
+/**
+ * \brief Сжать файл. Результат - рядом с исходным, с постфиксом алгоритма
+ * \param [in] algorithm Алгоритм
+ * \param [in] path Путь до файла
+ * \param [in] block_size Размер блока. 0 - файл сжимается одним блоком
+ * \param [out] result_path Путь до результата, строка с нулем в конце. Может
+ * быть NULL
+ * \param [in] result_capacity Размер буфера result_path
+ * \return Статус. Если путь не поместился - CMPRR_ERROR_BUFFER_TOO_SMALL,
+ * файл при этом создан
+ */
+CMPRR_API cmprr_status cmprr_compress_file( cmprr_algorithm algorithm, const char *path, size_t block_size,
+                                            char *result_path, size_t result_capacity );
+
+/**
+ * \brief Распаковать файл. Алгоритм определяется по постфиксу имени
+ * \param [in] path Путь до файла
+ * \param [out] result_path Путь до результата, строка с нулем в конце. Может
+ * быть NULL
+ * \param [in] result_capacity Размер буфера result_path
+ * \return Статус, как у \ref cmprr_compress_file
+ */
+CMPRR_API cmprr_status cmprr_decompress_file( const char *path, char *result_path, size_t result_capacity );
+
+/**
+ * \brief Задать количество рабочих потоков. Действует только до первого
+ * сжатия или распаковки
+ * \param [in] thread_count Количество потоков. 0 - по числу доступных
+ * процессоров
+ */
+CMPRR_API void cmprr_set_thread_count( size_t thread_count );
+
+/**
+ * \brief Задать общий предел памяти под блоки сжатия и распаковки. Данные,
+ * не помещающиеся в предел, дают CMPRR_ERROR_MEMORY_LIMIT
+ * \param [in] limit Предел в байтах. 0 - без ограничения
+ */
+CMPRR_API void cmprr_set_memory_limit( uint64_t limit );
+
+/**
+ * \brief Получить текст статуса
+ * \param [in] status Статус
+ * \return Строка латиницей, не освобождается
+ */
+CMPRR_API const char *cmprr_get_status_text( cmprr_status status );
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} */
+
+#endif /* CMPRR_H */
@@ -0,0 +1,212 @@
+/** ****************************************************************************
+ * \brief Исходные коды интерфейса C библиотеки ядра
+ *
+ * \file cmprr.cpp
+ * ****************************************************************************/
+
+#include "api/capi/h/cmprr.h" /// Заголовок интерфейса
+#include "api/cCompressor/h/cCompressor.h" /// Интерфейс C++
+#include "blockFormat/h/cBlockFormat.h" /// Наибольший размер сжатых данных
+#include <cstring> /// std::memcpy
+#include <new> /// std::bad_alloc
+
+static_assert( int( CMPRR_ERROR_ALGORITHM ) == int( ERR_STATUS_BAD_ALG ) &&
+               int( CMPRR_ERROR_MEMORY_LIMIT ) == int( ERR_STATUS_MEMORY_LIMIT ),
+               "Коды ошибок C должны совпадать с eErrStatus" );
+static_assert( int( CMPRR_ALGORITHM_RLE ) == int( ALG_TYPE_RLE ) &&
+               int( CMPRR_ALGORITHM_HAFFMAN ) == int( ALG_TYPE_HFMN ),
+               "Алгоритмы C должны совпадать с eTypeOfComprAlgorithm" );
+static_assert( CMPRR_DEFAULT_BLOCK_SIZE == cCompressor::DEFAULT_BLOCK_SIZE,
+               "Размер блока по умолчанию C и C++ должен совпадать" );
+
+/// \brief Выполнить вызов, не выпуская исключения за пределы библиотеки
+/// \param [in] call Вызов, возвращающий статус
+/// \return Статус вызова, CMPRR_ERROR_NO_MEMORY или CMPRR_ERROR_INTERNAL
+template< typename F >
+static cmprr_status guard( F &&call ) noexcept
+{
+    try
+    {
+        return call();
+    }
+    catch( const std::bad_alloc & )
+    {
+        return CMPRR_ERROR_NO_MEMORY;
+    }
+    catch( ... )
+    {
+        return CMPRR_ERROR_INTERNAL;
+    }
+}
+
+/// \brief Скопировать результат в буфер вызывающего
+/// \param [in] data Результат
+/// \param [out] dst Буфер
+/// \param [in] dstCapacity Размер буфера
+/// \param [out] dstSize Размер результата
+/// \return CMPRR_OK или CMPRR_ERROR_BUFFER_TOO_SMALL
+static cmprr_status copyResult( std::string_view data, void *dst, size_t dstCapacity, size_t *dstSize )
+{
+    *dstSize = data.size();
+    if( data.size() > dstCapacity )
+        return CMPRR_ERROR_BUFFER_TOO_SMALL;
+
+    std::memcpy( dst, data.data(), data.size() );
+    return CMPRR_OK;
+}
+
+/// \brief Скопировать путь до результата в буфер вызывающего
+/// \param [in] path Путь
+/// \param [out] resultPath Буфер. Может быть nullptr
+/// \param [in] resultCapacity Размер буфера
+/// \return CMPRR_OK или CMPRR_ERROR_BUFFER_TOO_SMALL
+static cmprr_status copyPath( const std::string &path, char *resultPath, size_t resultCapacity )
+{
+    if( nullptr == resultPath )
+        return CMPRR_OK;
+
+    if( path.size() >= resultCapacity )
+        return CMPRR_ERROR_BUFFER_TOO_SMALL;
+
+    std::memcpy( resultPath, path.c_str(), path.size() + 1 );
+    return CMPRR_OK;
+}
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+size_t cmprr_compress_bound( size_t raw_size, size_t block_size )
+{
+    return cBlockFormat::getCompressBound( raw_size, block_size ? block_size : raw_size,
+                                           cBlockFormat::FLAG_CHECKSUMS );
+}
+
+cmprr_status cmprr_compress( cmprr_algorithm algorithm, const void *src, size_t src_size,
+                             size_t block_size, void *dst, size_t dst_capacity, size_t *dst_size )
+{
+    if( ( nullptr == src && 0 != src_size ) || nullptr == dst || nullptr == dst_size )
+        return CMPRR_ERROR_ARGUMENT;
+
+    return guard( [ & ]( void )
+    {
+        const auto [ result, status ] = cCompressor::compress( eTypeOfComprAlgorithm( algorithm ),
+                                                               std::string_view( static_cast< const char * >( src ),
+                                                                                 src_size ),
+                                                               block_size );
+        return ERR_STATUS_SUCCESS == status ? copyResult( result, dst, dst_capacity, dst_size )
+                                            : cmprr_status( status );
+    } );
+}
+
+cmprr_status cmprr_get_raw_size( const void *src, size_t src_size, uint64_t *raw_size )
+{
+    if( ( nullptr == src && 0 != src_size ) || nullptr == raw_size )
+        return CMPRR_ERROR_ARGUMENT;
+
+    return guard( [ & ]( void )
+    {
+        const auto [ rawSize, status ] = cCompressor::getRawSize( std::string_view( static_cast< const char * >( src ),
+                                                                                    src_size ) );
+        *raw_size = rawSize;
+        return cmprr_status( status );
+    } );
+}
+
+cmprr_status cmprr_decompress( const void *src, size_t src_size, void *dst, size_t dst_capacity,
+                               size_t *dst_size )
+{
+    if( ( nullptr == src && 0 != src_size ) || nullptr == dst || nullptr == dst_size )
+        return CMPRR_ERROR_ARGUMENT;
+
+    return guard( [ & ]( void )
+    {
+        const std::string_view data( static_cast< const char * >( src ), src_size );
+
+        /// Размер проверяется до распаковки
+        const auto [ rawSize, sizeStatus ] = cCompressor::getRawSize( data );
+        if( ERR_STATUS_SUCCESS != sizeStatus )
+            return cmprr_status( sizeStatus );
+
+        *dst_size = rawSize;
+        if( rawSize > dst_capacity )
+            return CMPRR_ERROR_BUFFER_TOO_SMALL;
+
+        const auto [ result, status ] = cCompressor::decompress( data );
+        return ERR_STATUS_SUCCESS == status ? copyResult( result, dst, dst_capacity, dst_size )
+                                            : cmprr_status( status );
+    } );
+}
+
+cmprr_status cmprr_compress_file( cmprr_algorithm algorithm, const char *path, size_t block_size,
+                                  char *result_path, size_t result_capacity )
+{
+    if( nullptr == path )
+        return CMPRR_ERROR_ARGUMENT;
+
+    return guard( [ & ]( void )
+    {
+        const auto [ resultPath, status ] = cCompressor::compressFile( eTypeOfComprAlgorithm( algorithm ), path,
+                                                                       block_size );
+        return ERR_STATUS_SUCCESS == status ? copyPath( resultPath, result_path, result_capacity )
+                                            : cmprr_status( status );
+    } );
+}
+
+cmprr_status cmprr_decompress_file( const char *path, char *result_path, size_t result_capacity )
+{
+    if( nullptr == path )
+        return CMPRR_ERROR_ARGUMENT;
+
+    return guard( [ & ]( void )
+    {
+        const auto [ resultPath, status ] = cCompressor::decompressFile( path );
+        return ERR_STATUS_SUCCESS == status ? copyPath( resultPath, result_path, result_capacity )
+                                            : cmprr_status( status );
+    } );
+}
+
+void cmprr_set_thread_count( size_t thread_count )
+{
+    cCompressor::setThreadCount( thread_count );
+}
+
+void cmprr_set_memory_limit( uint64_t limit )
+{
+    cCompressor::setMemoryLimit( limit );
+}
+
+const char *cmprr_get_status_text( cmprr_status status )
+{
+    switch( status )
+    {
+    case CMPRR_OK:
+        return "success";
+    case CMPRR_ERROR_ALGORITHM:
+        return "algorithm error";
+    case CMPRR_ERROR_FILE_OPEN:
+        return "cannot open file";
+    case CMPRR_ERROR_POSTFIX:
+        return "file postfix does not match the algorithm";
+    case CMPRR_ERROR_EMPTY:
+        return "empty input";
+    case CMPRR_ERROR_FORMAT:
+        return "corrupted or truncated compressed data";
+    case CMPRR_ERROR_FILE_WRITE:
+        return "cannot write file";
+    case CMPRR_ERROR_CANCELED:
+        return "canceled";
+    case CMPRR_ERROR_MEMORY_LIMIT:
+        return "memory limit exceeded";
+    case CMPRR_ERROR_BUFFER_TOO_SMALL:
+        return "destination buffer is too small";
+    case CMPRR_ERROR_ARGUMENT:
+        return "invalid argument";
+    case CMPRR_ERROR_NO_MEMORY:
+        return "out of memory";
+    case CMPRR_ERROR_INTERNAL:
+        return "internal library error";
+    }
+
+    return "unknown status";
+}
@@ -0,0 +1,156 @@
+/** ****************************************************************************
+ * \file cArchiveFormat.h
+ * ****************************************************************************/
+
+/** ****************************************************************************
+ * \defgroup Archive Архив
+ *
+ * \brief Предназначен для хранения множества сжатых файлов в одном
+ *
+ * \details Состоит из описания формата - \ref ArchiveFormat, записи -
+ * \ref ArchiveWriter и чтения - \ref ArchiveReader
+ *
+ * ****************************************************************************/
+
+/** ****************************************************************************
+ * \defgroup ArchiveFormat Формат архива
+ * @{
+ * \ingroup Archive
+ *
+ * \brief Модуль, описывающий формат архива
+ *
+ * \details Архив:
+ * [ < Файлы > < Имена > < Индекс > < Концевик (40 байт) > ].
+ *
+ * Каждый файл (элемент архива) хранится так же, как отдельный сжатый файл, -
+ * в блочном формате \ref BlockFormat. Пустой файл данных не содержит.
+ *
+ * Индекс расположен в конце, поэтому архив пишется за один проход: файлы
+ * добавляются по мере сжатия, а индекс и концевик - при закрытии. Все числа
+ * записываются старшим байтом вперед.
+ *
+ * Запись индекса (48 байт), записи упорядочены по именам побайтно:
+ * - 8 байт - смещение имени в архиве;
+ * - 4 байта - длина имени;
+ * - 1 байт - тип алгоритма \ref eTypeOfComprAlgorithm;
+ * - 3 байта - зарезервировано;
+ * - 8 байт - смещение сжатых данных в архиве;
+ * - 8 байт - размер сжатых данных;
+ * - 8 байт - размер исходного файла;
+ * - 4 байта - CRC32C исходного файла \ref Checksum;
+ * - 4 байта - зарезервировано.
+ *
+ * Записи фиксированного размера, поэтому индекс читается прямо из
+ * отображенного в память архива: запись с номером i находится по смещению,
+ * а поиск по имени - двоичный. Разбирать индекс целиком не нужно.
+ *
+ * Концевик:
+ * - 4 байта - сигнатура "CMPA";
+ * - 1 байт - версия формата;
+ * - 3 байта - зарезервировано;
+ * - 8 байт - смещение имен;
+ * - 8 байт - смещение индекса;
+ * - 8 байт - количество файлов;
+ * - 4 байта - CRC32C имен и индекса;
+ * - 4 байта - зарезервировано.
+ *
+ * Реализован с поиощью класса \ref cArchiveFormat
+ * ****************************************************************************/
+
+#ifndef CARCHIVEFORMAT_H
+#define CARCHIVEFORMAT_H
+
+#include "common.h" /// Общие константы программы
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+#include <tuple> /// Кортежи
+
+/// \brief Класс, реализующий чтение и запись индекса архива
+/// \class cArchiveFormat
+class cArchiveFormat final
+{
+public:
+    /// \brief Структура, описывающая файл в архиве
+    /// \struct sMember
+    struct sMember
+    {
+        /// \brief Имя файла. При чтении - представление отображенного архива
+        std::string_view mName;
+        /// \brief Алгоритм, которым сжат файл
+        eTypeOfComprAlgorithm mAlgType = ALG_TYPE_RLE;
+        /// \brief Смещение сжатых данных в архиве
+        uint64_t mOffset = 0;
+        /// \brief Размер сжатых данных
+        uint64_t mCmprSize = 0;
+        /// \brief Размер исходного файла
+        uint64_t mRawSize = 0;
+        /// \brief CRC32C исходного файла
+        uint32_t mChecksum = 0;
+    };
+
+    /// \brief Структура, описывающая концевик архива
+    /// \struct sTrailer
+    struct sTrailer
+    {
+        /// \brief Смещение имен
+        uint64_t mNamesOffset = 0;
+        /// \brief Смещение индекса
+        uint64_t mIndexOffset = 0;
+        /// \brief Количество файлов
+        uint64_t mMemberCount = 0;
+        /// \brief CRC32C имен и индекса
+        uint32_t mIndexChecksum = 0;
+    };
+
+    /// \brief Размер записи индекса
+    constexpr static size_t ENTRY_SIZE = 48;
+    /// \brief Размер концевика
+    constexpr static size_t TRAILER_SIZE = 40;
+    /// \brief Текущая версия формата
+    constexpr static uint8_t FORMAT_VERSION = 1;
+
+    /// \brief Сериализовать запись индекса
+    /// \param [in] member Файл
+    /// \param [in] nameOffset Смещение имени в архиве
+    /// \return Байты записи
+    static std::string writeEntry( const sMember &member, uint64_t nameOffset );
+
+    /// \brief Сериализовать концевик
+    /// \param [in] trailer Концевик
+    /// \return Байты концевика
+    static std::string writeTrailer( const sTrailer &trailer );
+
+    /// \brief Прочитать и проверить концевик
+    ///
+    /// \details Проверяется сигнатура, версия, расположение имен и индекса и
+    /// контрольная сумма индекса
+    ///
+    /// \param [in] archive Архив целиком
+    ///
+    /// \return Концевик и статус:
+    /// ERR_STATUS_SUCCESS - концевик корректен,
+    /// ERR_STATUS_BAD_FORMAT - данные не являются архивом или индекс испорчен
+    static std::tuple< sTrailer, eErrStatus > readTrailer( std::string_view archive );
+
+    /// \brief Прочитать запись индекса
+    ///
+    /// \param [in] archive Архив целиком
+    /// \param [in] trailer Концевик, прочитанный \ref readTrailer
+    /// \param [in] index Номер записи, меньше количества файлов
+    ///
+    /// \return Файл и статус:
+    /// ERR_STATUS_SUCCESS - запись корректна,
+    /// ERR_STATUS_BAD_FORMAT - имя или данные вне своих областей архива
+    static std::tuple< sMember, eErrStatus > readEntry( std::string_view archive,
+                                                       const sTrailer &trailer,
+                                                       size_t index );
+
+private:
+    /// \brief Сигнатура формата
+    constexpr static char SIGNATURE[] = { 'C', 'M', 'P', 'A' };
+};
+
+/// @}
+
+#endif // CARCHIVEFORMAT_H
@@ -0,0 +1,127 @@
+/** ****************************************************************************
+ * \brief Исходные коды формата архива
+ *
+ * \file cArchiveFormat.cpp
+ * ****************************************************************************/
+
+#include "archive/cArchiveFormat/h/cArchiveFormat.h" /// Заголовок класса
+#include "algorithm/cAlgorithmRegistry/h/cAlgorithmRegistry.h" /// Известные типы алгоритмов
+#include "blockFormat/h/cBlockFormat.h" /// Запись и чтение чисел
+#include "checksum/h/cChecksum.h" /// Контрольные суммы
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+std::string cArchiveFormat::writeEntry( const sMember &member, uint64_t nameOffset )
+{
+    std::string result;
+    result.reserve( ENTRY_SIZE );
+
+    cBlockFormat::appendBigEndian< uint64_t >( result, nameOffset );
+    cBlockFormat::appendBigEndian< uint32_t >( result, member.mName.size() );
+    cBlockFormat::appendBigEndian< uint8_t >( result, member.mAlgType );
+    result.append( 3, '\0' );
+    cBlockFormat::appendBigEndian< uint64_t >( result, member.mOffset );
+    cBlockFormat::appendBigEndian< uint64_t >( result, member.mCmprSize );
+    cBlockFormat::appendBigEndian< uint64_t >( result, member.mRawSize );
+    cBlockFormat::appendBigEndian< uint32_t >( result, member.mChecksum );
+    cBlockFormat::appendBigEndian< uint32_t >( result, 0 );
+
+    return result;
+}
+
+std::string cArchiveFormat::writeTrailer( const sTrailer &trailer )
+{
+    std::string result;
+    result.reserve( TRAILER_SIZE );
+
+    result.append( SIGNATURE, sizeof( SIGNATURE ) );
+    cBlockFormat::appendBigEndian< uint8_t >( result, FORMAT_VERSION );
+    result.append( 3, '\0' );
+    cBlockFormat::appendBigEndian< uint64_t >( result, trailer.mNamesOffset );
+    cBlockFormat::appendBigEndian< uint64_t >( result, trailer.mIndexOffset );
+    cBlockFormat::appendBigEndian< uint64_t >( result, trailer.mMemberCount );
+    cBlockFormat::appendBigEndian< uint32_t >( result, trailer.mIndexChecksum );
+    cBlockFormat::appendBigEndian< uint32_t >( result, 0 );
+
+    return result;
+}
+
+std::tuple< cArchiveFormat::sTrailer, eErrStatus > cArchiveFormat::readTrailer( std::string_view archive )
+{
+    const auto badFormat = []( void )
+    {
+        return std::make_tuple( sTrailer(), ERR_STATUS_BAD_FORMAT );
+    };
+
+    if( archive.size() < TRAILER_SIZE )
+        return badFormat();
+
+    const std::string_view tail( archive.substr( archive.size() - TRAILER_SIZE ) );
+    if( tail.substr( 0, sizeof( SIGNATURE ) ) != std::string_view( SIGNATURE, sizeof( SIGNATURE ) ) ||
+        FORMAT_VERSION != cBlockFormat::readBigEndian< uint8_t >( tail, 4 ) )
+    {
+        return badFormat();
+    }
+
+    sTrailer trailer;
+    trailer.mNamesOffset = cBlockFormat::readBigEndian< uint64_t >( tail, 8 );
+    trailer.mIndexOffset = cBlockFormat::readBigEndian< uint64_t >( tail, 16 );
+    trailer.mMemberCount = cBlockFormat::readBigEndian< uint64_t >( tail, 24 );
+    trailer.mIndexChecksum = cBlockFormat::readBigEndian< uint32_t >( tail, 32 );
+
+    /// Имена, индекс и концевик идут подряд до конца архива
+    const uint64_t indexEnd = archive.size() - TRAILER_SIZE;
+    if( trailer.mNamesOffset > trailer.mIndexOffset || trailer.mIndexOffset > indexEnd ||
+        trailer.mMemberCount != ( indexEnd - trailer.mIndexOffset ) / ENTRY_SIZE ||
+        0 != ( indexEnd - trailer.mIndexOffset ) % ENTRY_SIZE )
+    {
+        return badFormat();
+    }
+
+    const std::string_view index( archive.substr( trailer.mNamesOffset, indexEnd - trailer.mNamesOffset ) );
+    if( cChecksum::crc32c( index ) != trailer.mIndexChecksum )
+        return badFormat();
+
+    return std::make_tuple( trailer, ERR_STATUS_SUCCESS );
+}
+
+std::tuple< cArchiveFormat::sMember, eErrStatus > cArchiveFormat::readEntry( std::string_view archive,
+                                                                             const sTrailer &trailer,
+                                                                             size_t index )
+{
+    const auto badFormat = []( void )
+    {
+        return std::make_tuple( sMember(), ERR_STATUS_BAD_FORMAT );
+    };
+
+    if( index >= trailer.mMemberCount )
+        return badFormat();
+
+    const std::string_view entry( archive.substr( trailer.mIndexOffset + index * ENTRY_SIZE, ENTRY_SIZE ) );
+    const uint64_t nameOffset = cBlockFormat::readBigEndian< uint64_t >( entry, 0 );
+    const uint32_t nameSize = cBlockFormat::readBigEndian< uint32_t >( entry, 8 );
+    const uint8_t algType = cBlockFormat::readBigEndian< uint8_t >( entry, 12 );
+
+    sMember member;
+    member.mAlgType = eTypeOfComprAlgorithm( algType );
+    member.mOffset = cBlockFormat::readBigEndian< uint64_t >( entry, 16 );
+    member.mCmprSize = cBlockFormat::readBigEndian< uint64_t >( entry, 24 );
+    member.mRawSize = cBlockFormat::readBigEndian< uint64_t >( entry, 32 );
+    member.mChecksum = cBlockFormat::readBigEndian< uint32_t >( entry, 40 );
+
+    /// Имя - в области имен, данные - до нее
+    if( !cAlgorithmRegistry::isKnown( algType ) ||
+        nameOffset < trailer.mNamesOffset || nameOffset > trailer.mIndexOffset ||
+        nameSize > trailer.mIndexOffset - nameOffset ||
+        member.mOffset > trailer.mNamesOffset || member.mCmprSize > trailer.mNamesOffset - member.mOffset ||
+        ( 0 == member.mCmprSize ) != ( 0 == member.mRawSize ) )
+    {
+        return badFormat();
+    }
+
+    member.mName = archive.substr( nameOffset, nameSize );
+
+    return std::make_tuple( member, ERR_STATUS_SUCCESS );
+}
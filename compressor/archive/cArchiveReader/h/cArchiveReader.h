@@ -0,0 +1,100 @@
+/** ****************************************************************************
+ * \file cArchiveReader.h
+ *
+ * \defgroup ArchiveReader Чтение архива
+ * @{
+ *
+ * \ingroup Archive
+ *
+ * \brief Модуль выборочного чтения файлов из архива
+ *
+ * \details Архив отображается в память (\ref InputSource) без упреждающего
+ * чтения. При открытии читается только концевик и проверяется контрольная
+ * сумма индекса; записи индекса разбираются по запросу прямо из отображения,
+ * поэтому список файлов доступен сразу, а извлечение одного файла читает
+ * только его сжатые данные.
+ *
+ * Извлеченный файл сверяется с CRC32C из индекса.
+ *
+ * Реализован с поиощью класса \ref cArchiveReader
+ * ****************************************************************************/
+
+#ifndef CARCHIVEREADER_H
+#define CARCHIVEREADER_H
+
+#include "common.h" /// Общие константы программы
+#include "algorithm/cAbstractAlgorithm/h/cAbstractAlgorithm.h" /// Интерфейс алгоритмов
+#include "archive/cArchiveFormat/h/cArchiveFormat.h" /// Формат архива
+#include "inputSource/h/cInputSource.h" /// Отображение архива в память
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+#include <tuple> /// Кортежи
+
+/// \brief Класс, реализующий чтение архива
+/// \class cArchiveReader
+class cArchiveReader final
+{
+public:
+    /// \brief Открыть архив
+    /// \param [in] path Путь до архива
+    /// \return Статус выполнения:
+    /// ERR_STATUS_SUCCESS - успех,
+    /// ERR_STATUS_BAD_FILE_OPEN - ошибка открытия файла,
+    /// ERR_STATUS_BAD_FORMAT - файл не является архивом или индекс испорчен
+    eErrStatus open( std::string_view path );
+
+    /// \brief Закрыть архив. Имена, полученные из архива, становятся
+    /// недействительными
+    void close( void );
+
+    /// \brief Проверить, открыт ли архив
+    /// \return true - архив открыт
+    inline bool isOpen( void ) const noexcept { return mIsOpen; }
+
+    /// \brief Получить количество файлов в архиве
+    /// \return Количество файлов
+    inline size_t getMemberCount( void ) const noexcept { return mTrailer.mMemberCount; }
+
+    /// \brief Получить описание файла
+    /// \param [in] index Номер файла в порядке имен
+    /// \return Файл и статус:
+    /// ERR_STATUS_SUCCESS - успех,
+    /// ERR_STATUS_BAD_FORMAT - номер вне архива или запись испорчена
+    std::tuple< cArchiveFormat::sMember, eErrStatus > getMember( size_t index ) const;
+
+    /// \brief Найти файл по имени двоичным поиском
+    /// \param [in] name Имя файла в архиве
+    /// \return Номер файла и статус:
+    /// ERR_STATUS_SUCCESS - файл найден,
+    /// ERR_STATUS_BAD_FILE_OPEN - файла нет в архиве,
+    /// ERR_STATUS_BAD_FORMAT - индекс испорчен
+    std::tuple< size_t, eErrStatus > find( std::string_view name ) const;
+
+    /// \brief Распаковать файл в память
+    ///
+    /// \param [in] index Номер файла
+    /// \param [in] algorithm Интерфейс алгоритма, которым сжат файл
+    ///
+    /// \return Содержимое файла и статус:
+    /// ERR_STATUS_SUCCESS - успех,
+    /// ERR_STATUS_BAD_POSTFIX - файл сжат другим алгоритмом,
+    /// ERR_STATUS_BAD_ALG - если выполнение алгоритма привело к ошибке,
+    /// ERR_STATUS_BAD_FORMAT - запись испорчена или содержимое не совпало с
+    /// контрольной суммой
+    std::tuple< std::string, eErrStatus > readMember( size_t index, cAbstractAlgorithm &algorithm ) const;
+
+private:
+    /// \brief Отображение архива
+    cInputSource mFile;
+    /// \brief Содержимое архива
+    std::string_view mArchive;
+    /// \brief Концевик архива
+    cArchiveFormat::sTrailer mTrailer;
+    /// \brief Флаг открытого архива
+    bool mIsOpen = false;
+};
+
+/// @}
+
+#endif // CARCHIVEREADER_H
@@ -0,0 +1,101 @@
+/** ****************************************************************************
+ * \brief Исходные коды чтения архива
+ *
+ * \file cArchiveReader.cpp
+ * ****************************************************************************/
+
+#include "archive/cArchiveReader/h/cArchiveReader.h" /// Заголовок класса
+#include "cFileWorker/h/cFileWorker.h" /// Распаковка в память
+#include "checksum/h/cChecksum.h" /// Контрольные суммы
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+eErrStatus cArchiveReader::open( std::string_view path )
+{
+    close();
+
+    /// Архив читается выборочно - упреждающее чтение только мешает
+    eErrStatus status = mFile.open( path, cInputSource::ACCESS_RANDOM );
+    if( ERR_STATUS_SUCCESS != status )
+        return status;
+
+    std::tie( mArchive, status ) = mFile.getData();
+    if( ERR_STATUS_SUCCESS != status )
+    {
+        close();
+        return status;
+    }
+
+    std::tie( mTrailer, status ) = cArchiveFormat::readTrailer( mArchive );
+    if( ERR_STATUS_SUCCESS != status )
+    {
+        close();
+        return status;
+    }
+
+    mIsOpen = true;
+
+    return ERR_STATUS_SUCCESS;
+}
+
+void cArchiveReader::close( void )
+{
+    mFile.close();
+    mArchive = std::string_view();
+    mTrailer = cArchiveFormat::sTrailer();
+    mIsOpen = false;
+}
+
+std::tuple< cArchiveFormat::sMember, eErrStatus > cArchiveReader::getMember( size_t index ) const
+{
+    return cArchiveFormat::readEntry( mArchive, mTrailer, index );
+}
+
+std::tuple< size_t, eErrStatus > cArchiveReader::find( std::string_view name ) const
+{
+    /// Записи упорядочены по именам
+    size_t begin = 0;
+    size_t end = getMemberCount();
+    while( begin < end )
+    {
+        const size_t middle = begin + ( end - begin ) / 2;
+        const auto [ member, status ] = getMember( middle );
+        if( ERR_STATUS_SUCCESS != status )
+            return std::make_tuple( size_t( 0 ), status );
+
+        if( member.mName == name )
+            return std::make_tuple( middle, ERR_STATUS_SUCCESS );
+
+        if( member.mName < name )
+            begin = middle + 1;
+        else
+            end = middle;
+    }
+
+    return std::make_tuple( size_t( 0 ), ERR_STATUS_BAD_FILE_OPEN );
+}
+
+std::tuple< std::string, eErrStatus > cArchiveReader::readMember( size_t index, cAbstractAlgorithm &algorithm ) const
+{
+    const auto [ member, entryStatus ] = getMember( index );
+    if( ERR_STATUS_SUCCESS != entryStatus )
+        return std::make_tuple( std::string(), entryStatus );
+
+    if( member.mAlgType != algorithm.getType() )
+        return std::make_tuple( std::string(), ERR_STATUS_BAD_POSTFIX );
+
+    if( 0 == member.mRawSize )
+        return std::make_tuple( std::string(), ERR_STATUS_SUCCESS );
+
+    auto [ result, status ] = cFileWorker::decompressData( algorithm,
+                                                           mArchive.substr( member.mOffset, member.mCmprSize ) );
+    if( ERR_STATUS_SUCCESS != status )
+        return std::make_tuple( std::string(), status );
+
+    if( result.size() != member.mRawSize || cChecksum::crc32c( result ) != member.mChecksum )
+        return std::make_tuple( std::string(), ERR_STATUS_BAD_FORMAT );
+
+    return std::make_tuple( std::move( result ), ERR_STATUS_SUCCESS );
+}
@@ -0,0 +1,124 @@
+/** ****************************************************************************
+ * \file cArchiveWriter.h
+ *
+ * \defgroup ArchiveWriter Запись архива
+ * @{
+ *
+ * \ingroup Archive
+ *
+ * \brief Модуль, создающий архив из множества файлов
+ *
+ * \details Каждый файл сжимается в память (\ref cFileWorker::compressData) и
+ * дописывается в конец архива. Сжатие идет вне блокировки, поэтому файлы
+ * можно добавлять из нескольких потоков одновременно: под мьютексом только
+ * резервируется место и запоминается запись индекса, а сама запись
+ * позиционная (\ref IoBackend).
+ *
+ * Архив пишется во временный файл рядом с итоговым (постфикс
+ * \ref cFileWorker::TEMP_POSTFIX) и переименовывается при закрытии, после
+ * записи индекса. Если архив не закрыт, временный файл удаляется.
+ *
+ * Реализован с поиощью класса \ref cArchiveWriter
+ * ****************************************************************************/
+
+#ifndef CARCHIVEWRITER_H
+#define CARCHIVEWRITER_H
+
+#include "common.h" /// Общие константы программы
+#include "algorithm/cAbstractAlgorithm/h/cAbstractAlgorithm.h" /// Интерфейс алгоритмов
+#include "archive/cArchiveFormat/h/cArchiveFormat.h" /// Формат архива
+#include "cFileWorker/h/cFileWorker.h" /// Сжатие в память
+#include "ioBackend/cAbstractIoBackend/h/cAbstractIoBackend.h" /// Подсистемы записи
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <memory> /// Умные указатели
+#include <mutex> /// Мьютексы
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+#include <unordered_set> /// Множества имен
+#include <vector> /// Вектор
+
+/// \brief Класс, реализующий запись архива
+/// \class cArchiveWriter
+class cArchiveWriter final
+{
+public:
+    /// \brief Конструктор класса
+    cArchiveWriter( void ) = default;
+
+    /// \brief Деструктор класса. Незакрытый архив удаляется
+    ~cArchiveWriter( void );
+
+    cArchiveWriter( const cArchiveWriter & ) = delete;
+    cArchiveWriter &operator=( const cArchiveWriter & ) = delete;
+
+    /// \brief Начать новый архив
+    /// \param [in] path Путь до архива. Существующий архив заменяется при
+    /// закрытии
+    /// \return ERR_STATUS_SUCCESS в случае успеха, ERR_STATUS_BAD_FILE_OPEN
+    /// в случае ошибки создания временного файла
+    eErrStatus open( std::string_view path );
+
+    /// \brief Сжать и добавить файл. Может вызываться из нескольких потоков
+    ///
+    /// \param [in] name Имя файла в архиве
+    /// \param [in] algorithm Интерфейс алгоритма
+    /// \param [in] data Содержимое файла. Может быть пустым
+    /// \param [in] blockSize Размер блока, см. \ref cFileWorker::setBlockSize
+    ///
+    /// \return Статус выполнения:
+    /// ERR_STATUS_SUCCESS - успех,
+    /// ERR_STATUS_BAD_FILE_OPEN - архив не открыт,
+    /// ERR_STATUS_BAD_ALG - если выполнение алгоритма привело к ошибке,
+    /// ERR_STATUS_BAD_FILE_WRITE - ошибка записи или файл с таким именем
+    /// уже добавлен
+    eErrStatus addMember( std::string_view name,
+                          cAbstractAlgorithm &algorithm,
+                          std::string_view data,
+                          uint64_t blockSize = cFileWorker::DEFAULT_BLOCK_SIZE );
+
+    /// \brief Записать индекс и закрыть архив
+    /// \return ERR_STATUS_SUCCESS в случае успеха, ERR_STATUS_BAD_FILE_OPEN,
+    /// если архив не открыт, ERR_STATUS_BAD_FILE_WRITE в случае ошибки записи.
+    /// При ошибке временный файл удаляется
+    eErrStatus close( void );
+
+    /// \brief Проверить, открыт ли архив
+    /// \return true - архив открыт
+    inline bool isOpen( void ) const noexcept { return nullptr != mpFile; }
+
+private:
+    /// \brief Структура, описывающая добавленный файл
+    /// \struct sPendingMember
+    struct sPendingMember
+    {
+        /// \brief Имя файла
+        std::string mName;
+        /// \brief Запись индекса. Имя заполняется при закрытии
+        cArchiveFormat::sMember mMember;
+    };
+
+    /// \brief Закрыть и удалить временный файл
+    void discard( void );
+
+    /// \brief Временный файл архива
+    std::unique_ptr< cAbstractIoBackend > mpFile;
+    /// \brief Путь до архива
+    std::string mPath;
+    /// \brief Путь до временного файла
+    std::string mTempPath;
+    /// \brief Смещение конца данных
+    uint64_t mWriteOffset = 0;
+    /// \brief Добавленные файлы
+    std::vector< sPendingMember > mMembers;
+    /// \brief Имена добавленных файлов
+    std::unordered_set< std::string > mNames;
+    /// \brief Ошибка записи с момента открытия
+    bool mIsFailed = false;
+
+    /// \brief Мьютекс смещения и списка файлов
+    std::mutex mMutex;
+};
+
+/// @}
+
+#endif // CARCHIVEWRITER_H
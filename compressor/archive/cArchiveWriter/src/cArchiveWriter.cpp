@@ -0,0 +1,156 @@
+/** ****************************************************************************
+ * \brief Исходные коды записи архива
+ *
+ * \file cArchiveWriter.cpp
+ * ****************************************************************************/
+
+#include "archive/cArchiveWriter/h/cArchiveWriter.h" /// Заголовок класса
+#include "checksum/h/cChecksum.h" /// Контрольные суммы
+#include <algorithm> /// std::sort
+#include <cstdio> /// std::rename, std::remove
+#include <tuple> /// Кортежи
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+cArchiveWriter::~cArchiveWriter( void )
+{
+    discard();
+}
+
+eErrStatus cArchiveWriter::open( std::string_view path )
+{
+    discard();
+
+    mPath = path;
+    mTempPath = mPath + cFileWorker::TEMP_POSTFIX;
+
+    mpFile = cAbstractIoBackend::create( IO_TYPE_URING, false );
+    if( ERR_STATUS_SUCCESS != mpFile->open( mTempPath ) )
+    {
+        mpFile.reset();
+        return ERR_STATUS_BAD_FILE_OPEN;
+    }
+
+    return ERR_STATUS_SUCCESS;
+}
+
+eErrStatus cArchiveWriter::addMember( std::string_view name,
+                                      cAbstractAlgorithm &algorithm,
+                                      std::string_view data,
+                                      uint64_t blockSize )
+{
+    if( !isOpen() )
+        return ERR_STATUS_BAD_FILE_OPEN;
+
+    sPendingMember pending;
+    pending.mName = name;
+    pending.mMember.mAlgType = algorithm.getType();
+    pending.mMember.mRawSize = data.size();
+    pending.mMember.mChecksum = cChecksum::crc32c( data );
+
+    /// Пустой файл хранится только в индексе
+    std::string compressed;
+    if( !data.empty() )
+    {
+        eErrStatus status;
+        std::tie( compressed, status ) = cFileWorker::compressData( algorithm, data, blockSize );
+        if( ERR_STATUS_SUCCESS != status )
+            return status;
+    }
+
+    pending.mMember.mCmprSize = compressed.size();
+
+    /// Под мьютексом только резервируется место
+    {
+        std::lock_guard< std::mutex > lock( mMutex );
+        if( !mNames.insert( pending.mName ).second )
+            return ERR_STATUS_BAD_FILE_WRITE;
+
+        pending.mMember.mOffset = mWriteOffset;
+        mWriteOffset += compressed.size();
+        mMembers.push_back( pending );
+    }
+
+    if( !mpFile->write( pending.mMember.mOffset, compressed ) )
+    {
+        std::lock_guard< std::mutex > lock( mMutex );
+        mIsFailed = true;
+        return ERR_STATUS_BAD_FILE_WRITE;
+    }
+
+    return ERR_STATUS_SUCCESS;
+}
+
+eErrStatus cArchiveWriter::close( void )
+{
+    if( !isOpen() )
+        return ERR_STATUS_BAD_FILE_OPEN;
+
+    std::lock_guard< std::mutex > lock( mMutex );
+
+    /// Записи индекса упорядочены по именам для двоичного поиска
+    std::sort( mMembers.begin(), mMembers.end(),
+               []( const sPendingMember &left, const sPendingMember &right )
+               {
+                   return left.mName < right.mName;
+               } );
+
+    cArchiveFormat::sTrailer trailer;
+    trailer.mNamesOffset = mWriteOffset;
+    trailer.mMemberCount = mMembers.size();
+
+    std::string index;
+    for( const sPendingMember &pending : mMembers )
+        index += pending.mName;
+
+    trailer.mIndexOffset = trailer.mNamesOffset + index.size();
+
+    uint64_t nameOffset = trailer.mNamesOffset;
+    for( sPendingMember &pending : mMembers )
+    {
+        pending.mMember.mName = pending.mName;
+        index += cArchiveFormat::writeEntry( pending.mMember, nameOffset );
+        nameOffset += pending.mName.size();
+    }
+
+    trailer.mIndexChecksum = cChecksum::crc32c( index );
+    index += cArchiveFormat::writeTrailer( trailer );
+
+    const bool isWritten = !mIsFailed && mpFile->write( trailer.mNamesOffset, index ) && mpFile->flush();
+    mpFile->close();
+    mpFile.reset();
+
+    mMembers.clear();
+    mNames.clear();
+    mWriteOffset = 0;
+    mIsFailed = false;
+
+    if( !isWritten || 0 != std::rename( mTempPath.c_str(), mPath.c_str() ) )
+    {
+        std::remove( mTempPath.c_str() );
+        return ERR_STATUS_BAD_FILE_WRITE;
+    }
+
+    return ERR_STATUS_SUCCESS;
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+void cArchiveWriter::discard( void )
+{
+    if( isOpen() )
+    {
+        mpFile->close();
+        mpFile.reset();
+        std::remove( mTempPath.c_str() );
+    }
+
+    mMembers.clear();
+    mNames.clear();
+    mWriteOffset = 0;
+    mIsFailed = false;
+}
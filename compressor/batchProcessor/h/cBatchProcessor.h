@@ -0,0 +1,209 @@
+/** ****************************************************************************
+ * \file cBatchProcessor.h
+ *
+ * \defgroup BatchProcessor Пакетная обработка
+ * @{
+ *
+ * \brief Модуль пакетного сжатия/распаковки множества файлов
+ *
+ * \details Принимает дерево директорий или список файлов и применяет к каждому
+ * файлу выбранный алгоритм. Каждый файл - отдельное задание со своим
+ * \ref cFileWorker и своим временным файлом рядом с исходным, поэтому задания
+ * не мешают друг другу.
+ *
+ * Задания выполняются в общем пуле \ref ThreadPool в порядке возрастания
+ * размера файлов (сначала короткие). Большие файлы внутри задания делятся на
+ * блоки \ref BlockFormat, которые ставятся в тот же пул, поэтому ядра заняты и
+ * в конце пакета, когда остаются только большие файлы.
+ *
+ * Вместо отдельного сжатого файла на каждый исходный файлы можно упаковать в
+ * один архив \ref Archive (\ref cBatchProcessor::pack) и извлечь обратно
+ * (\ref cBatchProcessor::unpack). Файлы сжимаются теми же параллельными
+ * заданиями, а в файловой системе создается один файл вместо множества.
+ *
+ * По завершении формируется отчет: результат по каждому файлу, общий объем
+ * исходных данных и пропускная способность.
+ *
+ * Реализован с поиощью класса \ref cBatchProcessor
+ * ****************************************************************************/
+
+#ifndef CBATCHPROCESSOR_H
+#define CBATCHPROCESSOR_H
+
+#include "common.h" /// Общие константы программы
+#include "algorithm/cAbstractAlgorithm/h/cAbstractAlgorithm.h" /// Интерфейс алгоритмов
+#include "cFileWorker/h/cFileWorker.h" /// Класс для работы с файлами
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <functional> /// Обертки функций
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+#include <tuple> /// Кортежи
+#include <vector> /// Вектор
+
+/// \brief Класс, реализующий пакетную обработку файлов
+/// \class cBatchProcessor
+class cBatchProcessor final
+{
+public:
+    /// \brief Структура, описывающая результат обработки одного файла
+    /// \struct sFileResult
+    struct sFileResult
+    {
+        /// \brief Исходный файл
+        std::string mSrcPath;
+        /// \brief Созданный файл
+        std::string mNewPath;
+        /// \brief Размер исходного файла
+        uint64_t mSrcSize = 0;
+        /// \brief Статус выполнения
+        eErrStatus mStatus = ERR_STATUS_SUCCESS;
+        /// \brief Статистика обработки. Заполняется только \ref run
+        cJobStats::sReport mStats;
+    };
+
+    /// \brief Структура, описывающая отчет о пакетной обработке
+    /// \struct sReport
+    struct sReport
+    {
+        /// \brief Результаты по файлам в порядке обработки
+        std::vector< sFileResult > mFiles;
+        /// \brief Объем исходных данных успешно обработанных файлов
+        uint64_t mTotalBytes = 0;
+        /// \brief Количество файлов, обработанных с ошибкой
+        size_t mFailedCount = 0;
+        /// \brief Время обработки в секундах
+        double mSeconds = 0.0;
+
+        /// \brief Пропускная способность
+        /// \return Мегабайт исходных данных в секунду
+        inline double getThroughput( void ) const noexcept
+        {
+            return mSeconds > 0.0 ? mTotalBytes / mSeconds / ( 1024.0 * 1024.0 ) : 0.0;
+        }
+    };
+
+    /// \brief Размер файла, начиная с которого результат пишется в обход
+    /// страничного кэша. Мелкие файлы быстрее записать через кэш
+    constexpr static uint64_t DIRECT_IO_MIN_SIZE = 64 * 1024 * 1024;
+
+    /// \brief Собрать файлы для обработки из дерева директорий
+    ///
+    /// \details При сжатии берутся все обычные файлы, кроме уже сжатых
+    /// выбранным алгоритмом и временных. При распаковке - только файлы с
+    /// постфиксом алгоритма. Недоступные директории пропускаются
+    ///
+    /// \param [in] dirPath Корневая директория
+    /// \param [in] algorithm Интерфейс алгоритма
+    /// \param [in] action ACT_TYPE_COMPR - сжатие ACT_TYPE_DECOMPR - распаковка
+    ///
+    /// \return Пути к файлам
+    static std::vector< std::string > collectFiles( std::string_view dirPath,
+                                                    const cAbstractAlgorithm &algorithm,
+                                                    eTypeOfActions action );
+
+    /// \brief Обработать список файлов
+    ///
+    /// \details Блокирует вызывающий поток до завершения всех заданий. Вызов
+    /// из рабочего потока пула допустим - поток участвует в обработке
+    ///
+    /// \param [in] files Пути к файлам
+    /// \param [in] algorithm Интерфейс алгоритма
+    /// \param [in] action ACT_TYPE_COMPR - сжатие ACT_TYPE_DECOMPR - распаковка
+    /// \param [in] job Задание: получает общий объем файлов и отчеты по
+    /// блокам. После отмены оставшиеся файлы получают статус
+    /// ERR_STATUS_CANCELED. Может быть nullptr
+    /// \param [in] blockSize Размер блока для сжатия, см. \ref cFileWorker::setBlockSize
+    ///
+    /// \return Отчет о пакетной обработке
+    static sReport run( const std::vector< std::string > &files,
+                        cAbstractAlgorithm &algorithm,
+                        eTypeOfActions action,
+                        cJob *job = nullptr,
+                        uint64_t blockSize = cFileWorker::DEFAULT_BLOCK_SIZE );
+
+    /// \brief Упаковать файлы в архив
+    ///
+    /// \details Файлы сжимаются параллельно и добавляются в архив под
+    /// именами относительно корневой директории. Файлы, обработанные с
+    /// ошибкой, в архив не попадают. После отмены архив не создается
+    ///
+    /// \param [in] rootPath Корневая директория файлов
+    /// \param [in] files Пути к файлам
+    /// \param [in] algorithm Интерфейс алгоритма
+    /// \param [in] archivePath Путь до создаваемого архива
+    /// \param [in] job Задание для отчета и отмены. Может быть nullptr
+    /// \param [in] blockSize Размер блока для сжатия, см. \ref cFileWorker::setBlockSize
+    ///
+    /// \return Отчет о пакетной обработке. Если архив записать не удалось,
+    /// все файлы получают статус ошибки записи
+    static sReport pack( std::string_view rootPath,
+                         const std::vector< std::string > &files,
+                         cAbstractAlgorithm &algorithm,
+                         std::string_view archivePath,
+                         cJob *job = nullptr,
+                         uint64_t blockSize = cFileWorker::DEFAULT_BLOCK_SIZE );
+
+    /// \brief Извлечь все файлы архива
+    ///
+    /// \details Файлы распаковываются параллельно в директорию назначения с
+    /// сохранением относительных путей. Файлы с абсолютными именами или
+    /// выходящие за директорию назначения не извлекаются
+    ///
+    /// \param [in] archivePath Путь до архива
+    /// \param [in] algorithm Интерфейс алгоритма, которым сжаты файлы
+    /// \param [in] destPath Директория назначения
+    /// \param [in] job Задание для отчета и отмены. Может быть nullptr
+    ///
+    /// \return Отчет о пакетной обработке и статус открытия архива
+    static std::tuple< sReport, eErrStatus > unpack( std::string_view archivePath,
+                                                     cAbstractAlgorithm &algorithm,
+                                                     std::string_view destPath,
+                                                     cJob *job = nullptr );
+
+private:
+    /// \brief Псевдоним для функции обработки одного файла: результат и
+    /// номер файла в исходном списке
+    /// \typedef fileProcessor_t
+    using fileProcessor_t = std::function< void( sFileResult &, size_t ) >;
+
+    /// \brief Подготовить отчет: пути и размеры файлов
+    /// \param [in] files Пути к файлам
+    /// \return Отчет без результатов
+    static sReport makeReport( const std::vector< std::string > &files );
+
+    /// \brief Выполнить задания по файлам отчета
+    ///
+    /// \details Файлы обрабатываются в порядке возрастания размера. После
+    /// отмены оставшиеся файлы получают статус ERR_STATUS_CANCELED. По
+    /// завершении результаты упорядочиваются по порядку обработки и
+    /// заполняются итоги отчета
+    ///
+    /// \param [in,out] report Отчет. На входе заполнены пути и размеры файлов
+    /// \param [in] job Задание: получает общий объем файлов. Может быть nullptr
+    /// \param [in] processor Обработка одного файла. Вызывается из рабочих
+    /// потоков
+    static void runJobs( sReport &report, cJob *job, const fileProcessor_t &processor );
+
+    /// \brief Обработать один файл
+    ///
+    /// \param [in,out] result Результат. На входе заполнены путь и размер
+    /// \param [in] algorithm Интерфейс алгоритма
+    /// \param [in] action ACT_TYPE_COMPR - сжатие ACT_TYPE_DECOMPR - распаковка
+    /// \param [in] job Задание для отчета и отмены. Может быть nullptr
+    /// \param [in] blockSize Размер блока для сжатия
+    static void processFile( sFileResult &result,
+                             cAbstractAlgorithm &algorithm,
+                             eTypeOfActions action,
+                             cJob *job,
+                             uint64_t blockSize );
+
+    /// \brief Записать извлеченный файл через временный файл рядом с ним
+    /// \param [in] path Путь до файла
+    /// \param [in] data Содержимое файла
+    /// \return Статус выполнения
+    static eErrStatus writeFile( const std::string &path, std::string_view data );
+};
+
+/// @}
+
+#endif // CBATCHPROCESSOR_H
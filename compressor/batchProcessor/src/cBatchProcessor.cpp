@@ -0,0 +1,302 @@
+/** ****************************************************************************
+ * \brief Исходные коды пакетной обработки файлов
+ *
+ * \file cBatchProcessor.cpp
+ * ****************************************************************************/
+
+#include "batchProcessor/h/cBatchProcessor.h" /// Заголовок класса
+#include "archive/cArchiveReader/h/cArchiveReader.h" /// Чтение архива
+#include "archive/cArchiveWriter/h/cArchiveWriter.h" /// Запись архива
+#include "threadPool/h/cThreadPool.h" /// Пул потоков
+#include <algorithm> /// std::sort, std::min
+#include <atomic> /// Атомарные переменные
+#include <chrono> /// Время
+#include <cstdio> /// std::rename, std::remove
+#include <filesystem> /// Обход директорий
+#include <numeric> /// std::iota
+#include <tuple> /// std::tie
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+std::vector< std::string > cBatchProcessor::collectFiles( std::string_view dirPath,
+                                                          const cAbstractAlgorithm &algorithm,
+                                                          eTypeOfActions action )
+{
+    namespace fs = std::filesystem;
+
+    std::vector< std::string > files;
+    std::error_code error;
+    fs::recursive_directory_iterator it( fs::path( dirPath ),
+                                         fs::directory_options::skip_permission_denied, error );
+
+    for( ; !error && it != fs::recursive_directory_iterator(); it.increment( error ) )
+    {
+        std::error_code entryError;
+        if( !it->is_regular_file( entryError ) )
+            continue;
+
+        const std::string extension( it->path().extension().string() );
+        const bool isCompressed = algorithm.getPostfix() == extension;
+
+        if( cFileWorker::TEMP_POSTFIX == extension || ( ACT_TYPE_COMPR == action ) == isCompressed )
+            continue;
+
+        files.push_back( it->path().string() );
+    }
+
+    return files;
+}
+
+cBatchProcessor::sReport cBatchProcessor::run( const std::vector< std::string > &files,
+                                               cAbstractAlgorithm &algorithm,
+                                               eTypeOfActions action,
+                                               cJob *job,
+                                               uint64_t blockSize )
+{
+    sReport report( makeReport( files ) );
+    runJobs( report, job, [ & ]( sFileResult &result, size_t )
+    {
+        processFile( result, algorithm, action, job, blockSize );
+    } );
+
+    return report;
+}
+
+cBatchProcessor::sReport cBatchProcessor::pack( std::string_view rootPath,
+                                                const std::vector< std::string > &files,
+                                                cAbstractAlgorithm &algorithm,
+                                                std::string_view archivePath,
+                                                cJob *job,
+                                                uint64_t blockSize )
+{
+    namespace fs = std::filesystem;
+
+    sReport report( makeReport( files ) );
+    cArchiveWriter archive;
+    const eErrStatus openStatus = archive.open( archivePath );
+
+    const fs::path root( rootPath );
+    runJobs( report, job, [ & ]( sFileResult &result, size_t )
+    {
+        result.mStatus = openStatus;
+        if( ERR_STATUS_SUCCESS != result.mStatus )
+            return;
+
+        cInputSource file;
+        result.mStatus = file.open( result.mSrcPath );
+        if( ERR_STATUS_SUCCESS != result.mStatus )
+            return;
+
+        const auto [ data, readStatus ] = file.getData();
+        result.mStatus = readStatus;
+        if( ERR_STATUS_SUCCESS != result.mStatus )
+            return;
+
+        /// Имена в архиве - относительные пути с разделителем '/'
+        const std::string name( fs::path( result.mSrcPath ).lexically_relative( root ).generic_string() );
+        result.mStatus = archive.addMember( name, algorithm, data, blockSize );
+        if( ERR_STATUS_SUCCESS != result.mStatus )
+            return;
+
+        result.mNewPath = std::string( archivePath );
+        if( job )
+            job->addProgress( data.size(), 0 );
+    } );
+
+    /// После отмены архив не нужен - временный файл удаляется
+    if( job && job->isCanceled() )
+        return report;
+
+    if( ERR_STATUS_SUCCESS == openStatus && ERR_STATUS_SUCCESS != archive.close() )
+    {
+        for( auto &result : report.mFiles )
+            result.mStatus = ERR_STATUS_BAD_FILE_WRITE;
+
+        report.mTotalBytes = 0;
+        report.mFailedCount = report.mFiles.size();
+    }
+
+    return report;
+}
+
+std::tuple< cBatchProcessor::sReport, eErrStatus > cBatchProcessor::unpack( std::string_view archivePath,
+                                                                           cAbstractAlgorithm &algorithm,
+                                                                           std::string_view destPath,
+                                                                           cJob *job )
+{
+    namespace fs = std::filesystem;
+
+    sReport report;
+    cArchiveReader archive;
+    const eErrStatus openStatus = archive.open( archivePath );
+    if( ERR_STATUS_SUCCESS != openStatus )
+        return std::make_tuple( std::move( report ), openStatus );
+
+    report.mFiles.resize( archive.getMemberCount() );
+    for( size_t i = 0; i < report.mFiles.size(); ++i )
+    {
+        const auto [ member, status ] = archive.getMember( i );
+        report.mFiles[ i ].mSrcPath = member.mName;
+        report.mFiles[ i ].mSrcSize = member.mRawSize;
+    }
+
+    const fs::path dest( destPath );
+    runJobs( report, job, [ & ]( sFileResult &result, size_t index )
+    {
+        const auto [ member, entryStatus ] = archive.getMember( index );
+        result.mStatus = entryStatus;
+        if( ERR_STATUS_SUCCESS != result.mStatus )
+            return;
+
+        /// Имя не должно выводить файл за директорию назначения
+        const fs::path name( fs::path( std::string( member.mName ) ).lexically_normal() );
+        if( name.empty() || name.is_absolute() || name.has_root_path() || *name.begin() == ".." )
+        {
+            result.mStatus = ERR_STATUS_BAD_FORMAT;
+            return;
+        }
+
+        const auto [ data, readStatus ] = archive.readMember( index, algorithm );
+        result.mStatus = readStatus;
+        if( ERR_STATUS_SUCCESS != result.mStatus )
+            return;
+
+        const fs::path target( dest / name );
+        std::error_code error;
+        fs::create_directories( target.parent_path(), error );
+
+        result.mNewPath = target.string();
+        result.mStatus = writeFile( result.mNewPath, data );
+        if( ERR_STATUS_SUCCESS == result.mStatus && job )
+            job->addProgress( member.mCmprSize, data.size() );
+    } );
+
+    return std::make_tuple( std::move( report ), ERR_STATUS_SUCCESS );
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+cBatchProcessor::sReport cBatchProcessor::makeReport( const std::vector< std::string > &files )
+{
+    sReport report;
+    report.mFiles.resize( files.size() );
+    for( size_t i = 0; i < files.size(); ++i )
+    {
+        std::error_code error;
+        report.mFiles[ i ].mSrcPath = files[ i ];
+        report.mFiles[ i ].mSrcSize = std::filesystem::file_size( files[ i ], error );
+        if( error )
+            report.mFiles[ i ].mSrcSize = 0;
+    }
+
+    return report;
+}
+
+void cBatchProcessor::runJobs( sReport &report, cJob *job, const fileProcessor_t &processor )
+{
+    uint64_t totalSize = 0;
+    for( const auto &result : report.mFiles )
+        totalSize += result.mSrcSize;
+
+    if( job )
+        job->setTotal( totalSize );
+
+    /// Сначала короткие файлы: они быстро освобождают потоки, а большие
+    /// файлы в конце пакета сами делятся на блоки
+    std::vector< size_t > order( report.mFiles.size() );
+    std::iota( order.begin(), order.end(), size_t( 0 ) );
+    std::stable_sort( order.begin(), order.end(),
+                      [ &report ]( size_t left, size_t right )
+                      {
+                          return report.mFiles[ left ].mSrcSize < report.mFiles[ right ].mSrcSize;
+                      } );
+
+    /// Исполнителей не больше, чем потоков пула. Каждый берет следующий по
+    /// порядку файл, поэтому порядок не зависит от перехвата задач
+    cThreadPool &pool = cThreadPool::instance();
+    const size_t runnerCount = std::min( report.mFiles.size(),
+                                         std::max< size_t >( 1, pool.getThreadCount() ) );
+    std::atomic< size_t > nextFile{ 0 };
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    pool.parallelFor( runnerCount, [ & ]( size_t )
+    {
+        for( size_t i = nextFile++; i < order.size(); i = nextFile++ )
+        {
+            sFileResult &result = report.mFiles[ order[ i ] ];
+            if( job && job->isCanceled() )
+                result.mStatus = ERR_STATUS_CANCELED;
+            else
+                processor( result, order[ i ] );
+        }
+    } );
+
+    report.mSeconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - startTime ).count();
+
+    /// Результаты - в порядке обработки
+    std::vector< sFileResult > results;
+    results.reserve( order.size() );
+    for( const size_t index : order )
+        results.push_back( std::move( report.mFiles[ index ] ) );
+
+    report.mFiles = std::move( results );
+
+    for( const auto &result : report.mFiles )
+    {
+        if( ERR_STATUS_SUCCESS == result.mStatus )
+            report.mTotalBytes += result.mSrcSize;
+        else
+            ++report.mFailedCount;
+    }
+}
+
+void cBatchProcessor::processFile( sFileResult &result,
+                                   cAbstractAlgorithm &algorithm,
+                                   eTypeOfActions action,
+                                   cJob *job,
+                                   uint64_t blockSize )
+{
+    /// Большие файлы пишутся в обход страничного кэша, чтобы пакетное
+    /// задание не вытесняло из него данные других процессов
+    cFileWorker fileWorker;
+    fileWorker.setBlockSize( blockSize );
+    fileWorker.setIoBackend( IO_TYPE_URING, result.mSrcSize >= DIRECT_IO_MIN_SIZE );
+
+    result.mStatus = fileWorker.updateReadFile( result.mSrcPath );
+    if( ERR_STATUS_SUCCESS != result.mStatus )
+    {
+        result.mStats.mPath = result.mSrcPath;
+        result.mStats.mAlgType = algorithm.getType();
+        result.mStats.mAction = action;
+        result.mStats.mStatus = result.mStatus;
+        return;
+    }
+
+    /// Временный файл уникален для задания и удаляется при ошибке
+    std::tie( result.mNewPath, result.mStatus ) = fileWorker.applyAlgorithm( algorithm, action, job );
+    result.mStats = fileWorker.getLastStats();
+}
+
+eErrStatus cBatchProcessor::writeFile( const std::string &path, std::string_view data )
+{
+    const std::string tempPath( path + cFileWorker::TEMP_POSTFIX );
+    std::unique_ptr< cAbstractIoBackend > file = cAbstractIoBackend::create( IO_TYPE_URING, false );
+    if( ERR_STATUS_SUCCESS != file->open( tempPath ) )
+        return ERR_STATUS_BAD_FILE_OPEN;
+
+    const bool isWritten = file->write( 0, data ) && file->flush();
+    file->close();
+
+    if( !isWritten || 0 != std::rename( tempPath.c_str(), path.c_str() ) )
+    {
+        std::remove( tempPath.c_str() );
+        return ERR_STATUS_BAD_FILE_WRITE;
+    }
+
+    return ERR_STATUS_SUCCESS;
+}
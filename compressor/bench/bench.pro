@@ -0,0 +1,20 @@
+# Программа замеров производительности. Qt не требуется
+
+TEMPLATE = app
+TARGET = bench
+
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+include(../core.pri)
+
+SOURCES += \
+        cBenchReport/src/cBenchReport.cpp \
+        cBenchRunner/src/cBenchRunner.cpp \
+        cCorpusGenerator/src/cCorpusGenerator.cpp \
+        main.cpp
+
+HEADERS += \
+    cBenchReport/h/cBenchReport.h \
+    cBenchRunner/h/cBenchRunner.h \
+    cCorpusGenerator/h/cCorpusGenerator.h
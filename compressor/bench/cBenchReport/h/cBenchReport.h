@@ -0,0 +1,102 @@
+/** ****************************************************************************
+ * \file cBenchReport.h
+ *
+ * \defgroup BenchReport Отчеты замеров
+ * @{
+ *
+ * \ingroup Bench
+ *
+ * \brief Модуль вывода результатов замеров и сравнения с базовыми
+ *
+ * \details Результаты выводятся в JSON (для систем мониторинга и графиков)
+ * или CSV (для таблиц). CSV также служит форматом сохраненных базовых
+ * результатов: \ref cBenchReport::fromCsv читает его обратно по именам
+ * столбцов, поэтому порядок и новые столбцы не мешают сравнению.
+ *
+ * Сравнение сопоставляет замеры с одинаковыми данными, алгоритмом, размером
+ * блока и числом потоков и отмечает ухудшение больше порога:
+ * - падение скорости сжатия или распаковки;
+ * - рост размера сжатых данных;
+ * - рост пикового объема памяти;
+ * - ошибку замера, который раньше выполнялся успешно.
+ *
+ * Реализован с поиощью класса \ref cBenchReport
+ * ****************************************************************************/
+
+#ifndef CBENCHREPORT_H
+#define CBENCHREPORT_H
+
+#include "bench/cBenchRunner/h/cBenchRunner.h" /// Выполнение замеров
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+#include <tuple> /// Кортежи
+#include <vector> /// Вектор
+
+/// \brief Класс, формирующий отчеты замеров
+/// \class cBenchReport
+class cBenchReport final
+{
+public:
+    /// \brief Структура, описывающая ухудшение результата
+    /// \struct sRegression
+    struct sRegression
+    {
+        /// \brief Базовый результат
+        cBenchRunner::sResult mBaseline;
+        /// \brief Текущий результат
+        cBenchRunner::sResult mCurrent;
+        /// \brief Имя ухудшившегося показателя - столбца CSV
+        std::string mMetric;
+        /// \brief Изменение в процентах относительно базового. Для ошибки
+        /// замера - 0
+        double mChange = 0.0;
+    };
+
+    /// \brief Сформировать отчет в JSON
+    /// \param [in] config Набор замеров
+    /// \param [in] results Результаты
+    /// \return Текст отчета
+    static std::string toJson( const cBenchRunner::sConfig &config,
+                               const std::vector< cBenchRunner::sResult > &results );
+
+    /// \brief Сформировать отчет в CSV
+    /// \param [in] results Результаты
+    /// \return Текст отчета со строкой заголовков
+    static std::string toCsv( const std::vector< cBenchRunner::sResult > &results );
+
+    /// \brief Прочитать результаты из отчета CSV
+    /// \param [in] csv Текст отчета
+    /// \return Результаты и статус: ERR_STATUS_SUCCESS - успех,
+    /// ERR_STATUS_BAD_FORMAT - нет нужного столбца или значение не разобрано
+    static std::tuple< std::vector< cBenchRunner::sResult >, eErrStatus > fromCsv( std::string_view csv );
+
+    /// \brief Сравнить результаты с базовыми
+    ///
+    /// \param [in] baseline Базовые результаты
+    /// \param [in] current Текущие результаты. Замеры без пары не сравниваются
+    /// \param [in] threshold Допустимое ухудшение в процентах
+    ///
+    /// \return Ухудшения больше порога
+    static std::vector< sRegression > compare( const std::vector< cBenchRunner::sResult > &baseline,
+                                               const std::vector< cBenchRunner::sResult > &current,
+                                               double threshold );
+
+    /// \brief Описать замер одной строкой: данные, алгоритм, блок, потоки
+    /// \param [in] result Результат
+    /// \return Описание
+    static std::string describe( const cBenchRunner::sResult &result );
+
+    /// \brief Допустимое ухудшение по умолчанию, проценты
+    constexpr static double DEFAULT_THRESHOLD = 5.0;
+
+private:
+    /// \brief Проверить, описывают ли результаты один и тот же замер
+    /// \param [in] left Первый результат
+    /// \param [in] right Второй результат
+    /// \return true - совпадают данные, алгоритм, блок и потоки
+    static bool isSameCase( const cBenchRunner::sResult &left, const cBenchRunner::sResult &right ) noexcept;
+};
+
+/// @}
+
+#endif // CBENCHREPORT_H
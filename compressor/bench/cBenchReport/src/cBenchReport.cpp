@@ -0,0 +1,241 @@
+/** ****************************************************************************
+ * \brief Исходные коды отчетов замеров
+ *
+ * \file cBenchReport.cpp
+ * ****************************************************************************/
+
+#include "bench/cBenchReport/h/cBenchReport.h" /// Заголовок класса
+#include <cstdio> /// std::snprintf
+#include <cstdlib> /// std::strtod, std::strtoull
+#include <map> /// Словарь
+
+/// \brief Столбцы CSV и поля JSON в порядке вывода
+static constexpr const char *COLUMNS[] =
+{
+    "corpus", "algorithm", "block_size", "threads", "raw_size", "cmpr_size", "ratio",
+    "compress_mbs", "decompress_mbs",
+    "compress_p50_ms", "compress_p90_ms", "compress_p99_ms",
+    "decompress_p50_ms", "decompress_p90_ms", "decompress_p99_ms",
+    "peak_rss_kb", "status"
+};
+
+/// \brief Разделить строку
+/// \param [in] line Строка
+/// \param [in] separator Разделитель
+/// \return Части строки
+static std::vector< std::string_view > split( std::string_view line, char separator )
+{
+    std::vector< std::string_view > parts;
+    for( ;; )
+    {
+        const size_t end = line.find( separator );
+        parts.push_back( line.substr( 0, end ) );
+        if( std::string_view::npos == end )
+            return parts;
+
+        line.remove_prefix( end + 1 );
+    }
+}
+
+/// \brief Получить значения результата в порядке \ref COLUMNS
+/// \param [in] result Результат
+/// \return Значения: имена - строками, числа - в текстовом виде
+static std::vector< std::string > getValues( const cBenchRunner::sResult &result )
+{
+    const auto number = []( double value )
+    {
+        char text[ 32 ];
+        std::snprintf( text, sizeof( text ), "%.3f", value );
+        return std::string( text );
+    };
+
+    return
+    {
+        std::string( cCorpusGenerator::getName( result.mCorpus ) ),
+        cBenchRunner::getAlgorithmName( result.mAlgorithm ),
+        std::to_string( result.mBlockSize ),
+        std::to_string( result.mThreads ),
+        std::to_string( result.mRawSize ),
+        std::to_string( result.mCmprSize ),
+        number( result.getRatio() ),
+        number( result.mCompressSpeed ),
+        number( result.mDecompressSpeed ),
+        number( result.mCompressLatency.mP50 ),
+        number( result.mCompressLatency.mP90 ),
+        number( result.mCompressLatency.mP99 ),
+        number( result.mDecompressLatency.mP50 ),
+        number( result.mDecompressLatency.mP90 ),
+        number( result.mDecompressLatency.mP99 ),
+        std::to_string( result.mPeakRss ),
+        std::to_string( int( result.mStatus ) )
+    };
+}
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+std::string cBenchReport::toJson( const cBenchRunner::sConfig &config,
+                                  const std::vector< cBenchRunner::sResult > &results )
+{
+    std::string json( "{\n" );
+    json += "  \"corpus_size\": " + std::to_string( config.mCorpusSize ) + ",\n";
+    json += "  \"iterations\": " + std::to_string( config.mIterations ) + ",\n";
+    json += "  \"seed\": " + std::to_string( config.mSeed ) + ",\n";
+    json += "  \"results\": [";
+
+    for( size_t i = 0; i < results.size(); ++i )
+    {
+        json += 0 == i ? "\n    {" : ",\n    {";
+
+        /// Имена - строки, остальное - числа
+        const std::vector< std::string > values( getValues( results[ i ] ) );
+        for( size_t column = 0; column < values.size(); ++column )
+        {
+            const bool isName = column < 2;
+            json += std::string( 0 == column ? " \"" : ", \"" ) + COLUMNS[ column ] + "\": ";
+            json += isName ? "\"" + values[ column ] + "\"" : values[ column ];
+        }
+
+        json += " }";
+    }
+
+    json += results.empty() ? "]\n}\n" : "\n  ]\n}\n";
+    return json;
+}
+
+std::string cBenchReport::toCsv( const std::vector< cBenchRunner::sResult > &results )
+{
+    std::string csv;
+    for( const char *column : COLUMNS )
+        csv += std::string( csv.empty() ? "" : "," ) + column;
+    csv += '\n';
+
+    for( const cBenchRunner::sResult &result : results )
+    {
+        const std::vector< std::string > values( getValues( result ) );
+        for( size_t column = 0; column < values.size(); ++column )
+            csv += ( 0 == column ? "" : "," ) + values[ column ];
+        csv += '\n';
+    }
+
+    return csv;
+}
+
+std::tuple< std::vector< cBenchRunner::sResult >, eErrStatus > cBenchReport::fromCsv( std::string_view csv )
+{
+    const auto badFormat = []( void )
+    {
+        return std::make_tuple( std::vector< cBenchRunner::sResult >(), ERR_STATUS_BAD_FORMAT );
+    };
+
+    std::vector< std::string_view > lines( split( csv, '\n' ) );
+    if( lines.empty() )
+        return badFormat();
+
+    /// Номера столбцов по именам из строки заголовков
+    std::map< std::string_view, size_t > columnIndex;
+    const std::vector< std::string_view > header( split( lines.front(), ',' ) );
+    for( size_t i = 0; i < header.size(); ++i )
+        columnIndex[ header[ i ] ] = i;
+
+    for( const char *column : COLUMNS )
+        if( !columnIndex.count( column ) )
+            return badFormat();
+
+    std::vector< cBenchRunner::sResult > results;
+    for( size_t line = 1; line < lines.size(); ++line )
+    {
+        if( lines[ line ].empty() )
+            continue;
+
+        const std::vector< std::string_view > fields( split( lines[ line ], ',' ) );
+        if( fields.size() != header.size() )
+            return badFormat();
+
+        const auto field = [ & ]( const char *column ) { return std::string( fields[ columnIndex[ column ] ] ); };
+        const auto integer = [ & ]( const char *column ) { return std::strtoull( field( column ).c_str(), nullptr, 10 ); };
+        const auto real = [ & ]( const char *column ) { return std::strtod( field( column ).c_str(), nullptr ); };
+
+        cBenchRunner::sResult result;
+        bool isCorpusKnown = false;
+        bool isAlgorithmKnown = false;
+        std::tie( result.mCorpus, isCorpusKnown ) = cCorpusGenerator::fromName( field( "corpus" ) );
+        std::tie( result.mAlgorithm, isAlgorithmKnown ) = cBenchRunner::algorithmFromName( field( "algorithm" ) );
+        if( !isCorpusKnown || !isAlgorithmKnown )
+            return badFormat();
+
+        result.mBlockSize = integer( "block_size" );
+        result.mThreads = integer( "threads" );
+        result.mRawSize = integer( "raw_size" );
+        result.mCmprSize = integer( "cmpr_size" );
+        result.mCompressSpeed = real( "compress_mbs" );
+        result.mDecompressSpeed = real( "decompress_mbs" );
+        result.mCompressLatency = { real( "compress_p50_ms" ), real( "compress_p90_ms" ), real( "compress_p99_ms" ) };
+        result.mDecompressLatency = { real( "decompress_p50_ms" ), real( "decompress_p90_ms" ),
+                                      real( "decompress_p99_ms" ) };
+        result.mPeakRss = integer( "peak_rss_kb" );
+        result.mStatus = eErrStatus( integer( "status" ) );
+
+        results.push_back( result );
+    }
+
+    return std::make_tuple( std::move( results ), ERR_STATUS_SUCCESS );
+}
+
+std::vector< cBenchReport::sRegression > cBenchReport::compare( const std::vector< cBenchRunner::sResult > &baseline,
+                                                                const std::vector< cBenchRunner::sResult > &current,
+                                                                double threshold )
+{
+    std::vector< sRegression > regressions;
+    for( const cBenchRunner::sResult &now : current )
+    {
+        for( const cBenchRunner::sResult &before : baseline )
+        {
+            if( !isSameCase( before, now ) || ERR_STATUS_SUCCESS != before.mStatus )
+                continue;
+
+            if( ERR_STATUS_SUCCESS != now.mStatus )
+            {
+                regressions.push_back( { before, now, "status", 0.0 } );
+                break;
+            }
+
+            /// Изменение в процентах; sign = -1 - хуже меньшее значение
+            const auto check = [ & ]( const char *metric, double was, double is, double sign )
+            {
+                if( was <= 0.0 )
+                    return;
+
+                const double change = ( is - was ) / was * 100.0;
+                if( sign * change > threshold )
+                    regressions.push_back( { before, now, metric, change } );
+            };
+
+            check( "compress_mbs", before.mCompressSpeed, now.mCompressSpeed, -1.0 );
+            check( "decompress_mbs", before.mDecompressSpeed, now.mDecompressSpeed, -1.0 );
+            check( "cmpr_size", double( before.mCmprSize ), double( now.mCmprSize ), 1.0 );
+            check( "peak_rss_kb", double( before.mPeakRss ), double( now.mPeakRss ), 1.0 );
+            break;
+        }
+    }
+
+    return regressions;
+}
+
+std::string cBenchReport::describe( const cBenchRunner::sResult &result )
+{
+    return std::string( cCorpusGenerator::getName( result.mCorpus ) ) + " " +
+           cBenchRunner::getAlgorithmName( result.mAlgorithm ) + " block=" + std::to_string( result.mBlockSize ) +
+           " threads=" + std::to_string( result.mThreads );
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+bool cBenchReport::isSameCase( const cBenchRunner::sResult &left, const cBenchRunner::sResult &right ) noexcept
+{
+    return left.mCorpus == right.mCorpus && left.mAlgorithm == right.mAlgorithm &&
+           left.mBlockSize == right.mBlockSize && left.mThreads == right.mThreads;
+}
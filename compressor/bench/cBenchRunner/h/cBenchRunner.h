@@ -0,0 +1,180 @@
+/** ****************************************************************************
+ * \file cBenchRunner.h
+ * ****************************************************************************/
+
+/** ****************************************************************************
+ * \defgroup Bench Замеры производительности
+ *
+ * \brief Отдельная от GUI программа замеров скорости и степени сжатия
+ *
+ * \details Состоит из генератора данных - \ref BenchCorpus, выполнения
+ * замеров - \ref BenchRunner и отчетов - \ref BenchReport
+ *
+ * ****************************************************************************/
+
+/** ****************************************************************************
+ * \defgroup BenchRunner Выполнение замеров
+ * @{
+ * \ingroup Bench
+ *
+ * \brief Модуль, выполняющий замеры всех сочетаний параметров
+ *
+ * \details Замер - сжатие и распаковка в память (\ref cFileWorker::compressData,
+ * \ref cFileWorker::decompressData) одного набора данных одним алгоритмом
+ * с заданными размером блока и числом потоков. Сначала выполняется один
+ * прогон без замера (прогрев), затем заданное количество прогонов с замером
+ * времени каждого. Скорость считается по медиане, кроме того сообщаются
+ * 50, 90 и 99 процентили времени прогона. Результат распаковки сверяется
+ * с исходными данными.
+ *
+ * Каждый замер выполняется в отдельном дочернем процессе:
+ * - пул потоков \ref ThreadPool создается один раз на процесс по числу
+ *   доступных процессоров, поэтому число потоков задается маской процессоров
+ *   дочернего процесса до создания пула;
+ * - пиковый объем резидентной памяти (ru_maxrss) относится только к этому
+ *   замеру и включает исходные данные.
+ *
+ * Реализован с поиощью класса \ref cBenchRunner
+ * ****************************************************************************/
+
+#ifndef CBENCHRUNNER_H
+#define CBENCHRUNNER_H
+
+#include "common.h" /// Общие константы программы
+#include "bench/cCorpusGenerator/h/cCorpusGenerator.h" /// Тестовые данные
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <functional> /// Обертки функций
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+#include <tuple> /// Кортежи
+#include <vector> /// Вектор
+
+/// \brief Класс, выполняющий замеры
+/// \class cBenchRunner
+class cBenchRunner final
+{
+public:
+    /// \brief Структура, описывающая набор замеров
+    /// \struct sConfig
+    struct sConfig
+    {
+        /// \brief Виды данных
+        std::vector< cCorpusGenerator::eCorpus > mCorpora;
+        /// \brief Алгоритмы
+        std::vector< eTypeOfComprAlgorithm > mAlgorithms;
+        /// \brief Размеры блока
+        std::vector< uint64_t > mBlockSizes;
+        /// \brief Количества потоков
+        std::vector< size_t > mThreadCounts;
+        /// \brief Размер каждого набора данных
+        size_t mCorpusSize = DEFAULT_CORPUS_SIZE;
+        /// \brief Количество прогонов с замером
+        size_t mIterations = DEFAULT_ITERATIONS;
+        /// \brief Начальное значение генератора данных
+        uint64_t mSeed = cCorpusGenerator::DEFAULT_SEED;
+    };
+
+    /// \brief Структура, описывающая процентили времени прогона
+    /// \struct sLatency
+    struct sLatency
+    {
+        /// \brief Медиана, мс
+        double mP50 = 0.0;
+        /// \brief 90 процентиль, мс
+        double mP90 = 0.0;
+        /// \brief 99 процентиль, мс
+        double mP99 = 0.0;
+    };
+
+    /// \brief Структура, описывающая результат замера. Копируется побайтно
+    /// из дочернего процесса
+    /// \struct sResult
+    struct sResult
+    {
+        /// \brief Вид данных
+        cCorpusGenerator::eCorpus mCorpus = cCorpusGenerator::CORPUS_TEXT;
+        /// \brief Алгоритм
+        eTypeOfComprAlgorithm mAlgorithm = ALG_TYPE_RLE;
+        /// \brief Размер блока
+        uint64_t mBlockSize = 0;
+        /// \brief Количество потоков
+        uint64_t mThreads = 0;
+        /// \brief Размер исходных данных
+        uint64_t mRawSize = 0;
+        /// \brief Размер сжатых данных
+        uint64_t mCmprSize = 0;
+        /// \brief Скорость сжатия, МБ/с исходных данных
+        double mCompressSpeed = 0.0;
+        /// \brief Скорость распаковки, МБ/с исходных данных
+        double mDecompressSpeed = 0.0;
+        /// \brief Время сжатия
+        sLatency mCompressLatency;
+        /// \brief Время распаковки
+        sLatency mDecompressLatency;
+        /// \brief Пиковый объем резидентной памяти, КБ
+        uint64_t mPeakRss = 0;
+        /// \brief Статус замера
+        eErrStatus mStatus = ERR_STATUS_SUCCESS;
+
+        /// \brief Степень сжатия
+        /// \return Отношение исходного размера к сжатому
+        inline double getRatio( void ) const noexcept
+        {
+            return mCmprSize ? double( mRawSize ) / mCmprSize : 0.0;
+        }
+    };
+
+    /// \brief Псевдоним для функции, вызываемой по завершении каждого замера
+    /// \typedef progress_t
+    using progress_t = std::function< void( const sResult &, size_t, size_t ) >;
+
+    /// \brief Выполнить все сочетания параметров набора
+    ///
+    /// \param [in] config Набор замеров
+    /// \param [in] progress Вызывается после каждого замера с результатом,
+    /// номером замера и их общим количеством. Может быть пустой
+    ///
+    /// \return Результаты в порядке: данные, алгоритм, блок, потоки
+    static std::vector< sResult > run( const sConfig &config, const progress_t &progress );
+
+    /// \brief Получить имя алгоритма - постфикс без ".cmpr"
+    /// \param [in] type Тип алгоритма
+    /// \return Имя или пустая строка для неизвестного типа
+    static std::string getAlgorithmName( eTypeOfComprAlgorithm type );
+
+    /// \brief Найти алгоритм по имени
+    /// \param [in] name Имя
+    /// \return Тип алгоритма и признак того, что имя известно
+    static std::tuple< eTypeOfComprAlgorithm, bool > algorithmFromName( std::string_view name );
+
+    /// \brief Размер набора данных по умолчанию
+    constexpr static size_t DEFAULT_CORPUS_SIZE = 16 * 1024 * 1024;
+
+    /// \brief Количество прогонов по умолчанию
+    constexpr static size_t DEFAULT_ITERATIONS = 5;
+
+private:
+    /// \brief Выполнить замер в дочернем процессе
+    /// \param [in] config Набор замеров
+    /// \param [in] result Параметры замера. Заполняется результатом
+    static void runInChild( const sConfig &config, sResult &result );
+
+    /// \brief Выполнить замер в текущем процессе
+    /// \param [in] config Набор замеров
+    /// \param [in,out] result Параметры замера. Заполняется результатом
+    static void measure( const sConfig &config, sResult &result );
+
+    /// \brief Ограничить процесс первыми доступными процессорами
+    /// \param [in] count Количество процессоров
+    /// \return Количество процессоров после ограничения
+    static size_t limitCpus( size_t count );
+
+    /// \brief Рассчитать процентили
+    /// \param [in] times Время прогонов, мс
+    /// \return Процентили
+    static sLatency getLatency( std::vector< double > times );
+};
+
+/// @}
+
+#endif // CBENCHRUNNER_H
@@ -0,0 +1,223 @@
+/** ****************************************************************************
+ * \brief Исходные коды выполнения замеров
+ *
+ * \file cBenchRunner.cpp
+ * ****************************************************************************/
+
+#include "bench/cBenchRunner/h/cBenchRunner.h" /// Заголовок класса
+#include "algorithm/cAlgorithmRegistry/h/cAlgorithmRegistry.h" /// Реестр алгоритмов
+#include "cFileWorker/h/cFileWorker.h" /// Сжатие в память
+#include <algorithm> /// std::sort
+#include <chrono> /// Время
+#include <cmath> /// std::ceil
+#include <sys/resource.h> /// getrusage
+#include <sys/wait.h> /// waitpid
+#include <sched.h> /// sched_setaffinity
+#include <unistd.h> /// fork, pipe
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+std::vector< cBenchRunner::sResult > cBenchRunner::run( const sConfig &config, const progress_t &progress )
+{
+    const size_t total = config.mCorpora.size() * config.mAlgorithms.size() *
+                         config.mBlockSizes.size() * config.mThreadCounts.size();
+
+    std::vector< sResult > results;
+    results.reserve( total );
+    for( const cCorpusGenerator::eCorpus corpus : config.mCorpora )
+        for( const eTypeOfComprAlgorithm algorithm : config.mAlgorithms )
+            for( const uint64_t blockSize : config.mBlockSizes )
+                for( const size_t threads : config.mThreadCounts )
+                {
+                    sResult result;
+                    result.mCorpus = corpus;
+                    result.mAlgorithm = algorithm;
+                    result.mBlockSize = blockSize;
+                    result.mThreads = threads;
+
+                    runInChild( config, result );
+                    results.push_back( result );
+
+                    if( progress )
+                        progress( result, results.size(), total );
+                }
+
+    return results;
+}
+
+std::string cBenchRunner::getAlgorithmName( eTypeOfComprAlgorithm type )
+{
+    return std::string( cAlgorithmRegistry::getName( type ) );
+}
+
+std::tuple< eTypeOfComprAlgorithm, bool > cBenchRunner::algorithmFromName( std::string_view name )
+{
+    return cAlgorithmRegistry::findByName( name );
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+void cBenchRunner::runInChild( const sConfig &config, sResult &result )
+{
+    int fds[ 2 ];
+    if( 0 != ::pipe( fds ) )
+    {
+        result.mStatus = ERR_STATUS_BAD_FILE_OPEN;
+        return;
+    }
+
+    const pid_t pid = ::fork();
+    if( 0 == pid )
+    {
+        /// Дочерний процесс: пул еще не создан, ограничение процессоров
+        /// определит число его потоков
+        ::close( fds[ 0 ] );
+        result.mThreads = limitCpus( result.mThreads );
+        measure( config, result );
+
+        const bool isWritten = sizeof( result ) == ::write( fds[ 1 ], &result, sizeof( result ) );
+        ::_exit( isWritten ? 0 : 1 );
+    }
+
+    ::close( fds[ 1 ] );
+
+    /// Результат меньше PIPE_BUF, поэтому приходит одним куском. Если
+    /// процесс аварийно завершился, результата нет
+    sResult childResult;
+    const bool isRead = -1 != pid && sizeof( childResult ) == ::read( fds[ 0 ], &childResult, sizeof( childResult ) );
+    ::close( fds[ 0 ] );
+
+    if( -1 != pid )
+        ::waitpid( pid, nullptr, 0 );
+
+    if( isRead )
+        result = childResult;
+    else
+        result.mStatus = ERR_STATUS_BAD_ALG;
+}
+
+void cBenchRunner::measure( const sConfig &config, sResult &result )
+{
+    using steadyClock_t = std::chrono::steady_clock;
+    const auto elapsedMs = []( steadyClock_t::time_point begin, steadyClock_t::time_point end )
+    {
+        return std::chrono::duration< double, std::milli >( end - begin ).count();
+    };
+
+    cAbstractAlgorithm &algorithm = *cAlgorithmRegistry::get( result.mAlgorithm );
+    const std::string data( cCorpusGenerator::generate( result.mCorpus, config.mCorpusSize, config.mSeed ) );
+    result.mRawSize = data.size();
+
+    std::vector< double > compressTimes;
+    std::vector< double > decompressTimes;
+
+    /// Прогон 0 - прогрев: страницы данных, потоки пула, кэши
+    for( size_t i = 0; i <= config.mIterations; ++i )
+    {
+        const steadyClock_t::time_point begin = steadyClock_t::now();
+        const auto [ cmprData, cmprStatus ] = cFileWorker::compressData( algorithm, data, result.mBlockSize );
+        const steadyClock_t::time_point middle = steadyClock_t::now();
+
+        if( ERR_STATUS_SUCCESS != cmprStatus )
+        {
+            result.mStatus = cmprStatus;
+            return;
+        }
+
+        const auto [ rawData, rawStatus ] = cFileWorker::decompressData( algorithm, cmprData );
+        const steadyClock_t::time_point end = steadyClock_t::now();
+
+        if( ERR_STATUS_SUCCESS != rawStatus )
+        {
+            result.mStatus = rawStatus;
+            return;
+        }
+
+        if( 0 == i )
+        {
+            /// Результаты всех прогонов одинаковы - сверяется первый
+            if( rawData != data )
+            {
+                result.mStatus = ERR_STATUS_BAD_ALG;
+                return;
+            }
+
+            result.mCmprSize = cmprData.size();
+            continue;
+        }
+
+        compressTimes.push_back( elapsedMs( begin, middle ) );
+        decompressTimes.push_back( elapsedMs( middle, end ) );
+    }
+
+    result.mCompressLatency = getLatency( compressTimes );
+    result.mDecompressLatency = getLatency( decompressTimes );
+
+    /// МБ/с по медиане
+    const double megabytes = result.mRawSize / ( 1024.0 * 1024.0 );
+    if( result.mCompressLatency.mP50 > 0.0 )
+        result.mCompressSpeed = megabytes / ( result.mCompressLatency.mP50 / 1000.0 );
+    if( result.mDecompressLatency.mP50 > 0.0 )
+        result.mDecompressSpeed = megabytes / ( result.mDecompressLatency.mP50 / 1000.0 );
+
+    rusage usage;
+    if( 0 == ::getrusage( RUSAGE_SELF, &usage ) )
+        result.mPeakRss = usage.ru_maxrss;
+}
+
+size_t cBenchRunner::limitCpus( size_t count )
+{
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO( &allowed );
+    if( 0 != sched_getaffinity( 0, sizeof( allowed ), &allowed ) )
+        return count;
+
+    /// Первые count допустимых процессоров
+    cpu_set_t limited;
+    CPU_ZERO( &limited );
+    size_t taken = 0;
+    for( int cpu = 0; cpu < CPU_SETSIZE && taken < count; ++cpu )
+    {
+        if( CPU_ISSET( cpu, &allowed ) )
+        {
+            CPU_SET( cpu, &limited );
+            ++taken;
+        }
+    }
+
+    if( 0 == taken || 0 != sched_setaffinity( 0, sizeof( limited ), &limited ) )
+        return CPU_COUNT( &allowed );
+
+    return taken;
+#else
+    /// Маску процессоров задать нельзя - пул создается по всем процессорам
+    return count;
+#endif
+}
+
+cBenchRunner::sLatency cBenchRunner::getLatency( std::vector< double > times )
+{
+    sLatency latency;
+    if( times.empty() )
+        return latency;
+
+    std::sort( times.begin(), times.end() );
+
+    /// Метод ближайшего ранга
+    const auto percentile = [ &times ]( double fraction )
+    {
+        const size_t rank = size_t( std::ceil( fraction * times.size() ) );
+        return times[ std::max< size_t >( rank, 1 ) - 1 ];
+    };
+
+    latency.mP50 = percentile( 0.50 );
+    latency.mP90 = percentile( 0.90 );
+    latency.mP99 = percentile( 0.99 );
+
+    return latency;
+}
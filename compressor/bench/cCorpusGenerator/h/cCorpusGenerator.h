@@ -0,0 +1,149 @@
+/** ****************************************************************************
+ * \file cCorpusGenerator.h
+ *
+ * \defgroup BenchCorpus Тестовые данные
+ * @{
+ *
+ * \ingroup Bench
+ *
+ * \brief Модуль, создающий воспроизводимые наборы данных для замеров
+ *
+ * \details Данные каждого вида определяются только размером и начальным
+ * значением генератора. Используется std::mt19937_64, последовательность
+ * которого задана стандартом, а распределения строятся из его чисел вручную
+ * (распределения стандартной библиотеки от реализации к реализации
+ * различаются). Поэтому на любой платформе и компиляторе набор данных
+ * одинаков байт в байт, и результаты замеров можно сравнивать.
+ *
+ * Виды данных \ref cCorpusGenerator::eCorpus:
+ * - текст - слова из словаря с неравномерными частотами, предложения и абзацы;
+ * - журналы - строки с отметкой времени, уровнем, потоком и полями запроса;
+ * - серии - длинные повторы одного байта вперемешку с короткими вставками;
+ * - случайные - равномерно распределенные байты, не сжимаются;
+ * - двоичные - записи фиксированной структуры с возрастающими полями;
+ * - смешанные - участки всех предыдущих видов друг за другом;
+ * - перекошенные - байты с частотами, убывающими вдвое. Коды Хаффмана
+ *   редких байт длиннее 16 бит, поэтому сверка распакованных данных с
+ *   исходными проверяет и длинные коды.
+ *
+ * Реализован с поиощью класса \ref cCorpusGenerator
+ * ****************************************************************************/
+
+#ifndef CCORPUSGENERATOR_H
+#define CCORPUSGENERATOR_H
+
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <random> /// Генератор псевдослучайных чисел
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+#include <tuple> /// Кортежи
+
+/// \brief Класс, создающий наборы данных для замеров
+/// \class cCorpusGenerator
+class cCorpusGenerator final
+{
+public:
+    /// \brief Виды данных
+    /// \enum eCorpus
+    enum eCorpus
+    {
+        CORPUS_TEXT = 0, ///< Текст на естественном языке
+        CORPUS_LOGS, ///< Журналы сервиса
+        CORPUS_RUNS, ///< Длинные серии одинаковых байт
+        CORPUS_RANDOM, ///< Случайные байты
+        CORPUS_BINARY, ///< Двоичные записи фиксированной структуры
+        CORPUS_MIXED, ///< Участки всех видов подряд
+        CORPUS_SKEWED, ///< Байты с частотами, убывающими вдвое
+        CORPUS_COUNT ///< Количество видов
+    };
+
+    /// \brief Создать набор данных
+    /// \param [in] corpus Вид данных
+    /// \param [in] size Размер в байтах
+    /// \param [in] seed Начальное значение генератора
+    /// \return Данные ровно указанного размера
+    static std::string generate( eCorpus corpus, size_t size, uint64_t seed = DEFAULT_SEED );
+
+    /// \brief Получить имя вида данных
+    /// \param [in] corpus Вид данных
+    /// \return Имя для отчетов и командной строки
+    static std::string_view getName( eCorpus corpus ) noexcept;
+
+    /// \brief Найти вид данных по имени
+    /// \param [in] name Имя
+    /// \return Вид данных и признак того, что имя известно
+    static std::tuple< eCorpus, bool > fromName( std::string_view name ) noexcept;
+
+    /// \brief Начальное значение генератора по умолчанию
+    constexpr static uint64_t DEFAULT_SEED = 20240101;
+
+private:
+    /// \brief Псевдоним для генератора
+    /// \typedef random_t
+    using random_t = std::mt19937_64;
+
+    /// \brief Получить число из [ 0, bound )
+    /// \param [in] random Генератор
+    /// \param [in] bound Граница, больше 0
+    /// \return Число
+    static inline uint64_t below( random_t &random, uint64_t bound ) { return random() % bound; }
+
+    /// \brief Дописать текст
+    /// \param [in,out] data Данные
+    /// \param [in] size Размер дописываемой части
+    /// \param [in] random Генератор
+    static void appendText( std::string &data, size_t size, random_t &random );
+
+    /// \brief Дописать строки журнала
+    /// \param [in,out] data Данные
+    /// \param [in] size Размер дописываемой части
+    /// \param [in] random Генератор
+    static void appendLogs( std::string &data, size_t size, random_t &random );
+
+    /// \brief Дописать серии одинаковых байт
+    /// \param [in,out] data Данные
+    /// \param [in] size Размер дописываемой части
+    /// \param [in] random Генератор
+    static void appendRuns( std::string &data, size_t size, random_t &random );
+
+    /// \brief Дописать случайные байты
+    /// \param [in,out] data Данные
+    /// \param [in] size Размер дописываемой части
+    /// \param [in] random Генератор
+    static void appendRandom( std::string &data, size_t size, random_t &random );
+
+    /// \brief Дописать двоичные записи
+    /// \param [in,out] data Данные
+    /// \param [in] size Размер дописываемой части
+    /// \param [in] random Генератор
+    static void appendBinary( std::string &data, size_t size, random_t &random );
+
+    /// \brief Дописать байты с частотами, убывающими вдвое
+    /// \param [in,out] data Данные
+    /// \param [in] size Размер дописываемой части
+    /// \param [in] random Генератор
+    static void appendSkewed( std::string &data, size_t size, random_t &random );
+
+    /// \brief Дописать данные указанного вида
+    /// \param [in] corpus Вид данных, кроме смешанного
+    /// \param [in,out] data Данные
+    /// \param [in] size Размер дописываемой части
+    /// \param [in] random Генератор
+    static void append( eCorpus corpus, std::string &data, size_t size, random_t &random );
+
+    /// \brief Размер словаря текста
+    constexpr static size_t WORD_COUNT = 2048;
+
+    /// \brief Размер записи двоичных данных
+    constexpr static size_t RECORD_SIZE = 32;
+
+    /// \brief Количество разных байт перекошенных данных
+    constexpr static size_t SKEWED_SYMBOL_COUNT = 48;
+
+    /// \brief Наибольший размер участка смешанных данных
+    constexpr static size_t MAX_MIXED_CHUNK = 1024 * 1024;
+};
+
+/// @}
+
+#endif // CCORPUSGENERATOR_H
@@ -0,0 +1,260 @@
+/** ****************************************************************************
+ * \brief Исходные коды генератора тестовых данных
+ *
+ * \file cCorpusGenerator.cpp
+ * ****************************************************************************/
+
+#include "bench/cCorpusGenerator/h/cCorpusGenerator.h" /// Заголовок класса
+#include <algorithm> /// std::min
+#include <array> /// Массивы фиксированного размера
+#include <cstdio> /// std::snprintf
+#include <vector> /// Вектор
+
+/// \brief Имена видов данных в порядке \ref cCorpusGenerator::eCorpus
+static constexpr std::array< std::string_view, cCorpusGenerator::CORPUS_COUNT > CORPUS_NAMES =
+{
+    "text", "logs", "runs", "random", "binary", "mixed", "skewed"
+};
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+std::string cCorpusGenerator::generate( eCorpus corpus, size_t size, uint64_t seed )
+{
+    random_t random( seed );
+
+    std::string data;
+    data.reserve( size );
+
+    if( CORPUS_MIXED != corpus )
+    {
+        append( corpus, data, size, random );
+    }
+    else
+    {
+        /// Участки случайного вида и размера, чтобы блоки сжимались по-разному
+        while( data.size() < size )
+        {
+            const auto chunkCorpus = eCorpus( below( random, CORPUS_MIXED ) );
+            const size_t chunkSize = MAX_MIXED_CHUNK / 16 + below( random, MAX_MIXED_CHUNK );
+            append( chunkCorpus, data, std::min( chunkSize, size - data.size() ), random );
+        }
+    }
+
+    data.resize( size );
+    return data;
+}
+
+std::string_view cCorpusGenerator::getName( eCorpus corpus ) noexcept
+{
+    return corpus < CORPUS_COUNT ? CORPUS_NAMES[ corpus ] : std::string_view();
+}
+
+std::tuple< cCorpusGenerator::eCorpus, bool > cCorpusGenerator::fromName( std::string_view name ) noexcept
+{
+    for( size_t i = 0; i < CORPUS_NAMES.size(); ++i )
+        if( CORPUS_NAMES[ i ] == name )
+            return std::make_tuple( eCorpus( i ), true );
+
+    return std::make_tuple( CORPUS_COUNT, false );
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+void cCorpusGenerator::appendText( std::string &data, size_t size, random_t &random )
+{
+    static constexpr std::array< std::string_view, 24 > SYLLABLES =
+    {
+        "ka", "lo", "mi", "ne", "ra", "to", "su", "vi", "de", "pa", "ko", "li",
+        "an", "er", "in", "on", "st", "th", "pr", "ch", "ing", "ment", "tion", "al"
+    };
+
+    /// Словарь из слов в 1-4 слога
+    std::vector< std::string > words( WORD_COUNT );
+    for( std::string &word : words )
+        for( uint64_t count = 1 + below( random, 4 ); count > 0; --count )
+            word += SYLLABLES[ below( random, SYLLABLES.size() ) ];
+
+    const size_t target = data.size() + size;
+    size_t wordsInSentence = 0;
+    size_t sentencesInParagraph = 0;
+    while( data.size() < target )
+    {
+        /// Произведение двух равномерных номеров - частые слова в начале
+        /// словаря, как в естественном языке
+        const size_t rank = below( random, WORD_COUNT ) * below( random, WORD_COUNT ) / WORD_COUNT;
+        std::string_view word( words[ rank ] );
+
+        if( 0 == wordsInSentence )
+        {
+            data += char( word.front() - 'a' + 'A' );
+            word.remove_prefix( 1 );
+        }
+
+        data += word;
+        ++wordsInSentence;
+
+        if( wordsInSentence > 4 && 0 == below( random, 8 ) )
+        {
+            data += 0 == below( random, 6 ) ? "?" : ".";
+            wordsInSentence = 0;
+            ++sentencesInParagraph;
+
+            data += sentencesInParagraph > 3 && 0 == below( random, 4 ) ? "\n\n" : " ";
+            if( '\n' == data.back() )
+                sentencesInParagraph = 0;
+        }
+        else
+        {
+            data += 0 == below( random, 12 ) ? ", " : " ";
+        }
+    }
+}
+
+void cCorpusGenerator::appendLogs( std::string &data, size_t size, random_t &random )
+{
+    static constexpr std::array< const char *, 4 > LEVELS = { "INFO ", "DEBUG", "WARN ", "ERROR" };
+    static constexpr std::array< const char *, 6 > PATHS =
+    {
+        "/api/v1/files", "/api/v1/files/upload", "/api/v1/jobs", "/api/v1/jobs/status", "/health", "/metrics"
+    };
+    static constexpr std::array< int, 6 > CODES = { 200, 200, 200, 201, 404, 500 };
+
+    const size_t target = data.size() + size;
+    uint64_t timestamp = 1700000000000ull;
+    uint64_t requestId = 100000 + below( random, 100000 );
+    char line[ 256 ];
+    while( data.size() < target )
+    {
+        timestamp += below( random, 50 );
+        ++requestId;
+
+        /// Уровни и коды ответов с неравномерными частотами
+        const uint64_t levelRoll = below( random, 100 );
+        const size_t level = levelRoll < 70 ? 0 : levelRoll < 90 ? 1 : levelRoll < 98 ? 2 : 3;
+
+        const int length = std::snprintf( line, sizeof( line ),
+                                          "%llu.%03llu %s [worker-%llu] req=%llu client=10.0.%llu.%llu "
+                                          "method=%s path=%s status=%d latency=%llums\n",
+                                          ( unsigned long long )( timestamp / 1000 ),
+                                          ( unsigned long long )( timestamp % 1000 ),
+                                          LEVELS[ level ],
+                                          ( unsigned long long )below( random, 16 ),
+                                          ( unsigned long long )requestId,
+                                          ( unsigned long long )below( random, 4 ),
+                                          ( unsigned long long )below( random, 256 ),
+                                          0 == below( random, 4 ) ? "POST" : "GET",
+                                          PATHS[ below( random, PATHS.size() ) ],
+                                          CODES[ below( random, CODES.size() ) ],
+                                          ( unsigned long long )( below( random, 20 ) * below( random, 20 ) ) );
+        data.append( line, length );
+    }
+}
+
+void cCorpusGenerator::appendRuns( std::string &data, size_t size, random_t &random )
+{
+    const size_t target = data.size() + size;
+    while( data.size() < target )
+    {
+        /// Длинная серия, затем иногда короткая вставка разных байт
+        data.append( 16 + below( random, 4096 ), char( below( random, 8 ) ) );
+
+        if( 0 == below( random, 4 ) )
+            for( uint64_t count = 1 + below( random, 32 ); count > 0; --count )
+                data += char( random() );
+    }
+}
+
+void cCorpusGenerator::appendRandom( std::string &data, size_t size, random_t &random )
+{
+    const size_t target = data.size() + size;
+    while( data.size() < target )
+    {
+        uint64_t value = random();
+        for( size_t i = 0; i < sizeof( value ); ++i, value >>= 8 )
+            data += char( value );
+    }
+}
+
+void cCorpusGenerator::appendBinary( std::string &data, size_t size, random_t &random )
+{
+    /// Запись: номер (4 байта), время (4), тип (2), флаги (2), значение -
+    /// случайное блуждание (8), метка из 12 символов с нулевым хвостом
+    const auto appendLittleEndian = [ &data ]( uint64_t value, size_t byteCount )
+    {
+        for( size_t i = 0; i < byteCount; ++i, value >>= 8 )
+            data += char( value );
+    };
+
+    const size_t target = data.size() + size;
+    uint32_t id = uint32_t( below( random, 1000 ) );
+    uint32_t time = 1700000000u;
+    int64_t value = 0;
+    char tag[ RECORD_SIZE - 20 ];
+    while( data.size() < target )
+    {
+        ++id;
+        time += uint32_t( below( random, 3 ) );
+        value += int64_t( below( random, 201 ) ) - 100;
+
+        appendLittleEndian( id, 4 );
+        appendLittleEndian( time, 4 );
+        appendLittleEndian( below( random, 8 ), 2 );
+        appendLittleEndian( 0 == below( random, 16 ) ? 0x8001 : 0x0001, 2 );
+        appendLittleEndian( uint64_t( value ), 8 );
+
+        const int length = std::snprintf( tag, sizeof( tag ), "sensor-%02llu",
+                                          ( unsigned long long )below( random, 64 ) );
+        data.append( tag, length );
+        data.append( sizeof( tag ) - length, '\0' );
+    }
+}
+
+void cCorpusGenerator::appendSkewed( std::string &data, size_t size, random_t &random )
+{
+    /// Номер байта - количество единиц подряд в младших битах случайного
+    /// числа: каждый следующий байт встречается вдвое реже предыдущего
+    const size_t target = data.size() + size;
+    while( data.size() < target )
+    {
+        uint64_t value = random();
+        size_t symbol = 0;
+        while( ( value & 1 ) && symbol + 1 < SKEWED_SYMBOL_COUNT )
+        {
+            value >>= 1;
+            ++symbol;
+        }
+
+        data += char( 'A' + symbol );
+    }
+}
+
+void cCorpusGenerator::append( eCorpus corpus, std::string &data, size_t size, random_t &random )
+{
+    switch( corpus )
+    {
+    case CORPUS_TEXT:
+        appendText( data, size, random );
+        break;
+    case CORPUS_LOGS:
+        appendLogs( data, size, random );
+        break;
+    case CORPUS_RUNS:
+        appendRuns( data, size, random );
+        break;
+    case CORPUS_RANDOM:
+        appendRandom( data, size, random );
+        break;
+    case CORPUS_BINARY:
+        appendBinary( data, size, random );
+        break;
+    case CORPUS_SKEWED:
+        appendSkewed( data, size, random );
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,314 @@
+/** ****************************************************************************
+ * \file main.cpp
+ *
+ * \brief Точка входа программы замеров \ref Bench
+ *
+ * \details Запуск:
+ *
+ *     bench [параметры]
+ *     bench --compare <базовый.csv> <текущий.csv> [--threshold <проценты>]
+ *
+ * Параметры (списки - через запятую):
+ * - --corpus <виды> - виды данных, по умолчанию все. Распакованные данные
+ *   сверяются с исходными, несовпадение - ошибка замера;
+ * - --algorithm <имена> - алгоритмы (RLE, Haffman), по умолчанию все;
+ * - --block-size <размеры> - размеры блока, суффиксы K и M, 0 - данные
+ *   одним блоком. По умолчанию 1M и 4M;
+ * - --threads <числа> - количества потоков, по умолчанию 1 и все доступные;
+ * - --size <размер> - размер каждого набора данных, по умолчанию 16M;
+ * - --iterations <число> - прогонов с замером, по умолчанию 5;
+ * - --seed <число> - начальное значение генератора данных;
+ * - --format json|csv - формат отчета, по умолчанию json;
+ * - --output <файл> - файл отчета, по умолчанию стандартный вывод;
+ * - --baseline <файл.csv> - сравнить результаты с сохраненными;
+ * - --threshold <проценты> - допустимое ухудшение, по умолчанию 5.
+ *
+ * Ход замеров выводится в стандартный поток ошибок. Код возврата: 0 - успех,
+ * 1 - ошибка замера или ухудшение относительно базовых результатов,
+ * 2 - неверные параметры.
+ * ****************************************************************************/
+
+#include "algorithm/cAlgorithmRegistry/h/cAlgorithmRegistry.h" /// Все алгоритмы программы
+#include "bench/cBenchReport/h/cBenchReport.h" /// Отчеты замеров
+#include "bench/cBenchRunner/h/cBenchRunner.h" /// Выполнение замеров
+#include "cFileWorker/h/cFileWorker.h" /// Размер блока по умолчанию
+#include "threadPool/h/cThreadPool.h" /// Количество доступных процессоров
+#include <cstdio> /// std::fprintf
+#include <cstdlib> /// std::strtoull, std::strtod
+#include <fstream> /// Файлы отчетов
+#include <iterator> /// std::istreambuf_iterator
+#include <string> /// Строки
+#include <vector> /// Вектор
+
+/// \brief Код возврата при ошибке замера или ухудшении
+static constexpr int EXIT_FAILED = 1;
+/// \brief Код возврата при неверных параметрах
+static constexpr int EXIT_USAGE = 2;
+
+/// \brief Разобрать размер с необязательным суффиксом K или M
+/// \param [in] text Текст
+/// \param [out] size Размер в байтах
+/// \return true - размер разобран
+static bool parseSize( const std::string &text, uint64_t &size )
+{
+    char *end = nullptr;
+    size = std::strtoull( text.c_str(), &end, 10 );
+    if( end == text.c_str() )
+        return false;
+
+    const std::string suffix( end );
+    if( "K" == suffix || "k" == suffix )
+        size *= 1024;
+    else if( "M" == suffix || "m" == suffix )
+        size *= 1024 * 1024;
+    else if( !suffix.empty() )
+        return false;
+
+    return true;
+}
+
+/// \brief Разобрать список через запятую
+/// \param [in] text Текст
+/// \param [in] parseItem Разбор одного элемента
+/// \return true - все элементы разобраны и список не пуст
+template< typename F >
+static bool parseList( const std::string &text, F &&parseItem )
+{
+    size_t begin = 0;
+    for( ;; )
+    {
+        const size_t end = text.find( ',', begin );
+        if( !parseItem( text.substr( begin, end - begin ) ) )
+            return false;
+
+        if( std::string::npos == end )
+            return true;
+
+        begin = end + 1;
+    }
+}
+
+/// \brief Прочитать файл целиком
+/// \param [in] path Путь до файла
+/// \param [out] data Содержимое
+/// \return true - файл прочитан
+static bool readFile( const std::string &path, std::string &data )
+{
+    std::ifstream file( path, std::ios::binary );
+    if( !file )
+        return false;
+
+    data.assign( std::istreambuf_iterator< char >( file ), std::istreambuf_iterator< char >() );
+    return true;
+}
+
+/// \brief Прочитать результаты из сохраненного отчета CSV
+/// \param [in] path Путь до отчета
+/// \param [out] results Результаты
+/// \return true - отчет прочитан
+static bool readResults( const std::string &path, std::vector< cBenchRunner::sResult > &results )
+{
+    std::string csv;
+    eErrStatus status = ERR_STATUS_BAD_FILE_OPEN;
+    if( readFile( path, csv ) )
+        std::tie( results, status ) = cBenchReport::fromCsv( csv );
+
+    if( ERR_STATUS_SUCCESS != status )
+        std::fprintf( stderr, "Не удалось прочитать отчет %s\n", path.c_str() );
+
+    return ERR_STATUS_SUCCESS == status;
+}
+
+/// \brief Вывести ухудшения
+/// \param [in] regressions Ухудшения
+/// \return Код возврата: 0 - ухудшений нет
+static int reportRegressions( const std::vector< cBenchReport::sRegression > &regressions )
+{
+    for( const cBenchReport::sRegression &regression : regressions )
+        std::fprintf( stderr, "УХУДШЕНИЕ %s: %s %+.1f%%\n", cBenchReport::describe( regression.mCurrent ).c_str(),
+                      regression.mMetric.c_str(), regression.mChange );
+
+    if( regressions.empty() )
+        std::fprintf( stderr, "Ухудшений нет\n" );
+
+    return regressions.empty() ? 0 : EXIT_FAILED;
+}
+
+/// \brief Вывести справку о параметрах
+static void printUsage( void )
+{
+    std::fprintf( stderr,
+                  "bench [--corpus text,logs,runs,random,binary,mixed,skewed] [--algorithm RLE,Haffman]\n"
+                  "      [--block-size 1M,4M] [--threads 1,8] [--size 16M] [--iterations 5] [--seed N]\n"
+                  "      [--format json|csv] [--output file] [--baseline base.csv] [--threshold 5]\n"
+                  "bench --compare base.csv current.csv [--threshold 5]\n" );
+}
+
+int main( int argc, char **argv )
+{
+    cBenchRunner::sConfig config;
+    std::string format( "json" );
+    std::string outputPath;
+    std::string baselinePath;
+    std::vector< std::string > comparePaths;
+    double threshold = cBenchReport::DEFAULT_THRESHOLD;
+
+    for( int i = 1; i < argc; ++i )
+    {
+        const std::string option( argv[ i ] );
+        const bool hasValue = i + 1 < argc;
+        const std::string value( hasValue ? argv[ i + 1 ] : "" );
+        bool isValid = hasValue;
+
+        if( "--corpus" == option )
+        {
+            isValid = isValid && parseList( value, [ &config ]( const std::string &name )
+            {
+                const auto [ corpus, isKnown ] = cCorpusGenerator::fromName( name );
+                config.mCorpora.push_back( corpus );
+                return isKnown;
+            } );
+        }
+        else if( "--algorithm" == option )
+        {
+            isValid = isValid && parseList( value, [ &config ]( const std::string &name )
+            {
+                const auto [ algorithm, isKnown ] = cBenchRunner::algorithmFromName( name );
+                config.mAlgorithms.push_back( algorithm );
+                return isKnown;
+            } );
+        }
+        else if( "--block-size" == option )
+        {
+            isValid = isValid && parseList( value, [ &config ]( const std::string &text )
+            {
+                config.mBlockSizes.push_back( 0 );
+                return parseSize( text, config.mBlockSizes.back() );
+            } );
+        }
+        else if( "--threads" == option )
+        {
+            isValid = isValid && parseList( value, [ &config ]( const std::string &text )
+            {
+                const uint64_t threads = std::strtoull( text.c_str(), nullptr, 10 );
+                config.mThreadCounts.push_back( threads );
+                return threads > 0;
+            } );
+        }
+        else if( "--size" == option )
+        {
+            uint64_t size = 0;
+            isValid = isValid && parseSize( value, size ) && size > 0;
+            config.mCorpusSize = size;
+        }
+        else if( "--iterations" == option )
+        {
+            config.mIterations = std::strtoull( value.c_str(), nullptr, 10 );
+            isValid = isValid && config.mIterations > 0;
+        }
+        else if( "--seed" == option )
+        {
+            config.mSeed = std::strtoull( value.c_str(), nullptr, 10 );
+        }
+        else if( "--format" == option )
+        {
+            format = value;
+            isValid = isValid && ( "json" == format || "csv" == format );
+        }
+        else if( "--output" == option )
+        {
+            outputPath = value;
+        }
+        else if( "--baseline" == option )
+        {
+            baselinePath = value;
+        }
+        else if( "--threshold" == option )
+        {
+            threshold = std::strtod( value.c_str(), nullptr );
+        }
+        else if( "--compare" == option )
+        {
+            isValid = i + 2 < argc;
+            if( isValid )
+                comparePaths = { argv[ i + 1 ], argv[ i + 2 ] };
+            ++i;
+        }
+        else
+        {
+            isValid = false;
+        }
+
+        if( !isValid )
+        {
+            printUsage();
+            return EXIT_USAGE;
+        }
+
+        ++i;
+    }
+
+    /// Сравнение двух сохраненных отчетов без замеров
+    if( !comparePaths.empty() )
+    {
+        std::vector< cBenchRunner::sResult > baseline;
+        std::vector< cBenchRunner::sResult > current;
+        if( !readResults( comparePaths[ 0 ], baseline ) || !readResults( comparePaths[ 1 ], current ) )
+            return EXIT_USAGE;
+
+        return reportRegressions( cBenchReport::compare( baseline, current, threshold ) );
+    }
+
+    std::vector< cBenchRunner::sResult > baseline;
+    if( !baselinePath.empty() && !readResults( baselinePath, baseline ) )
+        return EXIT_USAGE;
+
+    /// Значения по умолчанию
+    if( config.mCorpora.empty() )
+        for( size_t corpus = 0; corpus < cCorpusGenerator::CORPUS_COUNT; ++corpus )
+            config.mCorpora.push_back( cCorpusGenerator::eCorpus( corpus ) );
+
+    if( config.mAlgorithms.empty() )
+        config.mAlgorithms.assign( cAlgorithmRegistry::TYPES.begin(), cAlgorithmRegistry::TYPES.end() );
+
+    if( config.mBlockSizes.empty() )
+        config.mBlockSizes = { 1024 * 1024, cFileWorker::DEFAULT_BLOCK_SIZE };
+
+    if( config.mThreadCounts.empty() )
+    {
+        config.mThreadCounts = { 1 };
+        if( cThreadPool::getAvailableCpuCount() > 1 )
+            config.mThreadCounts.push_back( cThreadPool::getAvailableCpuCount() );
+    }
+
+    bool isFailed = false;
+    const std::vector< cBenchRunner::sResult > results = cBenchRunner::run( config,
+        [ &isFailed ]( const cBenchRunner::sResult &result, size_t index, size_t total )
+        {
+            isFailed = isFailed || ERR_STATUS_SUCCESS != result.mStatus;
+            std::fprintf( stderr, "[%zu/%zu] %s: ", index, total, cBenchReport::describe( result ).c_str() );
+            if( ERR_STATUS_SUCCESS == result.mStatus )
+                std::fprintf( stderr, "ratio %.3f, compress %.1f MB/s, decompress %.1f MB/s\n",
+                              result.getRatio(), result.mCompressSpeed, result.mDecompressSpeed );
+            else
+                std::fprintf( stderr, "ошибка %d\n", int( result.mStatus ) );
+        } );
+
+    const std::string report( "csv" == format ? cBenchReport::toCsv( results )
+                                              : cBenchReport::toJson( config, results ) );
+    if( outputPath.empty() )
+    {
+        std::fwrite( report.data(), 1, report.size(), stdout );
+    }
+    else if( !( std::ofstream( outputPath, std::ios::binary ) << report ) )
+    {
+        std::fprintf( stderr, "Не удалось записать отчет %s\n", outputPath.c_str() );
+        return EXIT_FAILED;
+    }
+
+    const int compareResult = baselinePath.empty() ? 0
+                                                   : reportRegressions( cBenchReport::compare( baseline, results,
+                                                                                               threshold ) );
+
+    return isFailed ? EXIT_FAILED : compareResult;
+}
@@ -0,0 +1,273 @@
+/** ****************************************************************************
+ * \file cBlockFormat.h
+ *
+ * \defgroup BlockFormat Блочный формат
+ * @{
+ *
+ * \brief Модуль, описывающий формат сжатого файла, разбитого на блоки
+ *
+ * \details Для параллельной обработки исходные данные делятся на независимые
+ * блоки одинакового размера (последний блок может быть меньше). Каждый блок
+ * сжимается выбранным алгоритмом отдельно, поэтому блоки могут сжиматься и
+ * распаковываться одновременно.
+ *
+ * Сжатый файл:
+ * [ < Заголовок (32 байта) > < Индекс блоков (8 или 12 байт на блок) >
+ * < Сумма содержимого (4 байта, если есть суммы) > < Блоки > ].
+ *
+ * Заголовок (все числа - старшим байтом вперед, как и в \ref AlgorithmHaffman):
+ * - 4 байта - сигнатура "CMPB";
+ * - 1 байт - версия формата;
+ * - 1 байт - тип алгоритма \ref eTypeOfComprAlgorithm;
+ * - 2 байта - флаги \ref cBlockFormat::eFlags. Файл с неизвестными флагами
+ * не читается;
+ * - 8 байт - размер исходных данных;
+ * - 8 байт - размер блока исходных данных;
+ * - 8 байт - количество блоков.
+ *
+ * Запись индекса: старший байт - тип блока \ref cBlockFormat::eBlockType,
+ * остальные 7 байт - размер блока в сжатом файле. Размер исходного блока
+ * не хранится, т.к. однозначно вычисляется по его номеру.
+ *
+ * С флагом \ref cBlockFormat::FLAG_CHECKSUMS за каждой записью индекса
+ * следует CRC32C исходного блока (\ref Checksum), а за индексом - CRC32C
+ * всего исходного содержимого. Суммы блоков считаются в задачах сжатия, а
+ * сумма содержимого получается из них без отдельного прохода по данным.
+ *
+ * Если алгоритм не уменьшил блок (например, RLE на случайных данных),
+ * блок записывается без сжатия.
+ *
+ * Блок, целиком состоящий из нулей (в том числе дыра разреженного файла),
+ * данных не содержит: размер в индексе равен нулю. При распаковке на его
+ * месте остается дыра.
+ *
+ * Файлы, не начинающиеся с сигнатуры, считаются сжатыми целиком (формат
+ * предыдущих версий программы). Файл с сигнатурой, но с испорченным
+ * заголовком, так не читается - это ошибка формата.
+ *
+ * Реализован с поиощью класса \ref cBlockFormat
+ * ****************************************************************************/
+
+#ifndef CBLOCKFORMAT_H
+#define CBLOCKFORMAT_H
+
+#include "common.h" /// Общие константы программы
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+#include <tuple> /// Кортежи
+#include <vector> /// Вектор
+
+/// \brief Класс, реализующий чтение и запись заголовка блочного формата
+/// \class cBlockFormat
+class cBlockFormat final
+{
+public:
+    /// \brief Типы блоков
+    /// \enum eBlockType
+    enum eBlockType : uint8_t
+    {
+        BLOCK_TYPE_CODEC = 0, ///< Блок сжат алгоритмом
+        BLOCK_TYPE_STORED = 1, ///< Блок записан без сжатия
+        BLOCK_TYPE_ZERO = 2 ///< Блок из нулей (дыра разреженного файла), данных нет
+    };
+
+    /// \brief Флаги заголовка
+    /// \enum eFlags
+    enum eFlags : uint16_t
+    {
+        FLAG_CHECKSUMS = 1 ///< Индекс содержит суммы блоков и содержимого
+    };
+
+    /// \brief Структура, описывающая блок в индексе
+    /// \struct sBlockInfo
+    struct sBlockInfo
+    {
+        /// \brief Тип блока
+        eBlockType mType = BLOCK_TYPE_CODEC;
+        /// \brief Размер блока в сжатом файле
+        uint64_t mCmprSize = 0;
+        /// \brief CRC32C исходного блока, если есть флаг FLAG_CHECKSUMS
+        uint32_t mChecksum = 0;
+    };
+
+    /// \brief Структура, описывающая заголовок сжатого файла
+    /// \struct sHeader
+    struct sHeader
+    {
+        /// \brief Алгоритм, которым сжаты блоки
+        eTypeOfComprAlgorithm mAlgType = ALG_TYPE_RLE;
+        /// \brief Размер исходных данных
+        uint64_t mRawSize = 0;
+        /// \brief Размер блока исходных данных
+        uint64_t mBlockSize = 0;
+        /// \brief Флаги \ref eFlags
+        uint16_t mFlags = 0;
+        /// \brief CRC32C исходного содержимого, если есть флаг FLAG_CHECKSUMS
+        uint32_t mContentChecksum = 0;
+        /// \brief Индекс блоков
+        std::vector< sBlockInfo > mBlocks;
+    };
+
+    /// \brief Размер заголовка без индекса
+    constexpr static size_t HEADER_FIXED_SIZE = 32;
+    /// \brief Размер одной записи индекса без суммы
+    constexpr static size_t INDEX_ENTRY_SIZE = 8;
+    /// \brief Размер контрольной суммы
+    constexpr static size_t CHECKSUM_SIZE = 4;
+    /// \brief Все известные флаги
+    constexpr static uint16_t KNOWN_FLAGS = FLAG_CHECKSUMS;
+    /// \brief Текущая версия формата
+    constexpr static uint8_t FORMAT_VERSION = 1;
+
+    /// \brief Количество блоков для данных заданного размера
+    /// \param [in] rawSize Размер исходных данных
+    /// \param [in] blockSize Размер блока
+    /// \return Количество блоков
+    static inline uint64_t getBlockCount( uint64_t rawSize, uint64_t blockSize ) noexcept
+    {
+        /// Без rawSize + blockSize - 1: сумма переполняется на испорченном
+        /// заголовке
+        return blockSize ? rawSize / blockSize + ( 0 != rawSize % blockSize ) : 0;
+    }
+
+    /// \brief Размер одной записи индекса
+    /// \param [in] flags Флаги заголовка
+    /// \return Размер в байтах
+    static inline size_t getIndexEntrySize( uint16_t flags ) noexcept
+    {
+        return INDEX_ENTRY_SIZE + ( ( flags & FLAG_CHECKSUMS ) ? CHECKSUM_SIZE : 0 );
+    }
+
+    /// \brief Размер заголовка вместе с индексом
+    /// \param [in] blockCount Количество блоков
+    /// \param [in] flags Флаги заголовка
+    /// \return Размер в байтах
+    static inline size_t getHeaderSize( uint64_t blockCount, uint16_t flags ) noexcept
+    {
+        return HEADER_FIXED_SIZE + blockCount * getIndexEntrySize( flags ) +
+               ( ( flags & FLAG_CHECKSUMS ) ? CHECKSUM_SIZE : 0 );
+    }
+
+    /// \brief Наибольший размер сжатых данных. Блок, который алгоритм не
+    /// уменьшил, хранится без сжатия, поэтому ни один блок не больше исходного
+    /// \param [in] rawSize Размер исходных данных
+    /// \param [in] blockSize Размер блока
+    /// \param [in] flags Флаги заголовка
+    /// \return Размер в байтах
+    static inline uint64_t getCompressBound( uint64_t rawSize, uint64_t blockSize, uint16_t flags ) noexcept
+    {
+        return getHeaderSize( getBlockCount( rawSize, blockSize ), flags ) + rawSize;
+    }
+
+    /// \brief Размер исходного блока с номером blockIndex
+    /// \param [in] header Заголовок
+    /// \param [in] blockIndex Номер блока
+    /// \return Размер исходного блока
+    static uint64_t getRawBlockSize( const sHeader &header, size_t blockIndex ) noexcept;
+
+    /// \brief Смещения блоков в сжатых данных - префиксные суммы размеров
+    /// из индекса
+    /// \param [in] header Заголовок
+    /// \param [in] headerSize Размер заголовка с индексом
+    /// \return Смещение каждого блока от начала сжатых данных
+    static std::vector< uint64_t > getBlockOffsets( const sHeader &header, size_t headerSize );
+
+    /// \brief Сериализовать заголовок вместе с индексом
+    /// \param [in] header Заголовок
+    /// \return Байты заголовка
+    static std::string writeHeader( const sHeader &header );
+
+    /// \brief Проверить, начинаются ли данные с сигнатуры формата
+    /// \param [in] data Начало сжатых данных
+    /// \return true - данные в блочном формате (возможно, испорченные),
+    /// false - данные сжаты целиком предыдущими версиями программы
+    static bool hasSignature( std::string_view data ) noexcept;
+
+    /// \brief Прочитать размер заголовка вместе с индексом
+    ///
+    /// \details Позволяет прочитать из файла сначала HEADER_FIXED_SIZE байт,
+    /// а затем - ровно заголовок с индексом, не читая блоки
+    ///
+    /// \param [in] data Начало сжатых данных, не меньше HEADER_FIXED_SIZE байт
+    ///
+    /// \return Размер заголовка с индексом и статус:
+    /// ERR_STATUS_SUCCESS - сигнатура, версия и флаги корректны,
+    /// ERR_STATUS_BAD_FORMAT - данные не в блочном формате
+    static std::tuple< size_t, eErrStatus > readHeaderSize( std::string_view data );
+
+    /// \brief Прочитать полный размер сжатых данных по заголовку с индексом
+    ///
+    /// \details Позволяет выделить из потока несколько записанных подряд
+    /// сжатых данных: сначала читается заголовок с индексом
+    /// (\ref readHeaderSize), затем - ровно оставшиеся блоки. Сам заголовок
+    /// проверяется при распаковке (\ref readHeader)
+    ///
+    /// \param [in] data Начало сжатых данных, содержащее заголовок с индексом
+    ///
+    /// \return Размер заголовка с индексом и всех блоков и статус:
+    /// ERR_STATUS_SUCCESS - размер прочитан,
+    /// ERR_STATUS_BAD_FORMAT - данные не в блочном формате или заголовок
+    /// неполон
+    static std::tuple< uint64_t, eErrStatus > readContainerSize( std::string_view data );
+
+    /// \brief Прочитать и проверить заголовок
+    ///
+    /// \details Проверяется сигнатура, версия, флаги, соответствие количества
+    /// блоков размеру данных и совпадение суммы размеров блоков с размером
+    /// файла. Контрольные суммы здесь не сверяются - они проверяются при
+    /// распаковке блоков
+    ///
+    /// \param [in] data Начало сжатых данных, содержащее заголовок с индексом
+    /// \param [in] fileSize Полный размер сжатых данных
+    ///
+    /// \return Заголовок, размер заголовка с индексом и статус:
+    /// ERR_STATUS_SUCCESS - заголовок корректен,
+    /// ERR_STATUS_BAD_FORMAT - данные не в блочном формате
+    static std::tuple< sHeader, size_t, eErrStatus > readHeader( std::string_view data, uint64_t fileSize );
+
+    /// \brief Прочитать и проверить заголовок сжатых данных, целиком
+    /// находящихся в памяти
+    /// \param [in] data Сжатые данные
+    /// \return См. \ref readHeader( std::string_view, uint64_t )
+    static inline std::tuple< sHeader, size_t, eErrStatus > readHeader( std::string_view data )
+    {
+        return readHeader( data, data.size() );
+    }
+
+    /// \brief Запись числа старшим байтом вперед. Используется и другими
+    /// форматами программы
+    /// \param [in] clctn Коллекция
+    /// \param [in] value Число
+    template< typename T >
+    static inline void appendBigEndian( std::string &clctn, T value )
+    {
+        for( size_t bt = sizeof( T ); bt > 0; --bt )
+            clctn += static_cast< char >( static_cast< uint64_t >( value ) >> ( 8 * ( bt - 1 ) ) );
+    }
+
+    /// \brief Чтение числа, записанного старшим байтом вперед
+    /// \param [in] clctn Коллекция
+    /// \param [in] shift Сдвиг от начала коллекции
+    /// \return Число
+    template< typename T >
+    static inline T readBigEndian( std::string_view clctn, size_t shift )
+    {
+        uint64_t result = 0;
+        for( size_t bt = 0; bt < sizeof( T ); ++bt )
+            result = ( result << 8 ) | static_cast< uint8_t >( clctn[ shift + bt ] );
+
+        return static_cast< T >( result );
+    }
+
+private:
+    /// \brief Сигнатура формата
+    constexpr static char SIGNATURE[] = { 'C', 'M', 'P', 'B' };
+
+    /// \brief Количество бит под размер блока в записи индекса
+    constexpr static size_t CMPR_SIZE_BITS = 56;
+};
+
+/// @}
+
+#endif // CBLOCKFORMAT_H
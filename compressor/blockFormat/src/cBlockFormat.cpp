@@ -0,0 +1,185 @@
+/** ****************************************************************************
+ * \brief Исходные коды блочного формата
+ *
+ * \file cBlockFormat.cpp
+ * ****************************************************************************/
+
+#include "blockFormat/h/cBlockFormat.h" /// Заголовок класса
+#include "algorithm/cAlgorithmRegistry/h/cAlgorithmRegistry.h" /// Известные типы алгоритмов
+#include <algorithm> /// std::min
+#include <limits> /// std::numeric_limits
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+uint64_t cBlockFormat::getRawBlockSize( const sHeader &header, size_t blockIndex ) noexcept
+{
+    const uint64_t blockStart = blockIndex * header.mBlockSize;
+    if( blockStart >= header.mRawSize )
+        return 0;
+
+    return std::min( header.mBlockSize, header.mRawSize - blockStart );
+}
+
+std::vector< uint64_t > cBlockFormat::getBlockOffsets( const sHeader &header, size_t headerSize )
+{
+    std::vector< uint64_t > offsets( header.mBlocks.size() );
+    uint64_t offset = headerSize;
+    for( size_t i = 0; i < header.mBlocks.size(); ++i )
+    {
+        offsets[ i ] = offset;
+        offset += header.mBlocks[ i ].mCmprSize;
+    }
+
+    return offsets;
+}
+
+std::string cBlockFormat::writeHeader( const sHeader &header )
+{
+    const bool hasChecksums = header.mFlags & FLAG_CHECKSUMS;
+
+    std::string result;
+    result.reserve( getHeaderSize( header.mBlocks.size(), header.mFlags ) );
+
+    result.append( SIGNATURE, sizeof( SIGNATURE ) );
+    appendBigEndian< uint8_t >( result, FORMAT_VERSION );
+    appendBigEndian< uint8_t >( result, header.mAlgType );
+    appendBigEndian< uint16_t >( result, header.mFlags );
+    appendBigEndian< uint64_t >( result, header.mRawSize );
+    appendBigEndian< uint64_t >( result, header.mBlockSize );
+    appendBigEndian< uint64_t >( result, header.mBlocks.size() );
+
+    for( const auto &block : header.mBlocks )
+    {
+        appendBigEndian< uint64_t >( result,
+                                     ( uint64_t( block.mType ) << CMPR_SIZE_BITS ) | block.mCmprSize );
+
+        if( hasChecksums )
+            appendBigEndian< uint32_t >( result, block.mChecksum );
+    }
+
+    if( hasChecksums )
+        appendBigEndian< uint32_t >( result, header.mContentChecksum );
+
+    return result;
+}
+
+bool cBlockFormat::hasSignature( std::string_view data ) noexcept
+{
+    return data.substr( 0, sizeof( SIGNATURE ) ) == std::string_view( SIGNATURE, sizeof( SIGNATURE ) );
+}
+
+std::tuple< size_t, eErrStatus > cBlockFormat::readHeaderSize( std::string_view data )
+{
+    /// Сигнатура, версия и флаги
+    if( data.size() < HEADER_FIXED_SIZE || !hasSignature( data ) ||
+        FORMAT_VERSION != readBigEndian< uint8_t >( data, 4 ) ||
+        0 != ( readBigEndian< uint16_t >( data, 6 ) & ~KNOWN_FLAGS ) )
+    {
+        return std::make_tuple( size_t( 0 ), ERR_STATUS_BAD_FORMAT );
+    }
+
+    /// Защита от переполнения размера на испорченном количестве блоков
+    const uint16_t flags = readBigEndian< uint16_t >( data, 6 );
+    const uint64_t blockCount = readBigEndian< uint64_t >( data, 24 );
+    if( blockCount > ( std::numeric_limits< size_t >::max() - HEADER_FIXED_SIZE - CHECKSUM_SIZE ) /
+                     getIndexEntrySize( flags ) )
+    {
+        return std::make_tuple( size_t( 0 ), ERR_STATUS_BAD_FORMAT );
+    }
+
+    return std::make_tuple( getHeaderSize( blockCount, flags ), ERR_STATUS_SUCCESS );
+}
+
+std::tuple< uint64_t, eErrStatus > cBlockFormat::readContainerSize( std::string_view data )
+{
+    const auto [ headerSize, status ] = readHeaderSize( data );
+    if( ERR_STATUS_SUCCESS != status || headerSize > data.size() )
+        return std::make_tuple( uint64_t( 0 ), ERR_STATUS_BAD_FORMAT );
+
+    const uint16_t flags = readBigEndian< uint16_t >( data, 6 );
+    const uint64_t blockCount = readBigEndian< uint64_t >( data, 24 );
+    const size_t entrySize = getIndexEntrySize( flags );
+
+    /// Защита от переполнения суммы на испорченном индексе
+    uint64_t totalSize = headerSize;
+    for( uint64_t i = 0; i < blockCount; ++i )
+    {
+        const uint64_t entry = readBigEndian< uint64_t >( data, HEADER_FIXED_SIZE + i * entrySize );
+        const uint64_t cmprSize = entry & ( ( uint64_t( 1 ) << CMPR_SIZE_BITS ) - 1 );
+        if( cmprSize > std::numeric_limits< uint64_t >::max() - totalSize )
+            return std::make_tuple( uint64_t( 0 ), ERR_STATUS_BAD_FORMAT );
+
+        totalSize += cmprSize;
+    }
+
+    return std::make_tuple( totalSize, ERR_STATUS_SUCCESS );
+}
+
+std::tuple< cBlockFormat::sHeader, size_t, eErrStatus > cBlockFormat::readHeader( std::string_view data,
+                                                                                uint64_t fileSize )
+{
+    auto badFormat = [](){ return std::make_tuple( sHeader(), size_t( 0 ), ERR_STATUS_BAD_FORMAT ); };
+
+    /// Сигнатура и версия
+    if( ERR_STATUS_SUCCESS != std::get< eErrStatus >( readHeaderSize( data ) ) )
+        return badFormat();
+
+    sHeader header;
+    const uint8_t algType = readBigEndian< uint8_t >( data, 5 );
+    if( !cAlgorithmRegistry::isKnown( algType ) )
+        return badFormat();
+
+    header.mAlgType = eTypeOfComprAlgorithm( algType );
+    header.mFlags = readBigEndian< uint16_t >( data, 6 );
+    header.mRawSize = readBigEndian< uint64_t >( data, 8 );
+    header.mBlockSize = readBigEndian< uint64_t >( data, 16 );
+    const uint64_t blockCount = readBigEndian< uint64_t >( data, 24 );
+
+    /// Количество блоков должно соответствовать размерам. Блок нулевого
+    /// размера не пишется: при нем данные без блоков не восстановить
+    const size_t headerSize = getHeaderSize( blockCount, header.mFlags );
+    if( 0 == header.mBlockSize || ( 0 != header.mRawSize && 0 == blockCount ) ||
+        blockCount != getBlockCount( header.mRawSize, header.mBlockSize ) || headerSize > data.size() )
+    {
+        return badFormat();
+    }
+
+    const bool hasChecksums = header.mFlags & FLAG_CHECKSUMS;
+    const size_t entrySize = getIndexEntrySize( header.mFlags );
+
+    /// Чтение индекса со сверкой общего размера
+    uint64_t totalSize = headerSize;
+    header.mBlocks.resize( blockCount );
+    for( size_t i = 0; i < blockCount; ++i )
+    {
+        const size_t entryShift = HEADER_FIXED_SIZE + i * entrySize;
+        const uint64_t entry = readBigEndian< uint64_t >( data, entryShift );
+        header.mBlocks[ i ].mType = eBlockType( entry >> CMPR_SIZE_BITS );
+        header.mBlocks[ i ].mCmprSize = entry & ( ( uint64_t( 1 ) << CMPR_SIZE_BITS ) - 1 );
+        if( hasChecksums )
+            header.mBlocks[ i ].mChecksum = readBigEndian< uint32_t >( data, entryShift + INDEX_ENTRY_SIZE );
+
+        if( header.mBlocks[ i ].mType > BLOCK_TYPE_ZERO )
+            return badFormat();
+
+        /// Нулевой блок не содержит данных
+        if( BLOCK_TYPE_ZERO == header.mBlocks[ i ].mType && 0 != header.mBlocks[ i ].mCmprSize )
+            return badFormat();
+
+        /// Защита от переполнения суммы на испорченном индексе
+        if( header.mBlocks[ i ].mCmprSize > std::numeric_limits< uint64_t >::max() - totalSize )
+            return badFormat();
+
+        totalSize += header.mBlocks[ i ].mCmprSize;
+    }
+
+    if( totalSize != fileSize )
+        return badFormat();
+
+    if( hasChecksums )
+        header.mContentChecksum = readBigEndian< uint32_t >( data, HEADER_FIXED_SIZE + blockCount * entrySize );
+
+    return std::make_tuple( std::move( header ), headerSize, ERR_STATUS_SUCCESS );
+}
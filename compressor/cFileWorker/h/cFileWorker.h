@@ -25,6 +25,64 @@
  * что и сжатый файл, но с префиксом _. Например, файл text.txt.cmprRLE после
  * декомпрессии будет иметь имя _text.txt и будет идентичен по составу text.txt
  *
+ * Исходный файл отображается в память модулем \ref InputSource, и алгоритмы
+ * получают блоки как представления этого отображения без копирования.
+ *
+ * При сжатии исходные данные делятся на блоки размером \ref cFileWorker::setBlockSize
+ * и обрабатываются конвейером в пуле потоков \ref ThreadPool: задача блока
+ * сжимает его (страницы подгружаются ядром с упреждением), а вызывающий поток
+ * записывает готовые блоки в исходном порядке в блочном формате
+ * \ref BlockFormat. В работе одновременно не больше
+ * \ref cFileWorker::PIPELINE_EXTRA_BLOCKS блоков сверх числа потоков, поэтому
+ * чтение следующих блоков, сжатие и запись предыдущих идут одновременно, а
+ * память под результат не зависит от размера файла. Индекс блоков становится
+ * известен в конце, поэтому заголовок записывается последним на
+ * зарезервированное место в начале файла.
+ *
+ * Блоки, лежащие в дырах разреженного исходного файла, не читаются и не
+ * сжимаются, а блоки из нулей не хранятся: в индекс пишется только их тип.
+ *
+ * Если включены контрольные суммы (\ref cFileWorker::setChecksumEnabled),
+ * задача блока считает CRC32C исходного блока сразу после сжатия, пока блок
+ * в кэше процессора, а поток записи объединяет суммы блоков в сумму всего
+ * содержимого. При распаковке сумма каждого блока сверяется в его задаче,
+ * поэтому испорченные или обрезанные данные дают ошибку формата, а не
+ * неверный результат.
+ *
+ * При распаковке задача каждого блока распаковывает его и записывает
+ * позиционно по смещению, вычисленному из индекса блоков. На месте блоков из
+ * нулей в результате остаются дыры.
+ *
+ * Запись выполняет подсистема \ref IoBackend, выбранная
+ * \ref cFileWorker::setIoBackend. В режиме записи в обход страничного кэша
+ * уже сжатые участки исходного файла также вытесняются из кэша.
+ *
+ * Результат пишется в файл с уникальным именем в директории назначения
+ * (.<имя>.<случайный суффикс>.part), поэтому одновременные задания не
+ * мешают друг другу. Место под файл выделяется заранее по верхней оценке
+ * размера сжатых данных или по известному размеру распакованных. В конце файл
+ * обрезается до итогового размера и атомарно переименовывается в
+ * результирующий. При ошибке временный файл удаляется.
+ *
+ * Если передано задание \ref Job, перед каждым блоком проверяется запрос
+ * отмены, а по готовности блока заданию сообщается его размер.
+ *
+ * Память под блоки ограничивается бюджетом \ref MemoryBudget: предел
+ * задания (\ref cFileWorker::setMemoryLimit) и общий предел программы.
+ * Блоки резервируют оценку памяти алгоритма до начала работы. При сжатии
+ * окно конвейера сужается до числа блоков, помещающихся в предел, а если не
+ * помещается и один блок, размер блока уменьшается вдвое, но не меньше
+ * \ref cFileWorker::MIN_BLOCK_SIZE. При распаковке одновременно
+ * распаковывается столько блоков, сколько помещается в предел. Если предел
+ * меньше памяти одного блока, задание завершается с
+ * ERR_STATUS_MEMORY_LIMIT, а не превышает его. Пик зарезервированной
+ * памяти попадает в отчет задания.
+ *
+ * Каждый вызов \ref cFileWorker::applyAlgorithm собирает статистику
+ * \ref Stats: время чтения, стадий алгоритма, контрольных сумм, ожидания
+ * блоков, записи и переименования. Задачи блоков привязывают к себе
+ * статистику вызова. Отчет - \ref cFileWorker::getLastStats.
+ *
  * Реализован с поиощью класса \ref cFileWorker
  * ****************************************************************************/
 
@@ -34,8 +92,14 @@
 
 #include "common.h" /// Общие константы программы
 #include "algorithm/cAbstractAlgorithm/h/cAbstractAlgorithm.h" /// Интерфейс алгоритмов
-#include <fstream> /// Стандартная библоиотека работы с потоками
-#include <QFile> /// Qt библиотека работы с фаловой системой
+#include "blockFormat/h/cBlockFormat.h" /// Блочный формат сжатых данных
+#include "job/h/cJob.h" /// Асинхронное задание
+#include "memoryBudget/h/cMemoryBudget.h" /// Бюджет памяти
+#include "inputSource/h/cInputSource.h" /// Источник входных данных
+#include "ioBackend/cAbstractIoBackend/h/cAbstractIoBackend.h" /// Подсистемы записи
+#include "stats/cJobStats/h/cJobStats.h" /// Статистика задания
+#include <memory> /// Умные указатели
+#include <functional> /// Обертки функций
 
 /// \brief Класс, реализующий работу с файлами
 /// \class cFileWorker
@@ -45,12 +109,6 @@ public:
     /// \brief Деструктор класса
     ~cFileWorker( void );
 
-    /// \brief Обновить имя файла для записи результата
-    /// \param [in] fileWeitePath Имя файла
-    /// \return ERR_STATUS_SUCCESS в случае успеха, ERR_STATUS_BAD_FILE_OPEN
-    /// в случае ошибки открытия файла
-    eErrStatus updateWriteFile( std::string_view fileWritePath );
-
     /// \brief Обновить имя файла для чтения исходных данных
     /// \param [in] fileReadPath Имя файла
     /// \return ERR_STATUS_SUCCESS в случае успеха, ERR_STATUS_BAD_FILE_OPEN
@@ -61,6 +119,8 @@ public:
     ///
     /// \param [in] algorithm Интерфейс выбранного алгоритма
     /// \param [in] action ACT_TYPE_COMPR - сжатие ACT_TYPE_DECOMPR - распаковка
+    /// \param [in] job Задание, которому сообщается о каждом блоке и которое
+    /// проверяется на отмену перед каждым блоком. Может быть nullptr
     ///
     /// \return
     /// Строка - созданный файл;
@@ -70,20 +130,137 @@ public:
     /// ERR_STATUS_BAD_POSTFIX - при распаковке, если постфикс файла не совпадает
     /// с постфиксом выбранного алгоритма,
     /// ERR_STATUS_EMPTY_SRC_FILE - если исходный файл пуст,
-    /// ERR_STATUS_BAD_ALG - если выполнение алгоритма привело к ошибке
-    std::tuple<std::string, eErrStatus> applyAlgorithm( cAbstractAlgorithm &algorithm, eTypeOfActions action );
+    /// ERR_STATUS_BAD_ALG - если выполнение алгоритма привело к ошибке,
+    /// ERR_STATUS_BAD_FILE_WRITE - в случае ошибки записи результата,
+    /// ERR_STATUS_CANCELED - если задание отменено,
+    /// ERR_STATUS_MEMORY_LIMIT - если блок не помещается в предел памяти
+    std::tuple<std::string, eErrStatus> applyAlgorithm( cAbstractAlgorithm &algorithm, eTypeOfActions action,
+                                                        cJob *job = nullptr );
+
+    /// \brief Установить размер блока исходных данных для сжатия
+    /// \param [in] blockSize Размер блока в байтах. 0 - файл сжимается
+    /// одним блоком
+    inline void setBlockSize( uint64_t blockSize ) noexcept { mBlockSize = blockSize; }
+
+    /// \brief Выбрать подсистему записи. Применяется при следующем
+    /// \ref applyAlgorithm
+    /// \param [in] type Тип подсистемы
+    /// \param [in] isDirect true - писать в обход страничного кэша
+    inline void setIoBackend( eTypeOfIoBackend type, bool isDirect ) noexcept
+    {
+        mIoBackendType = type;
+        mIsDirectIo = isDirect;
+    }
+
+    /// \brief Включить или выключить запись контрольных сумм при сжатии.
+    /// Суммы в сжатых данных при распаковке проверяются всегда
+    /// \param [in] isEnabled true - сохранять суммы блоков и содержимого
+    inline void setChecksumEnabled( bool isEnabled ) noexcept { mIsChecksumEnabled = isEnabled; }
+
+    /// \brief Установить предел памяти задания. Действует вместе с общим
+    /// пределом \ref cMemoryBudget::global
+    /// \param [in] limit Предел в байтах. 0 - без ограничения
+    inline void setMemoryLimit( uint64_t limit ) noexcept { mMemoryLimit = limit; }
+
+    /// \brief Получить отчет о последнем \ref applyAlgorithm
+    /// \return Отчет: объем, время, пик памяти и статистика стадий
+    inline const cJobStats::sReport &getLastStats( void ) const noexcept { return mLastStats; }
+
+    /// \brief Сжать данные в память в блочном формате
+    ///
+    /// \details Блоки сжимаются параллельно в пуле потоков. Предназначено для
+    /// небольших данных: все сжатые блоки одновременно находятся в памяти,
+    /// поэтому они резервируются в общем бюджете сразу вместе с результатом.
+    /// Контрольные суммы сохраняются всегда
+    ///
+    /// \param [in] algorithm Интерфейс алгоритма
+    /// \param [in] data Исходные данные
+    /// \param [in] blockSize Размер блока. 0 - данные сжимаются одним блоком
+    ///
+    /// \return Сжатые данные и статус выполнения:
+    /// ERR_STATUS_SUCCESS - успех,
+    /// ERR_STATUS_EMPTY_SRC_FILE - данные пусты,
+    /// ERR_STATUS_BAD_ALG - если выполнение алгоритма привело к ошибке,
+    /// ERR_STATUS_MEMORY_LIMIT - если данные не помещаются в общий предел
+    static std::tuple<std::string, eErrStatus> compressData( cAbstractAlgorithm &algorithm,
+                                                             std::string_view data,
+                                                             uint64_t blockSize = DEFAULT_BLOCK_SIZE );
+
+    /// \brief Распаковать данные в память
+    ///
+    /// \details Буфер под результат выделяется один раз по размеру из
+    /// заголовка, блоки распаковываются параллельно сразу по своим смещениям.
+    /// Результат и блоки резервируются в общем бюджете
+    ///
+    /// \param [in] algorithm Интерфейс алгоритма
+    /// \param [in] data Сжатые данные
+    ///
+    /// \return Распакованные данные и статус выполнения. При несовпадении
+    /// контрольных сумм - ERR_STATUS_BAD_FORMAT, если результат не
+    /// помещается в общий предел - ERR_STATUS_MEMORY_LIMIT
+    static std::tuple<std::string, eErrStatus> decompressData( cAbstractAlgorithm &algorithm,
+                                                               std::string_view data );
+
+    /// \brief Размер блока по умолчанию
+    constexpr static uint64_t DEFAULT_BLOCK_SIZE = 4 * 1024 * 1024;
+
+    /// \brief Наименьший размер блока, до которого сжатие уменьшает блок,
+    /// чтобы уложиться в предел памяти
+    constexpr static uint64_t MIN_BLOCK_SIZE = 64 * 1024;
+
+    /// \brief Количество блоков конвейера сжатия сверх числа потоков пула:
+    /// один читается впрок, один записывается
+    constexpr static size_t PIPELINE_EXTRA_BLOCKS = 2;
+
+    /// \brief Постфикс временного файла результата
+    constexpr static char TEMP_POSTFIX[] = ".part";
+
+    /// \brief Количество попыток подобрать уникальное имя временного файла
+    constexpr static int TEMP_FILE_ATTEMPTS = 8;
 
 private:
-    /// \brief Поток для записи в файл
-    std::ofstream mFile2Write;
-    /// \brief Поток для чтения файла
-    std::ifstream mFile2Read;
+    /// \brief Файл для записи. Запись позиционная, поэтому блоки могут
+    /// записываться из разных потоков
+    std::unique_ptr< cAbstractIoBackend > mpFile2Write;
+    /// \brief Файл для чтения, отображенный в память
+    cInputSource mFile2Read;
 
-    /// \brief Путь до файла записи
+    /// \brief Путь до временного файла записи
     std::string mFile2WritePath;
     /// \brief Путь до файла чтения
     std::string mFile2ReadPath;
 
+    /// \brief Размер блока исходных данных для сжатия
+    uint64_t mBlockSize = DEFAULT_BLOCK_SIZE;
+
+    /// \brief Тип подсистемы записи
+    eTypeOfIoBackend mIoBackendType = IO_TYPE_URING;
+    /// \brief Запись в обход страничного кэша
+    bool mIsDirectIo = false;
+
+    /// \brief Сохранять контрольные суммы при сжатии
+    bool mIsChecksumEnabled = true;
+
+    /// \brief Предел памяти задания
+    uint64_t mMemoryLimit = cMemoryBudget::UNLIMITED;
+
+    /// \brief Отчет о последнем applyAlgorithm
+    cJobStats::sReport mLastStats;
+
+    /// \brief Структура, описывающая сжатый блок
+    /// \struct sPackedBlock
+    struct sPackedBlock
+    {
+        /// \brief Запись индекса
+        cBlockFormat::sBlockInfo mInfo;
+        /// \brief Сжатые данные блока. Пусто, если блок записывается без
+        /// сжатия - тогда данные берутся из исходного файла, - или состоит
+        /// из нулей
+        std::string mData;
+        /// \brief Статус сжатия
+        eErrStatus mStatus = ERR_STATUS_SUCCESS;
+    };
+
     /// \brief Проерить имя архива на корректность
     ///
     /// \details В случае декомпрессии необходимо, чтобы расширение файла
@@ -95,9 +272,128 @@ private:
     /// \return true - Имя корректно, иначе - false
     bool checkPostfix( const cAbstractAlgorithm &algorithm ) const;
 
-    /// \brief Прочесть данные из файла для чтения
-    /// \return Вектор прочитанных байт и статус выполнения метода
-    std::tuple<std::string, eErrStatus> readData( void );
+    /// \brief Применить алгоритм к выбранным файлам. Выполняется с
+    /// привязанной к потоку статистикой
+    ///
+    /// \param [in] algorithm Интерфейс алгоритма
+    /// \param [in] action Действие
+    /// \param [in] job Задание для отчета и отмены. Может быть nullptr
+    /// \param [in] budget Бюджет памяти задания
+    /// \param [out] stats Статистика, в которую записывается объем данных
+    ///
+    /// \return Созданный файл и статус, как у \ref applyAlgorithm
+    std::tuple< std::string, eErrStatus > runAlgorithm( cAbstractAlgorithm &algorithm, eTypeOfActions action,
+                                                        cJob *job, cMemoryBudget &budget, cJobStats &stats );
+
+    /// \brief Сжать исходные данные в файл для записи конвейером
+    ///
+    /// \details Блок ставится в работу, только если его память
+    /// резервируется в бюджете. Иначе сначала дожидается и записывается
+    /// первый блок окна, а при пустом окне резерв ожидает освобождения
+    /// памяти другими заданиями
+    ///
+    /// \param [in] algorithm Интерфейс алгоритма
+    /// \param [in] data Исходные данные
+    /// \param [in] job Задание для отчета и отмены. Может быть nullptr
+    /// \param [in] budget Бюджет памяти задания
+    ///
+    /// \return Статус выполнения
+    eErrStatus compressFile( cAbstractAlgorithm &algorithm, std::string_view data, cJob *job,
+                             cMemoryBudget &budget ) const;
+
+    /// \brief Сжать один блок. Выполняется в задаче пула
+    ///
+    /// \param [in] algorithm Интерфейс алгоритма
+    /// \param [in] rawBlock Исходный блок
+    /// \param [in] isChecksumEnabled true - рассчитать сумму исходного блока
+    ///
+    /// \return Сжатый блок. Блок из нулей данных не содержит. Если алгоритм
+    /// не уменьшил блок, блок записывается без сжатия
+    static sPackedBlock packBlock( cAbstractAlgorithm &algorithm, std::string_view rawBlock,
+                                   bool isChecksumEnabled );
+
+    /// \brief Сверить контрольную сумму распакованного блока
+    /// \param [in] rawBlock Распакованный блок
+    /// \param [in] checksum Сумма из индекса
+    /// \return true - суммы совпали
+    static bool checkBlock( std::string_view rawBlock, uint32_t checksum );
+
+    /// \brief Проверить, состоит ли блок только из нулей
+    /// \param [in] rawBlock Исходный блок
+    /// \return true - все байты блока нулевые
+    static bool isZeroBlock( std::string_view rawBlock );
+
+    /// \brief Распаковать сжатые данные в файл для записи
+    ///
+    /// \details Если данные не начинаются с сигнатуры блочного формата, они
+    /// распаковываются алгоритмом целиком (файлы предыдущих версий программы).
+    /// Иначе файлу сразу задается итоговый размер, и каждый блок записывается по своему
+    /// смещению потоком, который его распаковал. На месте блоков из нулей
+    /// остаются дыры
+    ///
+    /// \param [in] algorithm Интерфейс алгоритма
+    /// \param [in] data Сжатые данные
+    /// \param [in] job Задание для отчета и отмены. Может быть nullptr
+    /// \param [in] budget Бюджет памяти задания
+    ///
+    /// \return Статус выполнения
+    eErrStatus decompressFile( cAbstractAlgorithm &algorithm, std::string_view data, cJob *job,
+                               cMemoryBudget &budget ) const;
+
+    /// \brief Псевдоним для функции записи распакованного блока по смещению
+    /// \typedef blockWriter_t
+    using blockWriter_t = std::function< bool( uint64_t, std::string_view ) >;
+
+    /// \brief Псевдоним для функции, оставляющей дыру по смещению и размеру
+    /// \typedef holeWriter_t
+    using holeWriter_t = std::function< void( uint64_t, uint64_t ) >;
+
+    /// \brief Параллельно распаковать блоки
+    ///
+    /// \details Если в заголовке есть контрольные суммы, сумма каждого блока
+    /// сверяется до его записи, а сумма содержимого - с объединением сумм
+    /// блоков.
+    ///
+    /// Память всех одновременно распаковываемых блоков резервируется одним
+    /// резервом до начала распаковки: ожидание памяти не может начаться,
+    /// когда часть ее уже удерживается. Если в предел помещается меньше
+    /// блоков, чем потоков в пуле, блоки распаковываются группами
+    ///
+    /// \param [in] algorithm Интерфейс алгоритма
+    /// \param [in] data Сжатые данные
+    /// \param [in] header Прочитанный заголовок
+    /// \param [in] headerSize Размер заголовка с индексом
+    /// \param [in] writer Запись распакованного блока по смещению. Вызывается
+    /// из рабочих потоков
+    /// \param [in] holeWriter Дыра на месте блока из нулей. Вызывается из
+    /// рабочих потоков. Может быть пустой, если результат уже заполнен нулями
+    /// \param [in] job Задание для отчета и отмены. Может быть nullptr
+    /// \param [in] budget Бюджет памяти
+    /// \param [in] resultSize Память под результат в памяти, резервируемая
+    /// вместе с блоками. 0 - результат пишется в файл
+    ///
+    /// \return Статус выполнения - первая ошибка среди блоков.
+    /// ERR_STATUS_BAD_FORMAT - если не совпала контрольная сумма,
+    /// ERR_STATUS_MEMORY_LIMIT - если блок не помещается в предел
+    static eErrStatus decodeBlocks( cAbstractAlgorithm &algorithm,
+                                    std::string_view data,
+                                    const cBlockFormat::sHeader &header,
+                                    size_t headerSize,
+                                    const blockWriter_t &writer,
+                                    const holeWriter_t &holeWriter,
+                                    cJob *job,
+                                    cMemoryBudget &budget,
+                                    uint64_t resultSize );
+
+    /// \brief Создать временный файл для записи результата
+    /// \param [in] resultPath Путь до результирующего файла. Временный
+    /// создается в той же директории
+    /// \return ERR_STATUS_SUCCESS в случае успеха, ERR_STATUS_BAD_FILE_OPEN
+    /// в случае ошибки создания файла
+    eErrStatus openWriteFile( const std::string &resultPath );
+
+    /// \brief Закрыть файл для записи
+    void closeWriteFile( void );
 };
 
 /// @}
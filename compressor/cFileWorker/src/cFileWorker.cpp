@@ -5,9 +5,16 @@
  * ****************************************************************************/
 
 #include "cFileWorker/h/cFileWorker.h" /// Заголовок класса
+#include "threadPool/h/cThreadPool.h" /// Пул потоков
+#include "checksum/h/cChecksum.h" /// Контрольные суммы
 #include <tuple> /// Кортежи
-#include <QString> /// Строки Qt
-#include <QFileInfo> /// Qt класс информации о файле
+#include <algorithm> /// std::min, std::max, std::clamp
+#include <deque> /// Деки
+#include <future> /// Результаты асинхронных задач
+#include <cstdio> /// std::rename, std::remove
+#include <cstring> /// std::memcpy, std::memcmp
+#include <filesystem> /// Размер результата
+#include <random> /// Суффикс временного файла
 
 /** ****************************************************************************
  * Определение API
@@ -15,55 +22,175 @@
 
 cFileWorker::~cFileWorker( void )
 {
-    /// Закрытие ранее открытых потоков
+    /// Закрытие ранее открытых файлов
     mFile2Read.close();
-    mFile2Write.close();
+    closeWriteFile();
 }
 
-eErrStatus cFileWorker::updateWriteFile( std::string_view fileWritePath )
+eErrStatus cFileWorker::updateReadFile( std::string_view fileReadPath )
 {
-    mFile2Write.close();
-    mFile2WritePath = fileWritePath;
-    mFile2Write.open( fileWritePath.data(),
-                      std::ios_base::binary | std::ios_base::out | std::ios_base::trunc );
+    mFile2ReadPath = fileReadPath;
+    return mFile2Read.open( fileReadPath );
+}
 
-    return mFile2Write.is_open() ? ERR_STATUS_SUCCESS : ERR_STATUS_BAD_FILE_OPEN;
+std::tuple< std::string, eErrStatus > cFileWorker::applyAlgorithm( cAbstractAlgorithm &algorithm, eTypeOfActions action,
+                                                                    cJob *job )
+{
+    cJobStats stats;
+    std::tuple< std::string, eErrStatus > result;
+
+    /// Резервы задания учитываются и в общем бюджете
+    cMemoryBudget budget( mMemoryLimit, &cMemoryBudget::global() );
+    {
+        /// Замеры этого потока и задач блоков попадают в статистику вызова
+        const cJobStats::cScope scope( &stats );
+        result = runAlgorithm( algorithm, action, job, budget, stats );
+    }
+
+    mLastStats = stats.getReport();
+    mLastStats.mMemoryLimit = budget.getEffectiveLimit();
+    mLastStats.mPeakReserved = budget.getPeak();
+    mLastStats.mPath = mFile2ReadPath;
+    mLastStats.mAlgType = algorithm.getType();
+    mLastStats.mAction = action;
+    mLastStats.mStatus = std::get< eErrStatus >( result );
+
+    return result;
 }
 
-eErrStatus cFileWorker::updateReadFile( std::string_view fileReadPath )
+std::tuple< std::string, eErrStatus > cFileWorker::compressData( cAbstractAlgorithm &algorithm,
+                                                                  std::string_view data,
+                                                                  uint64_t blockSize )
 {
-    mFile2Read.close();
-    mFile2ReadPath = fileReadPath;
-    mFile2Read.open( fileReadPath.data(),
-                     std::ios_base::binary | std::ios_base::in );
-    return mFile2Read.is_open() ? ERR_STATUS_SUCCESS : ERR_STATUS_BAD_FILE_OPEN;
+    if( data.empty() )
+        return std::make_tuple( std::string(), ERR_STATUS_EMPTY_SRC_FILE );
+
+    cBlockFormat::sHeader header;
+    header.mAlgType = algorithm.getType();
+    header.mRawSize = data.size();
+    header.mBlockSize = blockSize ? blockSize : data.size();
+    header.mFlags = cBlockFormat::FLAG_CHECKSUMS;
+
+    const size_t blockCount = cBlockFormat::getBlockCount( header.mRawSize, header.mBlockSize );
+
+    /// Сжатые блоки и результат находятся в памяти одновременно
+    const uint64_t memoryBound = algorithm.getMemoryBound( header.mRawSize, ACT_TYPE_COMPR )
+                                 + cBlockFormat::getCompressBound( header.mRawSize, header.mBlockSize, header.mFlags );
+    const cMemoryBudget::cReservation reservation( cMemoryBudget::global(), memoryBound );
+    if( !reservation.isReserved() )
+        return std::make_tuple( std::string(), ERR_STATUS_MEMORY_LIMIT );
+
+    std::vector< sPackedBlock > blocks( blockCount );
+    cThreadPool::instance().parallelFor( blockCount, [ & ]( size_t i )
+    {
+        blocks[ i ] = packBlock( algorithm, data.substr( i * header.mBlockSize, header.mBlockSize ), true );
+    } );
+
+    uint64_t resultSize = cBlockFormat::getHeaderSize( blockCount, header.mFlags );
+    for( size_t i = 0; i < blockCount; ++i )
+    {
+        const sPackedBlock &block = blocks[ i ];
+        if( ERR_STATUS_SUCCESS != block.mStatus )
+            return std::make_tuple( std::string(), block.mStatus );
+
+        header.mBlocks.push_back( block.mInfo );
+        header.mContentChecksum = cChecksum::crc32cCombine( header.mContentChecksum, block.mInfo.mChecksum,
+                                                            cBlockFormat::getRawBlockSize( header, i ) );
+        resultSize += block.mInfo.mCmprSize;
+    }
+
+    std::string result( cBlockFormat::writeHeader( header ) );
+    result.reserve( resultSize );
+    for( size_t i = 0; i < blockCount; ++i )
+    {
+        /// Блок без сжатия берется из исходных данных
+        if( cBlockFormat::BLOCK_TYPE_STORED == blocks[ i ].mInfo.mType )
+            result.append( data.substr( i * header.mBlockSize, header.mBlockSize ) );
+        else
+            result.append( blocks[ i ].mData );
+    }
+
+    return std::make_tuple( std::move( result ), ERR_STATUS_SUCCESS );
+}
+
+std::tuple< std::string, eErrStatus > cFileWorker::decompressData( cAbstractAlgorithm &algorithm,
+                                                                    std::string_view data )
+{
+    /// Формат предыдущих версий - данные сжаты целиком
+    if( !cBlockFormat::hasSignature( data ) )
+    {
+        std::string result( algorithm.decompress( data ) );
+        return std::make_tuple( std::move( result ), result.empty() ? ERR_STATUS_BAD_ALG
+                                                                    : ERR_STATUS_SUCCESS );
+    }
+
+    auto [ header, headerSize, formatStatus ] = cBlockFormat::readHeader( data );
+    if( ERR_STATUS_SUCCESS != formatStatus )
+        return std::make_tuple( std::string(), formatStatus );
+
+    if( header.mAlgType != algorithm.getType() )
+        return std::make_tuple( std::string(), ERR_STATUS_BAD_POSTFIX );
+
+    /// Буфер выделяется один раз, блоки копируются по своим смещениям. Размер
+    /// из заголовка проверяется бюджетом до выделения
+    if( !cMemoryBudget::global().isFeasible( header.mRawSize ) )
+        return std::make_tuple( std::string(), ERR_STATUS_MEMORY_LIMIT );
+
+    std::string result( header.mRawSize, '\0' );
+    const eErrStatus status = decodeBlocks( algorithm, data, header, headerSize,
+                                            [ &result ]( uint64_t offset, std::string_view rawBlock )
+                                            {
+                                                std::memcpy( result.data() + offset, rawBlock.data(), rawBlock.size() );
+                                                return true;
+                                            }, holeWriter_t(), nullptr, cMemoryBudget::global(), header.mRawSize );
+
+    if( ERR_STATUS_SUCCESS != status )
+        result.clear();
+
+    return std::make_tuple( std::move( result ), status );
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+bool cFileWorker::checkPostfix( const cAbstractAlgorithm &algorithm ) const
+{
+    /// Поиск последнего вхождения точки
+    const auto dotPos = mFile2ReadPath.find_last_of('.');
+    if( std::string::npos == dotPos )
+        return false;
+
+    /// Получение последнего постфикса
+    const auto curPostfix = mFile2ReadPath.substr( dotPos );
+    if( algorithm.getPostfix() != curPostfix )
+        return false;
+
+    return true;
 }
 
-std::tuple< std::string, eErrStatus > cFileWorker::applyAlgorithm( cAbstractAlgorithm &algorithm, eTypeOfActions action )
+std::tuple< std::string, eErrStatus > cFileWorker::runAlgorithm( cAbstractAlgorithm &algorithm, eTypeOfActions action,
+                                                                  cJob *job, cMemoryBudget &budget, cJobStats &stats )
 {
-    if( !mFile2Read.is_open() || !mFile2Write.is_open() )
+    if( !mFile2Read.isOpen() )
         return std::make_tuple( "", ERR_STATUS_BAD_FILE_OPEN );
 
     /// В случае декомпресси проверяем на правильное имя архива
     if( ACT_TYPE_DECOMPR == action && !checkPostfix( algorithm ) )
         return std::make_tuple( "", ERR_STATUS_BAD_POSTFIX );
 
-    /// Читаем данные из файла для чтения
-    auto [ buffer, readStatus ] = readData();
-    if( ERR_STATUS_SUCCESS != readStatus )
-        return std::make_tuple( "", ERR_STATUS_EMPTY_SRC_FILE );
-
-    /// Выполнение сжатия/распаковки с выбранным алгоритмом
-    std::string resultData( action == ACT_TYPE_COMPR ? algorithm.compress( buffer )
-                                                     : algorithm.decompress( buffer ) );
+    /// Исходный файл отображается в память без копирования
+    cJobStats::cTimer timer( cJobStats::STAGE_READ );
+    auto [ data, readStatus ] = mFile2Read.getData();
+    timer.addBytes( data.size() );
+    timer.stop();
+    stats.setBytes( data.size(), 0 );
 
-    /// Если результат пуст
-    if( resultData.empty() )
-        return std::make_tuple( "", ERR_STATUS_BAD_ALG );
+    if( ERR_STATUS_SUCCESS != readStatus )
+        return std::make_tuple( "", readStatus );
 
-    /// Запись в новый файл
-    mFile2Write.write( reinterpret_cast<char*>( resultData.data() ), resultData.size() );
-    mFile2Write.flush();
+    if( data.empty() )
+        return std::make_tuple( "", ERR_STATUS_EMPTY_SRC_FILE );
 
     /// Добавление постфикса/префикса к имени файла
     std::string newName;
@@ -81,53 +208,517 @@ std::tuple< std::string, eErrStatus > cFileWorker::applyAlgorithm( cAbstractAlgo
         newName.insert( newName.rfind( '/' ) + 1, 1, '_' );
     }
 
-    mFile2Write.close();
-    QFile::rename( QString( mFile2WritePath.data() ), QString::fromStdString( newName ) );
+    timer.next( cJobStats::STAGE_WRITE );
+    const eErrStatus openStatus = openWriteFile( newName );
+    timer.stop();
+
+    if( ERR_STATUS_SUCCESS != openStatus )
+        return std::make_tuple( "", openStatus );
+
+    /// Выполнение сжатия/распаковки с выбранным алгоритмом и запись в новый
+    /// файл конвейером: чтение, обработка и запись блоков идут одновременно
+    eErrStatus algStatus = ACT_TYPE_COMPR == action
+            ? compressFile( algorithm, data, job, budget )
+            : decompressFile( algorithm, data, job, budget );
+
+    /// Дожидание отложенных записей
+    timer.next( cJobStats::STAGE_WRITE );
+    if( ERR_STATUS_SUCCESS == algStatus && !mpFile2Write->flush() )
+        algStatus = ERR_STATUS_BAD_FILE_WRITE;
+
+    closeWriteFile();
+
+    /// Временный файл в той же директории - переименование атомарно и без
+    /// копирования
+    timer.next( cJobStats::STAGE_RENAME );
+    if( ERR_STATUS_SUCCESS == algStatus && 0 != std::rename( mFile2WritePath.c_str(), newName.c_str() ) )
+        algStatus = ERR_STATUS_BAD_FILE_WRITE;
+
+    timer.stop();
+
+    if( ERR_STATUS_SUCCESS != algStatus )
+    {
+        std::remove( mFile2WritePath.c_str() );
+        return std::make_tuple( "", algStatus );
+    }
+
+    std::error_code error;
+    const uint64_t resultSize = std::filesystem::file_size( newName, error );
+    stats.setBytes( data.size(), error ? 0 : resultSize );
 
     return std::make_tuple( newName, ERR_STATUS_SUCCESS );
 }
 
-/** ****************************************************************************
- * Определение приватной части
- * ****************************************************************************/
+eErrStatus cFileWorker::compressFile( cAbstractAlgorithm &algorithm, std::string_view data, cJob *job,
+                                      cMemoryBudget &budget ) const
+{
+    cBlockFormat::sHeader header;
+    header.mAlgType = algorithm.getType();
+    header.mRawSize = data.size();
+    header.mBlockSize = mBlockSize ? mBlockSize : data.size();
+    header.mFlags = mIsChecksumEnabled ? cBlockFormat::FLAG_CHECKSUMS : 0;
 
-bool cFileWorker::checkPostfix( const cAbstractAlgorithm &algorithm ) const
+    cThreadPool &pool = cThreadPool::instance();
+    size_t windowSize = pool.getThreadCount() + PIPELINE_EXTRA_BLOCKS;
+
+    /// Под предел памяти сначала сужается окно, затем уменьшается блок.
+    /// Блок должен помещаться в предел и при распаковке, иначе результат
+    /// не распакуется с тем же пределом
+    const uint64_t memoryLimit = budget.getEffectiveLimit();
+    if( cMemoryBudget::UNLIMITED != memoryLimit )
+    {
+        const auto getBlockBound = [ &algorithm, &header ]( void )
+        {
+            const uint64_t rawBlockSize = std::min( header.mBlockSize, header.mRawSize );
+            return std::max( algorithm.getMemoryBound( rawBlockSize, ACT_TYPE_COMPR ),
+                             algorithm.getMemoryBound( rawBlockSize, ACT_TYPE_DECOMPR ) );
+        };
+
+        while( std::min( header.mBlockSize, header.mRawSize ) > MIN_BLOCK_SIZE && getBlockBound() > memoryLimit )
+            header.mBlockSize = std::max( std::min( header.mBlockSize, header.mRawSize ) / 2, MIN_BLOCK_SIZE );
+
+        if( getBlockBound() > memoryLimit )
+            return ERR_STATUS_MEMORY_LIMIT;
+
+        const uint64_t blockBound = algorithm.getMemoryBound( std::min( header.mBlockSize, header.mRawSize ),
+                                                              ACT_TYPE_COMPR );
+        windowSize = std::clamp< uint64_t >( memoryLimit / blockBound, 1, windowSize );
+    }
+
+    const size_t blockCount = cBlockFormat::getBlockCount( header.mRawSize, header.mBlockSize );
+
+    /// Место выделяется сразу по верхней оценке, лишнее обрезается в конце
+    cJobStats::cTimer timer( cJobStats::STAGE_WRITE );
+    if( !mpFile2Write->allocate( cBlockFormat::getCompressBound( header.mRawSize, header.mBlockSize,
+                                                                 header.mFlags ) ) )
+    {
+        return ERR_STATUS_BAD_FILE_WRITE;
+    }
+
+    timer.stop();
+
+    /// Блоки пишутся сразу за местом, зарезервированным под заголовок
+    uint64_t writeOffset = cBlockFormat::getHeaderSize( blockCount, header.mFlags );
+
+    /// Окно конвейера: задачи блоков [ nextBlock - window.size(), nextBlock )
+    /// и зарезервированная под них память
+    std::deque< std::pair< std::future< sPackedBlock >, uint64_t > > window;
+    size_t nextBlock = 0;
+
+    /// Память записанного блока освобождается в начале следующего шага,
+    /// когда его данные уже разрушены
+    uint64_t releasedBytes = 0;
+    const cMemoryBudget::cancel_t isCanceled = [ job ]( void ) { return job && job->isCanceled(); };
+
+    /// Задачи блоков пишут замеры в статистику задания
+    cJobStats *pStats = cJobStats::current();
+
+    eErrStatus status = ERR_STATUS_SUCCESS;
+    for( size_t i = 0; i < blockCount; ++i )
+    {
+        budget.release( releasedBytes );
+        releasedBytes = 0;
+
+        /// Пополнение окна, пока нет ошибки и отмены
+        while( ERR_STATUS_SUCCESS == status && nextBlock < blockCount && window.size() < windowSize )
+        {
+            if( job && job->isCanceled() )
+            {
+                status = ERR_STATUS_CANCELED;
+                break;
+            }
+
+            const std::string_view rawBlock( data.substr( nextBlock * header.mBlockSize, header.mBlockSize ) );
+
+            /// Дыра разреженного файла не читается и не сжимается
+            if( mFile2Read.isHole( nextBlock * header.mBlockSize, rawBlock.size() ) )
+            {
+                sPackedBlock block;
+                block.mInfo.mType = cBlockFormat::BLOCK_TYPE_ZERO;
+                if( mIsChecksumEnabled )
+                    block.mInfo.mChecksum = cChecksum::crc32cZeros( rawBlock.size() );
+
+                std::promise< sPackedBlock > hole;
+                hole.set_value( std::move( block ) );
+                window.emplace_back( hole.get_future(), 0 );
+                ++nextBlock;
+                continue;
+            }
+
+            /// Пока в окне есть блоки, память освободится их записью. В
+            /// пустом окне резерв ждет освобождения памяти другими заданиями
+            const uint64_t blockBound = algorithm.getMemoryBound( rawBlock.size(), ACT_TYPE_COMPR );
+            if( !window.empty() ? !budget.tryReserve( blockBound ) : !budget.reserve( blockBound, isCanceled ) )
+            {
+                if( window.empty() )
+                    status = isCanceled() ? ERR_STATUS_CANCELED : ERR_STATUS_MEMORY_LIMIT;
+
+                break;
+            }
+
+            window.emplace_back( pool.submit( [ &algorithm, rawBlock, isChecksumEnabled = mIsChecksumEnabled, pStats ]( void )
+            {
+                const cJobStats::cScope scope( pStats );
+                return packBlock( algorithm, rawBlock, isChecksumEnabled );
+            } ), blockBound );
+            ++nextBlock;
+        }
+
+        /// После ошибки задачи в окне только дожидаются: они ссылаются на
+        /// алгоритм и исходные данные
+        if( window.empty() )
+            break;
+
+        timer.next( cJobStats::STAGE_WAIT );
+        sPackedBlock block = pool.get( window.front().first );
+        releasedBytes = window.front().second;
+        window.pop_front();
+        timer.stop();
+
+        if( ERR_STATUS_SUCCESS != status )
+            continue;
+
+        if( ERR_STATUS_SUCCESS != block.mStatus )
+        {
+            status = block.mStatus;
+            continue;
+        }
+
+        /// Блок без сжатия пишется прямо из исходных данных, блок из нулей
+        /// данных не содержит
+        const std::string_view blockData( cBlockFormat::BLOCK_TYPE_STORED == block.mInfo.mType
+                                          ? data.substr( i * header.mBlockSize, header.mBlockSize )
+                                          : std::string_view( block.mData ) );
+
+        /// Запись в исходном порядке, пока следующие блоки сжимаются
+        timer.next( cJobStats::STAGE_WRITE, blockData.size() );
+        if( !mpFile2Write->write( writeOffset, blockData ) )
+        {
+            status = ERR_STATUS_BAD_FILE_WRITE;
+            continue;
+        }
+
+        timer.stop();
+
+        /// Сжатый участок исходного файла больше не понадобится
+        if( mIsDirectIo )
+            mFile2Read.release( i * header.mBlockSize, cBlockFormat::getRawBlockSize( header, i ) );
+
+        writeOffset += blockData.size();
+        header.mBlocks.push_back( block.mInfo );
+
+        /// Сумма содержимого собирается из сумм блоков без прохода по данным
+        if( mIsChecksumEnabled )
+        {
+            header.mContentChecksum = cChecksum::crc32cCombine( header.mContentChecksum, block.mInfo.mChecksum,
+                                                                cBlockFormat::getRawBlockSize( header, i ) );
+        }
+
+        if( job )
+            job->addProgress( cBlockFormat::getRawBlockSize( header, i ), blockData.size() );
+    }
+
+    budget.release( releasedBytes );
+
+    if( ERR_STATUS_SUCCESS != status )
+        return status;
+
+    timer.next( cJobStats::STAGE_WRITE );
+    if( !mpFile2Write->truncate( writeOffset ) )
+        return ERR_STATUS_BAD_FILE_WRITE;
+
+    /// Индекс известен - запись заголовка на зарезервированное место
+    return mpFile2Write->write( 0, cBlockFormat::writeHeader( header ) ) ? ERR_STATUS_SUCCESS
+                                                                          : ERR_STATUS_BAD_FILE_WRITE;
+}
+
+cFileWorker::sPackedBlock cFileWorker::packBlock( cAbstractAlgorithm &algorithm, std::string_view rawBlock,
+                                                  bool isChecksumEnabled )
 {
-    /// Поиск последнего вхождения точки
-    const auto dotPos = mFile2ReadPath.find_last_of('.');
-    if( std::string::npos == dotPos )
-        return false;
+    sPackedBlock block;
+    if( isZeroBlock( rawBlock ) )
+    {
+        block.mInfo.mType = cBlockFormat::BLOCK_TYPE_ZERO;
+        if( isChecksumEnabled )
+            block.mInfo.mChecksum = cChecksum::crc32cZeros( rawBlock.size() );
 
-    /// Получение последнего постфикса
-    const auto curPostfix = mFile2ReadPath.substr( dotPos );
-    if( algorithm.getPostfix() != curPostfix )
-        return false;
+        return block;
+    }
 
-    return true;
+    block.mData = algorithm.compress( rawBlock );
+
+    if( block.mData.empty() )
+    {
+        block.mStatus = ERR_STATUS_BAD_ALG;
+    }
+    else if( block.mData.size() >= rawBlock.size() )
+    {
+        /// Алгоритм не уменьшил блок - запись без сжатия
+        block.mInfo.mType = cBlockFormat::BLOCK_TYPE_STORED;
+        block.mData.clear();
+        block.mData.shrink_to_fit();
+    }
+
+    block.mInfo.mCmprSize = cBlockFormat::BLOCK_TYPE_STORED == block.mInfo.mType ? rawBlock.size()
+                                                                                : block.mData.size();
+
+    /// Блок только что прочитан алгоритмом и еще в кэше процессора
+    if( isChecksumEnabled )
+    {
+        const cJobStats::cTimer timer( cJobStats::STAGE_CHECKSUM, rawBlock.size() );
+        block.mInfo.mChecksum = cChecksum::crc32c( rawBlock );
+    }
+
+    return block;
+}
+
+bool cFileWorker::checkBlock( std::string_view rawBlock, uint32_t checksum )
+{
+    const cJobStats::cTimer timer( cJobStats::STAGE_CHECKSUM, rawBlock.size() );
+    return cChecksum::crc32c( rawBlock ) == checksum;
 }
 
+bool cFileWorker::isZeroBlock( std::string_view rawBlock )
+{
+    /// Первый байт нулевой, и каждый байт равен следующему. memcmp
+    /// векторизован и останавливается на первом отличии
+    return !rawBlock.empty() && '\0' == rawBlock.front()
+           && 0 == std::memcmp( rawBlock.data(), rawBlock.data() + 1, rawBlock.size() - 1 );
+}
 
-std::tuple< std::string, eErrStatus > cFileWorker::readData( void )
+eErrStatus cFileWorker::decompressFile( cAbstractAlgorithm &algorithm, std::string_view data, cJob *job,
+                                        cMemoryBudget &budget ) const
 {
+    /// Формат предыдущих версий - данные сжаты целиком
+    if( !cBlockFormat::hasSignature( data ) )
+    {
+        /// Размер результата неизвестен до распаковки - резервируется
+        /// оценка для сжатия одним блоком
+        const cMemoryBudget::cReservation reservation( budget, algorithm.getMemoryBound( data.size(), ACT_TYPE_DECOMPR ),
+                                                       [ job ]( void ) { return job && job->isCanceled(); } );
+        if( !reservation.isReserved() )
+            return job && job->isCanceled() ? ERR_STATUS_CANCELED : ERR_STATUS_MEMORY_LIMIT;
 
-    QFileInfo fInfo( QString( mFile2ReadPath.data() ) );
-    const size_t FILE_READ_SIZE =fInfo.size();
+        const std::string result( algorithm.decompress( data ) );
+        if( result.empty() )
+            return ERR_STATUS_BAD_ALG;
 
-    if( 0 == FILE_READ_SIZE )
-        return std::make_tuple( std::string(), ERR_STATUS_EMPTY_SRC_FILE );
+        if( job )
+            job->addProgress( data.size(), result.size() );
 
-    symbol_t *rawBuffer = new symbol_t[ FILE_READ_SIZE ];
-    mFile2Read.seekg( 0 );
-    mFile2Read.read( reinterpret_cast<char*>( rawBuffer ), FILE_READ_SIZE );
+        const cJobStats::cTimer timer( cJobStats::STAGE_WRITE, result.size() );
+        return mpFile2Write->write( 0, result ) ? ERR_STATUS_SUCCESS : ERR_STATUS_BAD_FILE_WRITE;
+    }
 
-    std::string buffer;
-    buffer.reserve( FILE_READ_SIZE );
+    auto [ header, headerSize, formatStatus ] = cBlockFormat::readHeader( data );
+    if( ERR_STATUS_SUCCESS != formatStatus )
+        return formatStatus;
 
-    for( size_t i = 0; i < FILE_READ_SIZE; i++ )
-        buffer += ( rawBuffer[ i ] );
+    if( header.mAlgType != algorithm.getType() )
+        return ERR_STATUS_BAD_POSTFIX;
 
-    delete[] rawBuffer;
+    uint64_t zeroSize = 0;
+    for( size_t i = 0; i < header.mBlocks.size(); ++i )
+        if( cBlockFormat::BLOCK_TYPE_ZERO == header.mBlocks[ i ].mType )
+            zeroSize += cBlockFormat::getRawBlockSize( header, i );
 
-    return std::make_tuple( std::move( buffer ), ERR_STATUS_SUCCESS );
+    /// Место под выходной файл выделяется сразу по итоговому размеру, блоки
+    /// пишутся по своим смещениям в произвольном порядке. Если файл в
+    /// основном из нулей, выделять место, чтобы тут же освободить, незачем -
+    /// задается только размер, и файл сразу разреженный
+    const bool isMostlyZero = zeroSize > header.mRawSize / 2;
+    cJobStats::cTimer timer( cJobStats::STAGE_WRITE );
+    if( !( isMostlyZero ? mpFile2Write->truncate( header.mRawSize ) : mpFile2Write->allocate( header.mRawSize ) ) )
+        return ERR_STATUS_BAD_FILE_WRITE;
+
+    timer.stop();
+
+    cAbstractIoBackend *file = mpFile2Write.get();
+    return decodeBlocks( algorithm, data, header, headerSize,
+                         [ file ]( uint64_t offset, std::string_view rawBlock )
+                         {
+                             const cJobStats::cTimer timer( cJobStats::STAGE_WRITE, rawBlock.size() );
+                             return file->write( offset, rawBlock );
+                         },
+                         [ file ]( uint64_t offset, uint64_t size )
+                         {
+                             /// Без поддержки дыр участок и так читается нулями
+                             file->punchHole( offset, size );
+                         }, job, budget, 0 );
+}
+
+eErrStatus cFileWorker::decodeBlocks( cAbstractAlgorithm &algorithm,
+                                      std::string_view data,
+                                      const cBlockFormat::sHeader &header,
+                                      size_t headerSize,
+                                      const blockWriter_t &writer,
+                                      const holeWriter_t &holeWriter,
+                                      cJob *job,
+                                      cMemoryBudget &budget,
+                                      uint64_t resultSize )
+{
+    if( 0 == header.mRawSize )
+        return ERR_STATUS_BAD_FORMAT;
+
+    const size_t blockCount = header.mBlocks.size();
+    const bool hasChecksums = header.mFlags & cBlockFormat::FLAG_CHECKSUMS;
+
+    /// Сумма содержимого проверяется до распаковки: она объединяет суммы из
+    /// индекса, а данные блоков сверяются с ними в задачах
+    if( hasChecksums )
+    {
+        uint32_t contentChecksum = 0;
+        for( size_t i = 0; i < blockCount; ++i )
+            contentChecksum = cChecksum::crc32cCombine( contentChecksum, header.mBlocks[ i ].mChecksum,
+                                                        cBlockFormat::getRawBlockSize( header, i ) );
+
+        if( contentChecksum != header.mContentChecksum )
+            return ERR_STATUS_BAD_FORMAT;
+    }
+
+    /// Сдвиг блока в сжатых данных - префиксная сумма размеров из индекса
+    const std::vector< uint64_t > blockShifts( cBlockFormat::getBlockOffsets( header, headerSize ) );
+
+    /// Одновременно распаковывается не больше блоков, чем потоков вместе с
+    /// вызывающим. Если столько не помещается в предел вместе с результатом,
+    /// блоки распаковываются группами. Память резервируется сразу
+    cThreadPool &pool = cThreadPool::instance();
+    const uint64_t blockBound = algorithm.getMemoryBound( std::min( header.mBlockSize, header.mRawSize ),
+                                                          ACT_TYPE_DECOMPR );
+    size_t groupSize = blockCount;
+    size_t concurrency = std::min( blockCount, pool.getThreadCount() + 1 );
+
+    const uint64_t memoryLimit = budget.getEffectiveLimit();
+    if( cMemoryBudget::UNLIMITED != memoryLimit )
+    {
+        if( resultSize + blockBound > memoryLimit )
+            return ERR_STATUS_MEMORY_LIMIT;
+
+        const uint64_t fittingBlocks = ( memoryLimit - resultSize ) / blockBound;
+        if( fittingBlocks < concurrency )
+            groupSize = concurrency = fittingBlocks;
+    }
+
+    const cMemoryBudget::cReservation reservation( budget, resultSize + concurrency * blockBound,
+                                                   [ job ]( void ) { return job && job->isCanceled(); } );
+    if( !reservation.isReserved() )
+        return job && job->isCanceled() ? ERR_STATUS_CANCELED : ERR_STATUS_MEMORY_LIMIT;
+
+    /// Задачи блоков пишут замеры в статистику задания
+    cJobStats *pStats = cJobStats::current();
+
+    std::vector< eErrStatus > statuses( blockCount, ERR_STATUS_SUCCESS );
+    const auto decodeBlock = [ & ]( size_t i )
+    {
+        const cJobStats::cScope scope( pStats );
+
+        if( job && job->isCanceled() )
+        {
+            statuses[ i ] = ERR_STATUS_CANCELED;
+            return;
+        }
+
+        /// Блок должен лежать в данных целиком: substr на испорченном индексе
+        /// бросил бы исключение в задаче пула
+        const cBlockFormat::sBlockInfo &info = header.mBlocks[ i ];
+        if( blockShifts[ i ] > data.size() || info.mCmprSize > data.size() - blockShifts[ i ] )
+        {
+            statuses[ i ] = ERR_STATUS_BAD_FORMAT;
+            return;
+        }
+
+        const std::string_view block( data.substr( blockShifts[ i ], info.mCmprSize ) );
+        const uint64_t rawBlockSize = cBlockFormat::getRawBlockSize( header, i );
+        const uint64_t rawOffset = i * header.mBlockSize;
+
+        if( cBlockFormat::BLOCK_TYPE_ZERO == info.mType )
+        {
+            if( hasChecksums && cChecksum::crc32cZeros( rawBlockSize ) != info.mChecksum )
+            {
+                statuses[ i ] = ERR_STATUS_BAD_FORMAT;
+                return;
+            }
+
+            if( holeWriter )
+                holeWriter( rawOffset, rawBlockSize );
+
+            if( job )
+                job->addProgress( 0, rawBlockSize );
+
+            return;
+        }
+
+        if( cBlockFormat::BLOCK_TYPE_STORED == info.mType )
+        {
+            if( block.size() != rawBlockSize )
+                statuses[ i ] = ERR_STATUS_BAD_ALG;
+            else if( hasChecksums && !checkBlock( block, info.mChecksum ) )
+                statuses[ i ] = ERR_STATUS_BAD_FORMAT;
+            else if( !writer( rawOffset, block ) )
+                statuses[ i ] = ERR_STATUS_BAD_FILE_WRITE;
+            else if( job )
+                job->addProgress( block.size(), rawBlockSize );
+
+            return;
+        }
+
+        const std::string rawBlock( algorithm.decompress( block ) );
+
+        /// Размер распакованного блока обязан совпадать с индексом
+        if( rawBlock.size() != rawBlockSize )
+            statuses[ i ] = ERR_STATUS_BAD_ALG;
+        else if( hasChecksums && !checkBlock( rawBlock, info.mChecksum ) )
+            statuses[ i ] = ERR_STATUS_BAD_FORMAT;
+        else if( !writer( rawOffset, rawBlock ) )
+            statuses[ i ] = ERR_STATUS_BAD_FILE_WRITE;
+        else if( job )
+            job->addProgress( block.size(), rawBlockSize );
+    };
+
+    for( size_t groupStart = 0; groupStart < blockCount; groupStart += groupSize )
+    {
+        pool.parallelFor( std::min( groupSize, blockCount - groupStart ), [ & ]( size_t groupIndex )
+        {
+            decodeBlock( groupStart + groupIndex );
+        } );
+    }
+
+    /// Результат - первая ошибка
+    for( const eErrStatus blockStatus : statuses )
+        if( ERR_STATUS_SUCCESS != blockStatus )
+            return blockStatus;
+
+    return ERR_STATUS_SUCCESS;
 }
 
+eErrStatus cFileWorker::openWriteFile( const std::string &resultPath )
+{
+    closeWriteFile();
+
+    thread_local std::mt19937_64 generator( std::random_device{}() );
+
+    /// .<имя>.<суффикс>.part рядом с результатом
+    const size_t nameStart = resultPath.rfind( '/' ) + 1;
+    const std::string prefix( resultPath.substr( 0, nameStart ) + "." + resultPath.substr( nameStart ) + "." );
+
+    /// Файл создается только если его еще нет, поэтому при совпадении
+    /// суффиксов подбирается другой
+    for( int attempt = 0; attempt < TEMP_FILE_ATTEMPTS; ++attempt )
+    {
+        char suffix[ 17 ];
+        std::snprintf( suffix, sizeof( suffix ), "%016llx", static_cast< unsigned long long >( generator() ) );
+
+        mFile2WritePath = prefix + suffix + TEMP_POSTFIX;
+        mpFile2Write = cAbstractIoBackend::create( mIoBackendType, mIsDirectIo );
+        if( ERR_STATUS_SUCCESS == mpFile2Write->open( mFile2WritePath ) )
+            return ERR_STATUS_SUCCESS;
+    }
+
+    return ERR_STATUS_BAD_FILE_OPEN;
+}
+
+void cFileWorker::closeWriteFile( void )
+{
+    if( mpFile2Write )
+        mpFile2Write->close();
+}
@@ -0,0 +1,83 @@
+/** ****************************************************************************
+ * \file cChecksum.h
+ *
+ * \defgroup Checksum Контрольные суммы
+ * @{
+ *
+ * \brief Модуль расчета контрольных сумм данных
+ *
+ * \details Используется CRC32C (полином Кастаньоли 0x1EDC6F41, отраженная
+ * форма 0x82F63B78) - та же сумма, что в iSCSI, ext4 и Btrfs.
+ *
+ * На x86-64 с SSE4.2 сумма считается инструкцией crc32 по 8 байт за такт, на
+ * ARMv8 с расширением CRC - инструкцией crc32cx. Поддержка SSE4.2 проверяется
+ * при первом вызове, поэтому сборка не требует флагов процессора. Иначе
+ * расчет табличный, по 8 байт за шаг (slicing-by-8); таблицы строятся при
+ * компиляции.
+ *
+ * Сумму можно считать по частям: результат предыдущей части передается
+ * как начальное значение следующей.
+ *
+ * Реализован с поиощью класса \ref cChecksum
+ * ****************************************************************************/
+
+#ifndef CCHECKSUM_H
+#define CCHECKSUM_H
+
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <string_view> /// Представления строк
+
+/// \brief Класс, реализующий расчет контрольных сумм
+/// \class cChecksum
+class cChecksum final
+{
+public:
+    /// \brief Рассчитать CRC32C
+    ///
+    /// \param [in] data Данные
+    /// \param [in] crc Сумма предыдущих частей данных. 0 - начало данных
+    ///
+    /// \return Сумма данных вместе с предыдущими частями
+    static uint32_t crc32c( std::string_view data, uint32_t crc = 0 ) noexcept;
+
+    /// \brief Получить сумму двух последовательных частей данных по суммам
+    /// частей
+    ///
+    /// \details Позволяет считать суммы блоков параллельно и получать из них
+    /// сумму всех данных без повторного прохода
+    ///
+    /// \param [in] firstCrc Сумма первой части
+    /// \param [in] secondCrc Сумма второй части
+    /// \param [in] secondSize Размер второй части
+    ///
+    /// \return Сумма объединенных частей
+    static uint32_t crc32cCombine( uint32_t firstCrc, uint32_t secondCrc, uint64_t secondSize ) noexcept;
+
+    /// \brief Рассчитать CRC32C данных из нулевых байт без прохода по ним
+    /// \param [in] size Количество байт
+    /// \return Сумма
+    static uint32_t crc32cZeros( uint64_t size ) noexcept;
+
+    /// \brief Проверить, используется ли аппаратный расчет
+    /// \return true - сумма считается инструкциями процессора
+    static bool isHardwareAccelerated( void ) noexcept;
+
+private:
+    /// \brief Табличный расчет CRC32C без начальной и конечной инверсии
+    /// \param [in] bytes Данные
+    /// \param [in] size Размер данных
+    /// \param [in] crc Текущее состояние
+    /// \return Новое состояние
+    static uint32_t updateTable( const uint8_t *bytes, size_t size, uint32_t crc ) noexcept;
+
+    /// \brief Аппаратный расчет CRC32C без начальной и конечной инверсии
+    /// \param [in] bytes Данные
+    /// \param [in] size Размер данных
+    /// \param [in] crc Текущее состояние
+    /// \return Новое состояние
+    static uint32_t updateHardware( const uint8_t *bytes, size_t size, uint32_t crc ) noexcept;
+};
+
+/// @}
+
+#endif // CCHECKSUM_H
@@ -0,0 +1,176 @@
+/** ****************************************************************************
+ * \brief Исходные коды расчета контрольных сумм
+ *
+ * \file cChecksum.cpp
+ * ****************************************************************************/
+
+#include "checksum/h/cChecksum.h" /// Заголовок класса
+#include <array> /// Массивы фиксированного размера
+#include <cstring> /// std::memcpy
+
+#if defined( __x86_64__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+#define CHECKSUM_SSE42
+#include <nmmintrin.h> /// _mm_crc32_u64, _mm_crc32_u8
+#elif defined( __aarch64__ ) && defined( __ARM_FEATURE_CRC32 )
+#define CHECKSUM_ARM_CRC
+#include <arm_acle.h> /// __crc32cd, __crc32cb
+#endif
+
+/// \brief Отраженный полином CRC32C
+static constexpr uint32_t CRC32C_POLY = 0x82F63B78;
+
+/// \brief Псевдоним для таблиц slicing-by-8
+/// \typedef crcTables_t
+using crcTables_t = std::array< std::array< uint32_t, 256 >, 8 >;
+
+/// \brief Построить таблицы. Таблица k - сумма байта, за которым следуют
+/// k нулевых байт
+/// \return Таблицы
+static constexpr crcTables_t makeTables( void )
+{
+    crcTables_t tables{};
+    for( uint32_t i = 0; i < 256; ++i )
+    {
+        uint32_t crc = i;
+        for( int bit = 0; bit < 8; ++bit )
+            crc = ( crc >> 1 ) ^ ( ( crc & 1 ) ? CRC32C_POLY : 0 );
+
+        tables[ 0 ][ i ] = crc;
+    }
+
+    for( size_t k = 1; k < tables.size(); ++k )
+        for( size_t i = 0; i < 256; ++i )
+            tables[ k ][ i ] = ( tables[ k - 1 ][ i ] >> 8 ) ^ tables[ 0 ][ tables[ k - 1 ][ i ] & 0xFF ];
+
+    return tables;
+}
+
+/// \brief Таблицы CRC32C
+static constexpr crcTables_t CRC_TABLES = makeTables();
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+uint32_t cChecksum::crc32c( std::string_view data, uint32_t crc ) noexcept
+{
+    const auto *bytes = reinterpret_cast< const uint8_t * >( data.data() );
+
+    /// Поддержка процессором проверяется один раз
+    static const bool isHardware = isHardwareAccelerated();
+
+    return ~( isHardware ? updateHardware( bytes, data.size(), ~crc ) : updateTable( bytes, data.size(), ~crc ) );
+}
+
+uint32_t cChecksum::crc32cCombine( uint32_t firstCrc, uint32_t secondCrc, uint64_t secondSize ) noexcept
+{
+    /// Сумма конкатенации - сумма первой части, продолженной secondSize
+    /// нулевыми байтами, плюс сумма второй части. Продолжение нулями -
+    /// умножение на x^( 8 * secondSize ) по модулю полинома: степень
+    /// собирается возведением в квадрат, как в zlib crc32_combine
+    const auto multiply = []( uint32_t left, uint32_t right )
+    {
+        /// Умножение в отраженной форме: старший бит - x^0
+        uint32_t product = 0;
+        for( uint32_t bit = 0x80000000u; 0 != bit; bit >>= 1 )
+        {
+            if( left & bit )
+                product ^= right;
+
+            right = ( right >> 1 ) ^ ( ( right & 1 ) ? CRC32C_POLY : 0 );
+        }
+
+        return product;
+    };
+
+    /// x^( 8 * 2^k ) для текущего бита размера, начиная с x^8
+    uint32_t power = 0x00800000u;
+    uint32_t shift = 0x80000000u;
+    for( ; 0 != secondSize; secondSize >>= 1 )
+    {
+        if( secondSize & 1 )
+            shift = multiply( shift, power );
+
+        power = multiply( power, power );
+    }
+
+    return multiply( firstCrc, shift ) ^ secondCrc;
+}
+
+uint32_t cChecksum::crc32cZeros( uint64_t size ) noexcept
+{
+    /// Начальное состояние ~0, продолженное нулями, с конечной инверсией
+    return crc32cCombine( ~uint32_t( 0 ), ~uint32_t( 0 ), size );
+}
+
+bool cChecksum::isHardwareAccelerated( void ) noexcept
+{
+#if defined( CHECKSUM_SSE42 )
+    return __builtin_cpu_supports( "sse4.2" );
+#elif defined( CHECKSUM_ARM_CRC )
+    return true;
+#else
+    return false;
+#endif
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+uint32_t cChecksum::updateTable( const uint8_t *bytes, size_t size, uint32_t crc ) noexcept
+{
+    /// По 8 байт за шаг. Слово собирается побайтно: порядок байт
+    /// платформы не важен, а компилятор объединяет чтения
+    for( ; size >= 8; bytes += 8, size -= 8 )
+    {
+        const uint32_t low = crc ^ ( uint32_t( bytes[ 0 ] ) | uint32_t( bytes[ 1 ] ) << 8 |
+                                     uint32_t( bytes[ 2 ] ) << 16 | uint32_t( bytes[ 3 ] ) << 24 );
+
+        crc = CRC_TABLES[ 7 ][ low & 0xFF ] ^ CRC_TABLES[ 6 ][ ( low >> 8 ) & 0xFF ] ^
+              CRC_TABLES[ 5 ][ ( low >> 16 ) & 0xFF ] ^ CRC_TABLES[ 4 ][ low >> 24 ] ^
+              CRC_TABLES[ 3 ][ bytes[ 4 ] ] ^ CRC_TABLES[ 2 ][ bytes[ 5 ] ] ^
+              CRC_TABLES[ 1 ][ bytes[ 6 ] ] ^ CRC_TABLES[ 0 ][ bytes[ 7 ] ];
+    }
+
+    for( ; 0 != size; ++bytes, --size )
+        crc = ( crc >> 8 ) ^ CRC_TABLES[ 0 ][ ( crc ^ *bytes ) & 0xFF ];
+
+    return crc;
+}
+
+#if defined( CHECKSUM_SSE42 )
+__attribute__(( target( "sse4.2" ) ))
+#endif
+uint32_t cChecksum::updateHardware( const uint8_t *bytes, size_t size, uint32_t crc ) noexcept
+{
+#if defined( CHECKSUM_SSE42 ) || defined( CHECKSUM_ARM_CRC )
+    /// Инструкции определены для little-endian слов - на обеих архитектурах
+    /// это порядок байт в памяти
+    uint64_t state = crc;
+    for( ; size >= 8; bytes += 8, size -= 8 )
+    {
+        uint64_t word;
+        std::memcpy( &word, bytes, sizeof( word ) );
+#if defined( CHECKSUM_SSE42 )
+        state = _mm_crc32_u64( state, word );
+#else
+        state = __crc32cd( uint32_t( state ), word );
+#endif
+    }
+
+    crc = uint32_t( state );
+    for( ; 0 != size; ++bytes, --size )
+    {
+#if defined( CHECKSUM_SSE42 )
+        crc = _mm_crc32_u8( crc, *bytes );
+#else
+        crc = __crc32cb( crc, *bytes );
+#endif
+    }
+
+    return crc;
+#else
+    return updateTable( bytes, size, crc );
+#endif
+}
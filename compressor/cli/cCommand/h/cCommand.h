@@ -0,0 +1,192 @@
+/** ****************************************************************************
+ * \file cCommand.h
+ * ****************************************************************************/
+
+/** ****************************************************************************
+ * \defgroup Cli Программа командной строки
+ *
+ * \brief Отдельная программа сжатия без графического интерфейса и Qt
+ *
+ * \details Работает с теми же модулями, что и \ref WindowGUI:
+ * \ref FileWorker, \ref Algorithm и \ref ThreadPool, - но не загружает
+ * библиотеки Qt, поэтому запускается за миллисекунды и подходит для
+ * сценариев и конвейеров. Состоит из команд - \ref CliCommand и сжатия
+ * потоков - \ref CliStream
+ *
+ * ****************************************************************************/
+
+/** ****************************************************************************
+ * \defgroup CliCommand Команды
+ * @{
+ * \ingroup Cli
+ *
+ * \brief Модуль, выполняющий команды программы командной строки
+ *
+ * \details Команды:
+ * - compress - сжатие;
+ * - decompress - распаковка;
+ * - test - распаковка с проверкой контрольных сумм без записи результата;
+ * - list - сведения о сжатых данных из заголовков;
+ * - bench - замер сжатия и распаковки заданных файлов в памяти.
+ *
+ * Файл сжимается и распаковывается \ref cFileWorker: результат пишется рядом
+ * с исходным под теми же именами, что и в графическом интерфейсе, или
+ * переименовывается в заданный (\ref cCommand::sOptions::mOutputPath).
+ * Стандартный ввод ("-"), а также любой вход при выводе в стандартный вывод
+ * обрабатываются \ref cStreamCodec. Сжатый файл из нескольких частей
+ * (результат сжатия потока) распаковывается так же.
+ *
+ * Алгоритм распаковки определяется по заголовку сжатых данных, для файлов
+ * предыдущих версий - по постфиксу имени или заданный явно.
+ *
+ * После каждого задания отчет \ref Stats передается \ref cStatsExporter, а
+ * при подробном выводе - печатается в стандартный поток ошибок.
+ *
+ * Реализован с поиощью класса \ref cCommand
+ * ****************************************************************************/
+
+#ifndef CCOMMAND_H
+#define CCOMMAND_H
+
+#include "common.h" /// Общие константы программы
+#include "cFileWorker/h/cFileWorker.h" /// Работа с файлами
+#include "stats/cJobStats/h/cJobStats.h" /// Статистика задания
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+#include <tuple> /// Кортежи
+#include <vector> /// Вектор
+
+/// \brief Класс, выполняющий команды программы командной строки
+/// \class cCommand
+class cCommand final
+{
+public:
+    /// \brief Структура, описывающая параметры команды
+    /// \struct sOptions
+    struct sOptions
+    {
+        /// \brief Алгоритм сжатия
+        eTypeOfComprAlgorithm mAlgType = ALG_TYPE_HFMN;
+        /// \brief Алгоритм задан явно
+        bool mIsAlgSet = false;
+        /// \brief Размер блока исходных данных. 0 - данные сжимаются одним
+        /// блоком
+        uint64_t mBlockSize = cFileWorker::DEFAULT_BLOCK_SIZE;
+        /// \brief Выводить результат в стандартный вывод
+        bool mIsStdout = false;
+        /// \brief Путь до результата. Пустой - рядом с исходным файлом
+        std::string mOutputPath;
+        /// \brief Количество прогонов замера
+        size_t mIterations = DEFAULT_ITERATIONS;
+        /// \brief Печатать статистику заданий
+        bool mIsVerbose = false;
+        /// \brief Входные файлы. "-" - стандартный ввод
+        std::vector< std::string > mPaths;
+    };
+
+    /// \brief Сжать входные файлы
+    /// \param [in] options Параметры
+    /// \return ERR_STATUS_SUCCESS или статус последнего неуспешного задания
+    static eErrStatus compress( const sOptions &options );
+
+    /// \brief Распаковать входные файлы
+    /// \param [in] options Параметры
+    /// \return ERR_STATUS_SUCCESS или статус последнего неуспешного задания
+    static eErrStatus decompress( const sOptions &options );
+
+    /// \brief Проверить входные файлы распаковкой без записи результата
+    /// \param [in] options Параметры
+    /// \return ERR_STATUS_SUCCESS или статус последнего неуспешного задания
+    static eErrStatus test( const sOptions &options );
+
+    /// \brief Вывести сведения о сжатых данных
+    /// \param [in] options Параметры
+    /// \return ERR_STATUS_SUCCESS или статус последнего неуспешного задания
+    static eErrStatus list( const sOptions &options );
+
+    /// \brief Замерить сжатие и распаковку входных файлов в памяти
+    /// \param [in] options Параметры. Если алгоритм не задан - замеряются все
+    /// \return ERR_STATUS_SUCCESS или статус последнего неуспешного замера
+    static eErrStatus bench( const sOptions &options );
+
+    /// \brief Получить текст ошибки
+    /// \param [in] status Статус
+    /// \return Текст
+    static const char *getErrorText( eErrStatus status );
+
+    /// \brief Получить имя алгоритма - постфикс без ".cmpr"
+    /// \param [in] type Тип алгоритма
+    /// \return Имя или пустая строка для неизвестного типа
+    static std::string getAlgorithmName( eTypeOfComprAlgorithm type );
+
+    /// \brief Найти алгоритм по имени
+    /// \param [in] name Имя
+    /// \return Тип алгоритма и признак того, что имя известно
+    static std::tuple< eTypeOfComprAlgorithm, bool > algorithmFromName( std::string_view name );
+
+    /// \brief Имя стандартного ввода в списке файлов
+    constexpr static char STDIN_PATH[] = "-";
+
+    /// \brief Количество прогонов замера по умолчанию
+    constexpr static size_t DEFAULT_ITERATIONS = 5;
+
+private:
+    /// \brief Сжать или распаковать один вход
+    /// \param [in] options Параметры
+    /// \param [in] path Входной файл
+    /// \param [in] action Действие
+    /// \return Статус задания
+    static eErrStatus process( const sOptions &options, const std::string &path, eTypeOfActions action );
+
+    /// \brief Сжать или распаковать файл \ref cFileWorker
+    /// \param [in] options Параметры
+    /// \param [in] path Входной файл
+    /// \param [in] type Алгоритм
+    /// \param [in] action Действие
+    /// \return Статус задания
+    static eErrStatus processFile( const sOptions &options, const std::string &path, eTypeOfComprAlgorithm type,
+                                   eTypeOfActions action );
+
+    /// \brief Сжать или распаковать поток \ref cStreamCodec
+    /// \param [in] options Параметры
+    /// \param [in] path Входной файл или "-"
+    /// \param [in] outputPath Результат. Пустой - стандартный вывод
+    /// \param [in] action Действие
+    /// \param [in] isChecking true - результат только проверяется
+    /// \return Статус задания
+    static eErrStatus processStream( const sOptions &options, const std::string &path,
+                                     const std::string &outputPath, eTypeOfActions action, bool isChecking );
+
+    /// \brief Найти алгоритм по постфиксу имени сжатого файла
+    /// \param [in] path Путь до файла
+    /// \return Тип алгоритма и признак того, что постфикс известен
+    static std::tuple< eTypeOfComprAlgorithm, bool > algorithmFromPostfix( std::string_view path );
+
+    /// \brief Проверить, состоит ли сжатый файл из нескольких частей.
+    /// Читается только заголовок первой части
+    /// \param [in] path Путь до файла
+    /// \return true - первая часть короче файла
+    static bool isMultiPart( const std::string &path );
+
+    /// \brief Имя распакованного файла, как у \ref cFileWorker
+    /// \param [in] path Путь до сжатого файла
+    /// \param [in] type Алгоритм
+    /// \return Путь до результата
+    static std::string getDecompressedPath( const std::string &path, eTypeOfComprAlgorithm type );
+
+    /// \brief Передать отчет задания в \ref cStatsExporter и при подробном
+    /// выводе напечатать его
+    /// \param [in] options Параметры
+    /// \param [in] report Отчет
+    static void report( const sOptions &options, const cJobStats::sReport &report );
+
+    /// \brief Напечатать ошибку задания
+    /// \param [in] path Входной файл
+    /// \param [in] status Статус
+    static void printError( const std::string &path, eErrStatus status );
+};
+
+/// @}
+
+#endif // CCOMMAND_H
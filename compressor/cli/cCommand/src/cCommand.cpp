@@ -0,0 +1,460 @@
+/** ****************************************************************************
+ * \brief Исходные коды команд программы командной строки
+ *
+ * \file cCommand.cpp
+ * ****************************************************************************/
+
+#include "cli/cCommand/h/cCommand.h" /// Заголовок класса
+#include "cli/cStreamCodec/h/cStreamCodec.h" /// Сжатие потоков
+#include "algorithm/cAlgorithmRegistry/h/cAlgorithmRegistry.h" /// Реестр алгоритмов
+#include "blockFormat/h/cBlockFormat.h" /// Блочный формат
+#include "inputSource/h/cInputSource.h" /// Чтение файла для замеров
+#include "stats/cStatsExporter/h/cStatsExporter.h" /// Выгрузка статистики
+#include <algorithm> /// std::sort
+#include <chrono> /// Время
+#include <cstdio> /// std::printf
+#include <filesystem> /// Размер и переименование файлов
+#include <fstream> /// Чтение заголовка файла
+#include <fcntl.h> /// open
+#include <unistd.h> /// close, unlink
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+eErrStatus cCommand::compress( const sOptions &options )
+{
+    eErrStatus result = ERR_STATUS_SUCCESS;
+    for( const std::string &path : options.mPaths )
+    {
+        const eErrStatus status = process( options, path, ACT_TYPE_COMPR );
+        if( ERR_STATUS_SUCCESS != status )
+        {
+            printError( path, status );
+            result = status;
+        }
+    }
+
+    return result;
+}
+
+eErrStatus cCommand::decompress( const sOptions &options )
+{
+    eErrStatus result = ERR_STATUS_SUCCESS;
+    for( const std::string &path : options.mPaths )
+    {
+        const eErrStatus status = process( options, path, ACT_TYPE_DECOMPR );
+        if( ERR_STATUS_SUCCESS != status )
+        {
+            printError( path, status );
+            result = status;
+        }
+    }
+
+    return result;
+}
+
+eErrStatus cCommand::test( const sOptions &options )
+{
+    eErrStatus result = ERR_STATUS_SUCCESS;
+    for( const std::string &path : options.mPaths )
+    {
+        const eErrStatus status = processStream( options, path, std::string(), ACT_TYPE_DECOMPR, true );
+        if( ERR_STATUS_SUCCESS != status )
+        {
+            printError( path, status );
+            result = status;
+            continue;
+        }
+
+        std::printf( "%s: OK\n", path.c_str() );
+    }
+
+    return result;
+}
+
+eErrStatus cCommand::list( const sOptions &options )
+{
+    eErrStatus result = ERR_STATUS_SUCCESS;
+    for( const std::string &path : options.mPaths )
+    {
+        const bool isStdin = STDIN_PATH == path;
+        const int inFd = isStdin ? STDIN_FILENO : ::open( path.c_str(), O_RDONLY | O_CLOEXEC );
+        if( -1 == inFd )
+        {
+            printError( path, ERR_STATUS_BAD_FILE_OPEN );
+            result = ERR_STATUS_BAD_FILE_OPEN;
+            continue;
+        }
+
+        /// Итоги по всем частям
+        bool isLegacy = false;
+        bool hasChecksums = true;
+        eTypeOfComprAlgorithm algType = ALG_TYPE_RLE;
+        uint64_t partCount = 0;
+        uint64_t rawSize = 0;
+        uint64_t blockSize = 0;
+        uint64_t blockCount = 0;
+        uint64_t storedCount = 0;
+        uint64_t zeroCount = 0;
+
+        const auto [ cmprSize, status ] = cStreamCodec::readParts( inFd, [ & ]( std::string_view part )
+        {
+            if( !cBlockFormat::hasSignature( part ) )
+            {
+                isLegacy = true;
+                return ERR_STATUS_SUCCESS;
+            }
+
+            const auto [ header, headerSize, formatStatus ] = cBlockFormat::readHeader( part );
+            ( void )headerSize;
+            if( ERR_STATUS_SUCCESS != formatStatus )
+                return formatStatus;
+
+            ++partCount;
+            algType = header.mAlgType;
+            rawSize += header.mRawSize;
+            blockSize = header.mBlockSize;
+            blockCount += header.mBlocks.size();
+            hasChecksums = hasChecksums && ( header.mFlags & cBlockFormat::FLAG_CHECKSUMS );
+            for( const cBlockFormat::sBlockInfo &block : header.mBlocks )
+            {
+                storedCount += cBlockFormat::BLOCK_TYPE_STORED == block.mType;
+                zeroCount += cBlockFormat::BLOCK_TYPE_ZERO == block.mType;
+            }
+
+            return ERR_STATUS_SUCCESS;
+        } );
+
+        if( !isStdin )
+            ::close( inFd );
+
+        if( ERR_STATUS_SUCCESS != status )
+        {
+            printError( path, status );
+            result = status;
+            continue;
+        }
+
+        if( isLegacy )
+        {
+            std::printf( "%s: сжат целиком (формат предыдущих версий), %llu байт\n", path.c_str(),
+                         static_cast< unsigned long long >( cmprSize ) );
+            continue;
+        }
+
+        std::printf( "%s: %s, частей %llu, %llu -> %llu байт (%.2f), блоков %llu по %llu байт "
+                     "(без сжатия %llu, нулевых %llu), контрольные суммы: %s\n",
+                     path.c_str(),
+                     getAlgorithmName( algType ).c_str(),
+                     static_cast< unsigned long long >( partCount ),
+                     static_cast< unsigned long long >( rawSize ),
+                     static_cast< unsigned long long >( cmprSize ),
+                     cmprSize ? double( rawSize ) / cmprSize : 0.0,
+                     static_cast< unsigned long long >( blockCount ),
+                     static_cast< unsigned long long >( blockSize ),
+                     static_cast< unsigned long long >( storedCount ),
+                     static_cast< unsigned long long >( zeroCount ),
+                     hasChecksums ? "есть" : "нет" );
+    }
+
+    return result;
+}
+
+eErrStatus cCommand::bench( const sOptions &options )
+{
+    constexpr double MIB = 1024.0 * 1024.0;
+
+    std::vector< eTypeOfComprAlgorithm > algorithms( cAlgorithmRegistry::TYPES.begin(),
+                                                     cAlgorithmRegistry::TYPES.end() );
+    if( options.mIsAlgSet )
+        algorithms.assign( 1, options.mAlgType );
+
+    /// Медиана времени прогонов, с
+    auto getMedian = []( std::vector< double > times )
+    {
+        std::sort( times.begin(), times.end() );
+        return times.empty() ? 0.0 : times[ times.size() / 2 ];
+    };
+
+    std::printf( "file,algorithm,raw_bytes,cmpr_bytes,ratio,compress_mb_s,decompress_mb_s\n" );
+
+    eErrStatus result = ERR_STATUS_SUCCESS;
+    for( const std::string &path : options.mPaths )
+    {
+        /// Канал стандартного ввода читается источником целиком
+        cInputSource source;
+        eErrStatus status = source.open( STDIN_PATH == path ? "/dev/stdin" : path );
+        std::string_view data;
+        if( ERR_STATUS_SUCCESS == status )
+            std::tie( data, status ) = source.getData();
+
+        if( ERR_STATUS_SUCCESS == status && data.empty() )
+            status = ERR_STATUS_EMPTY_SRC_FILE;
+
+        for( size_t a = 0; a < algorithms.size() && ERR_STATUS_SUCCESS == status; ++a )
+        {
+            cAbstractAlgorithm &algorithm = *cAlgorithmRegistry::get( algorithms[ a ] );
+            std::vector< double > compressTimes;
+            std::vector< double > decompressTimes;
+            uint64_t cmprSize = 0;
+
+            for( size_t i = 0; i < options.mIterations && ERR_STATUS_SUCCESS == status; ++i )
+            {
+                const auto start = std::chrono::steady_clock::now();
+                const auto [ packed, packStatus ] = cFileWorker::compressData( algorithm, data, options.mBlockSize );
+                const auto packedAt = std::chrono::steady_clock::now();
+                if( ERR_STATUS_SUCCESS != packStatus )
+                {
+                    status = packStatus;
+                    break;
+                }
+
+                const auto [ raw, rawStatus ] = cFileWorker::decompressData( algorithm, packed );
+                const auto end = std::chrono::steady_clock::now();
+
+                /// Результат, не совпавший с исходными данными, - ошибка алгоритма
+                status = ERR_STATUS_SUCCESS != rawStatus ? rawStatus
+                                                         : raw == data ? ERR_STATUS_SUCCESS : ERR_STATUS_BAD_ALG;
+
+                cmprSize = packed.size();
+                compressTimes.push_back( std::chrono::duration< double >( packedAt - start ).count() );
+                decompressTimes.push_back( std::chrono::duration< double >( end - packedAt ).count() );
+            }
+
+            if( ERR_STATUS_SUCCESS != status )
+                break;
+
+            const double compressTime = getMedian( compressTimes );
+            const double decompressTime = getMedian( decompressTimes );
+            std::printf( "%s,%s,%llu,%llu,%.3f,%.1f,%.1f\n",
+                         path.c_str(),
+                         getAlgorithmName( algorithms[ a ] ).c_str(),
+                         static_cast< unsigned long long >( data.size() ),
+                         static_cast< unsigned long long >( cmprSize ),
+                         cmprSize ? double( data.size() ) / cmprSize : 0.0,
+                         compressTime > 0.0 ? data.size() / MIB / compressTime : 0.0,
+                         decompressTime > 0.0 ? data.size() / MIB / decompressTime : 0.0 );
+            std::fflush( stdout );
+        }
+
+        if( ERR_STATUS_SUCCESS != status )
+        {
+            printError( path, status );
+            result = status;
+        }
+    }
+
+    return result;
+}
+
+const char *cCommand::getErrorText( eErrStatus status )
+{
+    switch( status )
+    {
+    case ERR_STATUS_SUCCESS:
+        return "выполнено";
+
+    case ERR_STATUS_BAD_FILE_OPEN:
+        return "ошибка при открытии или чтении файла";
+
+    case ERR_STATUS_BAD_POSTFIX:
+        return "расширение файла или алгоритм сжатых данных не соответствует выбранному алгоритму";
+
+    case ERR_STATUS_EMPTY_SRC_FILE:
+        return "пустые входные данные";
+
+    case ERR_STATUS_BAD_ALG:
+        return "ошибка при выполнении алгоритма";
+
+    case ERR_STATUS_BAD_FORMAT:
+        return "ошибка формата сжатых данных";
+
+    case ERR_STATUS_BAD_FILE_WRITE:
+        return "ошибка записи";
+
+    case ERR_STATUS_CANCELED:
+        return "операция отменена";
+
+    case ERR_STATUS_MEMORY_LIMIT:
+        return "не хватает памяти в пределах заданного ограничения";
+    }
+
+    return "неизвестная ошибка";
+}
+
+std::string cCommand::getAlgorithmName( eTypeOfComprAlgorithm type )
+{
+    return std::string( cAlgorithmRegistry::getName( type ) );
+}
+
+std::tuple< eTypeOfComprAlgorithm, bool > cCommand::algorithmFromName( std::string_view name )
+{
+    return cAlgorithmRegistry::findByName( name );
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+eErrStatus cCommand::process( const sOptions &options, const std::string &path, eTypeOfActions action )
+{
+    /// Стандартный ввод и стандартный вывод - только потоком
+    if( STDIN_PATH == path || options.mIsStdout )
+        return processStream( options, path, options.mOutputPath, action, false );
+
+    if( ACT_TYPE_COMPR == action )
+        return processFile( options, path, options.mAlgType, action );
+
+    /// cFileWorker распаковывает файл с постфиксом алгоритма из одной части
+    const auto [ type, isKnown ] = algorithmFromPostfix( path );
+    if( isKnown && !isMultiPart( path ) )
+        return processFile( options, path, type, action );
+
+    if( !isKnown && options.mOutputPath.empty() )
+        return ERR_STATUS_BAD_POSTFIX;
+
+    return processStream( options, path, options.mOutputPath.empty() ? getDecompressedPath( path, type )
+                                                                     : options.mOutputPath,
+                          action, false );
+}
+
+eErrStatus cCommand::processFile( const sOptions &options, const std::string &path, eTypeOfComprAlgorithm type,
+                                  eTypeOfActions action )
+{
+    cAbstractAlgorithm &algorithm = *cAlgorithmRegistry::get( type );
+
+    cFileWorker worker;
+    worker.setBlockSize( options.mBlockSize );
+    eErrStatus status = worker.updateReadFile( path );
+    if( ERR_STATUS_SUCCESS != status )
+        return status;
+
+    const auto [ resultPath, algStatus ] = worker.applyAlgorithm( algorithm, action );
+    status = algStatus;
+
+    /// Результат уже атомарно переименован cFileWorker - переименование в
+    /// заданное имя тоже атомарно
+    if( ERR_STATUS_SUCCESS == status && !options.mOutputPath.empty() )
+    {
+        std::error_code error;
+        std::filesystem::rename( resultPath, options.mOutputPath, error );
+        if( error )
+            status = ERR_STATUS_BAD_FILE_WRITE;
+    }
+
+    cJobStats::sReport stats( worker.getLastStats() );
+    stats.mStatus = status;
+    report( options, stats );
+
+    return status;
+}
+
+eErrStatus cCommand::processStream( const sOptions &options, const std::string &path,
+                                    const std::string &outputPath, eTypeOfActions action, bool isChecking )
+{
+    const bool isStdin = STDIN_PATH == path;
+    const int inFd = isStdin ? STDIN_FILENO : ::open( path.c_str(), O_RDONLY | O_CLOEXEC );
+    if( -1 == inFd )
+        return ERR_STATUS_BAD_FILE_OPEN;
+
+    const bool isStdout = !isChecking && outputPath.empty();
+    const int outFd = isChecking ? -1
+                                 : isStdout ? STDOUT_FILENO
+                                            : ::open( outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                                                      0644 );
+
+    eErrStatus status = ERR_STATUS_BAD_FILE_OPEN;
+    if( isChecking || -1 != outFd )
+    {
+        cJobStats stats;
+        {
+            const cJobStats::cScope scope( &stats );
+            if( ACT_TYPE_COMPR == action )
+            {
+                status = cStreamCodec::compress( *cAlgorithmRegistry::get( options.mAlgType ), inFd, outFd,
+                                                 options.mBlockSize, stats );
+            }
+            else
+            {
+                /// Алгоритм нужен только данным без заголовка
+                cAbstractAlgorithm *pLegacyAlgorithm = options.mIsAlgSet ? cAlgorithmRegistry::get( options.mAlgType )
+                                                                         : nullptr;
+                status = cStreamCodec::decompress( inFd, outFd, pLegacyAlgorithm, stats );
+            }
+        }
+
+        cJobStats::sReport jobStats( stats.getReport() );
+        jobStats.mPath = path;
+        jobStats.mAlgType = options.mAlgType;
+        jobStats.mAction = action;
+        jobStats.mStatus = status;
+        report( options, jobStats );
+    }
+
+    if( !isStdin )
+        ::close( inFd );
+
+    if( !isChecking && !isStdout && -1 != outFd )
+    {
+        ::close( outFd );
+
+        /// Недописанный результат не оставляется
+        if( ERR_STATUS_SUCCESS != status )
+            ::unlink( outputPath.c_str() );
+    }
+
+    return status;
+}
+
+std::tuple< eTypeOfComprAlgorithm, bool > cCommand::algorithmFromPostfix( std::string_view path )
+{
+    return cAlgorithmRegistry::findByPostfix( path );
+}
+
+bool cCommand::isMultiPart( const std::string &path )
+{
+    std::error_code error;
+    const uint64_t fileSize = std::filesystem::file_size( path, error );
+    std::ifstream file( path, std::ios::binary );
+    std::string header( cBlockFormat::HEADER_FIXED_SIZE, '\0' );
+    if( error || !file.read( header.data(), header.size() ) )
+        return false;
+
+    /// Размер заголовка из испорченного файла не должен превышать файл
+    const auto [ headerSize, headerStatus ] = cBlockFormat::readHeaderSize( header );
+    if( ERR_STATUS_SUCCESS != headerStatus || headerSize > fileSize )
+        return false;
+
+    header.resize( headerSize );
+    if( !file.read( header.data() + cBlockFormat::HEADER_FIXED_SIZE, headerSize - cBlockFormat::HEADER_FIXED_SIZE ) )
+        return false;
+
+    const auto [ partSize, sizeStatus ] = cBlockFormat::readContainerSize( header );
+    return ERR_STATUS_SUCCESS == sizeStatus && partSize < fileSize;
+}
+
+std::string cCommand::getDecompressedPath( const std::string &path, eTypeOfComprAlgorithm type )
+{
+    std::string result( path );
+    /// Удаление постфикса алгоритма и '_' перед именем файла
+    result.erase( result.rfind( cAlgorithmRegistry::getPostfix( type ) ) );
+    result.insert( result.rfind( '/' ) + 1, 1, '_' );
+
+    return result;
+}
+
+void cCommand::report( const sOptions &options, const cJobStats::sReport &stats )
+{
+    if( options.mIsVerbose )
+        for( const std::string &line : cStatsExporter::describe( stats ) )
+            std::fprintf( stderr, "%s: %s\n", stats.mPath.c_str(), line.c_str() );
+
+    if( ERR_STATUS_SUCCESS != cStatsExporter::instance().add( stats ) )
+        std::fprintf( stderr, "Ошибка записи файла статистики\n" );
+}
+
+void cCommand::printError( const std::string &path, eErrStatus status )
+{
+    std::fprintf( stderr, "%s: %s\n", path.c_str(), getErrorText( status ) );
+}
@@ -0,0 +1,125 @@
+/** ****************************************************************************
+ * \file cStreamCodec.h
+ *
+ * \defgroup CliStream Сжатие потоков
+ * @{
+ *
+ * \ingroup Cli
+ *
+ * \brief Модуль, сжимающий и распаковывающий данные из канала в канал
+ *
+ * \details Индекс блочного формата \ref BlockFormat записывается перед
+ * блоками, поэтому данные неизвестного заранее размера (стандартный ввод)
+ * сжимаются частями: каждая часть из нескольких блоков - отдельные сжатые
+ * данные с собственным заголовком, и в поток они пишутся подряд. Часть
+ * содержит столько блоков, сколько потоков в пуле \ref ThreadPool, плюс
+ * \ref cFileWorker::PIPELINE_EXTRA_BLOCKS, поэтому блоки части сжимаются
+ * одновременно, а память не зависит от объема потока. Пока часть сжимается в
+ * пуле, вызывающий поток читает следующую.
+ *
+ * При распаковке из потока сначала читается заголовок с индексом, по нему -
+ * ровно блоки части (\ref cBlockFormat::readContainerSize). Части
+ * распаковываются по очереди, каждая - параллельно по блокам, с проверкой
+ * контрольных сумм. Поток, состоящий из одной части, совпадает со сжатым
+ * файлом программы; поток из нескольких частей читается только этим модулем.
+ * Данные без сигнатуры формата (сжатые целиком предыдущими версиями)
+ * читаются до конца и распаковываются заданным алгоритмом.
+ *
+ * Реализован с поиощью класса \ref cStreamCodec
+ * ****************************************************************************/
+
+#ifndef CSTREAMCODEC_H
+#define CSTREAMCODEC_H
+
+#include "common.h" /// Общие константы программы
+#include "algorithm/cAbstractAlgorithm/h/cAbstractAlgorithm.h" /// Интерфейс алгоритмов
+#include "stats/cJobStats/h/cJobStats.h" /// Статистика задания
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <functional> /// Обертки функций
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+#include <tuple> /// Кортежи
+
+/// \brief Класс, реализующий сжатие и распаковку потоков
+/// \class cStreamCodec
+class cStreamCodec final
+{
+public:
+    /// \brief Псевдоним для обработчика сжатых данных одной части
+    /// \typedef partHandler_t
+    using partHandler_t = std::function< eErrStatus( std::string_view ) >;
+
+    /// \brief Сжать поток
+    ///
+    /// \param [in] algorithm Интерфейс алгоритма
+    /// \param [in] inFd Дескриптор исходных данных
+    /// \param [in] outFd Дескриптор результата
+    /// \param [in] blockSize Размер блока. 0 - поток читается целиком и
+    /// сжимается одним блоком
+    /// \param [in] stats Статистика задания. Заполняются объемы данных
+    ///
+    /// \return ERR_STATUS_SUCCESS - успех,
+    /// ERR_STATUS_BAD_FILE_OPEN - ошибка чтения,
+    /// ERR_STATUS_EMPTY_SRC_FILE - поток пуст,
+    /// ERR_STATUS_BAD_ALG - если выполнение алгоритма привело к ошибке,
+    /// ERR_STATUS_BAD_FILE_WRITE - ошибка записи
+    static eErrStatus compress( cAbstractAlgorithm &algorithm, int inFd, int outFd, uint64_t blockSize,
+                                cJobStats &stats );
+
+    /// \brief Распаковать поток
+    ///
+    /// \param [in] inFd Дескриптор сжатых данных
+    /// \param [in] outFd Дескриптор результата. -1 - результат не пишется,
+    /// только проверяется
+    /// \param [in] legacyAlgorithm Алгоритм для данных без сигнатуры
+    /// формата. Может быть nullptr
+    /// \param [in] stats Статистика задания. Заполняются объемы данных
+    ///
+    /// \return ERR_STATUS_SUCCESS - успех,
+    /// ERR_STATUS_BAD_FILE_OPEN - ошибка чтения,
+    /// ERR_STATUS_EMPTY_SRC_FILE - поток пуст,
+    /// ERR_STATUS_BAD_FORMAT - испорченные или обрезанные данные, данные без
+    /// сигнатуры без заданного алгоритма,
+    /// ERR_STATUS_BAD_ALG - если выполнение алгоритма привело к ошибке,
+    /// ERR_STATUS_BAD_FILE_WRITE - ошибка записи
+    static eErrStatus decompress( int inFd, int outFd, cAbstractAlgorithm *legacyAlgorithm, cJobStats &stats );
+
+    /// \brief Прочитать поток по частям
+    ///
+    /// \details Данные без сигнатуры формата передаются обработчику одной
+    /// частью целиком
+    ///
+    /// \param [in] inFd Дескриптор сжатых данных
+    /// \param [in] handler Обработчик части. Чтение прекращается на первом
+    /// неуспешном статусе
+    ///
+    /// \return Количество прочитанных байт и статус: ERR_STATUS_SUCCESS,
+    /// статус обработчика, ERR_STATUS_BAD_FILE_OPEN - ошибка чтения,
+    /// ERR_STATUS_EMPTY_SRC_FILE - поток пуст, ERR_STATUS_BAD_FORMAT - поток
+    /// обрезан или заголовок части испорчен
+    static std::tuple< uint64_t, eErrStatus > readParts( int inFd, const partHandler_t &handler );
+
+private:
+    /// \brief Прочитать до size байт, повторяя прерванные и частичные вызовы
+    /// read
+    /// \param [in] fd Дескриптор
+    /// \param [in] buffer Буфер. Прочитанное дописывается в конец
+    /// \param [in] size Сколько байт прочитать
+    /// \return Количество прочитанных байт (меньше size - конец потока) и
+    /// признак успеха
+    static std::tuple< size_t, bool > readFully( int fd, std::string &buffer, size_t size );
+
+    /// \brief Записать данные целиком, повторяя прерванные и частичные вызовы
+    /// write
+    /// \param [in] fd Дескриптор
+    /// \param [in] data Данные
+    /// \return true - данные записаны
+    static bool writeFully( int fd, std::string_view data );
+
+    /// \brief Наибольший объем одного вызова read
+    constexpr static size_t READ_CHUNK_SIZE = 1024 * 1024;
+};
+
+/// @}
+
+#endif // CSTREAMCODEC_H
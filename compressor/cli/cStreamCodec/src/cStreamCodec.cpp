@@ -0,0 +1,230 @@
+/** ****************************************************************************
+ * \brief Исходные коды сжатия потоков
+ *
+ * \file cStreamCodec.cpp
+ * ****************************************************************************/
+
+#include "cli/cStreamCodec/h/cStreamCodec.h" /// Заголовок класса
+#include "algorithm/cAlgorithmRegistry/h/cAlgorithmRegistry.h" /// Реестр алгоритмов
+#include "blockFormat/h/cBlockFormat.h" /// Блочный формат
+#include "cFileWorker/h/cFileWorker.h" /// Сжатие данных в памяти
+#include "threadPool/h/cThreadPool.h" /// Пул потоков
+#include <algorithm> /// std::min
+#include <cerrno> /// Коды ошибок
+#include <limits> /// std::numeric_limits
+#include <unistd.h> /// read, write
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+eErrStatus cStreamCodec::compress( cAbstractAlgorithm &algorithm, int inFd, int outFd, uint64_t blockSize,
+                                   cJobStats &stats )
+{
+    cThreadPool &pool = cThreadPool::instance();
+    const size_t partSize = blockSize ? blockSize * ( pool.getThreadCount() + cFileWorker::PIPELINE_EXTRA_BLOCKS )
+                                      : std::numeric_limits< size_t >::max();
+
+    uint64_t bytesIn = 0;
+    uint64_t bytesOut = 0;
+    std::string part;
+    bool isEnd = false;
+
+    /// Чтение следующей части. Короткая часть - последняя
+    auto readPart = [ & ]( void )
+    {
+        cJobStats::cTimer timer( cJobStats::STAGE_READ );
+        part.clear();
+        const auto [ count, isRead ] = readFully( inFd, part, partSize );
+        timer.addBytes( count );
+        bytesIn += count;
+        isEnd = count < partSize;
+
+        return isRead ? ERR_STATUS_SUCCESS : ERR_STATUS_BAD_FILE_OPEN;
+    };
+
+    eErrStatus status = readPart();
+    if( ERR_STATUS_SUCCESS == status && part.empty() )
+        status = ERR_STATUS_EMPTY_SRC_FILE;
+
+    while( ERR_STATUS_SUCCESS == status && !part.empty() )
+    {
+        /// Часть сжимается в пуле, пока читается следующая
+        auto packed = pool.submit( [ &algorithm, &stats, data = std::move( part ), blockSize ]( void )
+        {
+            const cJobStats::cScope scope( &stats );
+            return cFileWorker::compressData( algorithm, data, blockSize );
+        } );
+
+        part.clear();
+        const eErrStatus readStatus = isEnd ? ERR_STATUS_SUCCESS : readPart();
+
+        cJobStats::cTimer timer( cJobStats::STAGE_WAIT );
+        const auto [ result, packStatus ] = pool.get( packed );
+        if( ERR_STATUS_SUCCESS != packStatus )
+            return packStatus;
+
+        timer.next( cJobStats::STAGE_WRITE, result.size() );
+        if( !writeFully( outFd, result ) )
+            return ERR_STATUS_BAD_FILE_WRITE;
+
+        bytesOut += result.size();
+        status = readStatus;
+    }
+
+    stats.setBytes( bytesIn, bytesOut );
+    return status;
+}
+
+eErrStatus cStreamCodec::decompress( int inFd, int outFd, cAbstractAlgorithm *legacyAlgorithm, cJobStats &stats )
+{
+    uint64_t bytesOut = 0;
+    const auto [ bytesIn, status ] = readParts( inFd, [ & ]( std::string_view part )
+    {
+        /// Алгоритм части - из ее заголовка
+        cAbstractAlgorithm *pAlgorithm = legacyAlgorithm;
+        if( cBlockFormat::hasSignature( part ) )
+        {
+            const auto [ header, headerSize, formatStatus ] = cBlockFormat::readHeader( part );
+            ( void )headerSize;
+            if( ERR_STATUS_SUCCESS != formatStatus )
+                return formatStatus;
+
+            pAlgorithm = cAlgorithmRegistry::get( header.mAlgType );
+        }
+
+        if( nullptr == pAlgorithm )
+            return ERR_STATUS_BAD_FORMAT;
+
+        const auto [ raw, rawStatus ] = cFileWorker::decompressData( *pAlgorithm, part );
+        if( ERR_STATUS_SUCCESS != rawStatus )
+            return rawStatus;
+
+        bytesOut += raw.size();
+        if( -1 == outFd )
+            return ERR_STATUS_SUCCESS;
+
+        const cJobStats::cTimer timer( cJobStats::STAGE_WRITE, raw.size() );
+        return writeFully( outFd, raw ) ? ERR_STATUS_SUCCESS : ERR_STATUS_BAD_FILE_WRITE;
+    } );
+
+    stats.setBytes( bytesIn, bytesOut );
+    return status;
+}
+
+std::tuple< uint64_t, eErrStatus > cStreamCodec::readParts( int inFd, const partHandler_t &handler )
+{
+    uint64_t total = 0;
+    std::string part;
+
+    for( size_t index = 0;; ++index )
+    {
+        cJobStats::cTimer timer( cJobStats::STAGE_READ );
+        part.clear();
+
+        /// Заголовок без индекса
+        auto [ count, isRead ] = readFully( inFd, part, cBlockFormat::HEADER_FIXED_SIZE );
+        total += count;
+        if( !isRead )
+            return std::make_tuple( total, ERR_STATUS_BAD_FILE_OPEN );
+
+        if( 0 == count )
+            return std::make_tuple( total, 0 == index ? ERR_STATUS_EMPTY_SRC_FILE : ERR_STATUS_SUCCESS );
+
+        if( !cBlockFormat::hasSignature( part ) )
+        {
+            /// Формат предыдущих версий - весь поток одними сжатыми данными
+            if( 0 != index )
+                return std::make_tuple( total, ERR_STATUS_BAD_FORMAT );
+
+            std::tie( count, isRead ) = readFully( inFd, part, std::numeric_limits< size_t >::max() );
+            total += count;
+            timer.addBytes( part.size() );
+            timer.stop();
+
+            return std::make_tuple( total, isRead ? handler( part ) : ERR_STATUS_BAD_FILE_OPEN );
+        }
+
+        const auto [ headerSize, headerStatus ] = cBlockFormat::readHeaderSize( part );
+        if( ERR_STATUS_SUCCESS != headerStatus )
+            return std::make_tuple( total, ERR_STATUS_BAD_FORMAT );
+
+        /// Индекс, затем - блоки части
+        std::tie( count, isRead ) = readFully( inFd, part, headerSize - part.size() );
+        total += count;
+        if( !isRead )
+            return std::make_tuple( total, ERR_STATUS_BAD_FILE_OPEN );
+
+        const auto [ partSize, sizeStatus ] = cBlockFormat::readContainerSize( part );
+        if( ERR_STATUS_SUCCESS != sizeStatus )
+            return std::make_tuple( total, ERR_STATUS_BAD_FORMAT );
+
+        std::tie( count, isRead ) = readFully( inFd, part, partSize - part.size() );
+        total += count;
+        if( !isRead )
+            return std::make_tuple( total, ERR_STATUS_BAD_FILE_OPEN );
+
+        if( part.size() != partSize )
+            return std::make_tuple( total, ERR_STATUS_BAD_FORMAT );
+
+        timer.addBytes( part.size() );
+        timer.stop();
+
+        const eErrStatus status = handler( part );
+        if( ERR_STATUS_SUCCESS != status )
+            return std::make_tuple( total, status );
+    }
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+std::tuple< size_t, bool > cStreamCodec::readFully( int fd, std::string &buffer, size_t size )
+{
+    size_t total = 0;
+    while( total < size )
+    {
+        /// Буфер растет по мере чтения: размер из испорченного заголовка не
+        /// приводит к выделению памяти сверх данных потока
+        const size_t chunk = std::min( size - total, READ_CHUNK_SIZE );
+        const size_t oldSize = buffer.size();
+        buffer.resize( oldSize + chunk );
+
+        const ssize_t count = ::read( fd, buffer.data() + oldSize, chunk );
+        buffer.resize( oldSize + ( count > 0 ? count : 0 ) );
+        if( count < 0 )
+        {
+            if( EINTR == errno )
+                continue;
+
+            return std::make_tuple( total, false );
+        }
+
+        if( 0 == count )
+            break;
+
+        total += count;
+    }
+
+    return std::make_tuple( total, true );
+}
+
+bool cStreamCodec::writeFully( int fd, std::string_view data )
+{
+    while( !data.empty() )
+    {
+        const ssize_t written = ::write( fd, data.data(), data.size() );
+        if( written < 0 )
+        {
+            if( EINTR == errno )
+                continue;
+
+            return false;
+        }
+
+        data.remove_prefix( written );
+    }
+
+    return true;
+}
@@ -0,0 +1,18 @@
+# Программа командной строки. Qt не требуется
+
+TEMPLATE = app
+TARGET = cmprr-cli
+
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+include(../core.pri)
+
+SOURCES += \
+        cCommand/src/cCommand.cpp \
+        cStreamCodec/src/cStreamCodec.cpp \
+        main.cpp
+
+HEADERS += \
+    cCommand/h/cCommand.h \
+    cStreamCodec/h/cStreamCodec.h
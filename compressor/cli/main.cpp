@@ -0,0 +1,210 @@
+/** ****************************************************************************
+ * \file main.cpp
+ *
+ * \brief Точка входа программы командной строки \ref Cli
+ *
+ * \details Запуск:
+ *
+ *     cmprr-cli <команда> [параметры] [файлы]
+ *
+ * Команды (\ref CliCommand): compress, decompress, test, list, bench. Без
+ * файлов читается стандартный ввод, "-" в списке - тоже стандартный ввод.
+ *
+ * Параметры:
+ * - -a, --algorithm <имя> - алгоритм (RLE, Haffman), по умолчанию Haffman.
+ *   При распаковке нужен только для данных предыдущих версий без заголовка,
+ *   для bench без него замеряются все алгоритмы;
+ * - -b, --block-size <размер> - размер блока, суффиксы K и M, 0 - данные
+ *   одним блоком. По умолчанию 4M;
+ * - -t, --threads <число> - рабочих потоков пула, по умолчанию все доступные;
+ * - -m, --memory-limit <размер> - предел памяти под блоки всех заданий
+ *   (\ref MemoryBudget), суффиксы K и M. Файлы сжимаются меньшими блоками,
+ *   чтобы уложиться в предел. По умолчанию без ограничения;
+ * - -c, --stdout - результат в стандартный вывод;
+ * - -o, --output <файл> - результат в заданный файл (один входной файл);
+ * - -n, --iterations <число> - прогонов замера bench, по умолчанию 5;
+ * - -v, --verbose - статистика заданий в стандартный поток ошибок.
+ *
+ * Уровней сжатия у алгоритмов нет: степень и скорость сжатия задаются
+ * алгоритмом и размером блока.
+ *
+ * Если задана переменная окружения CMPRR_STATS_FILE, после каждого задания в
+ * указанный файл выгружается статистика \ref Stats, как и в графической
+ * программе. Код возврата: 0 - успех, 1 - ошибка хотя бы одного задания,
+ * 2 - неверные параметры.
+ * ****************************************************************************/
+
+#include "cli/cCommand/h/cCommand.h" /// Команды
+#include "stats/cStatsExporter/h/cStatsExporter.h" /// Выгрузка статистики
+#include "memoryBudget/h/cMemoryBudget.h" /// Предел памяти
+#include "threadPool/h/cThreadPool.h" /// Количество потоков пула
+#include <algorithm> /// std::find
+#include <cstdio> /// std::fprintf
+#include <cstdlib> /// std::strtoull, std::getenv
+#include <string> /// Строки
+#include <unistd.h> /// isatty
+
+/// \brief Код возврата при ошибке задания
+static constexpr int EXIT_FAILED = 1;
+/// \brief Код возврата при неверных параметрах
+static constexpr int EXIT_USAGE = 2;
+
+/// \brief Разобрать размер с необязательным суффиксом K или M
+/// \param [in] text Текст
+/// \param [out] size Размер в байтах
+/// \return true - размер разобран
+static bool parseSize( const std::string &text, uint64_t &size )
+{
+    char *end = nullptr;
+    size = std::strtoull( text.c_str(), &end, 10 );
+    if( end == text.c_str() )
+        return false;
+
+    const std::string suffix( end );
+    if( "K" == suffix || "k" == suffix )
+        size *= 1024;
+    else if( "M" == suffix || "m" == suffix )
+        size *= 1024 * 1024;
+    else if( !suffix.empty() )
+        return false;
+
+    return true;
+}
+
+/// \brief Вывести краткую справку
+static void printUsage( void )
+{
+    std::fprintf( stderr,
+                  "cmprr-cli compress|decompress|test|list|bench [параметры] [файлы | -]\n"
+                  "  -a, --algorithm RLE|Haffman  -b, --block-size 4M  -t, --threads N\n"
+                  "  -m, --memory-limit 256M  -c, --stdout  -o, --output <файл>\n"
+                  "  -n, --iterations 5  -v, --verbose\n" );
+}
+
+int main( int argc, char **argv )
+{
+    if( argc < 2 )
+    {
+        printUsage();
+        return EXIT_USAGE;
+    }
+
+    const std::string command( argv[ 1 ] );
+    cCommand::sOptions options;
+    uint64_t threads = 0;
+    uint64_t memoryLimit = cMemoryBudget::UNLIMITED;
+
+    for( int i = 2; i < argc; ++i )
+    {
+        const std::string option( argv[ i ] );
+        if( option.empty() || '-' != option[ 0 ] || cCommand::STDIN_PATH == option )
+        {
+            options.mPaths.push_back( option );
+            continue;
+        }
+
+        /// Параметры без значения
+        if( "-c" == option || "--stdout" == option )
+        {
+            options.mIsStdout = true;
+            continue;
+        }
+
+        if( "-v" == option || "--verbose" == option )
+        {
+            options.mIsVerbose = true;
+            continue;
+        }
+
+        const bool hasValue = i + 1 < argc;
+        const std::string value( hasValue ? argv[ ++i ] : "" );
+        bool isValid = hasValue;
+
+        if( "-a" == option || "--algorithm" == option )
+        {
+            const auto [ type, isKnown ] = cCommand::algorithmFromName( value );
+            options.mAlgType = type;
+            options.mIsAlgSet = true;
+            isValid = isValid && isKnown;
+        }
+        else if( "-b" == option || "--block-size" == option )
+        {
+            isValid = isValid && parseSize( value, options.mBlockSize );
+        }
+        else if( "-t" == option || "--threads" == option )
+        {
+            threads = std::strtoull( value.c_str(), nullptr, 10 );
+            isValid = isValid && threads > 0;
+        }
+        else if( "-m" == option || "--memory-limit" == option )
+        {
+            isValid = isValid && parseSize( value, memoryLimit );
+        }
+        else if( "-o" == option || "--output" == option )
+        {
+            options.mOutputPath = value;
+            isValid = isValid && !value.empty();
+        }
+        else if( "-n" == option || "--iterations" == option )
+        {
+            options.mIterations = std::strtoull( value.c_str(), nullptr, 10 );
+            isValid = isValid && options.mIterations > 0;
+        }
+        else
+        {
+            isValid = false;
+        }
+
+        if( !isValid )
+        {
+            printUsage();
+            return EXIT_USAGE;
+        }
+    }
+
+    if( options.mPaths.empty() )
+        options.mPaths.emplace_back( cCommand::STDIN_PATH );
+
+    /// Один результат - для одного входа
+    if( !options.mOutputPath.empty() && ( options.mIsStdout || options.mPaths.size() > 1 ) )
+    {
+        std::fprintf( stderr, "--output задается для одного входного файла без --stdout\n" );
+        return EXIT_USAGE;
+    }
+
+    /// Сжатые данные в терминал не выводятся
+    const bool isCompressToStdout = "compress" == command && options.mOutputPath.empty() &&
+                                    ( options.mIsStdout || std::find( options.mPaths.begin(), options.mPaths.end(),
+                                                                      cCommand::STDIN_PATH ) != options.mPaths.end() );
+    if( isCompressToStdout && isatty( STDOUT_FILENO ) )
+    {
+        std::fprintf( stderr, "Сжатые данные не выводятся в терминал: задайте --output или перенаправьте вывод\n" );
+        return EXIT_USAGE;
+    }
+
+    /// До первого обращения к пулу
+    cThreadPool::setInstanceThreadCount( threads );
+    cMemoryBudget::global().setLimit( memoryLimit );
+
+    if( const char *statsPath = std::getenv( "CMPRR_STATS_FILE" ) )
+        cStatsExporter::instance().setPath( statsPath );
+
+    eErrStatus status = ERR_STATUS_SUCCESS;
+    if( "compress" == command )
+        status = cCommand::compress( options );
+    else if( "decompress" == command )
+        status = cCommand::decompress( options );
+    else if( "test" == command )
+        status = cCommand::test( options );
+    else if( "list" == command )
+        status = cCommand::list( options );
+    else if( "bench" == command )
+        status = cCommand::bench( options );
+    else
+    {
+        printUsage();
+        return EXIT_USAGE;
+    }
+
+    return ERR_STATUS_SUCCESS == status ? 0 : EXIT_FAILED;
+}
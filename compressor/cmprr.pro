@@ -7,19 +7,13 @@ CONFIG += c++17
 DEFINES += QT_DEPRECATED_WARNINGS
 
 
+include(core.pri)
+
 SOURCES += \
-        algorithm/cAlgorithmHaffman/src/cAlgorithmHaffman.cpp \
-        algorithm/cAlgorithmRLE/src/cAlgorithmRLE.cpp \
-        cFileWorker/src/cFileWorker.cpp \
         main.cpp \
         windowGUI/src/windowGUI.cpp
 
 HEADERS += \
-    algorithm/cAbstractAlgorithm/h/cAbstractAlgorithm.h \
-    algorithm/cAlgorithmHaffman/h/cAlgorithmHaffman.h \
-    algorithm/cAlgorithmRLE/h/cAlgorithmRLE.h \
-    cFileWorker/h/cFileWorker.h \
-    common.h \
     windowGUI/h/windowGUI.h
 
 FORMS += \
@@ -34,6 +28,3 @@ INCLUDEPATH += $$PWD/lib/libJournalView/h
 
 LIBS += -L$$PWD"/lib/libJournalView/bin"
 LIBS += -llibJournalView
-
-RESOURCES += \
-    resource.qrc
@@ -28,6 +28,14 @@ enum eTypeOfActions
     ACT_TYPE_DECOMPR ///< Распаковка
 };
 
+/// \brief Типы подсистем записи файлов
+/// \enum eTypeOfIoBackend
+enum eTypeOfIoBackend
+{
+    IO_TYPE_POSIX = 0, ///< Позиционная запись pwrite
+    IO_TYPE_URING ///< Асинхронная запись через io_uring
+};
+
 /// \brief Ошибки в программе
 /// \enum eErrStatus
 enum eErrStatus
@@ -36,7 +44,11 @@ enum eErrStatus
     ERR_STATUS_BAD_ALG, ///< Ошибка при выполнении алгоритма
     ERR_STATUS_BAD_FILE_OPEN, ///< Ошибка при открытии файла
     ERR_STATUS_BAD_POSTFIX, ///< Ошибка расширения файла для декомпрессии
-    ERR_STATUS_EMPTY_SRC_FILE ///< Ошибка выбора пустого файла для сжатия
+    ERR_STATUS_EMPTY_SRC_FILE, ///< Ошибка выбора пустого файла для сжатия
+    ERR_STATUS_BAD_FORMAT, ///< Ошибка формата сжатых данных
+    ERR_STATUS_BAD_FILE_WRITE, ///< Ошибка записи в файл
+    ERR_STATUS_CANCELED, ///< Операция отменена пользователем
+    ERR_STATUS_MEMORY_LIMIT ///< Не хватает памяти в пределах бюджета
 };
 
 /// \brief Псевдоним для считываемого байта
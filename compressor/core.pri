@@ -0,0 +1,68 @@
+# Ядро программы без графического интерфейса и Qt: алгоритмы, блочный
+# формат, работа с файлами, архивы, пул потоков, протокол службы сжатия и
+# интерфейс библиотеки. Подключается библиотекой ядра (core/core.pro),
+# программой (cmprr.pro), программой командной строки (cli/cli.pro), службой
+# сжатия (daemon/daemon.pro) и программами замеров (bench/bench.pro,
+# microbench/microbench.pro)
+
+CONFIG += c++17 thread
+
+# Сборка без замеров стадий заданий: qmake CONFIG+=no_stats
+no_stats: DEFINES += STATS_DISABLED
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+        $$PWD/algorithm/cAbstractAlgorithm/src/cAbstractAlgorithm.cpp \
+        $$PWD/algorithm/cAlgorithmHaffman/src/cAlgorithmHaffman.cpp \
+        $$PWD/algorithm/cAlgorithmRLE/src/cAlgorithmRLE.cpp \
+        $$PWD/api/cCompressor/src/cCompressor.cpp \
+        $$PWD/api/cDaemonClient/src/cDaemonClient.cpp \
+        $$PWD/api/capi/src/cmprr.cpp \
+        $$PWD/archive/cArchiveFormat/src/cArchiveFormat.cpp \
+        $$PWD/archive/cArchiveReader/src/cArchiveReader.cpp \
+        $$PWD/archive/cArchiveWriter/src/cArchiveWriter.cpp \
+        $$PWD/batchProcessor/src/cBatchProcessor.cpp \
+        $$PWD/blockFormat/src/cBlockFormat.cpp \
+        $$PWD/cFileWorker/src/cFileWorker.cpp \
+        $$PWD/checksum/src/cChecksum.cpp \
+        $$PWD/daemonProtocol/src/cDaemonProtocol.cpp \
+        $$PWD/inputSource/src/cInputSource.cpp \
+        $$PWD/ioBackend/cAbstractIoBackend/src/cAbstractIoBackend.cpp \
+        $$PWD/ioBackend/cIoBackendPosix/src/cIoBackendPosix.cpp \
+        $$PWD/ioBackend/cIoBackendUring/src/cIoBackendUring.cpp \
+        $$PWD/job/src/cJob.cpp \
+        $$PWD/memoryBudget/src/cMemoryBudget.cpp \
+        $$PWD/seekableReader/src/cSeekableReader.cpp \
+        $$PWD/stats/cJobStats/src/cJobStats.cpp \
+        $$PWD/stats/cStatsExporter/src/cStatsExporter.cpp \
+        $$PWD/threadPool/src/cThreadPool.cpp
+
+HEADERS += \
+    $$PWD/algorithm/cAbstractAlgorithm/h/cAbstractAlgorithm.h \
+    $$PWD/algorithm/cAlgorithmHaffman/h/cAlgorithmHaffman.h \
+    $$PWD/algorithm/cAlgorithmRLE/h/cAlgorithmRLE.h \
+    $$PWD/algorithm/cAlgorithmRegistry/h/cAlgorithmRegistry.h \
+    $$PWD/api/cCompressor/h/cCompressor.h \
+    $$PWD/api/cDaemonClient/h/cDaemonClient.h \
+    $$PWD/api/capi/h/cmprr.h \
+    $$PWD/archive/cArchiveFormat/h/cArchiveFormat.h \
+    $$PWD/archive/cArchiveReader/h/cArchiveReader.h \
+    $$PWD/archive/cArchiveWriter/h/cArchiveWriter.h \
+    $$PWD/batchProcessor/h/cBatchProcessor.h \
+    $$PWD/blockFormat/h/cBlockFormat.h \
+    $$PWD/cFileWorker/h/cFileWorker.h \
+    $$PWD/checksum/h/cChecksum.h \
+    $$PWD/common.h \
+    $$PWD/daemonProtocol/h/cDaemonProtocol.h \
+    $$PWD/eventChannel/h/cEventChannel.h \
+    $$PWD/inputSource/h/cInputSource.h \
+    $$PWD/ioBackend/cAbstractIoBackend/h/cAbstractIoBackend.h \
+    $$PWD/ioBackend/cIoBackendPosix/h/cIoBackendPosix.h \
+    $$PWD/ioBackend/cIoBackendUring/h/cIoBackendUring.h \
+    $$PWD/job/h/cJob.h \
+    $$PWD/memoryBudget/h/cMemoryBudget.h \
+    $$PWD/seekableReader/h/cSeekableReader.h \
+    $$PWD/stats/cJobStats/h/cJobStats.h \
+    $$PWD/stats/cStatsExporter/h/cStatsExporter.h \
+    $$PWD/threadPool/h/cThreadPool.h
@@ -0,0 +1,25 @@
+# Библиотека ядра для встраивания в другие программы. Qt не требуется.
+# По умолчанию статическая, разделяемая - qmake CONFIG+=core_shared
+
+TEMPLATE = lib
+TARGET = cmprr
+
+CONFIG += c++17
+CONFIG -= qt
+
+!core_shared: CONFIG += staticlib
+
+include(../core.pri)
+
+unix {
+    target.path = /opt/cmprr/lib
+
+    headers.path = /opt/cmprr/include
+    headers.files = \
+        ../api/cCompressor/h/cCompressor.h \
+        ../api/cDaemonClient/h/cDaemonClient.h \
+        ../api/capi/h/cmprr.h \
+        ../common.h
+
+    INSTALLS += target headers
+}
@@ -0,0 +1,175 @@
+/** ****************************************************************************
+ * \file cDaemonServer.h
+ * ****************************************************************************/
+
+/** ****************************************************************************
+ * \defgroup Daemon Служба сжатия
+ * @{
+ *
+ * \brief Долгоживущая локальная служба сжатия без Qt для потока небольших
+ * запросов
+ *
+ * \details При частых небольших запросах время уходит не на сжатие, а на
+ * запуск процесса, создание пула потоков и алгоритмов. Служба делает это
+ * один раз: пул \ref ThreadPool запущен, а запросы используют общие объекты
+ * алгоритмов реестра \ref AlgorithmRegistry (алгоритмы не хранят состояние
+ * между вызовами, поэтому один объект обслуживает все потоки).
+ *
+ * Клиенты (\ref cDaemonClient) подключаются к локальному сокету
+ * (\ref DaemonProtocol). Сокет доступен владельцу и группе (права 0660).
+ * Основной поток ждет событий всех соединений в poll и за один проход
+ * забирает все пришедшие запросы. Небольшие запросы (до
+ * \ref cDaemonServer::BATCH_REQUEST_LIMIT) объединяются в пакеты до
+ * \ref cDaemonServer::BATCH_SIZE байт: пакет - одна задача пула с высоким
+ * приоритетом, поэтому постановка в очередь и пробуждение потока делятся на
+ * все запросы пакета. Большие запросы - отдельные задачи, их блоки
+ * сжимаются параллельно. Ответ отправляет рабочий поток, выполнивший
+ * запрос; ответы одного соединения могут приходить не по порядку запросов.
+ *
+ * Реализован с поиощью класса \ref cDaemonServer
+ * ****************************************************************************/
+
+#ifndef CDAEMONSERVER_H
+#define CDAEMONSERVER_H
+
+#include "common.h" /// Общие константы программы
+#include "daemonProtocol/h/cDaemonProtocol.h" /// Протокол службы
+#include <condition_variable> /// Условные переменные
+#include <cstddef> /// size_t
+#include <memory> /// Умные указатели
+#include <mutex> /// Мьютексы
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+#include <tuple> /// Кортежи
+#include <vector> /// Вектор
+
+/// \brief Класс, реализующий службу сжатия
+/// \class cDaemonServer
+class cDaemonServer final
+{
+public:
+    /// \brief Конструктор класса
+    /// \param [in] socketPath Путь до сокета
+    explicit cDaemonServer( const std::string &socketPath );
+
+    /// \brief Деструктор класса
+    ~cDaemonServer( void );
+
+    cDaemonServer( const cDaemonServer & ) = delete;
+    cDaemonServer &operator=( const cDaemonServer & ) = delete;
+
+    /// \brief Обслуживать запросы до вызова \ref stop
+    ///
+    /// \details Перед возвратом удаляет сокет и дожидается ответов на все
+    /// принятые запросы
+    ///
+    /// \return ERR_STATUS_SUCCESS - служба остановлена,
+    /// ERR_STATUS_BAD_FILE_OPEN - не удалось создать сокет (например, по
+    /// этому пути уже работает другая служба)
+    eErrStatus run( void );
+
+    /// \brief Остановить службу. Можно вызывать из обработчика сигнала
+    void stop( void ) noexcept;
+
+    /// \brief Наибольший размер запроса, объединяемого в пакет
+    constexpr static size_t BATCH_REQUEST_LIMIT = 64 * 1024;
+
+    /// \brief Размер данных пакета, после которого начинается следующий
+    constexpr static size_t BATCH_SIZE = 1024 * 1024;
+
+    /// \brief Наибольшее количество запросов соединения за один проход, чтобы
+    /// одно соединение не задерживало остальные
+    constexpr static size_t MAX_REQUESTS_PER_POLL = 64;
+
+    /// \brief Наибольшее количество соединений
+    constexpr static size_t MAX_CONNECTIONS = 1024;
+
+    /// \brief Время ожидания отправки ответа клиенту, который не читает
+    /// ответы, в секундах. Не дает такому клиенту занять рабочие потоки
+    constexpr static int SEND_TIMEOUT_SECONDS = 5;
+
+private:
+    /// \brief Структура, описывающая соединение. Сокет закрывается, когда
+    /// соединение не нужно ни основному потоку, ни задачам
+    /// \struct sConnection
+    struct sConnection
+    {
+        /// \brief Конструктор
+        /// \param [in] fd Сокет
+        explicit sConnection( int fd ) : mFd( fd ) {}
+        /// \brief Деструктор. Закрывает сокет
+        ~sConnection( void );
+
+        sConnection( const sConnection & ) = delete;
+        sConnection &operator=( const sConnection & ) = delete;
+
+        /// \brief Сокет
+        const int mFd;
+    };
+
+    /// \brief Структура, описывающая принятый запрос
+    /// \struct sTask
+    struct sTask
+    {
+        /// \brief Соединение для ответа
+        std::shared_ptr< sConnection > mConnection;
+        /// \brief Заголовок запроса
+        cDaemonProtocol::sRequest mRequest;
+        /// \brief Данные запроса
+        std::unique_ptr< cDaemonProtocol::sPayload > mpPayload;
+    };
+
+    /// \brief Создать сокет и начать прием соединений
+    /// \return ERR_STATUS_SUCCESS или ERR_STATUS_BAD_FILE_OPEN
+    eErrStatus listen( void );
+
+    /// \brief Принять ожидающие соединения
+    void acceptConnections( void );
+
+    /// \brief Забрать пришедшие запросы соединения
+    /// \param [in] connection Соединение
+    /// \param [out] tasks Запросы
+    /// \return false - соединение закрыто или нарушен протокол
+    static bool receiveRequests( const std::shared_ptr< sConnection > &connection, std::vector< sTask > &tasks );
+
+    /// \brief Поставить запросы в пул: небольшие - пакетами, большие -
+    /// по одному
+    /// \param [in] tasks Запросы
+    void dispatch( std::vector< sTask > &tasks );
+
+    /// \brief Выполнить запрос и отправить ответ. Исключения не выпускает:
+    /// иначе запрос не будет учтен завершенным и остальные запросы пакета не
+    /// выполнятся
+    /// \param [in] task Запрос
+    void process( sTask &task ) noexcept;
+
+    /// \brief Выполнить операцию запроса
+    /// \param [in] request Заголовок запроса
+    /// \param [in] data Данные запроса
+    /// \return Результат и статус
+    std::tuple< std::string, eErrStatus > execute( const cDaemonProtocol::sRequest &request,
+                                                   std::string_view data ) const;
+
+    /// \brief Отметить завершение задач
+    /// \param [in] count Количество завершенных запросов
+    void finishTasks( size_t count );
+
+    /// \brief Путь до сокета
+    std::string mSocketPath;
+    /// \brief Сокет приема соединений
+    int mListenFd = -1;
+    /// \brief Событие остановки (eventfd)
+    int mStopFd = -1;
+    /// \brief Соединения
+    std::vector< std::shared_ptr< sConnection > > mConnections;
+    /// \brief Количество принятых запросов без ответа
+    size_t mInFlightCount = 0;
+    /// \brief Мьютекс счетчика запросов без ответа
+    std::mutex mInFlightMutex;
+    /// \brief Условная переменная ожидания ответов на все запросы
+    std::condition_variable mInFlightCondition;
+};
+
+/// @}
+
+#endif // CDAEMONSERVER_H
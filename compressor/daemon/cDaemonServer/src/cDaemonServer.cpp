@@ -0,0 +1,322 @@
+/** ****************************************************************************
+ * \brief Исходные коды службы сжатия
+ *
+ * \file cDaemonServer.cpp
+ * ****************************************************************************/
+
+#include "daemon/cDaemonServer/h/cDaemonServer.h" /// Заголовок класса
+#include "algorithm/cAlgorithmRegistry/h/cAlgorithmRegistry.h" /// Реестр алгоритмов
+#include "api/cCompressor/h/cCompressor.h" /// Распаковка данных из нескольких частей
+#include "blockFormat/h/cBlockFormat.h" /// Заголовок сжатых данных
+#include "cFileWorker/h/cFileWorker.h" /// Сжатие в памяти
+#include "threadPool/h/cThreadPool.h" /// Пул потоков
+#include <cerrno> /// errno
+#include <cstring> /// std::memcpy
+#include <new> /// std::bad_alloc
+#include <poll.h> /// poll
+#include <sys/eventfd.h> /// eventfd
+#include <sys/socket.h> /// socket, accept4
+#include <sys/stat.h> /// lstat, chmod
+#include <sys/un.h> /// sockaddr_un
+#include <unistd.h> /// close, unlink
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+cDaemonServer::cDaemonServer( const std::string &socketPath )
+    : mSocketPath( socketPath )
+{
+    mStopFd = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+}
+
+cDaemonServer::~cDaemonServer( void )
+{
+    if( -1 != mStopFd )
+        close( mStopFd );
+}
+
+eErrStatus cDaemonServer::run( void )
+{
+    if( -1 == mStopFd || ERR_STATUS_SUCCESS != listen() )
+        return ERR_STATUS_BAD_FILE_OPEN;
+
+    /// Пул запускается до первого запроса
+    ( void )cThreadPool::instance();
+
+    std::vector< pollfd > events;
+    bool isStopping = false;
+    while( !isStopping )
+    {
+        events.clear();
+        events.push_back( { mStopFd, POLLIN, 0 } );
+        events.push_back( { mListenFd, POLLIN, 0 } );
+        for( const auto &connection : mConnections )
+            events.push_back( { connection->mFd, POLLIN, 0 } );
+
+        if( poll( events.data(), events.size(), -1 ) < 0 )
+        {
+            if( EINTR == errno )
+                continue;
+            break;
+        }
+
+        isStopping = 0 != events[ 0 ].revents;
+
+        /// Запросы всех соединений за проход - в общий список для пакетов
+        std::vector< sTask > tasks;
+        std::vector< std::shared_ptr< sConnection > > alive;
+        alive.reserve( mConnections.size() );
+        for( size_t i = 0; i < mConnections.size(); ++i )
+        {
+            const short revents = events[ i + 2 ].revents;
+            const bool isOpen = ( revents & POLLIN ) ? receiveRequests( mConnections[ i ], tasks )
+                                                     : 0 == ( revents & ( POLLHUP | POLLERR | POLLNVAL ) );
+            if( isOpen )
+                alive.push_back( std::move( mConnections[ i ] ) );
+        }
+        mConnections = std::move( alive );
+
+        dispatch( tasks );
+
+        if( !isStopping && ( events[ 1 ].revents & POLLIN ) )
+            acceptConnections();
+    }
+
+    close( mListenFd );
+    mListenFd = -1;
+    unlink( mSocketPath.c_str() );
+    mConnections.clear();
+
+    /// Задачи обращаются к алгоритмам службы
+    std::unique_lock< std::mutex > lock( mInFlightMutex );
+    mInFlightCondition.wait( lock, [ this ]( void ){ return 0 == mInFlightCount; } );
+
+    return ERR_STATUS_SUCCESS;
+}
+
+void cDaemonServer::stop( void ) noexcept
+{
+    const uint64_t one = 1;
+    ( void )!write( mStopFd, &one, sizeof( one ) );
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+cDaemonServer::sConnection::~sConnection( void )
+{
+    close( mFd );
+}
+
+eErrStatus cDaemonServer::listen( void )
+{
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if( mSocketPath.empty() || mSocketPath.size() >= sizeof( address.sun_path ) )
+        return ERR_STATUS_BAD_FILE_OPEN;
+
+    std::memcpy( address.sun_path, mSocketPath.c_str(), mSocketPath.size() + 1 );
+
+    /// Сокет, оставшийся от аварийно завершенной службы, удаляется. Если
+    /// служба по этому пути отвечает - вторая не запускается
+    struct stat fileStat = {};
+    if( 0 == lstat( mSocketPath.c_str(), &fileStat ) && S_ISSOCK( fileStat.st_mode ) )
+    {
+        const int probe = socket( AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0 );
+        const bool isBusy = -1 != probe &&
+                            0 == connect( probe, reinterpret_cast< const sockaddr * >( &address ), sizeof( address ) );
+        if( -1 != probe )
+            close( probe );
+
+        if( isBusy )
+            return ERR_STATUS_BAD_FILE_OPEN;
+
+        unlink( mSocketPath.c_str() );
+    }
+
+    mListenFd = socket( AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC | SOCK_NONBLOCK, 0 );
+    if( -1 == mListenFd )
+        return ERR_STATUS_BAD_FILE_OPEN;
+
+    if( 0 != bind( mListenFd, reinterpret_cast< const sockaddr * >( &address ), sizeof( address ) ) ||
+        0 != chmod( mSocketPath.c_str(), S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP ) ||
+        0 != ::listen( mListenFd, SOMAXCONN ) )
+    {
+        close( mListenFd );
+        mListenFd = -1;
+        return ERR_STATUS_BAD_FILE_OPEN;
+    }
+
+    return ERR_STATUS_SUCCESS;
+}
+
+void cDaemonServer::acceptConnections( void )
+{
+    while( true )
+    {
+        const int fd = accept4( mListenFd, nullptr, nullptr, SOCK_CLOEXEC );
+        if( -1 == fd )
+        {
+            if( EINTR == errno )
+                continue;
+            return;
+        }
+
+        if( mConnections.size() >= MAX_CONNECTIONS )
+        {
+            close( fd );
+            continue;
+        }
+
+        const timeval timeout = { SEND_TIMEOUT_SECONDS, 0 };
+        setsockopt( fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof( timeout ) );
+
+        mConnections.push_back( std::make_shared< sConnection >( fd ) );
+    }
+}
+
+bool cDaemonServer::receiveRequests( const std::shared_ptr< sConnection > &connection, std::vector< sTask > &tasks )
+{
+    for( size_t i = 0; i < MAX_REQUESTS_PER_POLL; ++i )
+    {
+        sTask task;
+        task.mpPayload = std::make_unique< cDaemonProtocol::sPayload >();
+
+        const eErrStatus status = cDaemonProtocol::receiveRequest( connection->mFd, MSG_DONTWAIT,
+                                                                   task.mRequest, *task.mpPayload );
+        if( ERR_STATUS_CANCELED == status )
+            return cDaemonProtocol::isWouldBlock();
+
+        /// Нарушение протокола - соединение закрывается, ответить на
+        /// непонятный запрос нельзя
+        if( ERR_STATUS_SUCCESS != status )
+            return false;
+
+        task.mConnection = connection;
+        tasks.push_back( std::move( task ) );
+    }
+
+    return true;
+}
+
+void cDaemonServer::dispatch( std::vector< sTask > &tasks )
+{
+    if( tasks.empty() )
+        return;
+
+    {
+        std::lock_guard< std::mutex > lock( mInFlightMutex );
+        mInFlightCount += tasks.size();
+    }
+
+    cThreadPool &pool = cThreadPool::instance();
+    auto batch = std::make_shared< std::vector< sTask > >();
+    size_t batchSize = 0;
+
+    auto submitBatch = [ this, &pool, &batch, &batchSize ]( void )
+    {
+        if( batch->empty() )
+            return;
+
+        ( void )pool.submit( [ this, batch ]( void )
+        {
+            for( auto &task : *batch )
+                process( task );
+
+            finishTasks( batch->size() );
+        }, cThreadPool::TASK_PRIORITY_HIGH );
+
+        batch = std::make_shared< std::vector< sTask > >();
+        batchSize = 0;
+    };
+
+    for( auto &task : tasks )
+    {
+        if( task.mRequest.mSize > BATCH_REQUEST_LIMIT )
+        {
+            auto single = std::make_shared< sTask >( std::move( task ) );
+            ( void )pool.submit( [ this, single ]( void )
+            {
+                process( *single );
+                finishTasks( 1 );
+            } );
+            continue;
+        }
+
+        batchSize += task.mRequest.mSize;
+        batch->push_back( std::move( task ) );
+        if( batchSize >= BATCH_SIZE )
+            submitBatch();
+    }
+
+    submitBatch();
+}
+
+void cDaemonServer::process( sTask &task ) noexcept
+{
+    std::string result;
+    eErrStatus status = ERR_STATUS_SUCCESS;
+    try
+    {
+        std::tie( result, status ) = execute( task.mRequest, task.mpPayload->getData() );
+    }
+    catch( const std::bad_alloc & )
+    {
+        status = ERR_STATUS_MEMORY_LIMIT;
+    }
+    catch( ... )
+    {
+        /// Данные клиента не должны останавливать сервер
+        status = ERR_STATUS_BAD_ALG;
+    }
+
+    /// Данные запроса больше не нужны - отображение освобождается до ответа
+    task.mpPayload.reset();
+
+    cDaemonProtocol::sResponse response;
+    response.mStatus = status;
+    response.mId = task.mRequest.mId;
+
+    /// Клиент мог отключиться - ответ теряется, остальные не затрагиваются
+    try
+    {
+        ( void )cDaemonProtocol::sendResponse( task.mConnection->mFd, response,
+                                               ERR_STATUS_SUCCESS == status ? std::string_view( result )
+                                                                            : std::string_view() );
+    }
+    catch( ... )
+    {
+        /// Ответ, который не удалось собрать, теряется так же
+    }
+
+    task.mConnection.reset();
+}
+
+std::tuple< std::string, eErrStatus > cDaemonServer::execute( const cDaemonProtocol::sRequest &request,
+                                                              std::string_view data ) const
+{
+    if( cDaemonProtocol::OPERATION_COMPRESS == request.mOperation )
+        return cFileWorker::compressData( *cAlgorithmRegistry::get( request.mAlgType ), data, request.mBlockSize );
+
+    /// Данные из одной части - готовым алгоритмом, из нескольких - по частям
+    const auto [ containerSize, sizeStatus ] = cBlockFormat::readContainerSize( data );
+    if( ERR_STATUS_SUCCESS != sizeStatus || containerSize != data.size() )
+        return cCompressor::decompress( data );
+
+    const auto [ header, headerSize, headerStatus ] = cBlockFormat::readHeader( data );
+    ( void )headerSize;
+    if( ERR_STATUS_SUCCESS != headerStatus )
+        return std::make_tuple( std::string(), headerStatus );
+
+    return cFileWorker::decompressData( *cAlgorithmRegistry::get( header.mAlgType ), data );
+}
+
+void cDaemonServer::finishTasks( size_t count )
+{
+    std::lock_guard< std::mutex > lock( mInFlightMutex );
+    mInFlightCount -= count;
+    if( 0 == mInFlightCount )
+        mInFlightCondition.notify_all();
+}
@@ -0,0 +1,16 @@
+# Служба сжатия на локальном сокете. Qt не требуется
+
+TEMPLATE = app
+TARGET = cmprr-daemon
+
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+include(../core.pri)
+
+SOURCES += \
+        cDaemonServer/src/cDaemonServer.cpp \
+        main.cpp
+
+HEADERS += \
+    cDaemonServer/h/cDaemonServer.h
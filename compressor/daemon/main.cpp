@@ -0,0 +1,120 @@
+/** ****************************************************************************
+ * \file main.cpp
+ *
+ * \brief Точка входа службы сжатия \ref Daemon
+ *
+ * \details Запуск:
+ *
+ *     cmprr-daemon [параметры]
+ *
+ * Параметры:
+ * - -s, --socket <путь> - сокет службы, по умолчанию
+ *   $XDG_RUNTIME_DIR/cmprr.sock (без переменной - /tmp/cmprr.sock);
+ * - -t, --threads <число> - рабочих потоков пула, по умолчанию все доступные;
+ * - -m, --memory-limit <МБ> - предел памяти под данные всех запросов
+ *   (\ref MemoryBudget), по умолчанию без ограничения. Запросы сверх
+ *   предела ждут освобождения памяти, а заведомо не помещающиеся получают
+ *   ERR_STATUS_MEMORY_LIMIT.
+ *
+ * Служба работает до сигнала SIGINT или SIGTERM. Код возврата: 0 - служба
+ * остановлена, 1 - не удалось создать сокет, 2 - неверные параметры.
+ * ****************************************************************************/
+
+#include "daemon/cDaemonServer/h/cDaemonServer.h" /// Служба сжатия
+#include "daemonProtocol/h/cDaemonProtocol.h" /// Путь до сокета по умолчанию
+#include "memoryBudget/h/cMemoryBudget.h" /// Предел памяти
+#include "threadPool/h/cThreadPool.h" /// Количество потоков пула
+#include <csignal> /// Сигналы
+#include <cstdio> /// std::fprintf
+#include <cstdlib> /// std::strtoull
+#include <string> /// Строки
+
+/// \brief Код возврата при ошибке запуска
+static constexpr int EXIT_FAILED = 1;
+/// \brief Код возврата при неверных параметрах
+static constexpr int EXIT_USAGE = 2;
+
+/// \brief Служба, останавливаемая по сигналу
+static cDaemonServer *gpServer = nullptr;
+
+/// \brief Обработчик SIGINT и SIGTERM
+/// \param [in] signal Номер сигнала
+static void onSignal( int signal )
+{
+    ( void )signal;
+    if( nullptr != gpServer )
+        gpServer->stop();
+}
+
+/// \brief Вывести краткую справку
+static void printUsage( void )
+{
+    std::fprintf( stderr, "cmprr-daemon [-s, --socket <путь>] [-t, --threads N] [-m, --memory-limit <МБ>]\n" );
+}
+
+int main( int argc, char **argv )
+{
+    std::string socketPath( cDaemonProtocol::getDefaultSocketPath() );
+    uint64_t threads = 0;
+    uint64_t memoryLimitMib = 0;
+
+    for( int i = 1; i < argc; ++i )
+    {
+        const std::string option( argv[ i ] );
+        const bool hasValue = i + 1 < argc;
+        const std::string value( hasValue ? argv[ ++i ] : "" );
+        bool isValid = hasValue;
+
+        if( "-s" == option || "--socket" == option )
+        {
+            socketPath = value;
+            isValid = isValid && !value.empty();
+        }
+        else if( "-t" == option || "--threads" == option )
+        {
+            threads = std::strtoull( value.c_str(), nullptr, 10 );
+            isValid = isValid && threads > 0;
+        }
+        else if( "-m" == option || "--memory-limit" == option )
+        {
+            memoryLimitMib = std::strtoull( value.c_str(), nullptr, 10 );
+            isValid = isValid && memoryLimitMib > 0;
+        }
+        else
+        {
+            isValid = false;
+        }
+
+        if( !isValid )
+        {
+            printUsage();
+            return EXIT_USAGE;
+        }
+    }
+
+    /// До первого обращения к пулу
+    cThreadPool::setInstanceThreadCount( threads );
+    cMemoryBudget::global().setLimit( memoryLimitMib * 1024 * 1024 );
+
+    cDaemonServer server( socketPath );
+    gpServer = &server;
+
+    struct sigaction action = {};
+    action.sa_handler = onSignal;
+    sigemptyset( &action.sa_mask );
+    sigaction( SIGINT, &action, nullptr );
+    sigaction( SIGTERM, &action, nullptr );
+    std::signal( SIGPIPE, SIG_IGN );
+
+    std::fprintf( stderr, "cmprr-daemon: %s\n", socketPath.c_str() );
+    const eErrStatus status = server.run();
+    gpServer = nullptr;
+
+    if( ERR_STATUS_SUCCESS != status )
+    {
+        std::fprintf( stderr, "Не удалось создать сокет %s\n", socketPath.c_str() );
+        return EXIT_FAILED;
+    }
+
+    return 0;
+}
@@ -0,0 +1,242 @@
+/** ****************************************************************************
+ * \file cDaemonProtocol.h
+ *
+ * \defgroup DaemonProtocol Протокол службы сжатия
+ * @{
+ *
+ * \brief Модуль, описывающий обмен сообщениями между службой сжатия
+ * \ref Daemon и ее клиентами (\ref cDaemonClient)
+ *
+ * \details Обмен идет через локальный сокет AF_UNIX типа SOCK_SEQPACKET:
+ * границы сообщений сохраняются, поэтому один запрос или ответ - ровно одно
+ * сообщение. Сообщение начинается с заголовка фиксированного размера (числа
+ * старшим байтом вперед, как в \ref BlockFormat).
+ *
+ * Запрос:
+ *
+ *     +--------+--------+----------+-----+-------+----+------+-----------+
+ *     | "CMPD" | версия | операция | алг | флаги | id | size | blockSize |
+ *     |   4    |   1    |    1     |  1  |   1   |  8 |  8   |     8     |
+ *     +--------+--------+----------+-----+-------+----+------+-----------+
+ *
+ * Ответ:
+ *
+ *     +--------+--------+--------+-------+--------+----+------+
+ *     | "CMPD" | версия | статус | флаги | резерв | id | size |
+ *     |   4    |   1    |   1    |   1   |   1    |  8 |  8   |
+ *     +--------+--------+--------+-------+--------+----+------+
+ *
+ * Данные размером до \ref cDaemonProtocol::INLINE_LIMIT идут в том же
+ * сообщении сразу за заголовком. Большие данные передаются без копирования
+ * через сокет: отправитель кладет их в анонимный файл в памяти (memfd),
+ * запечатывает его от изменения и передает дескриптор (SCM_RIGHTS, флаг
+ * \ref cDaemonProtocol::FLAG_MEMFD). Получатель отображает файл в память
+ * только для чтения. Незапечатанный файл не принимается: его могли бы
+ * укоротить во время чтения.
+ *
+ * Реализован с поиощью класса \ref cDaemonProtocol
+ * ****************************************************************************/
+
+#ifndef CDAEMONPROTOCOL_H
+#define CDAEMONPROTOCOL_H
+
+#include "common.h" /// Общие константы программы
+#include <cstddef> /// size_t
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+
+/// \brief Класс, реализующий протокол службы сжатия
+/// \class cDaemonProtocol
+class cDaemonProtocol final
+{
+public:
+    /// \brief Операции запроса
+    /// \enum eOperation
+    enum eOperation : uint8_t
+    {
+        OPERATION_COMPRESS = 0, ///< Сжать данные
+        OPERATION_DECOMPRESS ///< Распаковать данные
+    };
+
+    /// \brief Флаги сообщения
+    /// \enum eFlags
+    enum eFlags : uint8_t
+    {
+        FLAG_MEMFD = 1 ///< Данные переданы дескриптором memfd
+    };
+
+    /// \brief Структура, описывающая заголовок запроса
+    /// \struct sRequest
+    struct sRequest
+    {
+        /// \brief Операция
+        eOperation mOperation = OPERATION_COMPRESS;
+        /// \brief Алгоритм сжатия. При распаковке не используется
+        eTypeOfComprAlgorithm mAlgType = ALG_TYPE_HFMN;
+        /// \brief Номер запроса, возвращается в ответе
+        uint64_t mId = 0;
+        /// \brief Размер данных
+        uint64_t mSize = 0;
+        /// \brief Размер блока при сжатии. 0 - данные сжимаются одним блоком
+        uint64_t mBlockSize = 0;
+    };
+
+    /// \brief Структура, описывающая заголовок ответа
+    /// \struct sResponse
+    struct sResponse
+    {
+        /// \brief Статус выполнения запроса
+        eErrStatus mStatus = ERR_STATUS_SUCCESS;
+        /// \brief Номер запроса
+        uint64_t mId = 0;
+        /// \brief Размер данных результата
+        uint64_t mSize = 0;
+    };
+
+    /// \brief Структура, описывающая полученные данные сообщения
+    ///
+    /// \details Владеет дескриптором и отображением memfd и освобождает их
+    /// при разрушении
+    ///
+    /// \struct sPayload
+    struct sPayload
+    {
+        sPayload( void ) = default;
+        ~sPayload( void );
+
+        sPayload( const sPayload & ) = delete;
+        sPayload &operator=( const sPayload & ) = delete;
+
+        /// \brief Получить данные
+        /// \return Данные из сообщения или отображенного memfd
+        inline std::string_view getData( void ) const noexcept
+        {
+            return nullptr != mpMapped ? std::string_view( static_cast< const char * >( mpMapped ), mMappedSize )
+                                       : std::string_view( mInline );
+        }
+
+        /// \brief Освободить данные
+        void reset( void );
+
+        /// \brief Данные, пришедшие в сообщении
+        std::string mInline;
+        /// \brief Дескриптор memfd или -1
+        int mFd = -1;
+        /// \brief Отображение memfd
+        void *mpMapped = nullptr;
+        /// \brief Размер отображения
+        size_t mMappedSize = 0;
+    };
+
+    /// \brief Отправить запрос
+    /// \param [in] socket Сокет
+    /// \param [in] request Заголовок запроса. Поле mSize заполняется по data
+    /// \param [in] data Данные
+    /// \return ERR_STATUS_SUCCESS или ERR_STATUS_BAD_FILE_WRITE
+    static eErrStatus sendRequest( int socket, const sRequest &request, std::string_view data );
+
+    /// \brief Получить запрос
+    /// \param [in] socket Сокет
+    /// \param [in] flags Флаги recvmsg (например, MSG_DONTWAIT)
+    /// \param [out] request Заголовок запроса
+    /// \param [out] payload Данные запроса
+    /// \return ERR_STATUS_SUCCESS - запрос получен,
+    /// ERR_STATUS_CANCELED - соединение закрыто или (с MSG_DONTWAIT) запросов
+    /// нет, см. \ref isWouldBlock,
+    /// ERR_STATUS_BAD_FORMAT - сообщение не по протоколу,
+    /// ERR_STATUS_BAD_FILE_OPEN - ошибка сокета или отображения memfd
+    static eErrStatus receiveRequest( int socket, int flags, sRequest &request, sPayload &payload );
+
+    /// \brief Отправить ответ
+    /// \param [in] socket Сокет
+    /// \param [in] response Заголовок ответа. Поле mSize заполняется по data
+    /// \param [in] data Данные результата
+    /// \return ERR_STATUS_SUCCESS или ERR_STATUS_BAD_FILE_WRITE
+    static eErrStatus sendResponse( int socket, const sResponse &response, std::string_view data );
+
+    /// \brief Получить ответ
+    /// \param [in] socket Сокет
+    /// \param [out] response Заголовок ответа
+    /// \param [out] payload Данные результата
+    /// \return Статус, как у \ref receiveRequest
+    static eErrStatus receiveResponse( int socket, sResponse &response, sPayload &payload );
+
+    /// \brief Проверить, вызвано ли последнее ERR_STATUS_CANCELED отсутствием
+    /// сообщений на неблокирующем сокете, а не закрытием соединения
+    /// \return true - сообщений пока нет
+    static bool isWouldBlock( void ) noexcept;
+
+    /// \brief Путь до сокета службы по умолчанию: $XDG_RUNTIME_DIR/cmprr.sock,
+    /// без переменной - /tmp/cmprr.sock
+    /// \return Путь
+    static std::string getDefaultSocketPath( void );
+
+    /// \brief Размер заголовка запроса
+    constexpr static size_t REQUEST_HEADER_SIZE = 32;
+
+    /// \brief Размер заголовка ответа
+    constexpr static size_t RESPONSE_HEADER_SIZE = 24;
+
+    /// \brief Наибольший размер данных в самом сообщении. Больше - через
+    /// memfd. Сообщение SOCK_SEQPACKET ограничено буфером сокета
+    constexpr static size_t INLINE_LIMIT = 64 * 1024;
+
+    /// \brief Версия протокола
+    constexpr static uint8_t PROTOCOL_VERSION = 1;
+
+private:
+    /// \brief Отправить сообщение: заголовок, данные в сообщении или memfd
+    /// \param [in] socket Сокет
+    /// \param [in] header Заголовок без флагов
+    /// \param [in] flagsOffset Смещение байта флагов в заголовке
+    /// \param [in] data Данные
+    /// \return ERR_STATUS_SUCCESS или ERR_STATUS_BAD_FILE_WRITE
+    static eErrStatus sendMessage( int socket, std::string &header, size_t flagsOffset, std::string_view data );
+
+    /// \brief Получить сообщение
+    /// \param [in] socket Сокет
+    /// \param [in] flags Флаги recvmsg
+    /// \param [in] headerSize Размер заголовка
+    /// \param [out] header Заголовок
+    /// \param [out] payload Данные в сообщении и дескриптор memfd, если есть
+    /// \return Статус, как у \ref receiveRequest
+    static eErrStatus receiveMessage( int socket, int flags, size_t headerSize, std::string &header,
+                                      sPayload &payload );
+
+    /// \brief Проверить и отобразить полученные данные
+    /// \param [in] header Заголовок
+    /// \param [in] flagsOffset Смещение байта флагов в заголовке
+    /// \param [in] size Размер данных из заголовка
+    /// \param [in,out] payload Данные
+    /// \return ERR_STATUS_SUCCESS, ERR_STATUS_BAD_FORMAT или
+    /// ERR_STATUS_BAD_FILE_OPEN
+    static eErrStatus attachPayload( std::string_view header, size_t flagsOffset, uint64_t size,
+                                     sPayload &payload );
+
+    /// \brief Создать запечатанный memfd с данными
+    /// \param [in] data Данные
+    /// \return Дескриптор или -1
+    static int createMemfd( std::string_view data );
+
+    /// \brief Проверить сигнатуру и версию заголовка
+    /// \param [in] header Заголовок
+    /// \return true - заголовок по протоколу
+    static bool checkSignature( std::string_view header ) noexcept;
+
+    /// \brief Сигнатура сообщений
+    constexpr static char SIGNATURE[] = { 'C', 'M', 'P', 'D' };
+
+    /// \brief Смещение байта флагов в заголовке запроса
+    constexpr static size_t REQUEST_FLAGS_OFFSET = 7;
+
+    /// \brief Смещение байта флагов в заголовке ответа
+    constexpr static size_t RESPONSE_FLAGS_OFFSET = 6;
+
+    /// \brief Печати memfd, без которых данные не принимаются
+    static const int REQUIRED_SEALS;
+};
+
+/// @}
+
+#endif // CDAEMONPROTOCOL_H
@@ -0,0 +1,311 @@
+/** ****************************************************************************
+ * \brief Исходные коды протокола службы сжатия
+ *
+ * \file cDaemonProtocol.cpp
+ * ****************************************************************************/
+
+#include "daemonProtocol/h/cDaemonProtocol.h" /// Заголовок класса
+#include "algorithm/cAlgorithmRegistry/h/cAlgorithmRegistry.h" /// Известные типы алгоритмов
+#include "blockFormat/h/cBlockFormat.h" /// Запись чисел старшим байтом вперед
+#include <cerrno> /// errno
+#include <cstdlib> /// std::getenv
+#include <cstring> /// std::memcpy
+#include <fcntl.h> /// Печати memfd
+#include <sys/mman.h> /// memfd_create, mmap
+#include <sys/socket.h> /// sendmsg, recvmsg
+#include <sys/stat.h> /// fstat
+#include <unistd.h> /// write, close
+
+const int cDaemonProtocol::REQUIRED_SEALS = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE;
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+cDaemonProtocol::sPayload::~sPayload( void )
+{
+    reset();
+}
+
+void cDaemonProtocol::sPayload::reset( void )
+{
+    if( nullptr != mpMapped )
+        munmap( mpMapped, mMappedSize );
+
+    if( -1 != mFd )
+        ::close( mFd );
+
+    mInline.clear();
+    mFd = -1;
+    mpMapped = nullptr;
+    mMappedSize = 0;
+}
+
+eErrStatus cDaemonProtocol::sendRequest( int socket, const sRequest &request, std::string_view data )
+{
+    std::string header;
+    header.reserve( REQUEST_HEADER_SIZE );
+    header.append( SIGNATURE, sizeof( SIGNATURE ) );
+    cBlockFormat::appendBigEndian< uint8_t >( header, PROTOCOL_VERSION );
+    cBlockFormat::appendBigEndian< uint8_t >( header, request.mOperation );
+    cBlockFormat::appendBigEndian< uint8_t >( header, request.mAlgType );
+    cBlockFormat::appendBigEndian< uint8_t >( header, 0 );
+    cBlockFormat::appendBigEndian< uint64_t >( header, request.mId );
+    cBlockFormat::appendBigEndian< uint64_t >( header, data.size() );
+    cBlockFormat::appendBigEndian< uint64_t >( header, request.mBlockSize );
+
+    return sendMessage( socket, header, REQUEST_FLAGS_OFFSET, data );
+}
+
+eErrStatus cDaemonProtocol::receiveRequest( int socket, int flags, sRequest &request, sPayload &payload )
+{
+    std::string header;
+    const eErrStatus status = receiveMessage( socket, flags, REQUEST_HEADER_SIZE, header, payload );
+    if( ERR_STATUS_SUCCESS != status )
+        return status;
+
+    const uint8_t operation = cBlockFormat::readBigEndian< uint8_t >( header, 5 );
+    const uint8_t algType = cBlockFormat::readBigEndian< uint8_t >( header, 6 );
+    if( operation > OPERATION_DECOMPRESS || !cAlgorithmRegistry::isKnown( algType ) )
+        return ERR_STATUS_BAD_FORMAT;
+
+    request.mOperation = eOperation( operation );
+    request.mAlgType = eTypeOfComprAlgorithm( algType );
+    request.mId = cBlockFormat::readBigEndian< uint64_t >( header, 8 );
+    request.mSize = cBlockFormat::readBigEndian< uint64_t >( header, 16 );
+    request.mBlockSize = cBlockFormat::readBigEndian< uint64_t >( header, 24 );
+
+    return attachPayload( header, REQUEST_FLAGS_OFFSET, request.mSize, payload );
+}
+
+eErrStatus cDaemonProtocol::sendResponse( int socket, const sResponse &response, std::string_view data )
+{
+    std::string header;
+    header.reserve( RESPONSE_HEADER_SIZE );
+    header.append( SIGNATURE, sizeof( SIGNATURE ) );
+    cBlockFormat::appendBigEndian< uint8_t >( header, PROTOCOL_VERSION );
+    cBlockFormat::appendBigEndian< uint8_t >( header, response.mStatus );
+    cBlockFormat::appendBigEndian< uint8_t >( header, 0 );
+    cBlockFormat::appendBigEndian< uint8_t >( header, 0 );
+    cBlockFormat::appendBigEndian< uint64_t >( header, response.mId );
+    cBlockFormat::appendBigEndian< uint64_t >( header, data.size() );
+
+    return sendMessage( socket, header, RESPONSE_FLAGS_OFFSET, data );
+}
+
+eErrStatus cDaemonProtocol::receiveResponse( int socket, sResponse &response, sPayload &payload )
+{
+    std::string header;
+    const eErrStatus status = receiveMessage( socket, 0, RESPONSE_HEADER_SIZE, header, payload );
+    if( ERR_STATUS_SUCCESS != status )
+        return status;
+
+    const uint8_t responseStatus = cBlockFormat::readBigEndian< uint8_t >( header, 5 );
+    if( responseStatus > ERR_STATUS_MEMORY_LIMIT )
+        return ERR_STATUS_BAD_FORMAT;
+
+    response.mStatus = eErrStatus( responseStatus );
+    response.mId = cBlockFormat::readBigEndian< uint64_t >( header, 8 );
+    response.mSize = cBlockFormat::readBigEndian< uint64_t >( header, 16 );
+
+    return attachPayload( header, RESPONSE_FLAGS_OFFSET, response.mSize, payload );
+}
+
+bool cDaemonProtocol::isWouldBlock( void ) noexcept
+{
+    return EAGAIN == errno || EWOULDBLOCK == errno;
+}
+
+std::string cDaemonProtocol::getDefaultSocketPath( void )
+{
+    const char *runtimeDir = std::getenv( "XDG_RUNTIME_DIR" );
+    return std::string( nullptr != runtimeDir && '\0' != runtimeDir[ 0 ] ? runtimeDir : "/tmp" ) + "/cmprr.sock";
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+eErrStatus cDaemonProtocol::sendMessage( int socket, std::string &header, size_t flagsOffset, std::string_view data )
+{
+    const bool isMemfd = data.size() > INLINE_LIMIT;
+    int fd = -1;
+    if( isMemfd )
+    {
+        fd = createMemfd( data );
+        if( -1 == fd )
+            return ERR_STATUS_BAD_FILE_WRITE;
+
+        header[ flagsOffset ] = static_cast< char >( FLAG_MEMFD );
+    }
+
+    iovec parts[ 2 ] = {};
+    parts[ 0 ].iov_base = header.data();
+    parts[ 0 ].iov_len = header.size();
+    parts[ 1 ].iov_base = const_cast< char * >( data.data() );
+    parts[ 1 ].iov_len = isMemfd ? 0 : data.size();
+
+    msghdr message = {};
+    message.msg_iov = parts;
+    message.msg_iovlen = 2;
+
+    /// Дескриптор передается вспомогательными данными
+    alignas( cmsghdr ) char control[ CMSG_SPACE( sizeof( int ) ) ] = {};
+    if( isMemfd )
+    {
+        message.msg_control = control;
+        message.msg_controllen = sizeof( control );
+
+        cmsghdr *cmsg = CMSG_FIRSTHDR( &message );
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN( sizeof( int ) );
+        std::memcpy( CMSG_DATA( cmsg ), &fd, sizeof( fd ) );
+    }
+
+    ssize_t sent = -1;
+    do
+    {
+        sent = sendmsg( socket, &message, MSG_NOSIGNAL );
+    }
+    while( -1 == sent && EINTR == errno );
+
+    /// Получатель владеет своей копией дескриптора
+    if( -1 != fd )
+        ::close( fd );
+
+    return -1 == sent ? ERR_STATUS_BAD_FILE_WRITE : ERR_STATUS_SUCCESS;
+}
+
+eErrStatus cDaemonProtocol::receiveMessage( int socket, int flags, size_t headerSize, std::string &header,
+                                            sPayload &payload )
+{
+    payload.reset();
+
+    std::string buffer( headerSize + INLINE_LIMIT, '\0' );
+    iovec part = { buffer.data(), buffer.size() };
+
+    alignas( cmsghdr ) char control[ CMSG_SPACE( sizeof( int ) ) ] = {};
+    msghdr message = {};
+    message.msg_iov = &part;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof( control );
+
+    ssize_t received = -1;
+    do
+    {
+        received = recvmsg( socket, &message, flags | MSG_CMSG_CLOEXEC );
+    }
+    while( -1 == received && EINTR == errno );
+
+    if( -1 == received )
+        return isWouldBlock() ? ERR_STATUS_CANCELED : ERR_STATUS_BAD_FILE_OPEN;
+
+    /// Пустое сообщение SOCK_SEQPACKET - закрытие соединения
+    if( 0 == received )
+    {
+        errno = 0;
+        return ERR_STATUS_CANCELED;
+    }
+
+    /// Дескриптор забирается до проверок, чтобы не утек
+    for( cmsghdr *cmsg = CMSG_FIRSTHDR( &message ); nullptr != cmsg; cmsg = CMSG_NXTHDR( &message, cmsg ) )
+    {
+        if( SOL_SOCKET != cmsg->cmsg_level || SCM_RIGHTS != cmsg->cmsg_type )
+            continue;
+
+        const size_t fdCount = ( cmsg->cmsg_len - CMSG_LEN( 0 ) ) / sizeof( int );
+        for( size_t i = 0; i < fdCount; ++i )
+        {
+            int fd = -1;
+            std::memcpy( &fd, CMSG_DATA( cmsg ) + i * sizeof( int ), sizeof( fd ) );
+            if( -1 == payload.mFd )
+                payload.mFd = fd;
+            else
+                ::close( fd );
+        }
+    }
+
+    if( ( message.msg_flags & ( MSG_TRUNC | MSG_CTRUNC ) ) || size_t( received ) < headerSize ||
+        !checkSignature( buffer ) )
+    {
+        return ERR_STATUS_BAD_FORMAT;
+    }
+
+    header.assign( buffer, 0, headerSize );
+    payload.mInline.assign( buffer, headerSize, size_t( received ) - headerSize );
+
+    return ERR_STATUS_SUCCESS;
+}
+
+eErrStatus cDaemonProtocol::attachPayload( std::string_view header, size_t flagsOffset, uint64_t size,
+                                           sPayload &payload )
+{
+    const uint8_t flags = cBlockFormat::readBigEndian< uint8_t >( header, flagsOffset );
+    if( 0 != ( flags & ~FLAG_MEMFD ) )
+        return ERR_STATUS_BAD_FORMAT;
+
+    if( !( flags & FLAG_MEMFD ) )
+        return -1 == payload.mFd && payload.mInline.size() == size ? ERR_STATUS_SUCCESS : ERR_STATUS_BAD_FORMAT;
+
+    if( -1 == payload.mFd || !payload.mInline.empty() )
+        return ERR_STATUS_BAD_FORMAT;
+
+    /// Отправитель не должен иметь возможности изменить или укоротить файл
+    struct stat fileStat = {};
+    const int seals = fcntl( payload.mFd, F_GET_SEALS );
+    if( -1 == seals || REQUIRED_SEALS != ( seals & REQUIRED_SEALS ) || 0 != fstat( payload.mFd, &fileStat ) ||
+        uint64_t( fileStat.st_size ) != size )
+    {
+        return ERR_STATUS_BAD_FORMAT;
+    }
+
+    if( 0 == size )
+        return ERR_STATUS_SUCCESS;
+
+    void *mapped = mmap( nullptr, size, PROT_READ, MAP_SHARED, payload.mFd, 0 );
+    if( MAP_FAILED == mapped )
+        return ERR_STATUS_BAD_FILE_OPEN;
+
+    payload.mpMapped = mapped;
+    payload.mMappedSize = size;
+
+    return ERR_STATUS_SUCCESS;
+}
+
+int cDaemonProtocol::createMemfd( std::string_view data )
+{
+    const int fd = memfd_create( "cmprr", MFD_CLOEXEC | MFD_ALLOW_SEALING );
+    if( -1 == fd )
+        return -1;
+
+    while( !data.empty() )
+    {
+        const ssize_t written = write( fd, data.data(), data.size() );
+        if( -1 == written && EINTR == errno )
+            continue;
+
+        if( written <= 0 )
+        {
+            ::close( fd );
+            return -1;
+        }
+
+        data.remove_prefix( size_t( written ) );
+    }
+
+    if( 0 != fcntl( fd, F_ADD_SEALS, REQUIRED_SEALS | F_SEAL_SEAL ) )
+    {
+        ::close( fd );
+        return -1;
+    }
+
+    return fd;
+}
+
+bool cDaemonProtocol::checkSignature( std::string_view header ) noexcept
+{
+    return header.substr( 0, sizeof( SIGNATURE ) ) == std::string_view( SIGNATURE, sizeof( SIGNATURE ) ) &&
+           PROTOCOL_VERSION == static_cast< uint8_t >( header[ sizeof( SIGNATURE ) ] );
+}
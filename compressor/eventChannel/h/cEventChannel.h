@@ -0,0 +1,164 @@
+/** ****************************************************************************
+ * \file cEventChannel.h
+ *
+ * \defgroup EventChannel Канал событий
+ * @{
+ *
+ * \brief Модуль неблокирующего канала событий от рабочих потоков к одному
+ * потребителю
+ *
+ * \details Кольцевой буфер фиксированного размера для многих производителей и
+ * одного потребителя (MPSC). Каждая ячейка хранит номер последовательности:
+ * производитель занимает позицию атомарным сравнением с обменом счетчика
+ * записи и публикует значение, увеличивая номер ячейки; потребитель читает
+ * ячейку, только если ее номер показывает, что значение опубликовано. Ни
+ * производители, ни потребитель не захватывают мьютексов.
+ *
+ * Потребитель (поток GUI) периодически забирает все накопившиеся события
+ * одной пачкой методом \ref cEventChannel::drain.
+ *
+ * Реализован с поиощью класса \ref cEventChannel
+ * ****************************************************************************/
+
+#ifndef CEVENTCHANNEL_H
+#define CEVENTCHANNEL_H
+
+#include <array> /// Массивы фиксированного размера
+#include <atomic> /// Атомарные переменные
+#include <cstddef> /// size_t
+#include <cstdint> /// intptr_t
+#include <thread> /// std::this_thread::yield
+#include <utility> /// std::move
+
+/// \brief Класс, реализующий канал событий
+/// \class cEventChannel
+/// \tparam T Тип события. Должен иметь конструктор по умолчанию
+/// \tparam CAPACITY Емкость канала, степень двойки
+template< typename T, size_t CAPACITY >
+class cEventChannel final
+{
+    static_assert( CAPACITY >= 2 && 0 == ( CAPACITY & ( CAPACITY - 1 ) ),
+                   "Емкость канала должна быть степенью двойки" );
+
+public:
+    /// \brief Конструктор класса
+    cEventChannel( void )
+    {
+        for( size_t i = 0; i < CAPACITY; ++i )
+            mCells[ i ].mSequence.store( i, std::memory_order_relaxed );
+    }
+
+    cEventChannel( const cEventChannel & ) = delete;
+    cEventChannel &operator=( const cEventChannel & ) = delete;
+
+    /// \brief Попытаться поставить событие. Вызывается из любого потока
+    /// \param [in] event Событие. Перемещается только в случае успеха
+    /// \return true - событие поставлено, false - канал полон
+    bool tryPush( T &&event )
+    {
+        size_t pos = mEnqueuePos.load( std::memory_order_relaxed );
+        for( ;; )
+        {
+            sCell &cell = mCells[ pos & MASK ];
+            const size_t sequence = cell.mSequence.load( std::memory_order_acquire );
+            const intptr_t diff = intptr_t( sequence ) - intptr_t( pos );
+
+            if( 0 == diff )
+            {
+                /// Ячейка свободна - занимаем позицию
+                if( mEnqueuePos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+                {
+                    cell.mValue = std::move( event );
+                    cell.mSequence.store( pos + 1, std::memory_order_release );
+                    return true;
+                }
+            }
+            else if( diff < 0 )
+            {
+                /// Потребитель еще не прочитал ячейку с прошлого круга
+                return false;
+            }
+            else
+            {
+                /// Позицию занял другой производитель
+                pos = mEnqueuePos.load( std::memory_order_relaxed );
+            }
+        }
+    }
+
+    /// \brief Поставить событие, уступая процессор, пока канал полон
+    ///
+    /// \details Не вызывать из потока потребителя: при полном канале он
+    /// будет ждать сам себя
+    ///
+    /// \param [in] event Событие
+    void push( T event )
+    {
+        while( !tryPush( std::move( event ) ) )
+            std::this_thread::yield();
+    }
+
+    /// \brief Забрать событие. Вызывается только потребителем
+    /// \param [out] event Событие
+    /// \return true - событие получено, false - канал пуст
+    bool tryPop( T &event )
+    {
+        sCell &cell = mCells[ mDequeuePos & MASK ];
+        if( cell.mSequence.load( std::memory_order_acquire ) != mDequeuePos + 1 )
+            return false;
+
+        event = std::move( cell.mValue );
+        cell.mValue = T();
+
+        /// Ячейка освобождается для следующего круга
+        cell.mSequence.store( mDequeuePos + CAPACITY, std::memory_order_release );
+        ++mDequeuePos;
+        return true;
+    }
+
+    /// \brief Забрать все накопившиеся события. Вызывается только потребителем
+    /// \param [in] consumer Обработчик события: void( T && )
+    /// \return Количество забранных событий
+    template< typename F >
+    size_t drain( F &&consumer )
+    {
+        size_t count = 0;
+        T event;
+        while( tryPop( event ) )
+        {
+            consumer( std::move( event ) );
+            ++count;
+        }
+
+        return count;
+    }
+
+private:
+    /// \brief Маска позиции в буфере
+    constexpr static size_t MASK = CAPACITY - 1;
+
+    /// \brief Размер строки кэша для разнесения счетчиков
+    constexpr static size_t CACHE_LINE_SIZE = 64;
+
+    /// \brief Структура, описывающая ячейку канала
+    /// \struct sCell
+    struct sCell
+    {
+        /// \brief Номер последовательности: pos - свободна для записи на
+        /// позиции pos, pos + 1 - хранит событие позиции pos
+        std::atomic< size_t > mSequence{ 0 };
+        /// \brief Событие
+        T mValue;
+    };
+
+    /// \brief Ячейки канала
+    std::array< sCell, CAPACITY > mCells;
+    /// \brief Позиция записи, общая для производителей
+    alignas( CACHE_LINE_SIZE ) std::atomic< size_t > mEnqueuePos{ 0 };
+    /// \brief Позиция чтения, принадлежит потребителю
+    alignas( CACHE_LINE_SIZE ) size_t mDequeuePos = 0;
+};
+
+/// @}
+
+#endif // CEVENTCHANNEL_H
@@ -0,0 +1,152 @@
+/** ****************************************************************************
+ * \file cInputSource.h
+ *
+ * \defgroup InputSource Источник входных данных
+ * @{
+ *
+ * \brief Модуль, предоставляющий содержимое входного файла как непрерывный
+ * массив байт только для чтения
+ *
+ * \details Обычный файл отображается в память (mmap) без копирования: страницы
+ * подгружаются ядром по мере обращения алгоритмов к данным. Ядру сообщается,
+ * что файл будет читаться последовательно и целиком (madvise), чтобы
+ * упреждающее чтение опережало сжатие. Для выборочного чтения (например,
+ * одного файла из архива) упреждение отключается.
+ *
+ * Если отобразить файл нельзя (канал, символьное устройство, файл с
+ * неизвестным размером, ошибка mmap), содержимое читается вызовами read в
+ * собственный буфер.
+ *
+ * Для отображенного файла запоминаются участки с данными (lseek SEEK_DATA /
+ * SEEK_HOLE). Диапазон, целиком лежащий в дыре разреженного файла, можно
+ * не читать: он состоит из нулей (\ref cInputSource::isHole).
+ *
+ * Реализован с поиощью класса \ref cInputSource
+ * ****************************************************************************/
+
+#ifndef CINPUTSOURCE_H
+#define CINPUTSOURCE_H
+
+#include "common.h" /// Общие константы программы
+#include <cstdint> /// Целые фиксированного размера
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+#include <tuple> /// Кортежи
+#include <vector> /// Вектор
+
+/// \brief Класс, реализующий источник входных данных
+/// \class cInputSource
+class cInputSource final
+{
+public:
+    /// \brief Порядок обращения к данным
+    /// \enum eAccess
+    enum eAccess
+    {
+        ACCESS_SEQUENTIAL, ///< Файл читается целиком от начала к концу
+        ACCESS_RANDOM ///< Читаются отдельные участки
+    };
+
+    /// \brief Конструктор класса
+    cInputSource( void ) = default;
+
+    /// \brief Деструктор класса
+    ~cInputSource( void );
+
+    cInputSource( const cInputSource & ) = delete;
+    cInputSource &operator=( const cInputSource & ) = delete;
+
+    /// \brief Открыть файл
+    /// \param [in] path Путь до файла
+    /// \param [in] access Порядок обращения к данным - подсказка ядру
+    /// \return ERR_STATUS_SUCCESS в случае успеха, ERR_STATUS_BAD_FILE_OPEN
+    /// в случае ошибки открытия файла
+    eErrStatus open( std::string_view path, eAccess access = ACCESS_SEQUENTIAL );
+
+    /// \brief Получить содержимое открытого файла
+    ///
+    /// \details При первом вызове файл отображается в память или читается.
+    /// Представление действительно до \ref close или повторного \ref open
+    ///
+    /// \return Содержимое файла и статус:
+    /// ERR_STATUS_SUCCESS - успех,
+    /// ERR_STATUS_BAD_FILE_OPEN - файл не открыт или ошибка чтения
+    std::tuple< std::string_view, eErrStatus > getData( void );
+
+    /// \brief Проверить, открыт ли файл
+    /// \return true - файл открыт
+    inline bool isOpen( void ) const noexcept { return -1 != mFd; }
+
+    /// \brief Проверить, отображен ли файл в память
+    /// \return true - отображен, false - прочитан в буфер или не загружен
+    inline bool isMapped( void ) const noexcept { return nullptr != mpMapped; }
+
+    /// \brief Проверить, лежит ли диапазон целиком в дыре файла
+    ///
+    /// \details Диапазон дыры читается нулями без обращения к диску. Если
+    /// файловая система не сообщает о дырах, дыр нет
+    ///
+    /// \param [in] offset Смещение в файле
+    /// \param [in] size Размер диапазона
+    ///
+    /// \return true - в диапазоне нет данных
+    bool isHole( uint64_t offset, uint64_t size ) const;
+
+    /// \brief Сообщить, что диапазон больше не нужен
+    ///
+    /// \details Страницы диапазона отключаются от отображения и вытесняются
+    /// из страничного кэша, чтобы большие задания не вытесняли оттуда чужие
+    /// данные. Повторное обращение к диапазону прочитает его с диска
+    ///
+    /// \param [in] offset Смещение в файле
+    /// \param [in] size Размер диапазона
+    void release( uint64_t offset, uint64_t size ) const;
+
+    /// \brief Закрыть файл и освободить отображение или буфер
+    void close( void );
+
+private:
+    /// \brief Отобразить файл в память
+    /// \param [in] size Размер файла
+    /// \return true - файл отображен
+    bool map( size_t size );
+
+    /// \brief Найти участки отображенного файла с данными
+    /// \param [in] size Размер файла
+    void scanExtents( uint64_t size );
+
+    /// \brief Прочитать файл вызовами read до конца
+    /// \return true - файл прочитан
+    bool readAll( void );
+
+    /// \brief Структура, описывающая участок файла с данными
+    /// \struct sExtent
+    struct sExtent
+    {
+        /// \brief Начало участка
+        uint64_t mBegin = 0;
+        /// \brief Конец участка (не включая)
+        uint64_t mEnd = 0;
+    };
+
+    /// \brief Дескриптор файла
+    int mFd = -1;
+    /// \brief Порядок обращения к данным
+    eAccess mAccess = ACCESS_SEQUENTIAL;
+    /// \brief Начало отображения
+    void *mpMapped = nullptr;
+    /// \brief Размер отображения
+    size_t mMappedSize = 0;
+    /// \brief Буфер для файлов, которые нельзя отобразить
+    std::string mBuffer;
+    /// \brief Участки с данными по возрастанию. Пусто, если дыр нет
+    std::vector< sExtent > mDataExtents;
+    /// \brief В файле есть дыры
+    bool mHasHoles = false;
+    /// \brief Флаг загрузки содержимого
+    bool mIsLoaded = false;
+};
+
+/// @}
+
+#endif // CINPUTSOURCE_H
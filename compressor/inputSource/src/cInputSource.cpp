@@ -0,0 +1,211 @@
+/** ****************************************************************************
+ * \brief Исходные коды источника входных данных
+ *
+ * \file cInputSource.cpp
+ * ****************************************************************************/
+
+#include "inputSource/h/cInputSource.h" /// Заголовок класса
+#include <algorithm> /// std::min, std::upper_bound
+#include <cerrno> /// Коды ошибок
+#include <string> /// Строки
+#include <fcntl.h> /// open, posix_fadvise
+#include <sys/mman.h> /// mmap, madvise
+#include <sys/stat.h> /// fstat
+#include <unistd.h> /// read, lseek, close, sysconf
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+cInputSource::~cInputSource( void )
+{
+    close();
+}
+
+eErrStatus cInputSource::open( std::string_view path, eAccess access )
+{
+    close();
+    mAccess = access;
+    mFd = ::open( std::string( path ).c_str(), O_RDONLY );
+
+    return -1 != mFd ? ERR_STATUS_SUCCESS : ERR_STATUS_BAD_FILE_OPEN;
+}
+
+std::tuple< std::string_view, eErrStatus > cInputSource::getData( void )
+{
+    if( -1 == mFd )
+        return std::make_tuple( std::string_view(), ERR_STATUS_BAD_FILE_OPEN );
+
+    if( !mIsLoaded )
+    {
+        struct stat fileStat;
+        if( 0 != ::fstat( mFd, &fileStat ) )
+            return std::make_tuple( std::string_view(), ERR_STATUS_BAD_FILE_OPEN );
+
+        /// Обычный файл известного размера - отображение, иначе - чтение.
+        /// Файлы с нулевым размером (в т.ч. /proc) читаются до конца
+        const bool isRegular = S_ISREG( fileStat.st_mode );
+        if( isRegular && 0 != fileStat.st_size && map( fileStat.st_size ) )
+            mIsLoaded = true;
+        else if( readAll() )
+            mIsLoaded = true;
+        else
+            return std::make_tuple( std::string_view(), ERR_STATUS_BAD_FILE_OPEN );
+    }
+
+    if( isMapped() )
+        return std::make_tuple( std::string_view( static_cast< const char * >( mpMapped ), mMappedSize ),
+                                ERR_STATUS_SUCCESS );
+
+    return std::make_tuple( std::string_view( mBuffer ), ERR_STATUS_SUCCESS );
+}
+
+bool cInputSource::isHole( uint64_t offset, uint64_t size ) const
+{
+    if( !mHasHoles || 0 == size )
+        return false;
+
+    /// Первый участок с данными, кончающийся после начала диапазона
+    const auto extent = std::upper_bound( mDataExtents.begin(), mDataExtents.end(), offset,
+                                          []( uint64_t value, const sExtent &item )
+                                          {
+                                              return value < item.mEnd;
+                                          } );
+
+    return mDataExtents.end() == extent || extent->mBegin >= offset + size;
+}
+
+void cInputSource::release( uint64_t offset, uint64_t size ) const
+{
+    if( !isMapped() || offset >= mMappedSize )
+        return;
+
+    /// Освобождаются только страницы, целиком лежащие в диапазоне
+    const uint64_t pageSize = static_cast< uint64_t >( ::sysconf( _SC_PAGESIZE ) );
+    const uint64_t begin = ( offset + pageSize - 1 ) / pageSize * pageSize;
+    const uint64_t end = std::min< uint64_t >( offset + size, mMappedSize ) / pageSize * pageSize;
+    if( begin >= end )
+        return;
+
+    /// Страницы, пока отображены, кэш не отдаст - сначала отключение
+    ::madvise( static_cast< char * >( mpMapped ) + begin, end - begin, MADV_DONTNEED );
+    ::posix_fadvise( mFd, begin, end - begin, POSIX_FADV_DONTNEED );
+}
+
+void cInputSource::close( void )
+{
+    if( isMapped() )
+        ::munmap( mpMapped, mMappedSize );
+
+    if( -1 != mFd )
+        ::close( mFd );
+
+    mFd = -1;
+    mpMapped = nullptr;
+    mMappedSize = 0;
+    mBuffer.clear();
+    mBuffer.shrink_to_fit();
+    mDataExtents.clear();
+    mDataExtents.shrink_to_fit();
+    mHasHoles = false;
+    mIsLoaded = false;
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+bool cInputSource::map( size_t size )
+{
+    void *mapped = ::mmap( nullptr, size, PROT_READ, MAP_PRIVATE, mFd, 0 );
+    if( MAP_FAILED == mapped )
+        return false;
+
+    /// Подсказки ядру носят рекомендательный характер, ошибки не важны
+    if( ACCESS_RANDOM == mAccess )
+    {
+        ::madvise( mapped, size, MADV_RANDOM );
+    }
+    else
+    {
+        ::madvise( mapped, size, MADV_SEQUENTIAL );
+        ::madvise( mapped, size, MADV_WILLNEED );
+    }
+
+    mpMapped = mapped;
+    mMappedSize = size;
+
+    scanExtents( size );
+
+    return true;
+}
+
+void cInputSource::scanExtents( uint64_t size )
+{
+    mDataExtents.clear();
+    mHasHoles = false;
+
+    uint64_t offset = 0;
+    while( offset < size )
+    {
+        const off_t dataBegin = ::lseek( mFd, offset, SEEK_DATA );
+        if( dataBegin < 0 )
+        {
+            /// ENXIO - до конца файла данных нет. Иначе SEEK_DATA не
+            /// поддерживается: файл считается сплошным
+            if( ENXIO != errno )
+            {
+                mDataExtents.clear();
+                return;
+            }
+
+            break;
+        }
+
+        off_t dataEnd = ::lseek( mFd, dataBegin, SEEK_HOLE );
+        if( dataEnd <= dataBegin || static_cast< uint64_t >( dataEnd ) > size )
+            dataEnd = size;
+
+        mDataExtents.push_back( { static_cast< uint64_t >( dataBegin ), static_cast< uint64_t >( dataEnd ) } );
+        offset = dataEnd;
+    }
+
+    /// Один участок на весь файл - дыр нет, участки не нужны
+    mHasHoles = !( 1 == mDataExtents.size() && 0 == mDataExtents.front().mBegin
+                   && size == mDataExtents.front().mEnd );
+    if( !mHasHoles )
+        mDataExtents.clear();
+
+    /// Позиция чтения не используется отображением, но возвращается в начало
+    ::lseek( mFd, 0, SEEK_SET );
+}
+
+bool cInputSource::readAll( void )
+{
+    constexpr size_t READ_CHUNK_SIZE = 1024 * 1024;
+
+    mBuffer.clear();
+    size_t filled = 0;
+    for( ;; )
+    {
+        mBuffer.resize( filled + READ_CHUNK_SIZE );
+        const ssize_t received = ::read( mFd, mBuffer.data() + filled, READ_CHUNK_SIZE );
+        if( received < 0 )
+        {
+            if( EINTR == errno )
+                continue;
+
+            mBuffer.clear();
+            return false;
+        }
+
+        if( 0 == received )
+            break;
+
+        filled += received;
+    }
+
+    mBuffer.resize( filled );
+
+    return true;
+}
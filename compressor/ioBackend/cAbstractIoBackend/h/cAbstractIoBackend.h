@@ -0,0 +1,116 @@
+/** ****************************************************************************
+ * \file cAbstractIoBackend.h
+ * ****************************************************************************/
+
+/** ****************************************************************************
+ * \defgroup IoBackend Подсистемы записи файлов
+ *
+ * \brief Предназначен для записи результата в файл
+ *
+ * \details Состоит из интерфейса подсистем записи - \ref IoBackendAbstract
+ * и его реализаций: \ref IoBackendPosix (переносимая позиционная запись) и
+ * \ref IoBackendUring (асинхронная запись через io_uring, в том числе в обход
+ * страничного кэша)
+ *
+ * ****************************************************************************/
+
+/** ****************************************************************************
+ * \defgroup IoBackendAbstract Интерфейс подсистем записи
+ * @{
+ * \ingroup IoBackend
+ *
+ * \brief Модуль, содержащий интерфейс подсистем записи файлов
+ *
+ * \details Запись позиционная и может вызываться из нескольких потоков
+ * одновременно. Реализация может завершать запись асинхронно: данные
+ * копируются до возврата из \ref cAbstractIoBackend::write, а об ошибках
+ * отложенных записей сообщает \ref cAbstractIoBackend::flush.
+ *
+ * Реализован с поиощью класса \ref cAbstractIoBackend
+ * ****************************************************************************/
+
+#ifndef CABSTRACTIOBACKEND_H
+#define CABSTRACTIOBACKEND_H
+
+#include "common.h" /// Общие константы
+#include <cstdint> /// Целые фиксированного размера
+#include <memory> /// Умные указатели
+#include <string_view> /// Представления строк
+
+/// \brief Абстрактный класс подсистем записи файлов
+/// \class cAbstractIoBackend
+class cAbstractIoBackend
+{
+public:
+    /// \brief Деструктор класса
+    virtual ~cAbstractIoBackend( void ) = default;
+
+    /// \brief Создать новый файл. Существующий файл не открывается
+    /// \param [in] path Путь до файла
+    /// \return ERR_STATUS_SUCCESS в случае успеха, ERR_STATUS_BAD_FILE_OPEN
+    /// в случае ошибки создания файла
+    virtual eErrStatus open( std::string_view path ) = 0;
+
+    /// \brief Записать данные по смещению
+    /// \param [in] offset Смещение в файле
+    /// \param [in] data Данные. Могут быть освобождены сразу после возврата
+    /// \return true - запись выполнена или поставлена в очередь
+    virtual bool write( uint64_t offset, std::string_view data ) = 0;
+
+    /// \brief Задать размер файла
+    /// \param [in] size Размер в байтах
+    /// \return true - размер задан
+    virtual bool truncate( uint64_t size ) = 0;
+
+    /// \brief Выделить место под файл заранее и задать его размер
+    ///
+    /// \details Файловая система выделяет место сразу крупными экстентами, а
+    /// не по мере записи. Если предварительное выделение не поддерживается,
+    /// только задается размер
+    ///
+    /// \param [in] size Размер в байтах
+    /// \return true - размер задан
+    virtual bool allocate( uint64_t size ) = 0;
+
+    /// \brief Освободить место под участком файла, оставив на нем дыру
+    ///
+    /// \details Участок читается нулями. Вызывается для участков, в которые
+    /// ничего не пишется, поэтому ошибка не критична: участок выделенного
+    /// заранее файла и так читается нулями, но занимает место на диске
+    ///
+    /// \param [in] offset Смещение в файле
+    /// \param [in] size Размер участка
+    /// \return true - место освобождено
+    virtual bool punchHole( uint64_t offset, uint64_t size ) = 0;
+
+    /// \brief Дождаться завершения всех поставленных записей
+    /// \return true - все записи с момента открытия выполнены успешно
+    virtual bool flush( void ) = 0;
+
+    /// \brief Закрыть файл. Незавершенные записи дожидаются
+    virtual void close( void ) = 0;
+
+    /// \brief Проверить, открыт ли файл
+    /// \return true - файл открыт
+    virtual bool isOpen( void ) const noexcept = 0;
+
+    /// \brief Получить тип подсистемы
+    /// \return Тип подсистемы
+    virtual eTypeOfIoBackend getType( void ) const noexcept = 0;
+
+    /// \brief Создать подсистему записи
+    ///
+    /// \details Если io_uring не поддерживается сборкой или ядром, создается
+    /// переносимая подсистема \ref IoBackendPosix
+    ///
+    /// \param [in] type Желаемый тип подсистемы
+    /// \param [in] isDirect true - писать в обход страничного кэша (O_DIRECT),
+    /// если подсистема и файловая система это поддерживают
+    ///
+    /// \return Подсистема записи
+    static std::unique_ptr< cAbstractIoBackend > create( eTypeOfIoBackend type, bool isDirect );
+};
+
+/// @}
+
+#endif // CABSTRACTIOBACKEND_H
@@ -0,0 +1,31 @@
+/** ****************************************************************************
+ * \brief Исходные коды интерфейса подсистем записи
+ *
+ * \file cAbstractIoBackend.cpp
+ * ****************************************************************************/
+
+#include "ioBackend/cAbstractIoBackend/h/cAbstractIoBackend.h" /// Заголовок класса
+#include "ioBackend/cIoBackendPosix/h/cIoBackendPosix.h" /// Позиционная запись
+#include "ioBackend/cIoBackendUring/h/cIoBackendUring.h" /// Запись через io_uring
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+std::unique_ptr< cAbstractIoBackend > cAbstractIoBackend::create( eTypeOfIoBackend type, bool isDirect )
+{
+#ifdef IO_URING_SUPPORTED
+    if( IO_TYPE_URING == type )
+    {
+        /// Ядро может не поддерживать io_uring или запрещать его политикой
+        auto backend = std::make_unique< cIoBackendUring >( isDirect );
+        if( backend->isReady() )
+            return backend;
+    }
+#else
+    ( void )type;
+    ( void )isDirect;
+#endif
+
+    return std::make_unique< cIoBackendPosix >();
+}
@@ -0,0 +1,86 @@
+/** ****************************************************************************
+ * \file cIoBackendPosix.h
+ *
+ * \defgroup IoBackendPosix Позиционная запись
+ * @{
+ *
+ * \ingroup IoBackend
+ *
+ * \brief Модуль, реализующий переносимую подсистему записи
+ *
+ * \details Каждая запись выполняется синхронно вызовами pwrite через
+ * страничный кэш. Используется там, где io_uring недоступен.
+ *
+ * Реализован с поиощью класса \ref cIoBackendPosix
+ * ****************************************************************************/
+
+#ifndef CIOBACKENDPOSIX_H
+#define CIOBACKENDPOSIX_H
+
+#include "ioBackend/cAbstractIoBackend/h/cAbstractIoBackend.h" /// Интерфейс подсистем записи
+
+/// \brief Класс, реализующий позиционную запись pwrite
+/// \class cIoBackendPosix
+class cIoBackendPosix final : public cAbstractIoBackend
+{
+public:
+    /// \brief Деструктор класса
+    ~cIoBackendPosix( void ) override;
+
+    eErrStatus open( std::string_view path ) override;
+
+    bool write( uint64_t offset, std::string_view data ) override;
+
+    bool truncate( uint64_t size ) override;
+
+    bool allocate( uint64_t size ) override;
+
+    bool punchHole( uint64_t offset, uint64_t size ) override;
+
+    /// \brief Записи синхронные - ожидать нечего
+    /// \return true
+    inline bool flush( void ) override { return true; }
+
+    void close( void ) override;
+
+    inline bool isOpen( void ) const noexcept override { return -1 != mFd; }
+
+    inline eTypeOfIoBackend getType( void ) const noexcept override { return IO_TYPE_POSIX; }
+
+    /// \brief Записать данные по смещению целиком, повторяя прерванные и
+    /// частичные вызовы pwrite
+    ///
+    /// \param [in] fd Дескриптор файла
+    /// \param [in] offset Смещение в файле
+    /// \param [in] data Данные
+    ///
+    /// \return true - данные записаны, иначе - false
+    static bool writeAll( int fd, uint64_t offset, std::string_view data );
+
+    /// \brief Выделить место под файл (fallocate) и задать его размер. Без
+    /// поддержки fallocate размер задается ftruncate
+    ///
+    /// \param [in] fd Дескриптор файла
+    /// \param [in] size Размер в байтах
+    ///
+    /// \return true - размер задан
+    static bool allocateFile( int fd, uint64_t size );
+
+    /// \brief Освободить место под участком файла (fallocate с
+    /// FALLOC_FL_PUNCH_HOLE), не меняя размер файла
+    ///
+    /// \param [in] fd Дескриптор файла
+    /// \param [in] offset Смещение в файле
+    /// \param [in] size Размер участка
+    ///
+    /// \return true - место освобождено, false - не поддерживается
+    static bool punchFileHole( int fd, uint64_t offset, uint64_t size );
+
+private:
+    /// \brief Дескриптор файла
+    int mFd = -1;
+};
+
+/// @}
+
+#endif // CIOBACKENDPOSIX_H
@@ -0,0 +1,116 @@
+/** ****************************************************************************
+ * \brief Исходные коды позиционной записи
+ *
+ * \file cIoBackendPosix.cpp
+ * ****************************************************************************/
+
+#include "ioBackend/cIoBackendPosix/h/cIoBackendPosix.h" /// Заголовок класса
+#include <cerrno> /// Коды ошибок
+#include <string> /// Строки
+#include <fcntl.h> /// open, fallocate
+#include <unistd.h> /// pwrite, ftruncate, close
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+cIoBackendPosix::~cIoBackendPosix( void )
+{
+    close();
+}
+
+eErrStatus cIoBackendPosix::open( std::string_view path )
+{
+    close();
+    mFd = ::open( std::string( path ).c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644 );
+
+    return -1 != mFd ? ERR_STATUS_SUCCESS : ERR_STATUS_BAD_FILE_OPEN;
+}
+
+bool cIoBackendPosix::write( uint64_t offset, std::string_view data )
+{
+    return writeAll( mFd, offset, data );
+}
+
+bool cIoBackendPosix::truncate( uint64_t size )
+{
+    return 0 == ::ftruncate( mFd, size );
+}
+
+bool cIoBackendPosix::allocate( uint64_t size )
+{
+    return allocateFile( mFd, size );
+}
+
+bool cIoBackendPosix::punchHole( uint64_t offset, uint64_t size )
+{
+    return punchFileHole( mFd, offset, size );
+}
+
+void cIoBackendPosix::close( void )
+{
+    if( -1 != mFd )
+        ::close( mFd );
+
+    mFd = -1;
+}
+
+bool cIoBackendPosix::writeAll( int fd, uint64_t offset, std::string_view data )
+{
+    while( !data.empty() )
+    {
+        const ssize_t written = ::pwrite( fd, data.data(), data.size(), offset );
+        if( written < 0 )
+        {
+            if( EINTR == errno )
+                continue;
+
+            return false;
+        }
+
+        data.remove_prefix( written );
+        offset += written;
+    }
+
+    return true;
+}
+
+bool cIoBackendPosix::allocateFile( int fd, uint64_t size )
+{
+#ifdef __linux__
+    /// Режим 0 выделяет место и увеличивает размер файла
+    for( ;; )
+    {
+        if( 0 == ::fallocate( fd, 0, 0, size ) )
+            return true;
+
+        if( EINTR != errno )
+            break;
+    }
+
+    /// Файловая система без fallocate или нет места под всю оценку размера -
+    /// задается только размер: итоговый файл обычно меньше оценки
+#endif
+
+    return 0 == ::ftruncate( fd, size );
+}
+
+bool cIoBackendPosix::punchFileHole( int fd, uint64_t offset, uint64_t size )
+{
+#ifdef __linux__
+    for( ;; )
+    {
+        if( 0 == ::fallocate( fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, offset, size ) )
+            return true;
+
+        if( EINTR != errno )
+            break;
+    }
+#else
+    ( void )fd;
+    ( void )offset;
+    ( void )size;
+#endif
+
+    return false;
+}
@@ -0,0 +1,230 @@
+/** ****************************************************************************
+ * \file cIoBackendUring.h
+ *
+ * \defgroup IoBackendUring Запись через io_uring
+ * @{
+ *
+ * \ingroup IoBackend
+ *
+ * \brief Модуль, реализующий асинхронную подсистему записи на io_uring
+ *
+ * \details Кольца io_uring создаются системными вызовами напрямую, без
+ * сторонних библиотек. Данные копируются в один из
+ * \ref cIoBackendUring::IO_BUFFER_COUNT буферов, заранее зарегистрированных в
+ * ядре (IORING_REGISTER_BUFFERS), поэтому ядру не нужно закреплять страницы
+ * при каждой записи. Запросы отправляются пачками по
+ * \ref cIoBackendUring::SUBMIT_BATCH одним системным вызовом; вызывающий поток
+ * ждет только при нехватке свободных буферов.
+ *
+ * В режиме O_DIRECT буферы выровнены по \ref cIoBackendUring::DIRECT_ALIGNMENT,
+ * и через кольцо пишется выровненная часть каждой записи. Невыровненные
+ * начало и конец (несколько байт вокруг границ блоков, заголовок) пишутся
+ * синхронно через второй, обычный дескриптор того же файла. Области двух
+ * дескрипторов не пересекаются по страницам. Если файловая система не
+ * поддерживает O_DIRECT, кольцо пишет через обычный дескриптор.
+ *
+ * Создание кольца и регистрация буферов дороже записи небольшого файла,
+ * поэтому кольцо закрытой подсистемы сохраняется (не больше
+ * \ref cIoBackendUring::RING_CACHE_SIZE) и достается следующей.
+ *
+ * Доступен только при сборке под Linux с заголовком linux/io_uring.h -
+ * тогда определяется IO_URING_SUPPORTED.
+ *
+ * Реализован с поиощью класса \ref cIoBackendUring
+ * ****************************************************************************/
+
+#ifndef CIOBACKENDURING_H
+#define CIOBACKENDURING_H
+
+#if defined( __linux__ ) && defined( __has_include )
+#if __has_include( <linux/io_uring.h> )
+#define IO_URING_SUPPORTED
+#endif
+#endif
+
+#ifdef IO_URING_SUPPORTED
+
+#include "ioBackend/cAbstractIoBackend/h/cAbstractIoBackend.h" /// Интерфейс подсистем записи
+#include <memory> /// Умные указатели
+#include <mutex> /// Мьютексы
+#include <vector> /// Вектор
+#include <linux/io_uring.h> /// Структуры io_uring
+
+/// \brief Класс, реализующий асинхронную запись через io_uring
+/// \class cIoBackendUring
+class cIoBackendUring final : public cAbstractIoBackend
+{
+public:
+    /// \brief Конструктор класса. Создает кольцо и регистрирует буферы
+    /// \param [in] isDirect true - писать в обход страничного кэша
+    explicit cIoBackendUring( bool isDirect );
+
+    /// \brief Деструктор класса
+    ~cIoBackendUring( void ) override;
+
+    cIoBackendUring( const cIoBackendUring & ) = delete;
+    cIoBackendUring &operator=( const cIoBackendUring & ) = delete;
+
+    /// \brief Проверить, создано ли кольцо
+    /// \return true - подсистема готова к работе
+    inline bool isReady( void ) const noexcept { return nullptr != mpRing; }
+
+    eErrStatus open( std::string_view path ) override;
+
+    bool write( uint64_t offset, std::string_view data ) override;
+
+    bool truncate( uint64_t size ) override;
+
+    bool allocate( uint64_t size ) override;
+
+    bool punchHole( uint64_t offset, uint64_t size ) override;
+
+    bool flush( void ) override;
+
+    void close( void ) override;
+
+    inline bool isOpen( void ) const noexcept override { return -1 != mFd; }
+
+    inline eTypeOfIoBackend getType( void ) const noexcept override { return IO_TYPE_URING; }
+
+    /// \brief Количество буферов записи и глубина очереди кольца
+    constexpr static unsigned IO_BUFFER_COUNT = 8;
+
+    /// \brief Размер буфера записи
+    constexpr static size_t IO_BUFFER_SIZE = 512 * 1024;
+
+    /// \brief Количество запросов, отправляемых ядру одним вызовом
+    constexpr static unsigned SUBMIT_BATCH = 4;
+
+    /// \brief Выравнивание смещений, размеров и адресов для O_DIRECT
+    constexpr static size_t DIRECT_ALIGNMENT = 4096;
+
+    /// \brief Количество сохраняемых свободных колец
+    constexpr static size_t RING_CACHE_SIZE = 16;
+
+private:
+    /// \brief Структура, описывающая буфер записи
+    /// \struct sIoBuffer
+    struct sIoBuffer
+    {
+        /// \brief Выровненная память буфера
+        char *mpData = nullptr;
+        /// \brief Смещение записи в файле
+        uint64_t mOffset = 0;
+        /// \brief Размер записи
+        size_t mSize = 0;
+    };
+
+    /// \brief Структура, описывающая кольцо с буферами записи
+    /// \struct sRing
+    struct sRing
+    {
+        /// \brief Деструктор. Закрывает кольцо и освобождает буферы
+        ~sRing( void );
+
+        /// \brief Создать кольцо и буферы
+        /// \return true - кольцо готово
+        bool setup( void );
+
+        /// \brief Отобразить кольца в память
+        /// \param [in] params Параметры, заполненные io_uring_setup
+        /// \return true - кольца отображены
+        bool mapRings( const io_uring_params &params );
+
+        /// \brief Выделить и зарегистрировать буферы записи
+        /// \return true - буферы выделены. Ошибка регистрации не критична
+        bool allocateBuffers( void );
+
+        /// \brief Файловый дескриптор кольца
+        int mRingFd = -1;
+        /// \brief Буферы зарегистрированы в ядре
+        bool mIsBuffersRegistered = false;
+
+        /// \brief Отображение кольца отправки
+        void *mpSqRing = nullptr;
+        /// \brief Размер отображения кольца отправки
+        size_t mSqRingSize = 0;
+        /// \brief Отображение кольца завершений
+        void *mpCqRing = nullptr;
+        /// \brief Размер отображения кольца завершений
+        size_t mCqRingSize = 0;
+        /// \brief Массив запросов
+        io_uring_sqe *mpSqes = nullptr;
+        /// \brief Размер массива запросов
+        size_t mSqesSize = 0;
+
+        /// \brief Хвост кольца отправки
+        unsigned *mpSqTail = nullptr;
+        /// \brief Маска кольца отправки
+        unsigned *mpSqMask = nullptr;
+        /// \brief Индексы запросов кольца отправки
+        unsigned *mpSqArray = nullptr;
+        /// \brief Голова кольца завершений
+        unsigned *mpCqHead = nullptr;
+        /// \brief Хвост кольца завершений
+        unsigned *mpCqTail = nullptr;
+        /// \brief Маска кольца завершений
+        unsigned *mpCqMask = nullptr;
+        /// \brief Завершения
+        io_uring_cqe *mpCqes = nullptr;
+
+        /// \brief Буферы записи
+        std::vector< sIoBuffer > mBuffers;
+        /// \brief Номера свободных буферов
+        std::vector< unsigned > mFreeBuffers;
+        /// \brief Количество запросов, поставленных, но не отправленных ядру
+        unsigned mQueuedCount = 0;
+        /// \brief Количество незавершенных запросов
+        unsigned mInFlightCount = 0;
+    };
+
+    /// \brief Взять сохраненное кольцо или создать новое
+    /// \return Кольцо или nullptr, если io_uring недоступен
+    static std::unique_ptr< sRing > acquireRing( void );
+
+    /// \brief Сохранить кольцо для следующей подсистемы
+    /// \param [in] ring Кольцо без незавершенных запросов
+    static void releaseRing( std::unique_ptr< sRing > ring );
+
+    /// \brief Получить свободный буфер, при необходимости дождавшись
+    /// завершения записей. Вызывается под мьютексом
+    /// \return Номер буфера или IO_BUFFER_COUNT при ошибке
+    unsigned acquireBuffer( void );
+
+    /// \brief Поставить запись буфера в очередь отправки. Вызывается под
+    /// мьютексом
+    /// \param [in] bufferIndex Номер буфера
+    /// \return true - запрос поставлен
+    bool queueBuffer( unsigned bufferIndex );
+
+    /// \brief Отправить поставленные запросы и забрать завершенные. Вызывается
+    /// под мьютексом
+    /// \param [in] minComplete Сколько завершений дождаться
+    /// \return true - системный вызов выполнен
+    bool submitAndReap( unsigned minComplete );
+
+    /// \brief Кольцо с буферами
+    std::unique_ptr< sRing > mpRing;
+    /// \brief Обычный дескриптор файла
+    int mFd = -1;
+    /// \brief Дескриптор файла с O_DIRECT. -1, если не используется
+    int mDirectFd = -1;
+    /// \brief Запрошена запись в обход страничного кэша
+    bool mIsDirect = false;
+    /// \brief Ошибка записи с момента открытия
+    bool mIsFailed = false;
+
+    /// \brief Мьютекс кольца и буферов
+    std::mutex mMutex;
+
+    /// \brief Сохраненные свободные кольца
+    inline static std::vector< std::unique_ptr< sRing > > mRingCache;
+    /// \brief Мьютекс сохраненных колец
+    inline static std::mutex mRingCacheMutex;
+};
+
+#endif // IO_URING_SUPPORTED
+
+/// @}
+
+#endif // CIOBACKENDURING_H
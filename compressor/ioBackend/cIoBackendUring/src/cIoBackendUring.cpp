@@ -0,0 +1,401 @@
+/** ****************************************************************************
+ * \brief Исходные коды записи через io_uring
+ *
+ * \file cIoBackendUring.cpp
+ * ****************************************************************************/
+
+#include "ioBackend/cIoBackendUring/h/cIoBackendUring.h" /// Заголовок класса
+
+#ifdef IO_URING_SUPPORTED
+
+#include "ioBackend/cIoBackendPosix/h/cIoBackendPosix.h" /// Синхронная запись краев
+#include <algorithm> /// std::min, std::max
+#include <cerrno> /// Коды ошибок
+#include <cstdlib> /// posix_memalign, free
+#include <cstring> /// std::memset, std::memcpy
+#include <string> /// Строки
+#include <fcntl.h> /// open, O_DIRECT
+#include <sys/mman.h> /// mmap
+#include <sys/syscall.h> /// Номера системных вызовов io_uring
+#include <sys/uio.h> /// iovec
+#include <unistd.h> /// syscall, ftruncate, close
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+cIoBackendUring::cIoBackendUring( bool isDirect ) : mpRing( acquireRing() ), mIsDirect( isDirect )
+{
+}
+
+cIoBackendUring::~cIoBackendUring( void )
+{
+    close();
+
+    if( mpRing )
+        releaseRing( std::move( mpRing ) );
+}
+
+eErrStatus cIoBackendUring::open( std::string_view path )
+{
+    close();
+
+    std::lock_guard< std::mutex > lock( mMutex );
+    const std::string filePath( path );
+    mFd = ::open( filePath.c_str(), O_WRONLY | O_CREAT | O_EXCL, 0644 );
+    if( -1 == mFd )
+        return ERR_STATUS_BAD_FILE_OPEN;
+
+    /// Файловая система может не поддерживать O_DIRECT (например, tmpfs) -
+    /// тогда кольцо пишет через обычный дескриптор
+    if( mIsDirect )
+        mDirectFd = ::open( filePath.c_str(), O_WRONLY | O_DIRECT );
+
+    return ERR_STATUS_SUCCESS;
+}
+
+bool cIoBackendUring::write( uint64_t offset, std::string_view data )
+{
+    std::lock_guard< std::mutex > lock( mMutex );
+    if( -1 == mFd || mIsFailed )
+        return false;
+
+    sRing &ring = *mpRing;
+
+    /// Через кольцо пишется [ ringBegin, ringEnd ), в режиме O_DIRECT -
+    /// только выровненная часть
+    const uint64_t end = offset + data.size();
+    uint64_t ringBegin = offset;
+    uint64_t ringEnd = end;
+    if( -1 != mDirectFd )
+    {
+        ringBegin = ( offset + DIRECT_ALIGNMENT - 1 ) / DIRECT_ALIGNMENT * DIRECT_ALIGNMENT;
+        ringEnd = end / DIRECT_ALIGNMENT * DIRECT_ALIGNMENT;
+        if( ringBegin >= ringEnd )
+            ringBegin = ringEnd = end;
+    }
+
+    /// Невыровненные края - синхронно через обычный дескриптор
+    if( !cIoBackendPosix::writeAll( mFd, offset, data.substr( 0, ringBegin - offset ) ) ||
+        !cIoBackendPosix::writeAll( mFd, ringEnd, data.substr( ringEnd - offset ) ) )
+    {
+        mIsFailed = true;
+        return false;
+    }
+
+    for( uint64_t position = ringBegin; position < ringEnd; )
+    {
+        const unsigned bufferIndex = acquireBuffer();
+        if( IO_BUFFER_COUNT == bufferIndex )
+        {
+            mIsFailed = true;
+            return false;
+        }
+
+        sIoBuffer &buffer = ring.mBuffers[ bufferIndex ];
+        buffer.mOffset = position;
+        buffer.mSize = std::min< uint64_t >( IO_BUFFER_SIZE, ringEnd - position );
+        std::memcpy( buffer.mpData, data.data() + ( position - offset ), buffer.mSize );
+
+        if( !queueBuffer( bufferIndex ) )
+        {
+            mIsFailed = true;
+            return false;
+        }
+
+        position += buffer.mSize;
+    }
+
+    return true;
+}
+
+bool cIoBackendUring::truncate( uint64_t size )
+{
+    std::lock_guard< std::mutex > lock( mMutex );
+    return 0 == ::ftruncate( mFd, size );
+}
+
+bool cIoBackendUring::allocate( uint64_t size )
+{
+    std::lock_guard< std::mutex > lock( mMutex );
+    return cIoBackendPosix::allocateFile( mFd, size );
+}
+
+bool cIoBackendUring::punchHole( uint64_t offset, uint64_t size )
+{
+    std::lock_guard< std::mutex > lock( mMutex );
+    return cIoBackendPosix::punchFileHole( mFd, offset, size );
+}
+
+bool cIoBackendUring::flush( void )
+{
+    std::lock_guard< std::mutex > lock( mMutex );
+    while( mpRing && 0 != mpRing->mInFlightCount )
+    {
+        if( !submitAndReap( 1 ) )
+        {
+            mIsFailed = true;
+            break;
+        }
+    }
+
+    return !mIsFailed;
+}
+
+void cIoBackendUring::close( void )
+{
+    flush();
+
+    std::lock_guard< std::mutex > lock( mMutex );
+    if( -1 != mDirectFd )
+        ::close( mDirectFd );
+    if( -1 != mFd )
+        ::close( mFd );
+
+    mDirectFd = -1;
+    mFd = -1;
+    mIsFailed = false;
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+std::unique_ptr< cIoBackendUring::sRing > cIoBackendUring::acquireRing( void )
+{
+    {
+        std::lock_guard< std::mutex > lock( mRingCacheMutex );
+        if( !mRingCache.empty() )
+        {
+            std::unique_ptr< sRing > ring( std::move( mRingCache.back() ) );
+            mRingCache.pop_back();
+            return ring;
+        }
+    }
+
+    auto ring = std::make_unique< sRing >();
+    if( !ring->setup() )
+        ring.reset();
+
+    return ring;
+}
+
+void cIoBackendUring::releaseRing( std::unique_ptr< sRing > ring )
+{
+    /// Кольцо с незавершенными запросами (после ошибки io_uring_enter)
+    /// повторно не используется
+    if( 0 != ring->mInFlightCount || 0 != ring->mQueuedCount )
+        return;
+
+    std::lock_guard< std::mutex > lock( mRingCacheMutex );
+    if( mRingCache.size() < RING_CACHE_SIZE )
+        mRingCache.push_back( std::move( ring ) );
+}
+
+cIoBackendUring::sRing::~sRing( void )
+{
+    if( nullptr != mpSqes )
+        ::munmap( mpSqes, mSqesSize );
+    if( nullptr != mpCqRing && mpCqRing != mpSqRing )
+        ::munmap( mpCqRing, mCqRingSize );
+    if( nullptr != mpSqRing )
+        ::munmap( mpSqRing, mSqRingSize );
+
+    /// Закрытие кольца снимает регистрацию буферов
+    if( -1 != mRingFd )
+        ::close( mRingFd );
+
+    for( auto &buffer : mBuffers )
+        std::free( buffer.mpData );
+}
+
+bool cIoBackendUring::sRing::setup( void )
+{
+    io_uring_params params;
+    std::memset( &params, 0, sizeof( params ) );
+
+    mRingFd = static_cast< int >( ::syscall( __NR_io_uring_setup, IO_BUFFER_COUNT, &params ) );
+    if( mRingFd < 0 )
+    {
+        mRingFd = -1;
+        return false;
+    }
+
+    /// Частично созданное кольцо освобождается деструктором
+    return mapRings( params ) && allocateBuffers();
+}
+
+bool cIoBackendUring::sRing::mapRings( const io_uring_params &params )
+{
+    mSqRingSize = params.sq_off.array + params.sq_entries * sizeof( unsigned );
+    mCqRingSize = params.cq_off.cqes + params.cq_entries * sizeof( io_uring_cqe );
+
+    /// Новые ядра отображают оба кольца одним вызовом
+    const bool isSingleMmap = 0 != ( params.features & IORING_FEAT_SINGLE_MMAP );
+    if( isSingleMmap )
+        mSqRingSize = mCqRingSize = std::max( mSqRingSize, mCqRingSize );
+
+    void *sqRing = ::mmap( nullptr, mSqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           mRingFd, IORING_OFF_SQ_RING );
+    if( MAP_FAILED == sqRing )
+        return false;
+    mpSqRing = sqRing;
+
+    if( isSingleMmap )
+    {
+        mpCqRing = mpSqRing;
+    }
+    else
+    {
+        void *cqRing = ::mmap( nullptr, mCqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                               mRingFd, IORING_OFF_CQ_RING );
+        if( MAP_FAILED == cqRing )
+            return false;
+        mpCqRing = cqRing;
+    }
+
+    mSqesSize = params.sq_entries * sizeof( io_uring_sqe );
+    void *sqes = ::mmap( nullptr, mSqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         mRingFd, IORING_OFF_SQES );
+    if( MAP_FAILED == sqes )
+        return false;
+    mpSqes = static_cast< io_uring_sqe * >( sqes );
+
+    char *sq = static_cast< char * >( mpSqRing );
+    mpSqTail = reinterpret_cast< unsigned * >( sq + params.sq_off.tail );
+    mpSqMask = reinterpret_cast< unsigned * >( sq + params.sq_off.ring_mask );
+    mpSqArray = reinterpret_cast< unsigned * >( sq + params.sq_off.array );
+
+    char *cq = static_cast< char * >( mpCqRing );
+    mpCqHead = reinterpret_cast< unsigned * >( cq + params.cq_off.head );
+    mpCqTail = reinterpret_cast< unsigned * >( cq + params.cq_off.tail );
+    mpCqMask = reinterpret_cast< unsigned * >( cq + params.cq_off.ring_mask );
+    mpCqes = reinterpret_cast< io_uring_cqe * >( cq + params.cq_off.cqes );
+
+    return true;
+}
+
+bool cIoBackendUring::sRing::allocateBuffers( void )
+{
+    std::vector< iovec > vectors;
+    mBuffers.resize( IO_BUFFER_COUNT );
+    for( unsigned i = 0; i < IO_BUFFER_COUNT; ++i )
+    {
+        void *memory = nullptr;
+        if( 0 != ::posix_memalign( &memory, DIRECT_ALIGNMENT, IO_BUFFER_SIZE ) )
+        {
+            for( auto &buffer : mBuffers )
+                std::free( buffer.mpData );
+            mBuffers.clear();
+            return false;
+        }
+
+        mBuffers[ i ].mpData = static_cast< char * >( memory );
+        vectors.push_back( { memory, IO_BUFFER_SIZE } );
+        mFreeBuffers.push_back( i );
+    }
+
+    /// Регистрация учитывается в RLIMIT_MEMLOCK. Если лимита не хватает,
+    /// запись идет из тех же буферов без регистрации
+    mIsBuffersRegistered = 0 == ::syscall( __NR_io_uring_register, mRingFd, IORING_REGISTER_BUFFERS,
+                                           vectors.data(), vectors.size() );
+
+    return true;
+}
+
+unsigned cIoBackendUring::acquireBuffer( void )
+{
+    sRing &ring = *mpRing;
+    while( ring.mFreeBuffers.empty() )
+    {
+        if( !submitAndReap( 1 ) )
+            return IO_BUFFER_COUNT;
+    }
+
+    const unsigned bufferIndex = ring.mFreeBuffers.back();
+    ring.mFreeBuffers.pop_back();
+
+    return bufferIndex;
+}
+
+bool cIoBackendUring::queueBuffer( unsigned bufferIndex )
+{
+    sRing &ring = *mpRing;
+    const sIoBuffer &buffer = ring.mBuffers[ bufferIndex ];
+
+    /// Запросов в работе не больше, чем буферов, а буферов не больше, чем
+    /// мест в кольце, поэтому свободное место в кольце есть всегда
+    const unsigned tail = *ring.mpSqTail;
+    const unsigned index = tail & *ring.mpSqMask;
+
+    io_uring_sqe &sqe = ring.mpSqes[ index ];
+    std::memset( &sqe, 0, sizeof( sqe ) );
+    sqe.opcode = ring.mIsBuffersRegistered ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    sqe.fd = -1 != mDirectFd ? mDirectFd : mFd;
+    sqe.addr = reinterpret_cast< uint64_t >( buffer.mpData );
+    sqe.len = static_cast< uint32_t >( buffer.mSize );
+    sqe.off = buffer.mOffset;
+    sqe.buf_index = static_cast< uint16_t >( bufferIndex );
+    sqe.user_data = bufferIndex;
+
+    ring.mpSqArray[ index ] = index;
+    __atomic_store_n( ring.mpSqTail, tail + 1, __ATOMIC_RELEASE );
+
+    ++ring.mQueuedCount;
+    ++ring.mInFlightCount;
+
+    /// Отправка пачкой
+    return ring.mQueuedCount < SUBMIT_BATCH || submitAndReap( 0 );
+}
+
+bool cIoBackendUring::submitAndReap( unsigned minComplete )
+{
+    sRing &ring = *mpRing;
+    const unsigned flags = 0 != minComplete ? IORING_ENTER_GETEVENTS : 0;
+    for( ;; )
+    {
+        const long submitted = ::syscall( __NR_io_uring_enter, ring.mRingFd, ring.mQueuedCount, minComplete, flags,
+                                          nullptr, 0 );
+        if( submitted >= 0 )
+        {
+            ring.mQueuedCount -= static_cast< unsigned >( submitted );
+            break;
+        }
+
+        if( EINTR != errno )
+            return false;
+    }
+
+    unsigned head = *ring.mpCqHead;
+    const unsigned tail = __atomic_load_n( ring.mpCqTail, __ATOMIC_ACQUIRE );
+    for( ; head != tail; ++head )
+    {
+        const io_uring_cqe &cqe = ring.mpCqes[ head & *ring.mpCqMask ];
+        const unsigned bufferIndex = static_cast< unsigned >( cqe.user_data );
+        const sIoBuffer &buffer = ring.mBuffers[ bufferIndex ];
+
+        /// Ядро отменяет асинхронные запросы потока, который их поставил и
+        /// завершился. Такие запросы, как и короткие записи, дописываются
+        /// синхронно из того же буфера
+        const bool isCanceled = -ECANCELED == cqe.res || -EINTR == cqe.res || -EAGAIN == cqe.res;
+        if( cqe.res < 0 && !isCanceled )
+        {
+            mIsFailed = true;
+        }
+        else
+        {
+            const size_t written = std::max( cqe.res, 0 );
+            const std::string_view rest( buffer.mpData + written, buffer.mSize - written );
+            if( !cIoBackendPosix::writeAll( mFd, buffer.mOffset + written, rest ) )
+                mIsFailed = true;
+        }
+
+        ring.mFreeBuffers.push_back( bufferIndex );
+        --ring.mInFlightCount;
+    }
+    __atomic_store_n( ring.mpCqHead, head, __ATOMIC_RELEASE );
+
+    return true;
+}
+
+#endif // IO_URING_SUPPORTED
@@ -0,0 +1,165 @@
+/** ****************************************************************************
+ * \file cJob.h
+ *
+ * \defgroup Job Задание
+ * @{
+ *
+ * \brief Модуль асинхронного задания с отменой и отчетом о ходе выполнения
+ *
+ * \details Задание запускается в общем пуле \ref ThreadPool и возвращает
+ * результат через std::shared_future, поэтому результат можно ожидать или
+ * опрашивать из любого потока.
+ *
+ * Отмена кооперативная: \ref cJob::cancel только поднимает флаг, который
+ * обработчики (\ref FileWorker, \ref BatchProcessor) проверяют перед каждым
+ * блоком. Уже начатый блок дорабатывается до конца.
+ *
+ * Обработчики сообщают о каждом готовом блоке через \ref cJob::addProgress.
+ * Это два атомарных сложения и чтение часов, а функция обратного вызова
+ * вызывается не чаще, чем раз в заданный интервал, поэтому отчет не замедляет
+ * обработку. По завершении задания отчет отправляется всегда.
+ *
+ * Реализован с поиощью класса \ref cJob
+ * ****************************************************************************/
+
+#ifndef CJOB_H
+#define CJOB_H
+
+#include "common.h" /// Общие константы программы
+#include "threadPool/h/cThreadPool.h" /// Пул потоков
+#include <atomic> /// Атомарные переменные
+#include <chrono> /// Время
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <functional> /// Обертки функций
+#include <future> /// Результаты асинхронных задач
+#include <memory> /// Умные указатели
+#include <string> /// Строки
+#include <tuple> /// Кортежи
+
+/// \brief Класс, реализующий асинхронное задание
+/// \class cJob
+class cJob final : public std::enable_shared_from_this< cJob >
+{
+public:
+    /// \brief Структура, описывающая ход выполнения задания
+    /// \struct sProgress
+    struct sProgress
+    {
+        /// \brief Обработано входных байт
+        uint64_t mBytesIn = 0;
+        /// \brief Получено выходных байт
+        uint64_t mBytesOut = 0;
+        /// \brief Всего входных байт. 0 - неизвестно
+        uint64_t mTotalBytes = 0;
+        /// \brief Скорость обработки входных данных, МБ/с
+        double mSpeed = 0.0;
+        /// \brief Оценка оставшегося времени, с. 0 - неизвестно
+        double mEta = 0.0;
+    };
+
+    /// \brief Псевдоним для функции отчета о ходе выполнения. Вызывается из
+    /// рабочих потоков пула
+    /// \typedef progressCallback_t
+    using progressCallback_t = std::function< void( const sProgress & ) >;
+
+    /// \brief Псевдоним для результата задания: созданный файл и статус
+    /// \typedef result_t
+    using result_t = std::tuple< std::string, eErrStatus >;
+
+    /// \brief Интервал отчетов по умолчанию
+    constexpr static std::chrono::milliseconds DEFAULT_PROGRESS_INTERVAL{ 100 };
+
+    /// \brief Конструктор класса
+    /// \param [in] callback Функция отчета о ходе выполнения. Может быть пустой
+    /// \param [in] interval Минимальный интервал между отчетами
+    explicit cJob( progressCallback_t callback = progressCallback_t(),
+                   std::chrono::milliseconds interval = DEFAULT_PROGRESS_INTERVAL );
+
+    cJob( const cJob & ) = delete;
+    cJob &operator=( const cJob & ) = delete;
+
+    /// \brief Запустить задание в общем пуле
+    ///
+    /// \details Задание должно принадлежать std::shared_ptr: пул хранит
+    /// ссылку на него до завершения
+    ///
+    /// \param [in] body Тело задания: result_t( cJob & )
+    /// \param [in] priority Приоритет задания
+    template< typename F >
+    void start( F &&body, cThreadPool::eTaskPriority priority = cThreadPool::TASK_PRIORITY_NORMAL )
+    {
+        mStartTime = std::chrono::steady_clock::now();
+
+        mResult = cThreadPool::instance().submit(
+                    [ self = shared_from_this(), body = std::forward< F >( body ) ]( void ) mutable
+        {
+            result_t result = body( *self );
+            self->reportProgress( true );
+            return result;
+        }, priority ).share();
+    }
+
+    /// \brief Запросить отмену задания
+    inline void cancel( void ) noexcept { mIsCanceled.store( true, std::memory_order_relaxed ); }
+
+    /// \brief Проверить, запрошена ли отмена
+    /// \return true - отмена запрошена
+    inline bool isCanceled( void ) const noexcept { return mIsCanceled.load( std::memory_order_relaxed ); }
+
+    /// \brief Проверить, завершено ли задание
+    /// \return true - результат готов
+    bool isDone( void ) const;
+
+    /// \brief Дождаться результата задания
+    ///
+    /// \details Не вызывать из рабочего потока пула: поток будет заблокирован
+    ///
+    /// \return Созданный файл и статус выполнения
+    result_t get( void ) const;
+
+    /// \brief Установить общий объем входных данных для оценки времени
+    /// \param [in] totalBytes Объем в байтах
+    inline void setTotal( uint64_t totalBytes ) noexcept { mTotalBytes.store( totalBytes, std::memory_order_relaxed ); }
+
+    /// \brief Учесть обработанную часть данных
+    ///
+    /// \details Безопасно вызывать из нескольких потоков одновременно
+    ///
+    /// \param [in] bytesIn Обработано входных байт
+    /// \param [in] bytesOut Получено выходных байт
+    void addProgress( uint64_t bytesIn, uint64_t bytesOut );
+
+    /// \brief Получить текущий ход выполнения
+    /// \return Ход выполнения
+    sProgress getProgress( void ) const;
+
+private:
+    /// \brief Отправить отчет, если с прошлого отчета прошел интервал
+    /// \param [in] isForced true - отправить независимо от интервала
+    void reportProgress( bool isForced );
+
+    /// \brief Функция отчета о ходе выполнения
+    progressCallback_t mCallback;
+    /// \brief Минимальный интервал между отчетами
+    std::chrono::nanoseconds mInterval;
+    /// \brief Время запуска задания
+    std::chrono::steady_clock::time_point mStartTime;
+    /// \brief Время последнего отчета от mStartTime, нс
+    std::atomic< int64_t > mLastReportTime{ 0 };
+
+    /// \brief Обработано входных байт
+    std::atomic< uint64_t > mBytesIn{ 0 };
+    /// \brief Получено выходных байт
+    std::atomic< uint64_t > mBytesOut{ 0 };
+    /// \brief Всего входных байт
+    std::atomic< uint64_t > mTotalBytes{ 0 };
+    /// \brief Флаг запроса отмены
+    std::atomic< bool > mIsCanceled{ false };
+
+    /// \brief Результат задания
+    std::shared_future< result_t > mResult;
+};
+
+/// @}
+
+#endif // CJOB_H
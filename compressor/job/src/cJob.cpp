@@ -0,0 +1,84 @@
+/** ****************************************************************************
+ * \brief Исходные коды асинхронного задания
+ *
+ * \file cJob.cpp
+ * ****************************************************************************/
+
+#include "job/h/cJob.h" /// Заголовок класса
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+cJob::cJob( progressCallback_t callback, std::chrono::milliseconds interval ) :
+    mCallback( std::move( callback ) ),
+    mInterval( interval ),
+    mStartTime( std::chrono::steady_clock::now() )
+{
+}
+
+bool cJob::isDone( void ) const
+{
+    return mResult.valid() &&
+           std::future_status::ready == mResult.wait_for( std::chrono::seconds( 0 ) );
+}
+
+cJob::result_t cJob::get( void ) const
+{
+    return mResult.get();
+}
+
+void cJob::addProgress( uint64_t bytesIn, uint64_t bytesOut )
+{
+    mBytesIn.fetch_add( bytesIn, std::memory_order_relaxed );
+    mBytesOut.fetch_add( bytesOut, std::memory_order_relaxed );
+
+    reportProgress( false );
+}
+
+cJob::sProgress cJob::getProgress( void ) const
+{
+    sProgress progress;
+    progress.mBytesIn = mBytesIn.load( std::memory_order_relaxed );
+    progress.mBytesOut = mBytesOut.load( std::memory_order_relaxed );
+    progress.mTotalBytes = mTotalBytes.load( std::memory_order_relaxed );
+
+    const double seconds =
+            std::chrono::duration< double >( std::chrono::steady_clock::now() - mStartTime ).count();
+    if( seconds > 0.0 && 0 != progress.mBytesIn )
+    {
+        const double bytesPerSecond = progress.mBytesIn / seconds;
+        progress.mSpeed = bytesPerSecond / ( 1024.0 * 1024.0 );
+
+        if( progress.mTotalBytes > progress.mBytesIn )
+            progress.mEta = ( progress.mTotalBytes - progress.mBytesIn ) / bytesPerSecond;
+    }
+
+    return progress;
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+void cJob::reportProgress( bool isForced )
+{
+    if( !mCallback )
+        return;
+
+    const int64_t now = std::chrono::duration_cast< std::chrono::nanoseconds >(
+                std::chrono::steady_clock::now() - mStartTime ).count();
+
+    /// Отчет отправляет только поток, первым заметивший истечение интервала
+    if( !isForced )
+    {
+        int64_t lastReport = mLastReportTime.load( std::memory_order_relaxed );
+        if( now - lastReport < mInterval.count() ||
+            !mLastReportTime.compare_exchange_strong( lastReport, now, std::memory_order_relaxed ) )
+        {
+            return;
+        }
+    }
+
+    mCallback( getProgress() );
+}
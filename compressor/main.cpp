@@ -10,16 +10,25 @@
  * \ref FileWorker - Работа с файлами,
  * \ref Algorithm - Алгоритмы сжатия,
  * а также дополнительного модуля общих констант программы \ref Common
+ *
+ * Если задана переменная окружения CMPRR_STATS_FILE, после каждого задания в
+ * указанный файл выгружается статистика \ref Stats (.json - JSON, иначе -
+ * текстовый формат Prometheus)
  * ****************************************************************************/
 
 #include <windowGUI/h/windowGUI.h> /// GUI
+#include "stats/cStatsExporter/h/cStatsExporter.h" /// Выгрузка статистики
 #include <QApplication> /// Qt управление GUI программами
+#include <cstdlib> /// std::getenv
 
 
 int main( int argc, char **argv )
 {
     QApplication a( argc, argv );
 
+    if( const char *statsPath = std::getenv( "CMPRR_STATS_FILE" ) )
+        cStatsExporter::instance().setPath( statsPath );
+
     windowGUI wg;
     return wg.exec();
 }
@@ -0,0 +1,174 @@
+/** ****************************************************************************
+ * \file cMemoryBudget.h
+ *
+ * \defgroup MemoryBudget Бюджет памяти
+ * @{
+ *
+ * \brief Модуль, ограничивающий память, которую задания выделяют под блоки
+ *
+ * \details Бюджет - предел и учет зарезервированных байт. Общий бюджет
+ * программы - \ref cMemoryBudget::global, бюджет задания создается с общим
+ * в качестве родителя: резерв в бюджете задания резервирует те же байты и в
+ * общем, поэтому одновременные задания вместе не превышают общего предела.
+ * Предел 0 - без ограничения, байты при этом все равно учитываются.
+ *
+ * Резервируется оценка памяти, выделяемой под блок, -
+ * \ref cAbstractAlgorithm::getMemoryBound, - до начала работы с ним, а
+ * освобождается по завершении. Если памяти не хватает, резервирующий
+ * ожидает освобождения другими блоками (\ref cMemoryBudget::reserve).
+ * Заведомо невыполнимый резерв (больше предела) сразу завершается
+ * неудачей - задание получает ERR_STATUS_MEMORY_LIMIT вместо превышения
+ * предела.
+ *
+ * Бюджет запоминает пик зарезервированных байт, который попадает в отчет
+ * задания \ref Stats.
+ *
+ * Реализован с поиощью класса \ref cMemoryBudget
+ * ****************************************************************************/
+
+#ifndef CMEMORYBUDGET_H
+#define CMEMORYBUDGET_H
+
+#include <condition_variable> /// Условные переменные
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <functional> /// Обертки функций
+#include <mutex> /// Мьютексы
+
+/// \brief Класс, реализующий бюджет памяти
+/// \class cMemoryBudget
+class cMemoryBudget final
+{
+public:
+    /// \brief Псевдоним для проверки отмены ожидания
+    /// \typedef cancel_t
+    using cancel_t = std::function< bool() >;
+
+    /// \brief Конструктор класса
+    /// \param [in] limit Предел в байтах. 0 - без ограничения
+    /// \param [in] pParent Родительский бюджет. Может быть nullptr
+    explicit cMemoryBudget( uint64_t limit = UNLIMITED, cMemoryBudget *pParent = nullptr ) noexcept
+        : mLimit( limit ), mpParent( pParent ) {}
+
+    cMemoryBudget( const cMemoryBudget & ) = delete;
+    cMemoryBudget &operator=( const cMemoryBudget & ) = delete;
+
+    /// \brief Зарезервировать память, если она есть сейчас
+    /// \param [in] bytes Количество байт
+    /// \return true - зарезервировано в этом бюджете и во всех родительских
+    bool tryReserve( uint64_t bytes );
+
+    /// \brief Зарезервировать память, ожидая ее освобождения
+    /// \param [in] bytes Количество байт
+    /// \param [in] isCanceled Проверка отмены ожидания. Может быть пустой
+    /// \return true - зарезервировано, false - резерв больше предела этого
+    /// или родительского бюджета либо ожидание отменено
+    bool reserve( uint64_t bytes, const cancel_t &isCanceled = cancel_t() );
+
+    /// \brief Освободить зарезервированную память
+    /// \param [in] bytes Количество байт
+    void release( uint64_t bytes );
+
+    /// \brief Проверить, может ли резерв когда-либо быть выполнен
+    /// \param [in] bytes Количество байт
+    /// \return true - резерв не больше пределов этого и родительских
+    /// бюджетов
+    bool isFeasible( uint64_t bytes ) const;
+
+    /// \brief Получить наименьший из пределов этого и родительских бюджетов
+    /// \return Предел в байтах. 0 - без ограничения
+    uint64_t getEffectiveLimit( void ) const;
+
+    /// \brief Задать предел. Уже зарезервированная память не освобождается
+    /// \param [in] limit Предел в байтах. 0 - без ограничения
+    void setLimit( uint64_t limit );
+
+    /// \brief Получить предел
+    /// \return Предел в байтах. 0 - без ограничения
+    uint64_t getLimit( void ) const;
+
+    /// \brief Получить количество зарезервированных байт
+    /// \return Количество байт
+    uint64_t getUsed( void ) const;
+
+    /// \brief Получить пик зарезервированных байт
+    /// \return Количество байт
+    uint64_t getPeak( void ) const;
+
+    /// \brief Общий бюджет программы
+    /// \return Ссылка на бюджет
+    static cMemoryBudget &global( void );
+
+    /// \brief Класс, освобождающий резерв при разрушении
+    /// \class cReservation
+    class cReservation final
+    {
+    public:
+        /// \brief Конструктор. Резервирует память с ожиданием
+        /// \param [in] budget Бюджет
+        /// \param [in] bytes Количество байт
+        /// \param [in] isCanceled Проверка отмены ожидания. Может быть
+        /// пустой
+        cReservation( cMemoryBudget &budget, uint64_t bytes, const cancel_t &isCanceled = cancel_t() )
+            : mpBudget( &budget ), mBytes( budget.reserve( bytes, isCanceled ) ? bytes : 0 ),
+              mIsReserved( 0 != mBytes || 0 == bytes ) {}
+
+        /// \brief Деструктор. Освобождает резерв
+        ~cReservation( void ) { if( mBytes ) mpBudget->release( mBytes ); }
+
+        cReservation( const cReservation & ) = delete;
+        cReservation &operator=( const cReservation & ) = delete;
+
+        /// \brief Проверить, выполнен ли резерв
+        /// \return true - память зарезервирована
+        inline bool isReserved( void ) const noexcept { return mIsReserved; }
+
+    private:
+        /// \brief Бюджет
+        cMemoryBudget *mpBudget;
+        /// \brief Зарезервировано байт
+        uint64_t mBytes;
+        /// \brief Резерв выполнен
+        bool mIsReserved;
+    };
+
+    /// \brief Предел "без ограничения"
+    constexpr static uint64_t UNLIMITED = 0;
+
+private:
+    /// \brief Проверить, помещается ли резерв во все бюджеты цепочки.
+    /// Вызывается под мьютексом
+    /// \param [in] bytes Количество байт
+    /// \return true - помещается
+    bool fits( uint64_t bytes ) const;
+
+    /// \brief Найти наименьший из пределов цепочки. Вызывается под мьютексом
+    /// \return Предел в байтах. 0 - без ограничения
+    uint64_t findEffectiveLimit( void ) const;
+
+    /// \brief Учесть резерв во всей цепочке. Вызывается под мьютексом
+    /// \param [in] bytes Количество байт
+    void add( uint64_t bytes );
+
+    /// \brief Интервал проверки отмены при ожидании
+    constexpr static int CANCEL_CHECK_INTERVAL_MS = 50;
+
+    /// \brief Предел
+    uint64_t mLimit;
+    /// \brief Зарезервировано байт
+    uint64_t mUsed = 0;
+    /// \brief Пик зарезервированных байт
+    uint64_t mPeak = 0;
+    /// \brief Родительский бюджет
+    cMemoryBudget *mpParent;
+
+    /// \brief Мьютекс всех бюджетов: резерв выполняется сразу во всей
+    /// цепочке. Резервы делаются на блок, поэтому общий мьютекс не узкое
+    /// место
+    static std::mutex mMutex;
+    /// \brief Условная переменная ожидания освобождения памяти
+    static std::condition_variable mCondition;
+};
+
+/// @}
+
+#endif // CMEMORYBUDGET_H
@@ -0,0 +1,132 @@
+/** ****************************************************************************
+ * \brief Исходные коды бюджета памяти
+ *
+ * \file cMemoryBudget.cpp
+ * ****************************************************************************/
+
+#include "memoryBudget/h/cMemoryBudget.h" /// Заголовок класса
+#include <algorithm> /// std::max
+#include <chrono> /// Интервал ожидания
+
+std::mutex cMemoryBudget::mMutex;
+std::condition_variable cMemoryBudget::mCondition;
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+bool cMemoryBudget::tryReserve( uint64_t bytes )
+{
+    std::lock_guard< std::mutex > lock( mMutex );
+    if( !fits( bytes ) )
+        return false;
+
+    add( bytes );
+    return true;
+}
+
+bool cMemoryBudget::reserve( uint64_t bytes, const cancel_t &isCanceled )
+{
+    std::unique_lock< std::mutex > lock( mMutex );
+    while( !fits( bytes ) )
+    {
+        /// Предел могли уменьшить во время ожидания
+        const uint64_t limit = findEffectiveLimit();
+        if( ( UNLIMITED != limit && bytes > limit ) || ( isCanceled && isCanceled() ) )
+            return false;
+
+        mCondition.wait_for( lock, std::chrono::milliseconds( CANCEL_CHECK_INTERVAL_MS ) );
+    }
+
+    add( bytes );
+    return true;
+}
+
+void cMemoryBudget::release( uint64_t bytes )
+{
+    {
+        std::lock_guard< std::mutex > lock( mMutex );
+        for( cMemoryBudget *pBudget = this; nullptr != pBudget; pBudget = pBudget->mpParent )
+            pBudget->mUsed -= std::min( bytes, pBudget->mUsed );
+    }
+
+    mCondition.notify_all();
+}
+
+bool cMemoryBudget::isFeasible( uint64_t bytes ) const
+{
+    const uint64_t limit = getEffectiveLimit();
+    return UNLIMITED == limit || bytes <= limit;
+}
+
+uint64_t cMemoryBudget::getEffectiveLimit( void ) const
+{
+    std::lock_guard< std::mutex > lock( mMutex );
+    return findEffectiveLimit();
+}
+
+void cMemoryBudget::setLimit( uint64_t limit )
+{
+    {
+        std::lock_guard< std::mutex > lock( mMutex );
+        mLimit = limit;
+    }
+
+    mCondition.notify_all();
+}
+
+uint64_t cMemoryBudget::getLimit( void ) const
+{
+    std::lock_guard< std::mutex > lock( mMutex );
+    return mLimit;
+}
+
+uint64_t cMemoryBudget::getUsed( void ) const
+{
+    std::lock_guard< std::mutex > lock( mMutex );
+    return mUsed;
+}
+
+uint64_t cMemoryBudget::getPeak( void ) const
+{
+    std::lock_guard< std::mutex > lock( mMutex );
+    return mPeak;
+}
+
+cMemoryBudget &cMemoryBudget::global( void )
+{
+    static cMemoryBudget budget;
+    return budget;
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+bool cMemoryBudget::fits( uint64_t bytes ) const
+{
+    for( const cMemoryBudget *pBudget = this; nullptr != pBudget; pBudget = pBudget->mpParent )
+        if( UNLIMITED != pBudget->mLimit && bytes > pBudget->mLimit - std::min( pBudget->mLimit, pBudget->mUsed ) )
+            return false;
+
+    return true;
+}
+
+uint64_t cMemoryBudget::findEffectiveLimit( void ) const
+{
+    uint64_t limit = UNLIMITED;
+    for( const cMemoryBudget *pBudget = this; nullptr != pBudget; pBudget = pBudget->mpParent )
+        if( UNLIMITED != pBudget->mLimit && ( UNLIMITED == limit || pBudget->mLimit < limit ) )
+            limit = pBudget->mLimit;
+
+    return limit;
+}
+
+void cMemoryBudget::add( uint64_t bytes )
+{
+    for( cMemoryBudget *pBudget = this; nullptr != pBudget; pBudget = pBudget->mpParent )
+    {
+        pBudget->mUsed += bytes;
+        pBudget->mPeak = std::max( pBudget->mPeak, pBudget->mUsed );
+    }
+}
@@ -0,0 +1,173 @@
+/** ****************************************************************************
+ * \file cKernelBench.h
+ * ****************************************************************************/
+
+/** ****************************************************************************
+ * \defgroup MicroBench Микрозамеры
+ *
+ * \brief Отдельная программа замеров внутренних частей алгоритмов
+ *
+ * \details В отличие от \ref Bench, который меряет сжатие целиком,
+ * показывает, куда уходят такты внутри алгоритмов. Состоит из счетчиков
+ * процессора - \ref MicroBenchCounters и замеров частей - \ref MicroBenchKernels
+ *
+ * ****************************************************************************/
+
+/** ****************************************************************************
+ * \defgroup MicroBenchKernels Замеры частей алгоритмов
+ * @{
+ * \ingroup MicroBench
+ *
+ * \brief Модуль, выполняющий части алгоритмов по отдельности
+ *
+ * \details Части (ядра) вызываются напрямую - класс объявлен другом
+ * \ref cAlgorithmHaffman и \ref cAlgorithmRLE, - на данных
+ * \ref cCorpusGenerator. Все подготовительные шаги (гистограмма для дерева,
+ * дерево для кодов, сжатые данные для распаковки) выполняются до замера.
+ * Рабочая память ядер Хаффмана - контекст алгоритма, созданный до замера,
+ * как у потока, сжимающего блоки подряд.
+ *
+ * Ядра:
+ * - histogram - подсчет частот символов (countFrequencies);
+ * - buildTree - построение дерева Хаффмана по гистограмме;
+ * - encodeTree - таблица кодов символов по дереву;
+ * - writeCodeTable - упаковка кодов в кодовую таблицу сжатых данных;
+ * - emitChunk - запись кодов данных в поток бит;
+ * - huffmanDecode - декодирование потока бит по дереву (decodeRange - то,
+ *   что fillDecomrData выполняет в каждой задаче пула);
+ * - rleScanRuns - поиск цепочек и одиночных элементов RLE (countRun,
+ *   countLiterals);
+ * - rleCopyLiterals - копирование одиночных элементов в результат.
+ *
+ * Все ядра однопоточные: счетчики считают только текущий поток. Из
+ * нескольких прогонов берется медианный по тактам. Размер данных ядра -
+ * весь набор, поэтому такты на байт у ядер построения дерева и таблицы -
+ * их доля в стоимости сжатия блока такого размера.
+ *
+ * Реализован с поиощью класса \ref cKernelBench
+ * ****************************************************************************/
+
+#ifndef CKERNELBENCH_H
+#define CKERNELBENCH_H
+
+#include "bench/cCorpusGenerator/h/cCorpusGenerator.h" /// Тестовые данные
+#include "microbench/cPerfCounters/h/cPerfCounters.h" /// Счетчики процессора
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <functional> /// Обертки функций
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+#include <tuple> /// Кортежи
+#include <vector> /// Вектор
+
+/// \brief Класс, выполняющий замеры частей алгоритмов
+/// \class cKernelBench
+class cKernelBench final
+{
+public:
+    /// \brief Структура, описывающая результат замера ядра
+    /// \struct sResult
+    struct sResult
+    {
+        /// \brief Имя ядра
+        std::string mKernel;
+        /// \brief Вид данных
+        cCorpusGenerator::eCorpus mCorpus = cCorpusGenerator::CORPUS_TEXT;
+        /// \brief Размер данных ядра
+        uint64_t mBytes = 0;
+        /// \brief Счетчики медианного прогона
+        cPerfCounters::sCounts mCounts;
+        /// \brief Счетчики аппаратные
+        bool mIsHardware = false;
+
+        /// \brief Получить значение счетчика на байт данных
+        /// \param [in] value Значение
+        /// \return Значение на байт
+        inline double perByte( uint64_t value ) const noexcept { return mBytes ? double( value ) / mBytes : 0.0; }
+    };
+
+    /// \brief Получить имена всех ядер
+    /// \return Имена в порядке описания
+    static std::vector< std::string_view > getKernelNames( void );
+
+    /// \brief Замерить ядро
+    ///
+    /// \param [in] kernel Имя ядра
+    /// \param [in] corpus Вид данных
+    /// \param [in] size Размер данных
+    /// \param [in] iterations Количество прогонов с замером
+    /// \param [in] counters Счетчики процессора
+    ///
+    /// \return Результат и признак того, что ядро известно
+    static std::tuple< sResult, bool > run( std::string_view kernel,
+                                            cCorpusGenerator::eCorpus corpus,
+                                            size_t size,
+                                            size_t iterations,
+                                            cPerfCounters &counters );
+
+private:
+    /// \brief Псевдоним для подготовленного ядра. Возвращает значение,
+    /// которое нельзя выбросить оптимизатору
+    /// \typedef kernel_t
+    using kernel_t = std::function< uint64_t( void ) >;
+
+    /// \brief Псевдоним для подготовки ядра по данным
+    /// \typedef factory_t
+    using factory_t = kernel_t ( * )( const std::string &data );
+
+    /// \brief Структура, описывающая ядро
+    /// \struct sKernel
+    struct sKernel
+    {
+        /// \brief Имя
+        const char *mName;
+        /// \brief Подготовка
+        factory_t mFactory;
+    };
+
+    /// \brief Подготовить подсчет частот
+    /// \param [in] data Данные
+    /// \return Ядро
+    static kernel_t makeHistogram( const std::string &data );
+
+    /// \brief Подготовить построение дерева
+    /// \param [in] data Данные
+    /// \return Ядро
+    static kernel_t makeBuildTree( const std::string &data );
+
+    /// \brief Подготовить построение кодов
+    /// \param [in] data Данные
+    /// \return Ядро
+    static kernel_t makeEncodeTree( const std::string &data );
+
+    /// \brief Подготовить запись кодовой таблицы
+    /// \param [in] data Данные
+    /// \return Ядро
+    static kernel_t makeWriteCodeTable( const std::string &data );
+
+    /// \brief Подготовить запись кодов
+    /// \param [in] data Данные
+    /// \return Ядро
+    static kernel_t makeEmitChunk( const std::string &data );
+
+    /// \brief Подготовить декодирование
+    /// \param [in] data Данные
+    /// \return Ядро
+    static kernel_t makeHuffmanDecode( const std::string &data );
+
+    /// \brief Подготовить поиск цепочек RLE
+    /// \param [in] data Данные
+    /// \return Ядро
+    static kernel_t makeRleScanRuns( const std::string &data );
+
+    /// \brief Подготовить копирование одиночных элементов RLE
+    /// \param [in] data Данные
+    /// \return Ядро
+    static kernel_t makeRleCopyLiterals( const std::string &data );
+
+    /// \brief Ядра в порядке описания
+    static const sKernel KERNELS[];
+};
+
+/// @}
+
+#endif // CKERNELBENCH_H
@@ -0,0 +1,261 @@
+/** ****************************************************************************
+ * \brief Исходные коды замеров частей алгоритмов
+ *
+ * \file cKernelBench.cpp
+ * ****************************************************************************/
+
+#include "microbench/cKernelBench/h/cKernelBench.h" /// Заголовок класса
+#include "algorithm/cAlgorithmHaffman/h/cAlgorithmHaffman.h" /// Алгоритм Хаффмана
+#include "algorithm/cAlgorithmRLE/h/cAlgorithmRLE.h" /// Алгоритм RLE
+#include <algorithm> /// std::sort
+#include <memory> /// Умные указатели
+#include <utility> /// std::pair
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+const cKernelBench::sKernel cKernelBench::KERNELS[] =
+{
+    { "histogram", &cKernelBench::makeHistogram },
+    { "buildTree", &cKernelBench::makeBuildTree },
+    { "encodeTree", &cKernelBench::makeEncodeTree },
+    { "writeCodeTable", &cKernelBench::makeWriteCodeTable },
+    { "emitChunk", &cKernelBench::makeEmitChunk },
+    { "huffmanDecode", &cKernelBench::makeHuffmanDecode },
+    { "rleScanRuns", &cKernelBench::makeRleScanRuns },
+    { "rleCopyLiterals", &cKernelBench::makeRleCopyLiterals }
+};
+
+std::vector< std::string_view > cKernelBench::getKernelNames( void )
+{
+    std::vector< std::string_view > names;
+    for( const sKernel &kernel : KERNELS )
+        names.emplace_back( kernel.mName );
+
+    return names;
+}
+
+std::tuple< cKernelBench::sResult, bool > cKernelBench::run( std::string_view kernel,
+                                                             cCorpusGenerator::eCorpus corpus,
+                                                             size_t size,
+                                                             size_t iterations,
+                                                             cPerfCounters &counters )
+{
+    sResult result;
+    result.mKernel = std::string( kernel );
+    result.mCorpus = corpus;
+    result.mIsHardware = counters.isHardware();
+
+    const sKernel *pKernel = std::find_if( std::begin( KERNELS ), std::end( KERNELS ),
+                                           [ kernel ]( const sKernel &known ) { return kernel == known.mName; } );
+    if( std::end( KERNELS ) == pKernel )
+        return { result, false };
+
+    const std::string data( cCorpusGenerator::generate( corpus, size ) );
+    result.mBytes = data.size();
+
+    kernel_t body = pKernel->mFactory( data );
+
+    /// Результат ядра копится здесь, чтобы вызов не был выброшен
+    volatile uint64_t sink = 0;
+
+    /// Прогрев: кэши, предсказатель переходов, страницы буферов
+    sink = sink + body();
+
+    std::vector< cPerfCounters::sCounts > samples;
+    samples.reserve( iterations );
+    for( size_t i = 0; i < std::max< size_t >( iterations, 1 ); ++i )
+    {
+        counters.start();
+        const uint64_t value = body();
+        samples.push_back( counters.stop() );
+
+        sink = sink + value;
+    }
+
+    /// Медиана по тактам устойчива к редким вытеснениям потока
+    std::sort( samples.begin(), samples.end(),
+               []( const cPerfCounters::sCounts &lhs, const cPerfCounters::sCounts &rhs )
+               {
+                   return lhs.mCycles < rhs.mCycles;
+               } );
+    result.mCounts = samples[ samples.size() / 2 ];
+
+    return { result, true };
+}
+
+
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+cKernelBench::kernel_t cKernelBench::makeHistogram( const std::string &data )
+{
+    return [ &data ]( void ) -> uint64_t
+    {
+        const cAlgorithmHaffman haffman;
+        const cAlgorithmHaffman::freqTable_t freq = haffman.countFrequencies( data );
+
+        return freq[ 0 ] + freq[ 255 ];
+    };
+}
+
+cKernelBench::kernel_t cKernelBench::makeBuildTree( const std::string &data )
+{
+    const cAlgorithmHaffman::freqTable_t freq = cAlgorithmHaffman().countFrequencies( data );
+    auto context = std::make_shared< cAlgorithmHaffman::sContext >();
+
+    return [ freq, context ]( void ) -> uint64_t
+    {
+        const cAlgorithmHaffman haffman;
+        const int32_t root = haffman.buildTree( freq, *context );
+
+        return context->mNodes[ root ].mFreq;
+    };
+}
+
+cKernelBench::kernel_t cKernelBench::makeEncodeTree( const std::string &data )
+{
+    /// Дерево строится один раз в контексте ядра
+    const cAlgorithmHaffman haffman;
+    auto context = std::make_shared< cAlgorithmHaffman::sContext >();
+    const int32_t root = haffman.buildTree( haffman.countFrequencies( data ), *context );
+
+    return [ root, context ]( void ) -> uint64_t
+    {
+        cAlgorithmHaffman().encodeTree( root, *context );
+
+        return context->mCodes[ 0 ].mLength + context->mCodes[ 255 ].mLength;
+    };
+}
+
+cKernelBench::kernel_t cKernelBench::makeWriteCodeTable( const std::string &data )
+{
+    const cAlgorithmHaffman haffman;
+    auto context = std::make_shared< cAlgorithmHaffman::sContext >();
+    haffman.encodeTree( haffman.buildTree( haffman.countFrequencies( data ), *context ), *context );
+
+    auto table = std::make_shared< std::string >( haffman.getCodeTableSize( context->mCodes ), '\0' );
+
+    return [ context, table ]( void ) -> uint64_t
+    {
+        std::fill( table->begin(), table->end(), '\0' );
+        cAlgorithmHaffman().writeCodeTable( context->mCodes, table->data() );
+
+        return table->size() + uint8_t( table->back() );
+    };
+}
+
+cKernelBench::kernel_t cKernelBench::makeEmitChunk( const std::string &data )
+{
+    const cAlgorithmHaffman haffman;
+    const cAlgorithmHaffman::freqTable_t freq = haffman.countFrequencies( data );
+
+    cAlgorithmHaffman::sContext context;
+    haffman.encodeTree( haffman.buildTree( freq, context ), context );
+    const cAlgorithmHaffman::codeTable_t codes = context.mCodes;
+
+    uint64_t bitCount = 0;
+    for( size_t sym = 0; sym < freq.size(); ++sym )
+        bitCount += freq[ sym ] * codes[ sym ].mLength;
+
+    /// Буфер выделяется заранее, как при сжатии
+    auto buffer = std::make_shared< std::vector< uint8_t > >( ( bitCount + 7 ) / 8 + 1 );
+
+    return [ &data, codes, buffer ]( void ) -> uint64_t
+    {
+        std::fill( buffer->begin(), buffer->end(), 0 );
+        const cAlgorithmHaffman::sChunkBoundary boundary = cAlgorithmHaffman().emitChunk( data, codes, 0, buffer->data() );
+
+        return boundary.mLastByte + buffer->front();
+    };
+}
+
+cKernelBench::kernel_t cKernelBench::makeHuffmanDecode( const std::string &data )
+{
+    const cAlgorithmHaffman haffman;
+    const cAlgorithmHaffman::freqTable_t freq = haffman.countFrequencies( data );
+
+    auto context = std::make_shared< cAlgorithmHaffman::sContext >();
+    haffman.encodeTree( haffman.buildTree( freq, *context ), *context );
+    const cAlgorithmHaffman::codeTable_t &codes = context->mCodes;
+
+    uint64_t bitCount = 0;
+    for( size_t sym = 0; sym < freq.size(); ++sym )
+        bitCount += freq[ sym ] * codes[ sym ].mLength;
+
+    /// Поток бит всех данных одним участком
+    auto stream = std::make_shared< std::vector< uint8_t > >( ( bitCount + 7 ) / 8 + 1 );
+    const cAlgorithmHaffman::sChunkBoundary boundary = haffman.emitChunk( data, codes, 0, stream->data() );
+    if( boundary.mHasLastByte )
+        ( *stream )[ bitCount / 8 ] |= boundary.mLastByte;
+
+    haffman.buildDecodeTree( codes, context->mDecodeTree );
+    context->mDecodedChunks.resize( 1 );
+
+    return [ stream, context, bitCount ]( void ) -> uint64_t
+    {
+        cAlgorithmHaffman::sDecodedChunk &chunk = context->mDecodedChunks.front();
+        cAlgorithmHaffman().decodeRange( stream->data(), context->mDecodeTree, 0, bitCount, bitCount, 0, chunk );
+
+        return chunk.mOutput.size() + chunk.mIsValid;
+    };
+}
+
+cKernelBench::kernel_t cKernelBench::makeRleScanRuns( const std::string &data )
+{
+    return [ &data ]( void ) -> uint64_t
+    {
+        uint64_t runCount = 0;
+        size_t index = 0;
+        while( index < data.size() )
+        {
+            const size_t counter = cAlgorithmRLE::countRun( data, index );
+            if( counter >= cAlgorithmRLE::COUNT_INCREMENT_SET )
+            {
+                ++runCount;
+                index += counter;
+                continue;
+            }
+
+            index += cAlgorithmRLE::countLiterals( data, index );
+        }
+
+        return runCount;
+    };
+}
+
+cKernelBench::kernel_t cKernelBench::makeRleCopyLiterals( const std::string &data )
+{
+    /// Участки одиночных элементов находятся заранее - замеряется только
+    /// копирование в результат, как при сжатии и распаковке
+    auto literals = std::make_shared< std::vector< std::pair< size_t, size_t > > >();
+    size_t index = 0;
+    while( index < data.size() )
+    {
+        const size_t counter = cAlgorithmRLE::countRun( data, index );
+        if( counter >= cAlgorithmRLE::COUNT_INCREMENT_SET )
+        {
+            index += counter;
+            continue;
+        }
+
+        const size_t literalCount = cAlgorithmRLE::countLiterals( data, index );
+        literals->emplace_back( index, literalCount );
+        index += literalCount;
+    }
+
+    auto output = std::make_shared< std::string >();
+    output->reserve( data.size() );
+
+    return [ &data, literals, output ]( void ) -> uint64_t
+    {
+        output->clear();
+        for( const auto &[ start, count ] : *literals )
+            output->append( data.data() + start, count );
+
+        return output->size();
+    };
+}
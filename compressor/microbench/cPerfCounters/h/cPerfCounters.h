@@ -0,0 +1,103 @@
+/** ****************************************************************************
+ * \file cPerfCounters.h
+ *
+ * \defgroup MicroBenchCounters Счетчики процессора
+ * @{
+ *
+ * \ingroup MicroBench
+ *
+ * \brief Модуль чтения аппаратных счетчиков производительности
+ *
+ * \details Под Linux счетчики открываются одной группой через
+ * perf_event_open: такты, инструкции, промахи предсказания переходов и
+ * промахи кэша последнего уровня. Группа включается и читается одним
+ * вызовом, поэтому все значения относятся к одному и тому же участку кода.
+ * Считается только пользовательский режим текущего потока - для этого
+ * достаточно perf_event_paranoid <= 2. Если ядро мультиплексирует счетчики,
+ * значения масштабируются по времени работы группы.
+ *
+ * Если perf_event_open недоступен (нет прав, контейнер, другая ОС), такты
+ * оцениваются счетчиком времени процессора (rdtsc на x86-64) - это опорные
+ * такты, а не такты ядра, - а остальные счетчики не заполняются.
+ *
+ * Реализован с поиощью класса \ref cPerfCounters
+ * ****************************************************************************/
+
+#ifndef CPERFCOUNTERS_H
+#define CPERFCOUNTERS_H
+
+#include <array> /// Массивы фиксированного размера
+#include <cstdint> /// Целочисленные типы фиксированного размера
+
+/// \brief Класс, читающий счетчики производительности текущего потока
+/// \class cPerfCounters
+class cPerfCounters final
+{
+public:
+    /// \brief Структура, описывающая значения счетчиков за участок кода
+    /// \struct sCounts
+    struct sCounts
+    {
+        /// \brief Время, нс
+        uint64_t mNanoseconds = 0;
+        /// \brief Такты: аппаратные или опорные (rdtsc)
+        uint64_t mCycles = 0;
+        /// \brief Инструкции. 0 - счетчик недоступен
+        uint64_t mInstructions = 0;
+        /// \brief Промахи предсказания переходов. 0 - счетчик недоступен
+        uint64_t mBranchMisses = 0;
+        /// \brief Промахи кэша последнего уровня. 0 - счетчик недоступен
+        uint64_t mCacheMisses = 0;
+    };
+
+    /// \brief Конструктор класса. Открывает счетчики
+    cPerfCounters( void );
+
+    /// \brief Деструктор класса. Закрывает счетчики
+    ~cPerfCounters( void );
+
+    cPerfCounters( const cPerfCounters & ) = delete;
+    cPerfCounters &operator=( const cPerfCounters & ) = delete;
+
+    /// \brief Проверить, используются ли аппаратные счетчики
+    /// \return true - счетчики perf_event_open, false - оценка по rdtsc
+    inline bool isHardware( void ) const noexcept { return -1 != mFds[ 0 ]; }
+
+    /// \brief Начать замер: обнулить и включить счетчики
+    void start( void );
+
+    /// \brief Завершить замер
+    /// \return Значения счетчиков с последнего \ref start
+    sCounts stop( void );
+
+private:
+    /// \brief События группы, первое - ведущее
+    /// \enum eEvent
+    enum eEvent
+    {
+        EVENT_CYCLES = 0, ///< Такты
+        EVENT_INSTRUCTIONS, ///< Инструкции
+        EVENT_BRANCH_MISSES, ///< Промахи предсказания переходов
+        EVENT_CACHE_MISSES, ///< Промахи кэша
+        EVENT_COUNT ///< Количество событий
+    };
+
+    /// \brief Прочитать счетчик времени процессора
+    /// \return Опорные такты или 0, если счетчика нет
+    static uint64_t readTimestamp( void ) noexcept;
+
+    /// \brief Прочитать монотонное время
+    /// \return Наносекунды
+    static uint64_t readNanoseconds( void ) noexcept;
+
+    /// \brief Дескрипторы счетчиков. -1 - счетчик не открыт
+    std::array< int, EVENT_COUNT > mFds;
+    /// \brief Время начала замера, нс
+    uint64_t mStartNanoseconds = 0;
+    /// \brief Счетчик времени процессора в начале замера
+    uint64_t mStartTimestamp = 0;
+};
+
+/// @}
+
+#endif // CPERFCOUNTERS_H
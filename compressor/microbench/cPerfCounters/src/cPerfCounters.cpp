@@ -0,0 +1,137 @@
+/** ****************************************************************************
+ * \brief Исходные коды чтения счетчиков производительности
+ *
+ * \file cPerfCounters.cpp
+ * ****************************************************************************/
+
+#include "microbench/cPerfCounters/h/cPerfCounters.h" /// Заголовок класса
+#include <ctime> /// clock_gettime
+#include <unistd.h> /// close, read
+
+#ifdef __linux__
+#include <cstring> /// std::memset
+#include <linux/perf_event.h> /// perf_event_attr
+#include <sys/ioctl.h> /// ioctl
+#include <sys/syscall.h> /// SYS_perf_event_open
+#endif
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <x86intrin.h> /// __rdtsc
+#endif
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+cPerfCounters::cPerfCounters( void )
+{
+    mFds.fill( -1 );
+
+#ifdef __linux__
+    constexpr uint64_t CONFIGS[ EVENT_COUNT ] =
+    {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_MISSES
+    };
+
+    for( size_t event = 0; event < EVENT_COUNT; ++event )
+    {
+        perf_event_attr attr;
+        std::memset( &attr, 0, sizeof( attr ) );
+        attr.size = sizeof( attr );
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = CONFIGS[ event ];
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        /// Включается и выключается только ведущий счетчик - вместе с группой
+        attr.disabled = EVENT_CYCLES == event ? 1 : 0;
+
+        const int groupFd = EVENT_CYCLES == event ? -1 : mFds[ EVENT_CYCLES ];
+        mFds[ event ] = int( ::syscall( SYS_perf_event_open, &attr, 0, -1, groupFd, 0 ) );
+
+        /// Без тактов группы нет; прочие события процессор может не поддерживать
+        if( EVENT_CYCLES == event && -1 == mFds[ event ] )
+            break;
+    }
+#endif
+}
+
+cPerfCounters::~cPerfCounters( void )
+{
+    for( const int fd : mFds )
+        if( -1 != fd )
+            ::close( fd );
+}
+
+void cPerfCounters::start( void )
+{
+#ifdef __linux__
+    if( isHardware() )
+    {
+        ::ioctl( mFds[ EVENT_CYCLES ], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP );
+        ::ioctl( mFds[ EVENT_CYCLES ], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+    }
+#endif
+
+    mStartTimestamp = readTimestamp();
+    mStartNanoseconds = readNanoseconds();
+}
+
+cPerfCounters::sCounts cPerfCounters::stop( void )
+{
+    sCounts counts;
+    counts.mNanoseconds = readNanoseconds() - mStartNanoseconds;
+    counts.mCycles = readTimestamp() - mStartTimestamp;
+
+#ifdef __linux__
+    if( !isHardware() )
+        return counts;
+
+    ::ioctl( mFds[ EVENT_CYCLES ], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP );
+
+    /// Формат группы: количество, время включения, время работы, значения в
+    /// порядке открытия
+    uint64_t buffer[ 3 + EVENT_COUNT ] = {};
+    if( ::read( mFds[ EVENT_CYCLES ], buffer, sizeof( buffer ) ) < ssize_t( 3 * sizeof( uint64_t ) ) )
+        return counts;
+
+    /// Поправка на мультиплексирование счетчиков
+    const double scale = buffer[ 2 ] ? double( buffer[ 1 ] ) / buffer[ 2 ] : 1.0;
+
+    uint64_t values[ EVENT_COUNT ] = {};
+    for( size_t event = 0, valueIndex = 0; event < EVENT_COUNT && valueIndex < buffer[ 0 ]; ++event )
+        if( -1 != mFds[ event ] )
+            values[ event ] = uint64_t( buffer[ 3 + valueIndex++ ] * scale );
+
+    counts.mCycles = values[ EVENT_CYCLES ];
+    counts.mInstructions = values[ EVENT_INSTRUCTIONS ];
+    counts.mBranchMisses = values[ EVENT_BRANCH_MISSES ];
+    counts.mCacheMisses = values[ EVENT_CACHE_MISSES ];
+#endif
+
+    return counts;
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+uint64_t cPerfCounters::readTimestamp( void ) noexcept
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+uint64_t cPerfCounters::readNanoseconds( void ) noexcept
+{
+    timespec now;
+    ::clock_gettime( CLOCK_MONOTONIC, &now );
+    return uint64_t( now.tv_sec ) * 1000000000ull + now.tv_nsec;
+}
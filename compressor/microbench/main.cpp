@@ -0,0 +1,198 @@
+/** ****************************************************************************
+ * \file main.cpp
+ *
+ * \brief Точка входа программы микрозамеров \ref MicroBench
+ *
+ * \details Запуск:
+ *
+ *     microbench [параметры]
+ *
+ * Параметры (списки - через запятую):
+ * - --kernel <имена> - ядра (\ref MicroBenchKernels), по умолчанию все;
+ * - --corpus <виды> - виды данных, по умолчанию text, runs и random;
+ * - --size <размер> - размер данных ядра, суффиксы K и M, по умолчанию 1M;
+ * - --iterations <число> - прогонов с замером, по умолчанию 11;
+ * - --format csv|json - формат отчета, по умолчанию csv.
+ *
+ * Отчет выводится в стандартный поток вывода, источник счетчиков - в
+ * стандартный поток ошибок. Значения на байт и на 1 КиБ даны для медианного
+ * прогона. Если счетчики не аппаратные (counters = tsc), такты - опорные
+ * такты счетчика времени, а инструкции и промахи не заполняются.
+ * Код возврата: 0 - успех, 2 - неверные параметры.
+ * ****************************************************************************/
+
+#include "microbench/cKernelBench/h/cKernelBench.h" /// Замеры частей алгоритмов
+#include <algorithm> /// std::find
+#include <cstdio> /// std::printf
+#include <cstdlib> /// std::strtoull
+#include <string> /// Строки
+#include <vector> /// Вектор
+
+/// \brief Код возврата при неверных параметрах
+static constexpr int EXIT_USAGE = 2;
+
+/// \brief Разобрать размер с необязательным суффиксом K или M
+/// \param [in] text Текст
+/// \param [out] size Размер в байтах
+/// \return true - размер разобран
+static bool parseSize( const std::string &text, uint64_t &size )
+{
+    char *end = nullptr;
+    size = std::strtoull( text.c_str(), &end, 10 );
+    if( end == text.c_str() )
+        return false;
+
+    const std::string suffix( end );
+    if( "K" == suffix || "k" == suffix )
+        size *= 1024;
+    else if( "M" == suffix || "m" == suffix )
+        size *= 1024 * 1024;
+    else if( !suffix.empty() )
+        return false;
+
+    return true;
+}
+
+/// \brief Разобрать список через запятую
+/// \param [in] text Текст
+/// \param [in] parseItem Разбор одного элемента
+/// \return true - все элементы разобраны и список не пуст
+template< typename F >
+static bool parseList( const std::string &text, F &&parseItem )
+{
+    size_t begin = 0;
+    for( ;; )
+    {
+        const size_t end = text.find( ',', begin );
+        if( !parseItem( text.substr( begin, end - begin ) ) )
+            return false;
+
+        if( std::string::npos == end )
+            return true;
+
+        begin = end + 1;
+    }
+}
+
+/// \brief Вывести результат строкой CSV или объектом JSON
+/// \param [in] result Результат
+/// \param [in] isJson true - JSON
+/// \param [in] isLast Последний результат в отчете
+static void printResult( const cKernelBench::sResult &result, bool isJson, bool isLast )
+{
+    const cPerfCounters::sCounts &counts = result.mCounts;
+    const std::string corpus( cCorpusGenerator::getName( result.mCorpus ) );
+    const double ipc = counts.mCycles ? double( counts.mInstructions ) / counts.mCycles : 0.0;
+    const char *source = result.mIsHardware ? "perf" : "tsc";
+
+    std::printf( isJson ? "    {\"kernel\": \"%s\", \"corpus\": \"%s\", \"bytes\": %llu, \"ns_per_byte\": %.4f, "
+                          "\"cycles_per_byte\": %.4f, \"ipc\": %.3f, \"branch_misses_per_kb\": %.3f, "
+                          "\"cache_misses_per_kb\": %.3f, \"counters\": \"%s\"}%s\n"
+                        : "%s,%s,%llu,%.4f,%.4f,%.3f,%.3f,%.3f,%s%s\n",
+                 result.mKernel.c_str(),
+                 corpus.c_str(),
+                 static_cast< unsigned long long >( result.mBytes ),
+                 result.perByte( counts.mNanoseconds ),
+                 result.perByte( counts.mCycles ),
+                 ipc,
+                 result.perByte( counts.mBranchMisses ) * 1024,
+                 result.perByte( counts.mCacheMisses ) * 1024,
+                 source,
+                 isJson && !isLast ? "," : "" );
+}
+
+int main( int argc, char **argv )
+{
+    std::vector< std::string > kernels;
+    std::vector< cCorpusGenerator::eCorpus > corpora;
+    uint64_t size = 1024 * 1024;
+    uint64_t iterations = 11;
+    std::string format( "csv" );
+
+    const std::vector< std::string_view > knownKernels( cKernelBench::getKernelNames() );
+
+    for( int i = 1; i < argc; i += 2 )
+    {
+        const std::string option( argv[ i ] );
+        const bool hasValue = i + 1 < argc;
+        const std::string value( hasValue ? argv[ i + 1 ] : "" );
+        bool isValid = hasValue;
+
+        if( "--kernel" == option )
+        {
+            isValid = isValid && parseList( value, [ &kernels, &knownKernels ]( const std::string &name )
+            {
+                kernels.push_back( name );
+                return std::find( knownKernels.begin(), knownKernels.end(), name ) != knownKernels.end();
+            } );
+        }
+        else if( "--corpus" == option )
+        {
+            isValid = isValid && parseList( value, [ &corpora ]( const std::string &name )
+            {
+                const auto [ corpus, isKnown ] = cCorpusGenerator::fromName( name );
+                corpora.push_back( corpus );
+                return isKnown;
+            } );
+        }
+        else if( "--size" == option )
+        {
+            isValid = isValid && parseSize( value, size ) && size > 0;
+        }
+        else if( "--iterations" == option )
+        {
+            iterations = std::strtoull( value.c_str(), nullptr, 10 );
+            isValid = isValid && iterations > 0;
+        }
+        else if( "--format" == option )
+        {
+            format = value;
+            isValid = isValid && ( "json" == format || "csv" == format );
+        }
+        else
+        {
+            isValid = false;
+        }
+
+        if( !isValid )
+        {
+            std::fprintf( stderr,
+                          "microbench [--kernel histogram,buildTree,...] [--corpus text,runs,random]\n"
+                          "           [--size 1M] [--iterations 11] [--format csv|json]\n" );
+            return EXIT_USAGE;
+        }
+    }
+
+    /// Значения по умолчанию
+    if( kernels.empty() )
+        kernels.assign( knownKernels.begin(), knownKernels.end() );
+
+    if( corpora.empty() )
+        corpora = { cCorpusGenerator::CORPUS_TEXT, cCorpusGenerator::CORPUS_RUNS, cCorpusGenerator::CORPUS_RANDOM };
+
+    cPerfCounters counters;
+    std::fprintf( stderr, "Счетчики: %s\n", counters.isHardware() ? "perf_event_open"
+                                                                  : "счетчик времени (perf_event_open недоступен)" );
+
+    const bool isJson = "json" == format;
+    std::printf( isJson ? "{\n  \"results\": [\n"
+                        : "kernel,corpus,bytes,ns_per_byte,cycles_per_byte,ipc,branch_misses_per_kb,"
+                          "cache_misses_per_kb,counters\n" );
+
+    for( size_t k = 0; k < kernels.size(); ++k )
+    {
+        for( size_t c = 0; c < corpora.size(); ++c )
+        {
+            const auto [ result, isKnown ] = cKernelBench::run( kernels[ k ], corpora[ c ], size, iterations, counters );
+            ( void )isKnown;
+
+            printResult( result, isJson, k + 1 == kernels.size() && c + 1 == corpora.size() );
+            std::fflush( stdout );
+        }
+    }
+
+    if( isJson )
+        std::printf( "  ]\n}\n" );
+
+    return 0;
+}
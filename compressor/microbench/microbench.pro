@@ -0,0 +1,20 @@
+# Программа микрозамеров частей алгоритмов. Qt не требуется
+
+TEMPLATE = app
+TARGET = microbench
+
+CONFIG += console c++17
+CONFIG -= qt app_bundle
+
+include(../core.pri)
+
+SOURCES += \
+        ../bench/cCorpusGenerator/src/cCorpusGenerator.cpp \
+        cKernelBench/src/cKernelBench.cpp \
+        cPerfCounters/src/cPerfCounters.cpp \
+        main.cpp
+
+HEADERS += \
+    ../bench/cCorpusGenerator/h/cCorpusGenerator.h \
+    cKernelBench/h/cKernelBench.h \
+    cPerfCounters/h/cPerfCounters.h
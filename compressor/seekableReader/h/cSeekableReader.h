@@ -0,0 +1,168 @@
+/** ****************************************************************************
+ * \file cSeekableReader.h
+ *
+ * \defgroup SeekableReader Выборочное чтение сжатых данных
+ * @{
+ *
+ * \brief Модуль чтения произвольных диапазонов сжатого файла без его полной
+ * распаковки
+ *
+ * \details Файл в блочном формате \ref BlockFormat уже содержит все
+ * необходимое для выборочного чтения: исходные блоки одного размера, поэтому
+ * блок, содержащий смещение, находится делением, а его положение в сжатом
+ * файле - по префиксным суммам индекса. \ref cSeekableReader::readRange
+ * распаковывает только блоки, перекрывающие диапазон (параллельно, в пуле
+ * \ref ThreadPool). Точность выборки определяется размером блока при сжатии.
+ *
+ * Распакованные блоки хранятся в кэше LRU ограниченного объема
+ * (\ref cSeekableReader::setCacheSize), поэтому повторные и соседние чтения
+ * не распаковывают блоки заново. Блоки без сжатия копируются прямо из
+ * отображения файла, а блоки из нулей не читаются вовсе - в кэш они не
+ * попадают.
+ *
+ * Если в файле есть контрольные суммы, каждый распакованный блок сверяется с
+ * суммой из индекса до попадания в кэш, а блок без сжатия - при каждом
+ * копировании.
+ *
+ * Файлы предыдущих версий (сжатые целиком) выборочно читать нельзя.
+ *
+ * Чтение из нескольких потоков одновременно допустимо.
+ *
+ * Реализован с поиощью класса \ref cSeekableReader
+ * ****************************************************************************/
+
+#ifndef CSEEKABLEREADER_H
+#define CSEEKABLEREADER_H
+
+#include "common.h" /// Общие константы программы
+#include "algorithm/cAbstractAlgorithm/h/cAbstractAlgorithm.h" /// Интерфейс алгоритмов
+#include "blockFormat/h/cBlockFormat.h" /// Блочный формат сжатых данных
+#include "inputSource/h/cInputSource.h" /// Отображение файла в память
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <list> /// Очередь LRU
+#include <memory> /// Умные указатели
+#include <mutex> /// Мьютексы
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+#include <tuple> /// Кортежи
+#include <unordered_map> /// Хеш-таблицы
+#include <vector> /// Вектор
+
+/// \brief Класс, реализующий выборочное чтение сжатого файла
+/// \class cSeekableReader
+class cSeekableReader final
+{
+public:
+    /// \brief Открыть сжатый файл
+    ///
+    /// \param [in] path Путь до сжатого файла
+    /// \param [in] algorithm Интерфейс алгоритма. Должен существовать, пока
+    /// файл открыт
+    ///
+    /// \return Статус выполнения:
+    /// ERR_STATUS_SUCCESS - успех,
+    /// ERR_STATUS_BAD_FILE_OPEN - ошибка открытия файла,
+    /// ERR_STATUS_BAD_FORMAT - файл не в блочном формате,
+    /// ERR_STATUS_BAD_POSTFIX - файл сжат другим алгоритмом
+    eErrStatus open( std::string_view path, cAbstractAlgorithm &algorithm );
+
+    /// \brief Закрыть файл и очистить кэш
+    void close( void );
+
+    /// \brief Проверить, открыт ли файл
+    /// \return true - файл открыт
+    inline bool isOpen( void ) const noexcept { return nullptr != mpAlgorithm; }
+
+    /// \brief Получить размер исходных данных
+    /// \return Размер в байтах
+    inline uint64_t getRawSize( void ) const noexcept { return mHeader.mRawSize; }
+
+    /// \brief Прочитать диапазон исходных данных
+    ///
+    /// \param [in] offset Смещение в исходных данных
+    /// \param [in] length Длина диапазона. Диапазон, выходящий за конец
+    /// данных, обрезается
+    ///
+    /// \return Данные диапазона и статус:
+    /// ERR_STATUS_SUCCESS - успех,
+    /// ERR_STATUS_BAD_FILE_OPEN - файл не открыт,
+    /// ERR_STATUS_BAD_ALG - если выполнение алгоритма привело к ошибке,
+    /// ERR_STATUS_BAD_FORMAT - если не совпала контрольная сумма блока
+    std::tuple< std::string, eErrStatus > readRange( uint64_t offset, uint64_t length );
+
+    /// \brief Задать объем кэша распакованных блоков
+    /// \param [in] cacheSize Объем в байтах. 0 - блоки не кэшируются
+    void setCacheSize( uint64_t cacheSize );
+
+    /// \brief Объем кэша по умолчанию
+    constexpr static uint64_t DEFAULT_CACHE_SIZE = 64 * 1024 * 1024;
+
+private:
+    /// \brief Псевдоним для распакованного блока. Блок остается доступен
+    /// читателю, даже если его вытеснили из кэша
+    /// \typedef block_t
+    using block_t = std::shared_ptr< const std::string >;
+
+    /// \brief Получить распакованный блок из кэша
+    /// \param [in] blockIndex Номер блока
+    /// \return Блок или nullptr, если его нет в кэше
+    block_t findBlock( size_t blockIndex );
+
+    /// \brief Положить распакованный блок в кэш, вытеснив давно не
+    /// использованные блоки сверх объема
+    /// \param [in] blockIndex Номер блока
+    /// \param [in] block Блок
+    void storeBlock( size_t blockIndex, const block_t &block );
+
+    /// \brief Вытеснить давно не использованные блоки сверх объема кэша.
+    /// Вызывается под мьютексом кэша
+    void evict( void );
+
+    /// \brief Распаковать блок, сжатый алгоритмом
+    /// \param [in] blockIndex Номер блока
+    /// \return Блок и статус: ERR_STATUS_BAD_ALG при ошибке алгоритма,
+    /// ERR_STATUS_BAD_FORMAT при несовпадении контрольной суммы
+    std::tuple< block_t, eErrStatus > decodeBlock( size_t blockIndex ) const;
+
+    /// \brief Сверить исходный блок с контрольной суммой из индекса
+    /// \param [in] blockIndex Номер блока
+    /// \param [in] rawBlock Исходный блок
+    /// \return true - сумма совпала или в файле нет сумм
+    bool checkBlock( size_t blockIndex, std::string_view rawBlock ) const;
+
+    /// \brief Отображение сжатого файла
+    cInputSource mFile;
+    /// \brief Сжатые данные
+    std::string_view mData;
+    /// \brief Заголовок
+    cBlockFormat::sHeader mHeader;
+    /// \brief Смещения блоков в сжатых данных
+    std::vector< uint64_t > mBlockOffsets;
+    /// \brief Алгоритм. nullptr, если файл не открыт
+    cAbstractAlgorithm *mpAlgorithm = nullptr;
+
+    /// \brief Номера блоков в кэше, начиная с последнего использованного
+    std::list< size_t > mLruOrder;
+    /// \brief Структура, описывающая блок в кэше
+    /// \struct sCacheEntry
+    struct sCacheEntry
+    {
+        /// \brief Блок
+        block_t mBlock;
+        /// \brief Положение в очереди LRU
+        std::list< size_t >::iterator mLruPosition;
+    };
+    /// \brief Кэш распакованных блоков
+    std::unordered_map< size_t, sCacheEntry > mCache;
+    /// \brief Объем блоков в кэше
+    uint64_t mCachedBytes = 0;
+    /// \brief Объем кэша
+    uint64_t mCacheSize = DEFAULT_CACHE_SIZE;
+
+    /// \brief Мьютекс кэша
+    std::mutex mCacheMutex;
+};
+
+/// @}
+
+#endif // CSEEKABLEREADER_H
@@ -0,0 +1,215 @@
+/** ****************************************************************************
+ * \brief Исходные коды выборочного чтения сжатых данных
+ *
+ * \file cSeekableReader.cpp
+ * ****************************************************************************/
+
+#include "seekableReader/h/cSeekableReader.h" /// Заголовок класса
+#include "threadPool/h/cThreadPool.h" /// Пул потоков
+#include "checksum/h/cChecksum.h" /// Контрольные суммы
+#include <algorithm> /// std::min, std::max
+#include <cstring> /// std::memcpy
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+eErrStatus cSeekableReader::open( std::string_view path, cAbstractAlgorithm &algorithm )
+{
+    close();
+
+    /// Читаются отдельные блоки - упреждающее чтение всего файла не нужно
+    eErrStatus status = mFile.open( path, cInputSource::ACCESS_RANDOM );
+    if( ERR_STATUS_SUCCESS != status )
+        return status;
+
+    std::tie( mData, status ) = mFile.getData();
+    if( ERR_STATUS_SUCCESS != status )
+    {
+        close();
+        return status;
+    }
+
+    size_t headerSize = 0;
+    std::tie( mHeader, headerSize, status ) = cBlockFormat::readHeader( mData );
+    if( ERR_STATUS_SUCCESS == status && mHeader.mAlgType != algorithm.getType() )
+        status = ERR_STATUS_BAD_POSTFIX;
+
+    /// Номер блока по смещению - деление на размер блока
+    if( ERR_STATUS_SUCCESS == status && 0 == mHeader.mBlockSize )
+        status = ERR_STATUS_BAD_FORMAT;
+
+    if( ERR_STATUS_SUCCESS != status )
+    {
+        close();
+        return status;
+    }
+
+    mBlockOffsets = cBlockFormat::getBlockOffsets( mHeader, headerSize );
+    mpAlgorithm = &algorithm;
+
+    return ERR_STATUS_SUCCESS;
+}
+
+void cSeekableReader::close( void )
+{
+    std::lock_guard< std::mutex > lock( mCacheMutex );
+
+    mFile.close();
+    mData = std::string_view();
+    mHeader = cBlockFormat::sHeader();
+    mBlockOffsets.clear();
+    mpAlgorithm = nullptr;
+
+    mCache.clear();
+    mLruOrder.clear();
+    mCachedBytes = 0;
+}
+
+std::tuple< std::string, eErrStatus > cSeekableReader::readRange( uint64_t offset, uint64_t length )
+{
+    if( !isOpen() )
+        return std::make_tuple( std::string(), ERR_STATUS_BAD_FILE_OPEN );
+
+    if( offset >= mHeader.mRawSize || 0 == length )
+        return std::make_tuple( std::string(), ERR_STATUS_SUCCESS );
+
+    length = std::min( length, mHeader.mRawSize - offset );
+
+    const size_t firstBlock = offset / mHeader.mBlockSize;
+    const size_t lastBlock = ( offset + length - 1 ) / mHeader.mBlockSize;
+    const size_t blockCount = lastBlock - firstBlock + 1;
+
+    /// Блоки из нулей уже есть в результате, блоки без сжатия копируются из
+    /// отображения, остальные берутся из кэша или распаковываются
+    std::string result( length, '\0' );
+    std::vector< eErrStatus > statuses( blockCount, ERR_STATUS_SUCCESS );
+    cThreadPool::instance().parallelFor( blockCount, [ & ]( size_t i )
+    {
+        const size_t blockIndex = firstBlock + i;
+        const cBlockFormat::sBlockInfo &info = mHeader.mBlocks[ blockIndex ];
+        if( cBlockFormat::BLOCK_TYPE_ZERO == info.mType )
+            return;
+
+        /// Пересечение блока с диапазоном
+        const uint64_t blockBegin = blockIndex * mHeader.mBlockSize;
+        const uint64_t copyBegin = std::max( offset, blockBegin );
+        const uint64_t copyEnd = std::min( offset + length,
+                                           blockBegin + cBlockFormat::getRawBlockSize( mHeader, blockIndex ) );
+
+        std::string_view rawBlock;
+        block_t block;
+        if( cBlockFormat::BLOCK_TYPE_STORED == info.mType )
+        {
+            /// Блок без сжатия обязан иметь исходный размер: копирование идет
+            /// по нему
+            rawBlock = mData.substr( mBlockOffsets[ blockIndex ], info.mCmprSize );
+            if( rawBlock.size() != cBlockFormat::getRawBlockSize( mHeader, blockIndex ) )
+            {
+                statuses[ i ] = ERR_STATUS_BAD_ALG;
+                return;
+            }
+
+            if( !checkBlock( blockIndex, rawBlock ) )
+            {
+                statuses[ i ] = ERR_STATUS_BAD_FORMAT;
+                return;
+            }
+        }
+        else
+        {
+            block = findBlock( blockIndex );
+            if( !block )
+            {
+                std::tie( block, statuses[ i ] ) = decodeBlock( blockIndex );
+                if( ERR_STATUS_SUCCESS != statuses[ i ] )
+                    return;
+
+                storeBlock( blockIndex, block );
+            }
+
+            rawBlock = *block;
+        }
+
+        std::memcpy( result.data() + ( copyBegin - offset ), rawBlock.data() + ( copyBegin - blockBegin ),
+                     copyEnd - copyBegin );
+    } );
+
+    for( const eErrStatus blockStatus : statuses )
+        if( ERR_STATUS_SUCCESS != blockStatus )
+            return std::make_tuple( std::string(), blockStatus );
+
+    return std::make_tuple( std::move( result ), ERR_STATUS_SUCCESS );
+}
+
+void cSeekableReader::setCacheSize( uint64_t cacheSize )
+{
+    std::lock_guard< std::mutex > lock( mCacheMutex );
+    mCacheSize = cacheSize;
+    evict();
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+cSeekableReader::block_t cSeekableReader::findBlock( size_t blockIndex )
+{
+    std::lock_guard< std::mutex > lock( mCacheMutex );
+    const auto entry = mCache.find( blockIndex );
+    if( mCache.end() == entry )
+        return nullptr;
+
+    /// Блок становится последним использованным
+    mLruOrder.splice( mLruOrder.begin(), mLruOrder, entry->second.mLruPosition );
+
+    return entry->second.mBlock;
+}
+
+void cSeekableReader::storeBlock( size_t blockIndex, const block_t &block )
+{
+    std::lock_guard< std::mutex > lock( mCacheMutex );
+
+    /// Блок мог распаковать другой поток одновременно с этим
+    if( block->size() > mCacheSize || mCache.count( blockIndex ) )
+        return;
+
+    mLruOrder.push_front( blockIndex );
+    mCache.emplace( blockIndex, sCacheEntry{ block, mLruOrder.begin() } );
+    mCachedBytes += block->size();
+
+    evict();
+}
+
+void cSeekableReader::evict( void )
+{
+    while( mCachedBytes > mCacheSize && !mLruOrder.empty() )
+    {
+        const auto entry = mCache.find( mLruOrder.back() );
+        mCachedBytes -= entry->second.mBlock->size();
+        mCache.erase( entry );
+        mLruOrder.pop_back();
+    }
+}
+
+std::tuple< cSeekableReader::block_t, eErrStatus > cSeekableReader::decodeBlock( size_t blockIndex ) const
+{
+    const cBlockFormat::sBlockInfo &info = mHeader.mBlocks[ blockIndex ];
+    auto block = std::make_shared< std::string >(
+                mpAlgorithm->decompress( mData.substr( mBlockOffsets[ blockIndex ], info.mCmprSize ) ) );
+
+    /// Размер распакованного блока обязан совпадать с индексом
+    if( block->size() != cBlockFormat::getRawBlockSize( mHeader, blockIndex ) )
+        return std::make_tuple( nullptr, ERR_STATUS_BAD_ALG );
+
+    if( !checkBlock( blockIndex, *block ) )
+        return std::make_tuple( nullptr, ERR_STATUS_BAD_FORMAT );
+
+    return std::make_tuple( std::move( block ), ERR_STATUS_SUCCESS );
+}
+
+bool cSeekableReader::checkBlock( size_t blockIndex, std::string_view rawBlock ) const
+{
+    return !( mHeader.mFlags & cBlockFormat::FLAG_CHECKSUMS ) ||
+           cChecksum::crc32c( rawBlock ) == mHeader.mBlocks[ blockIndex ].mChecksum;
+}
@@ -0,0 +1,384 @@
+/** ****************************************************************************
+ * \file cJobStats.h
+ * ****************************************************************************/
+
+/** ****************************************************************************
+ * \defgroup Stats Статистика заданий
+ *
+ * \brief Предназначен для поиска медленной стадии задания
+ *
+ * \details Состоит из сбора времени по стадиям - \ref StatsJob и выгрузки
+ * отчетов в файл для мониторинга - \ref StatsExporter
+ *
+ * ****************************************************************************/
+
+/** ****************************************************************************
+ * \defgroup StatsJob Сбор статистики задания
+ * @{
+ * \ingroup Stats
+ *
+ * \brief Модуль, собирающий время, вызовы и объем данных по стадиям задания
+ *
+ * \details Статистика одного задания (сжатия или распаковки файла) - объект
+ * \ref cJobStats. Поток, выполняющий часть задания, привязывает его к себе
+ * через \ref cJobStats::cScope. Замеры \ref cJobStats::cTimer копятся в
+ * счетчиках потока без атомарных операций и переносятся в общие счетчики
+ * задания один раз при выходе из области привязки (конец задачи блока).
+ * Замер в непривязанном потоке ничего не делает, поэтому алгоритмы можно
+ * вызывать и вне заданий.
+ *
+ * Время стадий - суммарное время потоков: стадии блоков идут параллельно,
+ * поэтому их сумма может превышать время задания. Время замера исключительное:
+ * вложенный замер или вложенная привязка (задача другого блока, выполненная
+ * потоком, пока он ждет в пуле) приостанавливает внешний замер, поэтому одно
+ * и то же время не попадает в две стадии.
+ *
+ * Сборка с определенным STATS_DISABLED (qmake CONFIG+=no_stats) убирает
+ * замеры стадий полностью: привязка и замеры становятся пустыми встроенными
+ * функциями. Общее время, объем данных и пик памяти задания собираются
+ * всегда.
+ *
+ * Реализован с поиощью класса \ref cJobStats
+ * ****************************************************************************/
+
+#ifndef CJOBSTATS_H
+#define CJOBSTATS_H
+
+#include "common.h" /// Общие константы
+#include <array> /// Массивы фиксированного размера
+#include <atomic> /// Атомарные переменные
+#include <chrono> /// Время
+#include <cstdint> /// Целочисленные типы фиксированного размера
+#include <string> /// Строки
+#include <string_view> /// Представления строк
+
+/// \brief Класс, собирающий статистику задания
+/// \class cJobStats
+class cJobStats final
+{
+public:
+    /// \brief Стадии задания
+    /// \enum eStage
+    enum eStage
+    {
+        STAGE_READ = 0, ///< Открытие и отображение исходного файла
+        STAGE_HISTOGRAM, ///< Подсчет частот символов
+        STAGE_TREE, ///< Построение дерева и таблицы кодов
+        STAGE_ENCODE, ///< Кодирование данных
+        STAGE_DECODE, ///< Декодирование данных
+        STAGE_CHECKSUM, ///< Контрольные суммы
+        STAGE_WAIT, ///< Ожидание следующего блока для записи
+        STAGE_WRITE, ///< Запись результата
+        STAGE_RENAME, ///< Переименование временного файла
+        STAGE_COUNT ///< Количество стадий
+    };
+
+    /// \brief Структура, описывающая статистику стадии
+    /// \struct sStage
+    struct sStage
+    {
+        /// \brief Суммарное время потоков, нс
+        uint64_t mNanoseconds = 0;
+        /// \brief Количество замеров
+        uint64_t mCalls = 0;
+        /// \brief Обработано байт
+        uint64_t mBytes = 0;
+
+        /// \brief Получить скорость стадии
+        /// \return МБ/с, 0 - нет данных
+        inline double getThroughput( void ) const noexcept
+        {
+            return mNanoseconds ? mBytes * 1e9 / mNanoseconds / ( 1024.0 * 1024.0 ) : 0.0;
+        }
+    };
+
+    /// \brief Структура, описывающая отчет о задании
+    /// \struct sReport
+    struct sReport
+    {
+        /// \brief Исходный файл
+        std::string mPath;
+        /// \brief Алгоритм
+        eTypeOfComprAlgorithm mAlgType = ALG_TYPE_RLE;
+        /// \brief Действие
+        eTypeOfActions mAction = ACT_TYPE_COMPR;
+        /// \brief Статус выполнения
+        eErrStatus mStatus = ERR_STATUS_SUCCESS;
+        /// \brief Входных байт
+        uint64_t mBytesIn = 0;
+        /// \brief Выходных байт
+        uint64_t mBytesOut = 0;
+        /// \brief Время задания, с
+        double mSeconds = 0.0;
+        /// \brief Пик используемой процессом памяти на момент завершения, байт
+        uint64_t mPeakMemory = 0;
+        /// \brief Предел памяти задания \ref MemoryBudget, байт. 0 - без
+        /// ограничения
+        uint64_t mMemoryLimit = 0;
+        /// \brief Пик памяти, зарезервированной заданием в бюджете, байт
+        uint64_t mPeakReserved = 0;
+        /// \brief Статистика стадий
+        std::array< sStage, STAGE_COUNT > mStages{};
+
+        /// \brief Получить скорость обработки входных данных
+        /// \return МБ/с
+        inline double getThroughput( void ) const noexcept
+        {
+            return mSeconds > 0.0 ? mBytesIn / mSeconds / ( 1024.0 * 1024.0 ) : 0.0;
+        }
+    };
+
+    class cTimer;
+
+    /// \brief Класс, привязывающий статистику задания к текущему потоку
+    /// \class cScope
+    class cScope final
+    {
+    public:
+        /// \brief Конструктор класса. Переносит замеры предыдущей привязки
+        /// \param [in] pStats Статистика задания. nullptr - отвязать поток
+        explicit cScope( cJobStats *pStats ) noexcept
+#ifndef STATS_DISABLED
+            : mpPrevious( mThreadState.mpStats ),
+              mpPaused( mThreadState.mpActive )
+        {
+            if( mpPaused )
+                mpPaused->pause();
+
+            mThreadState.mpActive = nullptr;
+            flush();
+            mThreadState.mpStats = pStats;
+        }
+#else
+        {
+            ( void )pStats;
+        }
+#endif
+
+        /// \brief Деструктор класса. Переносит замеры и восстанавливает
+        /// предыдущую привязку
+        ~cScope( void )
+        {
+#ifndef STATS_DISABLED
+            flush();
+            mThreadState.mpStats = mpPrevious;
+            mThreadState.mpActive = mpPaused;
+
+            if( mpPaused )
+                mpPaused->resume();
+#endif
+        }
+
+        cScope( const cScope & ) = delete;
+        cScope &operator=( const cScope & ) = delete;
+
+    private:
+#ifndef STATS_DISABLED
+        /// \brief Статистика, привязанная к потоку до этой области
+        cJobStats *mpPrevious;
+        /// \brief Замер, приостановленный на время области
+        cTimer *mpPaused;
+#endif
+    };
+
+    /// \brief Класс, замеряющий стадию от создания до уничтожения
+    /// \class cTimer
+    class cTimer final
+    {
+    public:
+        /// \brief Конструктор класса. Начинает замер
+        /// \param [in] stage Стадия
+        /// \param [in] bytes Объем данных стадии
+        explicit cTimer( eStage stage, uint64_t bytes = 0 ) noexcept { next( stage, bytes ); }
+
+        /// \brief Деструктор класса. Завершает замер
+        ~cTimer( void ) { stop(); }
+
+        cTimer( const cTimer & ) = delete;
+        cTimer &operator=( const cTimer & ) = delete;
+
+        /// \brief Завершить замер и начать замер следующей стадии
+        /// \param [in] stage Стадия
+        /// \param [in] bytes Объем данных стадии
+        inline void next( eStage stage, uint64_t bytes = 0 ) noexcept
+        {
+#ifndef STATS_DISABLED
+            stop();
+            mIsActive = nullptr != mThreadState.mpStats;
+            if( !mIsActive )
+                return;
+
+            mStage = stage;
+            mBytes = bytes;
+
+            /// Внешний замер стоит, пока идет этот
+            mpOuter = mThreadState.mpActive;
+            if( mpOuter )
+                mpOuter->pause();
+
+            mThreadState.mpActive = this;
+            resume();
+#else
+            ( void )stage;
+            ( void )bytes;
+#endif
+        }
+
+        /// \brief Учесть данные, объем которых стал известен в ходе стадии
+        /// \param [in] bytes Объем данных
+        inline void addBytes( uint64_t bytes ) noexcept
+        {
+#ifndef STATS_DISABLED
+            mBytes += bytes;
+#else
+            ( void )bytes;
+#endif
+        }
+
+        /// \brief Завершить замер. Повторный вызов ничего не делает
+        inline void stop( void ) noexcept
+        {
+#ifndef STATS_DISABLED
+            if( !mIsActive )
+                return;
+
+            mIsActive = false;
+            pause();
+
+            sStage &stage = mThreadState.mStages[ mStage ];
+            stage.mCalls++;
+            stage.mBytes += mBytes;
+
+            mThreadState.mpActive = mpOuter;
+            if( mpOuter )
+                mpOuter->resume();
+#endif
+        }
+
+    private:
+#ifndef STATS_DISABLED
+        friend class cScope;
+
+        /// \brief Учесть время с начала замера или с возобновления
+        inline void pause( void ) noexcept
+        {
+            mThreadState.mStages[ mStage ].mNanoseconds += std::chrono::duration_cast< std::chrono::nanoseconds >(
+                        std::chrono::steady_clock::now() - mStart ).count();
+        }
+
+        /// \brief Возобновить замер после вложенного
+        inline void resume( void ) noexcept { mStart = std::chrono::steady_clock::now(); }
+
+        /// \brief Стадия
+        eStage mStage = STAGE_READ;
+        /// \brief Объем данных
+        uint64_t mBytes = 0;
+        /// \brief Начало замера
+        std::chrono::steady_clock::time_point mStart;
+        /// \brief Замер, приостановленный этим
+        cTimer *mpOuter = nullptr;
+        /// \brief Замер идет
+        bool mIsActive = false;
+#endif
+    };
+
+    /// \brief Замеры стадий включены в сборку
+    constexpr static bool IS_ENABLED =
+#ifndef STATS_DISABLED
+            true;
+#else
+            false;
+#endif
+
+    /// \brief Конструктор класса. Запоминает время начала задания
+    cJobStats( void );
+
+    cJobStats( const cJobStats & ) = delete;
+    cJobStats &operator=( const cJobStats & ) = delete;
+
+    /// \brief Получить статистику, привязанную к текущему потоку
+    /// \return Статистика или nullptr
+    static inline cJobStats *current( void ) noexcept
+    {
+#ifndef STATS_DISABLED
+        return mThreadState.mpStats;
+#else
+        return nullptr;
+#endif
+    }
+
+    /// \brief Задать объем данных задания
+    /// \param [in] bytesIn Входных байт
+    /// \param [in] bytesOut Выходных байт
+    inline void setBytes( uint64_t bytesIn, uint64_t bytesOut ) noexcept
+    {
+        mBytesIn = bytesIn;
+        mBytesOut = bytesOut;
+    }
+
+    /// \brief Получить отчет на текущий момент
+    ///
+    /// \details Замеры потоков, привязанных к заданию, попадают в отчет после
+    /// выхода из их областей привязки. Поля файла, алгоритма, действия и
+    /// статуса заполняет вызывающий
+    ///
+    /// \return Отчет
+    sReport getReport( void ) const;
+
+    /// \brief Получить имя стадии для отчетов
+    /// \param [in] stage Стадия
+    /// \return Имя латиницей
+    static std::string_view getStageName( eStage stage ) noexcept;
+
+    /// \brief Получить пик используемой процессом памяти
+    /// \return Байт, 0 - неизвестно
+    static uint64_t getPeakMemory( void ) noexcept;
+
+private:
+    /// \brief Структура, описывающая общие счетчики стадии
+    /// \struct sSharedStage
+    struct sSharedStage
+    {
+        /// \brief Суммарное время потоков, нс
+        std::atomic< uint64_t > mNanoseconds{ 0 };
+        /// \brief Количество замеров
+        std::atomic< uint64_t > mCalls{ 0 };
+        /// \brief Обработано байт
+        std::atomic< uint64_t > mBytes{ 0 };
+    };
+
+    /// \brief Структура, описывающая привязку и счетчики потока
+    /// \struct sThreadState
+    struct sThreadState
+    {
+        /// \brief Привязанная статистика
+        cJobStats *mpStats = nullptr;
+        /// \brief Идущий замер
+        cTimer *mpActive = nullptr;
+        /// \brief Замеры, еще не перенесенные в mpStats
+        std::array< sStage, STAGE_COUNT > mStages{};
+    };
+
+    /// \brief Перенести замеры потока в привязанную статистику и обнулить их
+    static void flush( void ) noexcept;
+
+    /// \brief Время начала задания
+    std::chrono::steady_clock::time_point mStartTime;
+    /// \brief Входных байт
+    uint64_t mBytesIn = 0;
+    /// \brief Выходных байт
+    uint64_t mBytesOut = 0;
+    /// \brief Общие счетчики стадий
+    std::array< sSharedStage, STAGE_COUNT > mStages;
+
+    /// \brief Привязка и счетчики текущего потока
+    static thread_local sThreadState mThreadState;
+};
+
+/// Определяется вне класса: инициализаторы полей sThreadState должны быть
+/// известны до определения
+inline thread_local cJobStats::sThreadState cJobStats::mThreadState;
+
+/// @}
+
+#endif // CJOBSTATS_H
@@ -0,0 +1,113 @@
+/** ****************************************************************************
+ * \brief Исходные коды сбора статистики задания
+ *
+ * \file cJobStats.cpp
+ * ****************************************************************************/
+
+#include "stats/cJobStats/h/cJobStats.h" /// Заголовок класса
+
+#ifdef __unix__
+#include <sys/resource.h> /// getrusage
+#endif
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+cJobStats::cJobStats( void ) :
+    mStartTime( std::chrono::steady_clock::now() )
+{
+}
+
+cJobStats::sReport cJobStats::getReport( void ) const
+{
+    sReport report;
+    report.mBytesIn = mBytesIn;
+    report.mBytesOut = mBytesOut;
+    report.mSeconds = std::chrono::duration< double >( std::chrono::steady_clock::now() - mStartTime ).count();
+    report.mPeakMemory = getPeakMemory();
+
+    for( size_t i = 0; i < STAGE_COUNT; ++i )
+    {
+        report.mStages[ i ].mNanoseconds = mStages[ i ].mNanoseconds.load( std::memory_order_relaxed );
+        report.mStages[ i ].mCalls = mStages[ i ].mCalls.load( std::memory_order_relaxed );
+        report.mStages[ i ].mBytes = mStages[ i ].mBytes.load( std::memory_order_relaxed );
+    }
+
+    return report;
+}
+
+std::string_view cJobStats::getStageName( eStage stage ) noexcept
+{
+    switch( stage )
+    {
+    case STAGE_READ:
+        return "read";
+
+    case STAGE_HISTOGRAM:
+        return "histogram";
+
+    case STAGE_TREE:
+        return "tree";
+
+    case STAGE_ENCODE:
+        return "encode";
+
+    case STAGE_DECODE:
+        return "decode";
+
+    case STAGE_CHECKSUM:
+        return "checksum";
+
+    case STAGE_WAIT:
+        return "wait";
+
+    case STAGE_WRITE:
+        return "write";
+
+    case STAGE_RENAME:
+        return "rename";
+
+    case STAGE_COUNT:
+        break;
+    }
+
+    return "unknown";
+}
+
+uint64_t cJobStats::getPeakMemory( void ) noexcept
+{
+#ifdef __unix__
+    rusage usage{};
+    if( 0 == ::getrusage( RUSAGE_SELF, &usage ) )
+    {
+        /// В Linux - килобайты
+        return uint64_t( usage.ru_maxrss ) * 1024;
+    }
+#endif
+
+    return 0;
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+void cJobStats::flush( void ) noexcept
+{
+    cJobStats *pStats = mThreadState.mpStats;
+    if( !pStats )
+        return;
+
+    for( size_t i = 0; i < STAGE_COUNT; ++i )
+    {
+        sStage &local = mThreadState.mStages[ i ];
+        if( 0 == local.mCalls )
+            continue;
+
+        pStats->mStages[ i ].mNanoseconds.fetch_add( local.mNanoseconds, std::memory_order_relaxed );
+        pStats->mStages[ i ].mCalls.fetch_add( local.mCalls, std::memory_order_relaxed );
+        pStats->mStages[ i ].mBytes.fetch_add( local.mBytes, std::memory_order_relaxed );
+        local = sStage();
+    }
+}
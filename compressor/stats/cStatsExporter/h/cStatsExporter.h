@@ -0,0 +1,148 @@
+/** ****************************************************************************
+ * \file cStatsExporter.h
+ *
+ * \defgroup StatsExporter Выгрузка статистики
+ * @{
+ *
+ * \ingroup Stats
+ *
+ * \brief Модуль, выводящий отчеты заданий в журнал и в файл для мониторинга
+ *
+ * \details Отчеты \ref StatsJob копятся в итогах с запуска программы: задания
+ * по действиям и статусам, байты, время и статистика стадий. После каждого
+ * отчета, если задан путь (\ref cStatsExporter::setPath), файл статистики
+ * перезаписывается целиком: итоги и отчет последнего задания. Файл пишется
+ * во временный рядом и переименовывается, поэтому сборщик не увидит его
+ * недописанным.
+ *
+ * Формат выбирается по расширению: .json - JSON, иначе - текстовый формат
+ * Prometheus (например, для textfile collector у node_exporter).
+ *
+ * Реализован с поиощью класса \ref cStatsExporter
+ * ****************************************************************************/
+
+#ifndef CSTATSEXPORTER_H
+#define CSTATSEXPORTER_H
+
+#include "stats/cJobStats/h/cJobStats.h" /// Статистика задания
+#include <map> /// Контейнер отображения
+#include <mutex> /// Мьютексы
+#include <string> /// Строки
+#include <tuple> /// Кортежи
+#include <vector> /// Вектор
+
+/// \brief Класс, выгружающий статистику заданий
+/// \class cStatsExporter
+class cStatsExporter final
+{
+public:
+    /// \brief Получить общий на программу объект выгрузки
+    /// \return Объект выгрузки
+    static cStatsExporter &instance( void );
+
+    cStatsExporter( const cStatsExporter & ) = delete;
+    cStatsExporter &operator=( const cStatsExporter & ) = delete;
+
+    /// \brief Задать файл статистики
+    /// \param [in] path Путь до файла. Пустой - файл не пишется
+    void setPath( std::string path );
+
+    /// \brief Учесть отчет задания и перезаписать файл статистики
+    ///
+    /// \details Безопасно вызывать из нескольких потоков одновременно
+    ///
+    /// \param [in] report Отчет
+    /// \return ERR_STATUS_SUCCESS в случае успеха или если файл не задан,
+    /// ERR_STATUS_BAD_FILE_WRITE в случае ошибки записи
+    eErrStatus add( const cJobStats::sReport &report );
+
+    /// \brief Получить итоги в текстовом формате Prometheus
+    /// \return Текст
+    std::string toPrometheus( void ) const;
+
+    /// \brief Получить итоги в JSON
+    /// \return Текст
+    std::string toJson( void ) const;
+
+    /// \brief Описать отчет строками для журнала
+    /// \param [in] report Отчет
+    /// \return Строки: объем, время и память задания; время стадий
+    static std::vector< std::string > describe( const cJobStats::sReport &report );
+
+    /// \brief Сложить отчеты, например файлов пакета
+    ///
+    /// \details Время - сумма времени заданий, пик памяти - наибольший
+    ///
+    /// \param [in,out] total Сумма
+    /// \param [in] report Отчет
+    static void accumulate( cJobStats::sReport &total, const cJobStats::sReport &report );
+
+private:
+    /// \brief Конструктор класса
+    cStatsExporter( void ) = default;
+
+    /// \brief Структура, описывающая итоги по действию
+    /// \struct sTotals
+    struct sTotals
+    {
+        /// \brief Сумма отчетов
+        cJobStats::sReport mSum;
+        /// \brief Количество заданий по статусам
+        std::map< eErrStatus, uint64_t > mJobs;
+    };
+
+    /// \brief Получить имя алгоритма для отчетов
+    /// \param [in] type Тип алгоритма
+    /// \return Имя
+    static const char *getAlgorithmName( eTypeOfComprAlgorithm type ) noexcept;
+
+    /// \brief Получить имя действия для отчетов
+    /// \param [in] action Действие
+    /// \return Имя
+    static const char *getActionName( eTypeOfActions action ) noexcept;
+
+    /// \brief Получить имя статуса для отчетов
+    /// \param [in] status Статус
+    /// \return Имя
+    static const char *getStatusName( eErrStatus status ) noexcept;
+
+    /// \brief Описать отчет объектом JSON
+    /// \param [in] report Отчет
+    /// \param [in] indent Отступ полей
+    /// \return Объект JSON без отступа перед открывающей скобкой
+    static std::string reportToJson( const cJobStats::sReport &report, const std::string &indent );
+
+    /// \brief Получить итоги в текстовом формате Prometheus. Вызывается под
+    /// мьютексом
+    /// \return Текст
+    std::string formatPrometheus( void ) const;
+
+    /// \brief Получить итоги в JSON. Вызывается под мьютексом
+    /// \return Текст
+    std::string formatJson( void ) const;
+
+    /// \brief Экранировать строку для JSON и меток Prometheus
+    /// \param [in] text Строка
+    /// \return Экранированная строка
+    static std::string escape( std::string_view text );
+
+    /// \brief Записать файл статистики. Вызывается под мьютексом
+    /// \return true - файл записан
+    bool writeFile( void ) const;
+
+    /// \brief Путь до файла статистики
+    std::string mPath;
+    /// \brief Итоги по действиям
+    std::map< eTypeOfActions, sTotals > mTotals;
+    /// \brief Отчет последнего задания
+    cJobStats::sReport mLastReport;
+    /// \brief Получен хотя бы один отчет
+    bool mHasLastReport = false;
+
+    /// \brief Мьютекс итогов
+    mutable std::mutex mMutex;
+};
+
+/// @}
+
+#endif // CSTATSEXPORTER_H
@@ -0,0 +1,418 @@
+/** ****************************************************************************
+ * \brief Исходные коды выгрузки статистики заданий
+ *
+ * \file cStatsExporter.cpp
+ * ****************************************************************************/
+
+#include "stats/cStatsExporter/h/cStatsExporter.h" /// Заголовок класса
+#include "algorithm/cAlgorithmRegistry/h/cAlgorithmRegistry.h" /// Имена алгоритмов
+#include <algorithm> /// std::max
+#include <cstdio> /// std::snprintf, std::rename, std::remove
+#include <fstream> /// Запись файла
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+cStatsExporter &cStatsExporter::instance( void )
+{
+    static cStatsExporter exporter;
+    return exporter;
+}
+
+void cStatsExporter::setPath( std::string path )
+{
+    std::lock_guard< std::mutex > lock( mMutex );
+    mPath = std::move( path );
+}
+
+eErrStatus cStatsExporter::add( const cJobStats::sReport &report )
+{
+    std::lock_guard< std::mutex > lock( mMutex );
+
+    sTotals &totals = mTotals[ report.mAction ];
+    accumulate( totals.mSum, report );
+    totals.mJobs[ report.mStatus ]++;
+
+    mLastReport = report;
+    mHasLastReport = true;
+
+    if( mPath.empty() )
+        return ERR_STATUS_SUCCESS;
+
+    return writeFile() ? ERR_STATUS_SUCCESS : ERR_STATUS_BAD_FILE_WRITE;
+}
+
+std::string cStatsExporter::toPrometheus( void ) const
+{
+    std::lock_guard< std::mutex > lock( mMutex );
+    return formatPrometheus();
+}
+
+std::string cStatsExporter::toJson( void ) const
+{
+    std::lock_guard< std::mutex > lock( mMutex );
+    return formatJson();
+}
+
+std::vector< std::string > cStatsExporter::describe( const cJobStats::sReport &report )
+{
+    constexpr double MIB = 1024.0 * 1024.0;
+    char line[ 256 ];
+    std::vector< std::string > lines;
+
+    std::snprintf( line, sizeof( line ), "%.1f МБ -> %.1f МБ за %.3f с (%.1f МБ/с), пик памяти %.1f МБ",
+                   report.mBytesIn / MIB, report.mBytesOut / MIB, report.mSeconds, report.getThroughput(),
+                   report.mPeakMemory / MIB );
+    lines.emplace_back( line );
+
+    if( 0 != report.mMemoryLimit )
+    {
+        std::snprintf( line, sizeof( line ), "Зарезервировано блоками до %.1f МБ при пределе %.1f МБ",
+                       report.mPeakReserved / MIB, report.mMemoryLimit / MIB );
+        lines.emplace_back( line );
+    }
+
+    if( !cJobStats::IS_ENABLED )
+        return lines;
+
+    /// Только стадии, которые выполнялись
+    std::string stages( "Стадии, с (МБ/с):" );
+    for( size_t i = 0; i < cJobStats::STAGE_COUNT; ++i )
+    {
+        const cJobStats::sStage &stage = report.mStages[ i ];
+        if( 0 == stage.mCalls )
+            continue;
+
+        std::snprintf( line, sizeof( line ), " %s %.3f", cJobStats::getStageName( cJobStats::eStage( i ) ).data(),
+                       stage.mNanoseconds / 1e9 );
+        stages += line;
+
+        if( stage.mBytes )
+        {
+            std::snprintf( line, sizeof( line ), " (%.1f)", stage.getThroughput() );
+            stages += line;
+        }
+    }
+    lines.push_back( std::move( stages ) );
+
+    return lines;
+}
+
+void cStatsExporter::accumulate( cJobStats::sReport &total, const cJobStats::sReport &report )
+{
+    total.mAlgType = report.mAlgType;
+    total.mAction = report.mAction;
+    total.mBytesIn += report.mBytesIn;
+    total.mBytesOut += report.mBytesOut;
+    total.mSeconds += report.mSeconds;
+    total.mPeakMemory = std::max( total.mPeakMemory, report.mPeakMemory );
+    total.mPeakReserved = std::max( total.mPeakReserved, report.mPeakReserved );
+
+    for( size_t i = 0; i < cJobStats::STAGE_COUNT; ++i )
+    {
+        total.mStages[ i ].mNanoseconds += report.mStages[ i ].mNanoseconds;
+        total.mStages[ i ].mCalls += report.mStages[ i ].mCalls;
+        total.mStages[ i ].mBytes += report.mStages[ i ].mBytes;
+    }
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+const char *cStatsExporter::getAlgorithmName( eTypeOfComprAlgorithm type ) noexcept
+{
+    /// Имена в реестре - строковые литералы, завершенные нулем
+    return cAlgorithmRegistry::isKnown( type ) ? cAlgorithmRegistry::getName( type ).data() : "unknown";
+}
+
+const char *cStatsExporter::getActionName( eTypeOfActions action ) noexcept
+{
+    return ACT_TYPE_COMPR == action ? "compress" : "decompress";
+}
+
+const char *cStatsExporter::getStatusName( eErrStatus status ) noexcept
+{
+    switch( status )
+    {
+    case ERR_STATUS_SUCCESS:
+        return "success";
+
+    case ERR_STATUS_BAD_ALG:
+        return "bad_alg";
+
+    case ERR_STATUS_BAD_FILE_OPEN:
+        return "bad_file_open";
+
+    case ERR_STATUS_BAD_POSTFIX:
+        return "bad_postfix";
+
+    case ERR_STATUS_EMPTY_SRC_FILE:
+        return "empty_src_file";
+
+    case ERR_STATUS_BAD_FORMAT:
+        return "bad_format";
+
+    case ERR_STATUS_BAD_FILE_WRITE:
+        return "bad_file_write";
+
+    case ERR_STATUS_CANCELED:
+        return "canceled";
+
+    case ERR_STATUS_MEMORY_LIMIT:
+        return "memory_limit";
+    }
+
+    return "unknown";
+}
+
+std::string cStatsExporter::escape( std::string_view text )
+{
+    std::string result;
+    result.reserve( text.size() );
+
+    for( const char sym : text )
+    {
+        if( '"' == sym || '\\' == sym )
+        {
+            result += '\\';
+            result += sym;
+        }
+        else if( '\n' == sym )
+        {
+            result += "\\n";
+        }
+        else if( symbol_t( sym ) < 0x20 )
+        {
+            char code[ 8 ];
+            std::snprintf( code, sizeof( code ), "\\u%04x", unsigned( symbol_t( sym ) ) );
+            result += code;
+        }
+        else
+        {
+            result += sym;
+        }
+    }
+
+    return result;
+}
+
+std::string cStatsExporter::reportToJson( const cJobStats::sReport &report, const std::string &indent )
+{
+    char line[ 512 ];
+    std::string json( "{\n" );
+
+    std::snprintf( line, sizeof( line ),
+                   "%s  \"bytes_in\": %llu,\n%s  \"bytes_out\": %llu,\n%s  \"seconds\": %.6f,\n"
+                   "%s  \"throughput_mbps\": %.3f,\n%s  \"peak_memory_bytes\": %llu,\n"
+                   "%s  \"memory_limit_bytes\": %llu,\n%s  \"peak_reserved_bytes\": %llu,\n%s  \"stages\": {",
+                   indent.c_str(), static_cast< unsigned long long >( report.mBytesIn ),
+                   indent.c_str(), static_cast< unsigned long long >( report.mBytesOut ),
+                   indent.c_str(), report.mSeconds,
+                   indent.c_str(), report.getThroughput(),
+                   indent.c_str(), static_cast< unsigned long long >( report.mPeakMemory ),
+                   indent.c_str(), static_cast< unsigned long long >( report.mMemoryLimit ),
+                   indent.c_str(), static_cast< unsigned long long >( report.mPeakReserved ),
+                   indent.c_str() );
+    json += line;
+
+    for( size_t i = 0; cJobStats::IS_ENABLED && i < cJobStats::STAGE_COUNT; ++i )
+    {
+        const cJobStats::sStage &stage = report.mStages[ i ];
+        std::snprintf( line, sizeof( line ),
+                       "%s\n%s    \"%s\": { \"seconds\": %.6f, \"calls\": %llu, \"bytes\": %llu }",
+                       i ? "," : "", indent.c_str(), cJobStats::getStageName( cJobStats::eStage( i ) ).data(),
+                       stage.mNanoseconds / 1e9, static_cast< unsigned long long >( stage.mCalls ),
+                       static_cast< unsigned long long >( stage.mBytes ) );
+        json += line;
+    }
+
+    json += cJobStats::IS_ENABLED ? "\n" + indent + "  }\n" + indent + "}" : "}\n" + indent + "}";
+    return json;
+}
+
+std::string cStatsExporter::formatPrometheus( void ) const
+{
+    char line[ 512 ];
+    std::string text;
+
+    /// Заголовок метрики
+    const auto describeMetric = [ &text ]( const char *name, const char *type, const char *help )
+    {
+        text += std::string( "# HELP " ) + name + " " + help + "\n# TYPE " + name + " " + type + "\n";
+    };
+
+    describeMetric( "cmprr_jobs_total", "counter", "Finished jobs" );
+    for( const auto &[ action, totals ] : mTotals )
+    {
+        for( const auto &[ status, count ] : totals.mJobs )
+        {
+            std::snprintf( line, sizeof( line ), "cmprr_jobs_total{action=\"%s\",status=\"%s\"} %llu\n",
+                           getActionName( action ), getStatusName( status ),
+                           static_cast< unsigned long long >( count ) );
+            text += line;
+        }
+    }
+
+    describeMetric( "cmprr_bytes_in_total", "counter", "Input bytes of finished jobs" );
+    for( const auto &[ action, totals ] : mTotals )
+    {
+        std::snprintf( line, sizeof( line ), "cmprr_bytes_in_total{action=\"%s\"} %llu\n", getActionName( action ),
+                       static_cast< unsigned long long >( totals.mSum.mBytesIn ) );
+        text += line;
+    }
+
+    describeMetric( "cmprr_bytes_out_total", "counter", "Output bytes of finished jobs" );
+    for( const auto &[ action, totals ] : mTotals )
+    {
+        std::snprintf( line, sizeof( line ), "cmprr_bytes_out_total{action=\"%s\"} %llu\n", getActionName( action ),
+                       static_cast< unsigned long long >( totals.mSum.mBytesOut ) );
+        text += line;
+    }
+
+    describeMetric( "cmprr_job_seconds_total", "counter", "Wall time of finished jobs" );
+    for( const auto &[ action, totals ] : mTotals )
+    {
+        std::snprintf( line, sizeof( line ), "cmprr_job_seconds_total{action=\"%s\"} %.6f\n", getActionName( action ),
+                       totals.mSum.mSeconds );
+        text += line;
+    }
+
+    if( cJobStats::IS_ENABLED )
+    {
+        describeMetric( "cmprr_stage_seconds_total", "counter", "Thread time spent in job stages" );
+        describeMetric( "cmprr_stage_bytes_total", "counter", "Bytes processed by job stages" );
+        for( const auto &[ action, totals ] : mTotals )
+        {
+            for( size_t i = 0; i < cJobStats::STAGE_COUNT; ++i )
+            {
+                const cJobStats::sStage &stage = totals.mSum.mStages[ i ];
+                const char *stageName = cJobStats::getStageName( cJobStats::eStage( i ) ).data();
+
+                std::snprintf( line, sizeof( line ),
+                               "cmprr_stage_seconds_total{action=\"%s\",stage=\"%s\"} %.6f\n"
+                               "cmprr_stage_bytes_total{action=\"%s\",stage=\"%s\"} %llu\n",
+                               getActionName( action ), stageName, stage.mNanoseconds / 1e9,
+                               getActionName( action ), stageName, static_cast< unsigned long long >( stage.mBytes ) );
+                text += line;
+            }
+        }
+    }
+
+    describeMetric( "cmprr_peak_memory_bytes", "gauge", "Peak resident memory of the process" );
+    std::snprintf( line, sizeof( line ), "cmprr_peak_memory_bytes %llu\n",
+                   static_cast< unsigned long long >( cJobStats::getPeakMemory() ) );
+    text += line;
+
+    if( !mHasLastReport )
+        return text;
+
+    /// Последнее задание - метки алгоритма, действия и статуса
+    std::snprintf( line, sizeof( line ), "action=\"%s\",algorithm=\"%s\",status=\"%s\"",
+                   getActionName( mLastReport.mAction ), getAlgorithmName( mLastReport.mAlgType ),
+                   getStatusName( mLastReport.mStatus ) );
+    const std::string labels( line );
+
+    describeMetric( "cmprr_last_job_seconds", "gauge", "Wall time of the last job" );
+    std::snprintf( line, sizeof( line ), "cmprr_last_job_seconds{%s} %.6f\n", labels.c_str(), mLastReport.mSeconds );
+    text += line;
+
+    describeMetric( "cmprr_last_job_bytes_in", "gauge", "Input bytes of the last job" );
+    std::snprintf( line, sizeof( line ), "cmprr_last_job_bytes_in{%s} %llu\n", labels.c_str(),
+                   static_cast< unsigned long long >( mLastReport.mBytesIn ) );
+    text += line;
+
+    describeMetric( "cmprr_last_job_throughput_mbps", "gauge", "Input throughput of the last job, MiB/s" );
+    std::snprintf( line, sizeof( line ), "cmprr_last_job_throughput_mbps{%s} %.3f\n", labels.c_str(),
+                   mLastReport.getThroughput() );
+    text += line;
+
+    describeMetric( "cmprr_last_job_memory_limit_bytes", "gauge", "Memory limit of the last job, 0 - unlimited" );
+    std::snprintf( line, sizeof( line ), "cmprr_last_job_memory_limit_bytes{%s} %llu\n", labels.c_str(),
+                   static_cast< unsigned long long >( mLastReport.mMemoryLimit ) );
+    text += line;
+
+    describeMetric( "cmprr_last_job_peak_reserved_bytes", "gauge", "Peak memory reserved by blocks of the last job" );
+    std::snprintf( line, sizeof( line ), "cmprr_last_job_peak_reserved_bytes{%s} %llu\n", labels.c_str(),
+                   static_cast< unsigned long long >( mLastReport.mPeakReserved ) );
+    text += line;
+
+    if( cJobStats::IS_ENABLED )
+    {
+        describeMetric( "cmprr_last_job_stage_seconds", "gauge", "Thread time spent in stages of the last job" );
+        for( size_t i = 0; i < cJobStats::STAGE_COUNT; ++i )
+        {
+            std::snprintf( line, sizeof( line ), "cmprr_last_job_stage_seconds{%s,stage=\"%s\"} %.6f\n",
+                           labels.c_str(), cJobStats::getStageName( cJobStats::eStage( i ) ).data(),
+                           mLastReport.mStages[ i ].mNanoseconds / 1e9 );
+            text += line;
+        }
+    }
+
+    return text;
+}
+
+std::string cStatsExporter::formatJson( void ) const
+{
+    char line[ 256 ];
+    std::string json( "{\n" );
+
+    std::snprintf( line, sizeof( line ), "  \"stages_enabled\": %s,\n  \"peak_memory_bytes\": %llu,\n  \"totals\": {",
+                   cJobStats::IS_ENABLED ? "true" : "false",
+                   static_cast< unsigned long long >( cJobStats::getPeakMemory() ) );
+    json += line;
+
+    bool isFirst = true;
+    for( const auto &[ action, totals ] : mTotals )
+    {
+        json += std::string( isFirst ? "" : "," ) + "\n    \"" + getActionName( action ) + "\": {\n      \"jobs\": {";
+        isFirst = false;
+
+        bool isFirstStatus = true;
+        for( const auto &[ status, count ] : totals.mJobs )
+        {
+            std::snprintf( line, sizeof( line ), "%s \"%s\": %llu", isFirstStatus ? "" : ",", getStatusName( status ),
+                           static_cast< unsigned long long >( count ) );
+            json += line;
+            isFirstStatus = false;
+        }
+
+        json += " },\n      \"sum\": " + reportToJson( totals.mSum, "      " ) + "\n    }";
+    }
+    json += mTotals.empty() ? "}" : "\n  }";
+
+    if( mHasLastReport )
+    {
+        std::snprintf( line, sizeof( line ), ",\n  \"last_job\": {\n    \"action\": \"%s\",\n"
+                                             "    \"algorithm\": \"%s\",\n    \"status\": \"%s\",\n",
+                       getActionName( mLastReport.mAction ), getAlgorithmName( mLastReport.mAlgType ),
+                       getStatusName( mLastReport.mStatus ) );
+        json += line;
+        json += "    \"path\": \"" + escape( mLastReport.mPath ) + "\",\n    \"report\": " +
+                reportToJson( mLastReport, "    " ) + "\n  }";
+    }
+
+    json += "\n}\n";
+    return json;
+}
+
+bool cStatsExporter::writeFile( void ) const
+{
+    const bool isJson = mPath.size() >= 5 && 0 == mPath.compare( mPath.size() - 5, 5, ".json" );
+    const std::string text( isJson ? formatJson() : formatPrometheus() );
+
+    /// Сборщик читает файл в любой момент - замена атомарная
+    const std::string tempPath( mPath + ".tmp" );
+    std::ofstream file( tempPath, std::ios::binary | std::ios::trunc );
+    file << text;
+    file.close();
+
+    if( !file || 0 != std::rename( tempPath.c_str(), mPath.c_str() ) )
+    {
+        std::remove( tempPath.c_str() );
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,325 @@
+/** ****************************************************************************
+ * \file cThreadPool.h
+ *
+ * \defgroup ThreadPool Пул потоков
+ * @{
+ *
+ * \brief Модуль, предоставляющий пул рабочих потоков с перехватом задач
+ *
+ * \details Единственный на программу планировщик: задачи файлов, блоков и
+ * участков алгоритмов ставятся в один пул, поэтому вложенный параллелизм
+ * (много файлов по много блоков) не создает потоков больше, чем доступно
+ * процессорных ядер.
+ *
+ * Количество рабочих потоков определяется \ref cThreadPool::getAvailableCpuCount
+ * с учетом маски допустимых процессоров и квоты CPU контрольной группы
+ * (cgroup v2 cpu.max или cgroup v1 cpu.cfs_quota_us / cpu.cfs_period_us).
+ * Программа может задать его явно до создания общего пула
+ * (\ref cThreadPool::setInstanceThreadCount).
+ *
+ * У каждого рабочего потока своя очередь (дек). Задачи, порожденные в рабочем
+ * потоке, кладутся в конец его дека и берутся оттуда же (последней пришла -
+ * первой выполнена), что сохраняет локальность данных. Свободный поток
+ * забирает задачи из начала чужих деков (перехват). Задачи, поставленные не из
+ * рабочего потока (например, задания GUI), попадают в общие очереди по
+ * приоритетам \ref cThreadPool::eTaskPriority.
+ *
+ * Рабочий поток, ожидающий завершения своих подзадач в
+ * \ref cThreadPool::parallelFor, не блокируется, а выполняет задачи из очередей.
+ * Поэтому вложенное ожидание не может занять все потоки пула.
+ *
+ * Результат отдельной задачи возвращается через std::future.
+ *
+ * Реализован с поиощью класса \ref cThreadPool
+ * ****************************************************************************/
+
+#ifndef CTHREADPOOL_H
+#define CTHREADPOOL_H
+
+#include <array> /// Массивы фиксированного размера
+#include <atomic> /// Атомарные переменные
+#include <chrono> /// Время
+#include <condition_variable> /// Условные переменные
+#include <deque> /// Деки
+#include <exception> /// Передача исключений между потоками
+#include <functional> /// Обертки функций
+#include <future> /// Результаты асинхронных задач
+#include <memory> /// Умные указатели
+#include <mutex> /// Мьютексы
+#include <thread> /// Потоки
+#include <type_traits> /// Свойства типов
+#include <vector> /// Вектор
+
+/// \brief Класс, реализующий пул потоков с перехватом задач
+/// \class cThreadPool
+class cThreadPool final
+{
+public:
+    /// \brief Приоритеты задач, поставленных не из рабочего потока
+    /// \enum eTaskPriority
+    enum eTaskPriority
+    {
+        TASK_PRIORITY_HIGH = 0, ///< Интерактивные задания
+        TASK_PRIORITY_NORMAL, ///< Обычные задания
+        TASK_PRIORITY_LOW, ///< Фоновые задания
+        TASK_PRIORITY_COUNT ///< Количество приоритетов
+    };
+
+    /// \brief Конструктор класса
+    /// \param [in] threadCount Количество рабочих потоков. При 0 - по
+    /// \ref getAvailableCpuCount
+    explicit cThreadPool( size_t threadCount = 0 );
+
+    /// \brief Деструктор класса. Дожидается выполнения всех задач
+    ~cThreadPool( void );
+
+    cThreadPool( const cThreadPool & ) = delete;
+    cThreadPool &operator=( const cThreadPool & ) = delete;
+
+    /// \brief Поставить задачу в очередь
+    /// \param [in] task Задача
+    /// \param [in] priority Приоритет. Учитывается для задач, поставленных не
+    /// из рабочего потока
+    /// \return Результат задачи
+    template< typename F >
+    std::future< std::invoke_result_t< F > > submit( F &&task,
+                                                     eTaskPriority priority = TASK_PRIORITY_NORMAL )
+    {
+        using result_t = std::invoke_result_t< F >;
+
+        /// std::function требует копируемый объект, packaged_task - только
+        /// перемещаемый, поэтому задача хранится через shared_ptr
+        auto packaged = std::make_shared< std::packaged_task< result_t() > >(
+                    std::forward< F >( task ) );
+        std::future< result_t > result = packaged->get_future();
+
+        push( [ packaged ]( void ){ ( *packaged )(); }, priority );
+
+        return result;
+    }
+
+    /// \brief Выполнить func( i ) для i из [0, count) параллельно
+    ///
+    /// \details Итерация 0 выполняется в вызывающем потоке, остальные - в
+    /// пуле. Рабочий поток пула на время ожидания выполняет другие задачи,
+    /// сторонний поток - блокируется. Исключение итерации не прерывает
+    /// остальные: после завершения всех итераций первое из исключений
+    /// бросается вызывающему, как результат задачи \ref submit
+    ///
+    /// \param [in] count Количество итераций
+    /// \param [in] func Тело итерации
+    /// \param [in] priority Приоритет итераций
+    template< typename F >
+    void parallelFor( size_t count, F &&func, eTaskPriority priority = TASK_PRIORITY_NORMAL )
+    {
+        if( 0 == count )
+            return;
+
+        if( 1 == count || mWorkers.empty() )
+        {
+            for( size_t i = 0; i < count; ++i )
+                func( i );
+            return;
+        }
+
+        /// Задачи ссылаются на func и latch, поэтому выход из функции - только
+        /// после завершения всех поставленных итераций, в том числе при
+        /// исключении
+        sLatch latch( count - 1 );
+        size_t pushed = 1;
+        try
+        {
+            for( ; pushed < count; ++pushed )
+            {
+                push( [ &func, &latch, i = pushed ]( void )
+                {
+                    try
+                    {
+                        func( i );
+                    }
+                    catch( ... )
+                    {
+                        latch.fail( std::current_exception() );
+                    }
+
+                    latch.countDown();
+                }, priority );
+            }
+
+            func( 0 );
+        }
+        catch( ... )
+        {
+            latch.fail( std::current_exception() );
+        }
+
+        /// Итерации, не поставленные из-за исключения, не выполняются
+        if( pushed < count )
+            latch.countDown( count - pushed );
+
+        wait( latch );
+
+        if( latch.mError )
+            std::rethrow_exception( latch.mError );
+    }
+
+    /// \brief Дождаться результата задачи, поставленной через \ref submit
+    ///
+    /// \details Рабочий поток пула на время ожидания выполняет другие задачи,
+    /// как и в \ref parallelFor, сторонний поток - блокируется
+    ///
+    /// \param [in] future Результат задачи
+    /// \return Значение результата
+    template< typename T >
+    T get( std::future< T > &future )
+    {
+        if( isWorkerThread() )
+        {
+            helpUntil( [ &future ]( std::chrono::microseconds timeout )
+            {
+                return std::future_status::ready == future.wait_for( timeout );
+            } );
+        }
+
+        return future.get();
+    }
+
+    /// \brief Проверить, выполняется ли вызывающий код в рабочем потоке пула
+    /// \return true - в рабочем потоке, иначе - false
+    bool isWorkerThread( void ) const noexcept;
+
+    /// \brief Получить количество рабочих потоков
+    /// \return Количество рабочих потоков
+    inline size_t getThreadCount( void ) const noexcept { return mWorkers.size(); }
+
+    /// \brief Количество процессоров, доступных процессу
+    ///
+    /// \details Минимум из количества аппаратных потоков, размера маски
+    /// допустимых процессоров и квоты CPU контрольной группы (с округлением
+    /// вверх)
+    ///
+    /// \return Количество процессоров, не меньше 1
+    static size_t getAvailableCpuCount( void );
+
+    /// \brief Общий пул потоков программы
+    /// \return Ссылка на пул
+    static cThreadPool &instance( void );
+
+    /// \brief Задать количество рабочих потоков общего пула. Действует только
+    /// до первого вызова \ref instance
+    /// \param [in] threadCount Количество потоков. 0 - по
+    /// \ref getAvailableCpuCount
+    static inline void setInstanceThreadCount( size_t threadCount ) noexcept
+    {
+        mInstanceThreadCount = threadCount;
+    }
+
+private:
+    /// \brief Псевдоним для задачи
+    /// \typedef task_t
+    using task_t = std::function< void() >;
+
+    /// \brief Структура, описывающая счетчик незавершенных итераций
+    /// \struct sLatch
+    struct sLatch
+    {
+        /// \brief Конструктор
+        /// \param [in] count Количество итераций
+        explicit sLatch( size_t count ) : mRemaining( count ) {}
+
+        /// \brief Отметить завершение итераций
+        /// \param [in] count Количество завершенных итераций
+        void countDown( size_t count = 1 )
+        {
+            /// Под мьютексом, чтобы ожидающий не разрушил счетчик, пока
+            /// последний поток еще обращается к нему
+            std::lock_guard< std::mutex > lock( mMutex );
+            mRemaining -= count;
+            if( 0 == mRemaining )
+                mCondition.notify_all();
+        }
+
+        /// \brief Запомнить исключение итерации. Сохраняется первое
+        /// \param [in] error Исключение
+        void fail( std::exception_ptr error )
+        {
+            std::lock_guard< std::mutex > lock( mMutex );
+            if( !mError )
+                mError = std::move( error );
+        }
+
+        /// \brief Количество незавершенных итераций
+        std::atomic< size_t > mRemaining;
+        /// \brief Первое исключение итераций. Читается после ожидания
+        std::exception_ptr mError;
+        /// \brief Мьютекс для ожидания
+        std::mutex mMutex;
+        /// \brief Условная переменная для ожидания
+        std::condition_variable mCondition;
+    };
+
+    /// \brief Структура, описывающая очередь рабочего потока
+    /// \struct sWorkerQueue
+    struct sWorkerQueue
+    {
+        /// \brief Мьютекс очереди
+        std::mutex mMutex;
+        /// \brief Задачи. Владелец работает с концом, остальные - с началом
+        std::deque< task_t > mTasks;
+    };
+
+    /// \brief Интервал, с которым ожидающий рабочий поток проверяет очереди
+    constexpr static std::chrono::microseconds HELP_WAIT_INTERVAL{ 200 };
+
+    /// \brief Поставить задачу: из рабочего потока - в его дек, иначе - в
+    /// общую очередь приоритета
+    /// \param [in] task Задача
+    /// \param [in] priority Приоритет
+    void push( task_t task, eTaskPriority priority );
+
+    /// \brief Взять задачу: из своего дека, из общих очередей по приоритету,
+    /// перехватом из чужих деков
+    /// \param [in] workerIndex Номер рабочего потока
+    /// \param [out] task Задача
+    /// \param [in] isHelping true - поток ожидает свои подзадачи и не берет
+    /// задачи из общих очередей
+    /// \return true - задача получена
+    bool popTask( size_t workerIndex, task_t &task, bool isHelping );
+
+    /// \brief Дождаться завершения итераций parallelFor
+    /// \param [in] latch Счетчик итераций
+    void wait( sLatch &latch );
+
+    /// \brief Выполнять задачи из очередей, пока не наступит событие.
+    /// Вызывается только из рабочего потока
+    /// \param [in] waitFor Ожидание события не дольше заданного времени.
+    /// Возвращает true, если событие наступило
+    void helpUntil( const std::function< bool( std::chrono::microseconds ) > &waitFor );
+
+    /// \brief Цикл рабочего потока
+    /// \param [in] workerIndex Номер рабочего потока
+    void workerLoop( size_t workerIndex );
+
+    /// \brief Очереди рабочих потоков
+    std::vector< std::unique_ptr< sWorkerQueue > > mWorkerQueues;
+    /// \brief Общие очереди по приоритетам
+    std::array< std::deque< task_t >, TASK_PRIORITY_COUNT > mGlobalQueues;
+    /// \brief Мьютекс общих очередей и ожидания задач
+    std::mutex mMutex;
+    /// \brief Условная переменная для ожидания задач
+    std::condition_variable mCondition;
+    /// \brief Количество задач во всех очередях
+    std::atomic< size_t > mPendingCount{ 0 };
+    /// \brief Флаг остановки пула
+    bool mIsStopping = false;
+    /// \brief Рабочие потоки
+    std::vector< std::thread > mWorkers;
+
+    /// \brief Количество рабочих потоков общего пула. 0 - по
+    /// getAvailableCpuCount
+    inline static std::atomic< size_t > mInstanceThreadCount{ 0 };
+};
+
+/// @}
+
+#endif // CTHREADPOOL_H
@@ -0,0 +1,244 @@
+/** ****************************************************************************
+ * \brief Исходные коды пула потоков
+ *
+ * \file cThreadPool.cpp
+ * ****************************************************************************/
+
+#include "threadPool/h/cThreadPool.h" /// Заголовок класса
+#include <algorithm> /// std::min, std::max
+#include <fstream> /// Чтение файлов контрольной группы
+#include <string> /// Строки
+#ifdef __linux__
+#include <sched.h> /// sched_getaffinity
+#endif
+
+/// \brief Пул, которому принадлежит текущий рабочий поток
+static thread_local const cThreadPool *tlsPool = nullptr;
+/// \brief Номер текущего рабочего потока в его пуле
+static thread_local size_t tlsWorkerIndex = 0;
+
+/** ****************************************************************************
+ * Определение API
+ * ****************************************************************************/
+
+cThreadPool::cThreadPool( size_t threadCount )
+{
+    if( 0 == threadCount )
+        threadCount = getAvailableCpuCount();
+
+    mWorkerQueues.reserve( threadCount );
+    for( size_t i = 0; i < threadCount; ++i )
+        mWorkerQueues.push_back( std::make_unique< sWorkerQueue >() );
+
+    mWorkers.reserve( threadCount );
+    for( size_t i = 0; i < threadCount; ++i )
+        mWorkers.emplace_back( [ this, i ]( void ){ workerLoop( i ); } );
+}
+
+cThreadPool::~cThreadPool( void )
+{
+    {
+        std::lock_guard< std::mutex > lock( mMutex );
+        mIsStopping = true;
+    }
+    mCondition.notify_all();
+
+    for( auto &worker : mWorkers )
+        worker.join();
+}
+
+bool cThreadPool::isWorkerThread( void ) const noexcept
+{
+    return this == tlsPool;
+}
+
+size_t cThreadPool::getAvailableCpuCount( void )
+{
+    size_t count = std::max( 1u, std::thread::hardware_concurrency() );
+
+#ifdef __linux__
+    /// Маска допустимых процессоров (taskset, cpuset)
+    cpu_set_t cpuSet;
+    CPU_ZERO( &cpuSet );
+    if( 0 == sched_getaffinity( 0, sizeof( cpuSet ), &cpuSet ) )
+        count = std::min< size_t >( count, std::max( 1, CPU_COUNT( &cpuSet ) ) );
+
+    /// Квота CPU: количество процессоров = квота / период с округлением вверх
+    auto applyQuota = [ &count ]( long long quota, long long period )
+    {
+        if( quota > 0 && period > 0 )
+            count = std::min< size_t >( count, std::max( 1ll, ( quota + period - 1 ) / period ) );
+    };
+
+    /// cgroup v2: "<квота|max> <период>"
+    std::ifstream cpuMax( "/sys/fs/cgroup/cpu.max" );
+    std::string quota;
+    long long period = 0;
+    if( cpuMax >> quota >> period )
+    {
+        if( "max" != quota )
+            applyQuota( std::atoll( quota.c_str() ), period );
+    }
+    else
+    {
+        /// cgroup v1: квота -1 - без ограничений
+        std::ifstream quotaFile( "/sys/fs/cgroup/cpu/cpu.cfs_quota_us" );
+        std::ifstream periodFile( "/sys/fs/cgroup/cpu/cpu.cfs_period_us" );
+        long long quotaV1 = -1;
+        if( quotaFile >> quotaV1 && periodFile >> period )
+            applyQuota( quotaV1, period );
+    }
+#endif
+
+    return count;
+}
+
+cThreadPool &cThreadPool::instance( void )
+{
+    static cThreadPool pool( mInstanceThreadCount );
+    return pool;
+}
+
+/** ****************************************************************************
+ * Определение приватной части
+ * ****************************************************************************/
+
+void cThreadPool::push( task_t task, eTaskPriority priority )
+{
+    /// Счетчик увеличивается до появления задачи в очереди, иначе перехвативший
+    /// ее поток уменьшит счетчик раньше и он переполнится. Увеличение - под
+    /// общим мьютексом, чтобы засыпающий поток не пропустил оповещение
+    if( isWorkerThread() )
+    {
+        {
+            std::lock_guard< std::mutex > lock( mMutex );
+            ++mPendingCount;
+        }
+
+        sWorkerQueue &queue = *mWorkerQueues[ tlsWorkerIndex ];
+        try
+        {
+            std::lock_guard< std::mutex > lock( queue.mMutex );
+            queue.mTasks.push_back( std::move( task ) );
+        }
+        catch( ... )
+        {
+            --mPendingCount;
+            throw;
+        }
+    }
+    else
+    {
+        std::lock_guard< std::mutex > lock( mMutex );
+        mGlobalQueues[ priority ].push_back( std::move( task ) );
+        ++mPendingCount;
+    }
+
+    mCondition.notify_one();
+}
+
+bool cThreadPool::popTask( size_t workerIndex, task_t &task, bool isHelping )
+{
+    /// Свой дек - с конца
+    {
+        sWorkerQueue &queue = *mWorkerQueues[ workerIndex ];
+        std::lock_guard< std::mutex > lock( queue.mMutex );
+        if( !queue.mTasks.empty() )
+        {
+            task = std::move( queue.mTasks.back() );
+            queue.mTasks.pop_back();
+            --mPendingCount;
+            return true;
+        }
+    }
+
+    /// Новые задания берет только свободный поток, а не ожидающий своих
+    /// подзадач, иначе ожидание затянется на все новое задание
+    if( !isHelping )
+    {
+        std::lock_guard< std::mutex > lock( mMutex );
+        for( auto &queue : mGlobalQueues )
+        {
+            if( queue.empty() )
+                continue;
+
+            task = std::move( queue.front() );
+            queue.pop_front();
+            --mPendingCount;
+            return true;
+        }
+    }
+
+    /// Перехват из начала чужих деков
+    for( size_t shift = 1; shift < mWorkerQueues.size(); ++shift )
+    {
+        sWorkerQueue &queue = *mWorkerQueues[ ( workerIndex + shift ) % mWorkerQueues.size() ];
+        std::lock_guard< std::mutex > lock( queue.mMutex );
+        if( !queue.mTasks.empty() )
+        {
+            task = std::move( queue.mTasks.front() );
+            queue.mTasks.pop_front();
+            --mPendingCount;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void cThreadPool::wait( sLatch &latch )
+{
+    if( isWorkerThread() )
+    {
+        helpUntil( [ &latch ]( std::chrono::microseconds timeout )
+        {
+            std::unique_lock< std::mutex > lock( latch.mMutex );
+            return latch.mCondition.wait_for( lock, timeout,
+                                              [ &latch ]( void ){ return 0 == latch.mRemaining; } );
+        } );
+    }
+
+    /// Захват мьютекса гарантирует, что последняя итерация вышла из countDown
+    std::unique_lock< std::mutex > lock( latch.mMutex );
+    latch.mCondition.wait( lock, [ &latch ]( void ){ return 0 == latch.mRemaining; } );
+}
+
+void cThreadPool::helpUntil( const std::function< bool( std::chrono::microseconds ) > &waitFor )
+{
+    /// Выполнение задач вместо блокировки
+    while( !waitFor( std::chrono::microseconds( 0 ) ) )
+    {
+        task_t task;
+        if( popTask( tlsWorkerIndex, task, true ) )
+        {
+            task();
+            continue;
+        }
+
+        if( waitFor( HELP_WAIT_INTERVAL ) )
+            return;
+    }
+}
+
+void cThreadPool::workerLoop( size_t workerIndex )
+{
+    tlsPool = this;
+    tlsWorkerIndex = workerIndex;
+
+    for( ;; )
+    {
+        task_t task;
+        if( popTask( workerIndex, task, false ) )
+        {
+            task();
+            continue;
+        }
+
+        std::unique_lock< std::mutex > lock( mMutex );
+        mCondition.wait( lock, [ this ]( void ){ return mIsStopping || 0 != mPendingCount; } );
+
+        /// Остановка только после опустошения очередей
+        if( mIsStopping && 0 == mPendingCount )
+            return;
+    }
+}
@@ -16,12 +16,15 @@
 #define WINDOWGUI_H
 
 #include <QDialog> /// Qt класс диалогового окна
-#include <QLabel> /// Qt класс метки
-#include <QMovie> /// Qt класс для воспроизведения анимаций
-#include <map> /// Контейнер отображения
+#include <QTimer> /// Qt класс таймера
 #include "cFileWorker/h/cFileWorker.h" /// Класс для работы с файлами
+#include "batchProcessor/h/cBatchProcessor.h" /// Пакетная обработка файлов
+#include "job/h/cJob.h" /// Асинхронное задание
+#include "eventChannel/h/cEventChannel.h" /// Канал событий для журнала
+#include "stats/cJobStats/h/cJobStats.h" /// Статистика задания
 #include "libJournalView.h" /// Объект модели для представления журнала
 #include <memory> /// Умные указатели
+#include <atomic> /// Атомарные переменные
 #include "common.h" /// Общие константы программы
 #include "algorithm/cAbstractAlgorithm/h/cAbstractAlgorithm.h" /// Интерфейс алгоритмов
 
@@ -47,46 +50,102 @@ public:
 
 
 signals:
-    /// \brief Сигнал Qt для скрытия GIF бесконечной загрузки
-    void signalHideGif();
+    /// \brief Сигнал Qt о ходе выполнения задания. Испускается из рабочих
+    /// потоков, обрабатывается в потоке GUI
+    /// \param [in] percent Процент выполнения
+    /// \param [in] text Текст для индикатора
+    void signalProgress( int percent, QString text );
+
+    /// \brief Сигнал Qt о завершении задания для скрытия индикатора
+    void signalJobEnded();
 
 private slots:
+    /// \brief Обновить индикатор выполнения
+    /// \param [in] percent Процент выполнения
+    /// \param [in] text Текст для индикатора
+    void updateProgress( int percent, QString text );
+
+    /// \brief Перенести накопившиеся строки из канала в журнал одной пачкой
+    void drainJournal( void );
+
     /// \brief Клик по кнопке выбора файла
     void on_btnOpenFile_clicked( void );
 
+    /// \brief Клик по кнопке выбора директории
+    ///
+    /// \details Включает пакетный режим: алгоритм применяется ко всем файлам
+    /// дерева директорий
+    void on_btnOpenDir_clicked( void );
+
     /// \brief Клик по кнопке "сжать"
     ///
     /// \details Применит выбранный алгоритм к выбранному файлу для сжатия.
-    /// Во время сжатия отобразит gif бесконечной загрузки
+    /// Во время сжатия отобразит индикатор выполнения
     void on_btnCompress_clicked( void );
 
     /// \brief Клик по кнопке "разархивирорвать"
     ///
     /// \details Применит выбранный алгоритм к выбранному файлу для разархивирования.
-    /// Во время сжатия отобразит gif бесконечной загрузки
+    /// Во время сжатия отобразит индикатор выполнения
     void on_btnDecompress_clicked( void );
 
-private:
-    /// \brief Заполнить отображение mmAlgorithms
-    void fillCtrtAlgorithms( void );
+    /// \brief Клик по кнопке "отмена"
+    ///
+    /// \details Запросит отмену текущего задания. Задание завершится после
+    /// обработки уже начатых блоков
+    void on_btnCancel_clicked( void );
 
+private:
     /// \brief Метод, вызывающийся при завершении потоков обработки
     /// (при завершении компрессии/декомпрессии)
     ///
-    /// \details Вывод результата выполнения алгоритма в лог, скрытие
-    /// гифки бесконечной загрузки
+    /// \details Вывод результата выполнения алгоритма и статистики задания в
+    /// лог, выгрузка статистики в файл, скрытие индикатора выполнения
     ///
     /// \param [in] status Результат выполнения алгоритма
     /// \param [in] newName Результирующий файл
-    void threadEnding( eErrStatus status, const std::string &newName );
+    /// \param [in] stats Статистика задания
+    void threadEnding( eErrStatus status, const std::string &newName, const cJobStats::sReport &stats );
+
+    /// \brief Метод, вызывающийся при завершении пакетной обработки
+    ///
+    /// \details Вывод итогов, суммарной статистики и ошибочных файлов в лог,
+    /// выгрузка статистики каждого файла в файл, скрытие индикатора
+    /// выполнения
+    ///
+    /// \param [in] report Отчет о пакетной обработке
+    void batchEnding( const cBatchProcessor::sReport &report );
 
-    /// \brief Инициализация объекта гифки бесконечной загрузки
-    void initGifLoading( void );
+    /// \brief Текст ошибки для журнала
+    /// \param [in] status Статус выполнения
+    /// \return Текст ошибки
+    static const char *getErrorText( eErrStatus status );
+
+    /// \brief Записать статистику задания в журнал
+    /// \param [in] stats Статистика
+    void writeStats( const cJobStats::sReport &stats );
+
+    /// \brief Записать строку в журнал
+    ///
+    /// \details Модель журнала изменяется только в потоке GUI. Из рабочих
+    /// потоков строка ставится в канал \ref mJournalChannel и попадает в
+    /// журнал по таймеру \ref mJournalTimer
+    ///
+    /// \param [in] str Строка
+    void writeJournal( QString str );
+
+    /// \brief Создать задание с отчетом о ходе выполнения в индикатор
+    /// \return Задание
+    std::shared_ptr< cJob > makeJob( void );
 
     /// \brief Делегировать выполнение реальной работы в бэк
     /// \param [in] action Тип действия
     void delegateExecRealWork( eTypeOfActions action );
 
+    /// \brief Делегировать пакетную обработку директории в бэк
+    /// \param [in] action Тип действия
+    void delegateExecBatchWork( eTypeOfActions action );
+
     /// \brief Проверка флага состояния потоков
     /// \return true - Флаг поднят, false - опущен
     bool checkEndThreadFlag( void );
@@ -98,27 +157,30 @@ private:
     /// \brief Объект для работы с файлами ОС
     cFileWorker mFileWorker;
 
-    /// \brief Псевдоним для отображения типа алгоритма на unuque ptr от
-    /// объекта алгоритма
-    /// \typedef mapAlgType2UniqPtrAlg_t
-    using mapAlgType2UniqPtrAlg_t = std::map< eTypeOfComprAlgorithm,
-                                              std::unique_ptr< cAbstractAlgorithm > >;
-
-    /// \brief Отображение типа алгоритма по его номеру на сам объект,
-    /// реализующий алгоритм
-    mapAlgType2UniqPtrAlg_t mmAlgorithms;
+    /// \brief Директория для пакетной обработки. Пустая - обрабатывается
+    /// выбранный файл
+    std::string mBatchDirPath;
 
     /// \brief Объект модели для представления журнала
     cJournalModel mJouarnalModel;
 
+    /// \brief Емкость канала строк журнала
+    constexpr static size_t JOURNAL_CHANNEL_SIZE = 1024;
+    /// \brief Период переноса строк из канала в журнал, мс
+    constexpr static int JOURNAL_DRAIN_INTERVAL = 50;
+
+    /// \brief Канал строк журнала от рабочих потоков
+    cEventChannel< QString, JOURNAL_CHANNEL_SIZE > mJournalChannel;
+    /// \brief Таймер переноса строк из канала в журнал
+    QTimer mJournalTimer;
+
     /// \brief Флаг, отвечающий за состояние потоков обработчиков.
-    /// Если все потоки выполнены - флаг = true, иначе - false
-    bool mIsThreadEnd = true;
+    /// Если все потоки выполнены - флаг = true, иначе - false. Опускается в
+    /// потоке GUI, поднимается в рабочем потоке пула
+    std::atomic< bool > mIsThreadEnd{ true };
 
-    /// \brief Метка загрузки для помещения в нее объекта QMovie
-    QLabel mlblLoading;
-    /// \brief Объект для отображения бесконечной загрузки
-    QMovie mMovieLoading;
+    /// \brief Текущее или последнее задание
+    std::shared_ptr< cJob > mpJob;
 };
 
 /// @}
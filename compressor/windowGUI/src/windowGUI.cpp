@@ -8,9 +8,11 @@
 #include "windowGUI/h/windowGUI.h" /// Заголовок класса
 #include "ui_windowGUI.h" /// Файл, генерируемый из формы windowGUI.ui
 #include <QFileDialog> /// Диалоговое окно выбора файла
-#include <thread> /// Поддержка многопоточности
-#include "algorithm/cAlgorithmRLE/h/cAlgorithmRLE.h" /// Алгоритм RLE
-#include "algorithm/cAlgorithmHaffman/h/cAlgorithmHaffman.h" /// Алгоритм Хаффмана
+#include <QFileInfo> /// Qt класс информации о файле
+#include <QThread> /// Qt класс потока
+#include "threadPool/h/cThreadPool.h" /// Пул потоков
+#include "algorithm/cAlgorithmRegistry/h/cAlgorithmRegistry.h" /// Реестр алгоритмов
+#include "stats/cStatsExporter/h/cStatsExporter.h" /// Выгрузка статистики
 
 /** ****************************************************************************
  * Определение API
@@ -19,36 +21,50 @@
 windowGUI::windowGUI( QWidget *parent ) :
     QDialog( parent ),
     mpUI( new Ui::windowGUI ),
-    mJouarnalModel( this ),
-    mMovieLoading(":/gif/gif/loading.gif") /// Путь до гифки, добавленной в
-                                           /// ресурсы прокта
+    mJouarnalModel( this )
 {
     /// Установка GUI
     mpUI->setupUi( this );
 
-    /// Инициализация отображения типа алгоритма к объекту алгоритма
-    fillCtrtAlgorithms();
-
     /// Установка модели логера для представления на GUI
     mpUI->journal->setModel( &mJouarnalModel );
 
     /// Установка фиксированного размера окна программы
     this->setFixedSize( this->size() );
 
-    /// Инициализация gif
-    initGifLoading();
+    /// Индикатор выполнения виден только во время работы
+    mpUI->progressBar->hide();
 
     /// Запрет действий до выбора файла
     mpUI->gbAlg->setEnabled( false );
 
-    /// Сигнал-слотовое соединение для сокрытия бесконечной загрузки
+    /// Сигнал-слотовые соединения индикатора выполнения. Сигналы испускаются
+    /// в рабочих потоках, поэтому соединения - через очередь событий
     qRegisterMetaType<QVector<int>>("QVector<int>");
-    connect( this, &windowGUI::signalHideGif,
-             &this->mlblLoading, &QLabel::hide );
+    connect( this, &windowGUI::signalProgress,
+             this, &windowGUI::updateProgress, Qt::QueuedConnection );
+    connect( this, &windowGUI::signalJobEnded,
+             mpUI->progressBar, &QProgressBar::hide, Qt::QueuedConnection );
+
+    /// Перенос строк журнала из рабочих потоков
+    connect( &mJournalTimer, &QTimer::timeout, this, &windowGUI::drainJournal );
+    mJournalTimer.start( JOURNAL_DRAIN_INTERVAL );
 }
 
 windowGUI::~windowGUI( void )
 {
+    /// Задание обращается к окну, поэтому дожидаемся его завершения. Канал
+    /// журнала опустошается, чтобы задание не ждало места в нем
+    if( mpJob )
+    {
+        mpJob->cancel();
+        while( !mpJob->isDone() )
+        {
+            drainJournal();
+            QThread::msleep( JOURNAL_DRAIN_INTERVAL );
+        }
+    }
+
     delete mpUI;
 }
 
@@ -56,59 +72,129 @@ windowGUI::~windowGUI( void )
  * Определение приватной части
  * ****************************************************************************/
 
-void windowGUI::fillCtrtAlgorithms( void )
+void windowGUI::threadEnding( eErrStatus status, const std::string &newName, const cJobStats::sReport &stats )
 {
-    mmAlgorithms.insert( std::make_pair( ALG_TYPE_RLE,
-                                         std::make_unique< cAlgorithmRLE >() ) );
-    mmAlgorithms.insert( std::make_pair( ALG_TYPE_HFMN,
-                                         std::make_unique< cAlgorithmHaffman >() ) );
+    if( ERR_STATUS_SUCCESS == status )
+    {
+        writeJournal( "Выполнено! Результат в файле:" );
+        writeJournal( QString::fromStdString( newName ) );
+    }
+    else
+    {
+        writeJournal( getErrorText( status ) );
+    }
+
+    writeStats( stats );
+    if( ERR_STATUS_SUCCESS != cStatsExporter::instance().add( stats ) )
+        writeJournal( "Ошибка записи файла статистики!" );
+
+    /// Скрыть индикатор
+    emit signalJobEnded();
+}
+
+void windowGUI::batchEnding( const cBatchProcessor::sReport &report )
+{
+    /// Только ошибочные файлы, иначе журнал переполнится на больших пакетах.
+    /// В файл статистики попадает каждый файл
+    cJobStats::sReport total;
+    bool isExported = true;
+    for( const auto &result : report.mFiles )
+    {
+        if( ERR_STATUS_SUCCESS != result.mStatus )
+            writeJournal( QString::fromStdString( result.mSrcPath ) + ": " +
+                                         getErrorText( result.mStatus ) );
+
+        cStatsExporter::accumulate( total, result.mStats );
+        isExported = ERR_STATUS_SUCCESS == cStatsExporter::instance().add( result.mStats ) && isExported;
+    }
+
+    writeJournal( QString( "Пакет выполнен! Файлов: %1, с ошибкой: %2" )
+                                 .arg( report.mFiles.size() ).arg( report.mFailedCount ) );
+    writeJournal( QString( "Обработано %1 МБ за %2 с (%3 МБ/с)" )
+                                 .arg( report.mTotalBytes / ( 1024.0 * 1024.0 ), 0, 'f', 1 )
+                                 .arg( report.mSeconds, 0, 'f', 2 )
+                                 .arg( report.getThroughput(), 0, 'f', 1 ) );
+
+    /// Время стадий - сумма по файлам
+    writeStats( total );
+    if( !isExported )
+        writeJournal( "Ошибка записи файла статистики!" );
+
+    /// Скрыть индикатор
+    emit signalJobEnded();
 }
 
-void windowGUI::threadEnding( eErrStatus status , const std::string &newName )
+const char *windowGUI::getErrorText( eErrStatus status )
 {
     switch( status )
     {
     case ERR_STATUS_SUCCESS:
-        mJouarnalModel.insertString( "Выполнено! Результат в файле:" );
-        mJouarnalModel.insertString( newName.c_str() );
-        break;
+        return "Выполнено!";
 
     case ERR_STATUS_BAD_FILE_OPEN:
-        mJouarnalModel.insertString( "Ошибка при открытии файлов!" );
-        break;
+        return "Ошибка при открытии файлов!";
 
     case ERR_STATUS_BAD_POSTFIX:
-        mJouarnalModel.insertString( "Расширение файла не является допустимым для данного алгоритма!" );
-        break;
+        return "Расширение файла не является допустимым для данного алгоритма!";
 
     case ERR_STATUS_EMPTY_SRC_FILE:
-        mJouarnalModel.insertString( "Выбран пустой файл!" );
-        break;
+        return "Выбран пустой файл!";
 
     case ERR_STATUS_BAD_ALG:
-        mJouarnalModel.insertString( "Ошибка при выполнении алгоритма!" );
-        break;
+        return "Ошибка при выполнении алгоритма!";
+
+    case ERR_STATUS_BAD_FORMAT:
+        return "Ошибка формата сжатых данных!";
+
+    case ERR_STATUS_BAD_FILE_WRITE:
+        return "Ошибка записи в файл!";
+
+    case ERR_STATUS_CANCELED:
+        return "Операция отменена!";
+
+    case ERR_STATUS_MEMORY_LIMIT:
+        return "Не хватает памяти в пределах ограничения!";
     }
 
-    /// Скрыть гифку
-    emit signalHideGif();
+    return "Неизвестная ошибка!";
 }
 
-void windowGUI::initGifLoading()
+void windowGUI::writeStats( const cJobStats::sReport &stats )
 {
-    static constexpr size_t GIF_WIDTH( 320 );
-    static constexpr size_t GIF_HEIGHT( 180 );
+    for( const std::string &line : cStatsExporter::describe( stats ) )
+        writeJournal( QString::fromStdString( line ) );
+}
 
-    mlblLoading.setParent( this );
-    mlblLoading.setFixedSize( GIF_WIDTH, GIF_HEIGHT );
+void windowGUI::writeJournal( QString str )
+{
+    if( QThread::currentThread() != thread() )
+    {
+        mJournalChannel.push( std::move( str ) );
+        return;
+    }
 
-    /// Центровка
-    mlblLoading.move(( this->width() / 2 ) - GIF_WIDTH / 2,
-                    ( this->height() / 2 ) - GIF_HEIGHT / 2);
+    /// Сначала строки рабочих потоков, чтобы сохранить порядок
+    drainJournal();
+    mJouarnalModel.insertString( str );
+}
 
-    mlblLoading.setMovie( &mMovieLoading );
-    mMovieLoading.start();
-    mlblLoading.hide();
+std::shared_ptr< cJob > windowGUI::makeJob( void )
+{
+    auto job = std::make_shared< cJob >( [ this ]( const cJob::sProgress &progress )
+    {
+        const int percent = progress.mTotalBytes
+                ? int( progress.mBytesIn * 100 / progress.mTotalBytes ) : 0;
+
+        emit signalProgress( percent, QString( "%p% - %1 МБ/с, осталось %2 с" )
+                             .arg( progress.mSpeed, 0, 'f', 1 )
+                             .arg( progress.mEta, 0, 'f', 0 ) );
+    } );
+
+    mpUI->progressBar->setValue( 0 );
+    mpUI->progressBar->setFormat( "%p%" );
+    mpUI->progressBar->show();
+
+    return job;
 }
 
 void windowGUI::delegateExecRealWork( eTypeOfActions action )
@@ -117,44 +203,93 @@ void windowGUI::delegateExecRealWork( eTypeOfActions action )
     if( !checkEndThreadFlag() )
         return;
 
-    /// Открытие файла для записи
-    if( ERR_STATUS_SUCCESS != mFileWorker.updateWriteFile("./temporary" ) )
+    /// Выбрана директория - пакетная обработка
+    if( !mBatchDirPath.empty() )
     {
-        mJouarnalModel.insertString( "Ошибка открытия файла!" );
+        delegateExecBatchWork( action );
+        return;
     }
-    else
+
+    /// Файл для записи создается при выполнении рядом с результатом
+    writeJournal( "Выполнение работы..." );
+
+    /// Запуск задания в общем пуле дабы не блокировать GUI. Блоки файла
+    /// ставятся в тот же пул, поэтому потоков не больше, чем ядер
+    mIsThreadEnd = false;
+
+    /// Номер в списке выбора - тип алгоритма
+    cAbstractAlgorithm &algorithm =
+            *cAlgorithmRegistry::get( eTypeOfComprAlgorithm( mpUI->cbAlgorithmType->currentIndex() ) );
+
+    mpJob = makeJob();
+    mpJob->setTotal( QFileInfo( mpUI->path2File->text() ).size() );
+    mpJob->start( [ this, &algorithm, action ]( cJob &job )
     {
-        mJouarnalModel.insertString( "Открыт файл для записи" );
-        mJouarnalModel.insertString( "Выполнение работы..." );
+        /// Запуск выполнения алгоритма
+        auto result = mFileWorker.applyAlgorithm( algorithm, action, &job );
 
-        /// Запуск потока дабы не блокировать GUI
-        mIsThreadEnd = false;
+        threadEnding( std::get< eErrStatus >( result ), std::get< std::string >( result ),
+                      mFileWorker.getLastStats() );
 
-        std::thread thread( [ this, action ]( void )
-        {
-            /// Запуск выполнения алгоритма
-            auto [ newName, applyStatus ] =
-                    mFileWorker.applyAlgorithm(
-                        *mmAlgorithms.at( eTypeOfComprAlgorithm( mpUI->cbAlgorithmType->currentIndex() ) ),
-                        action );
-
-            /// В конце поднятие флага
-            mIsThreadEnd = true;
-            threadEnding( applyStatus, newName );
-        });
-
-        /// Не дожидаться
-        thread.detach();
-
-        /// Показать гифку загрузки
-        mlblLoading.show();
-    }
+        /// Флаг поднимается после отчета: до него GUI может начать новую
+        /// работу с mFileWorker, пока статистика еще читается
+        mIsThreadEnd = true;
+
+        return result;
+    }, cThreadPool::TASK_PRIORITY_HIGH );
+}
+
+void windowGUI::delegateExecBatchWork( eTypeOfActions action )
+{
+    writeJournal( "Пакетная обработка директории:" );
+    writeJournal( QString::fromStdString( mBatchDirPath ) );
+
+    mIsThreadEnd = false;
+
+    /// Номер в списке выбора - тип алгоритма
+    cAbstractAlgorithm &algorithm =
+            *cAlgorithmRegistry::get( eTypeOfComprAlgorithm( mpUI->cbAlgorithmType->currentIndex() ) );
+
+    /// Каждый файл - отдельное задание в общем пуле со своим cFileWorker,
+    /// поэтому mFileWorker не используется
+    mpJob = makeJob();
+    mpJob->start( [ this, &algorithm, action, dirPath = mBatchDirPath ]( cJob &job )
+    {
+        const cBatchProcessor::sReport report =
+                cBatchProcessor::run( cBatchProcessor::collectFiles( dirPath, algorithm, action ),
+                                      algorithm, action, &job );
+
+        batchEnding( report );
+
+        /// Флаг поднимается после отчета, как и для одного файла
+        mIsThreadEnd = true;
+
+        const eErrStatus status = job.isCanceled() ? ERR_STATUS_CANCELED
+                                                   : report.mFailedCount ? ERR_STATUS_BAD_ALG
+                                                                         : ERR_STATUS_SUCCESS;
+        return cJob::result_t( dirPath, status );
+    }, cThreadPool::TASK_PRIORITY_HIGH );
+}
+
+void windowGUI::updateProgress( int percent, QString text )
+{
+    mpUI->progressBar->setValue( percent );
+    mpUI->progressBar->setFormat( text );
+}
+
+void windowGUI::drainJournal( void )
+{
+    QStringList batch;
+    mJournalChannel.drain( [ &batch ]( QString &&str ){ batch.append( std::move( str ) ); } );
+
+    if( !batch.isEmpty() )
+        mJouarnalModel.insertString( batch );
 }
 
 bool windowGUI::checkEndThreadFlag( void )
 {
     if( !mIsThreadEnd )
-        mJouarnalModel.insertString( "Дождитесь завершения работы..." );
+        writeJournal( "Дождитесь завершения работы..." );
 
     return mIsThreadEnd;
 }
@@ -169,13 +304,16 @@ void windowGUI::on_btnOpenFile_clicked( void )
     QString fileName = QFileDialog::getOpenFileName( this, "Выбор файла", "." );
     mpUI->path2File->setText( fileName );
 
+    /// Выбор файла отменяет пакетный режим
+    mBatchDirPath.clear();
+
     if( !fileName.isEmpty() )
     {
         /// Установка файла, как файл для чтения для mFileWorker
         eErrStatus isOpenGood(
                     mFileWorker.updateReadFile( mpUI->path2File->text().toStdString() ) );
 
-        mJouarnalModel.insertString( ERR_STATUS_SUCCESS == isOpenGood
+        writeJournal( ERR_STATUS_SUCCESS == isOpenGood
                                      ? "Открыт файл для чтения:\n" + fileName
                                      : "Ошибка открытия файла! " + fileName );
 
@@ -184,7 +322,30 @@ void windowGUI::on_btnOpenFile_clicked( void )
     else
     {
         mpUI->gbAlg->setEnabled( false );
-        mJouarnalModel.insertString( "Файл не выбран" );
+        writeJournal( "Файл не выбран" );
+    }
+}
+
+void windowGUI::on_btnOpenDir_clicked( void )
+{
+    /// Не пускать, если поток еще в процессе
+    if( !checkEndThreadFlag() )
+        return;
+
+    /// Выбор директории пользователем
+    QString dirName = QFileDialog::getExistingDirectory( this, "Выбор директории", "." );
+    mpUI->path2File->setText( dirName );
+    mBatchDirPath = dirName.toStdString();
+
+    if( !dirName.isEmpty() )
+    {
+        writeJournal( "Выбрана директория для пакетной обработки:\n" + dirName );
+        mpUI->gbAlg->setEnabled( true );
+    }
+    else
+    {
+        mpUI->gbAlg->setEnabled( false );
+        writeJournal( "Директория не выбрана" );
     }
 }
 
@@ -198,3 +359,12 @@ void windowGUI::on_btnDecompress_clicked( void )
     delegateExecRealWork( ACT_TYPE_DECOMPR );
 }
 
+void windowGUI::on_btnCancel_clicked( void )
+{
+    if( mIsThreadEnd || !mpJob )
+        return;
+
+    mpJob->cancel();
+    writeJournal( "Отмена задания..." );
+}
+